@@ -51,6 +51,10 @@ public:
 	Bit8u Write_Sector(Bit32u head,Bit32u cylinder,Bit32u sector,void * data);
 	Bit8u Read_AbsoluteSector(Bit32u sectnum, void * data);
 	Bit8u Write_AbsoluteSector(Bit32u sectnum, void * data);
+	/* Bulk variants covering a linear run of sectors with one host
+	   transfer; the int13 handler uses them for multi-sector requests */
+	Bit8u Read_AbsoluteSectors(Bit32u sectnum, Bitu count, void * data);
+	Bit8u Write_AbsoluteSectors(Bit32u sectnum, Bitu count, void * data);
 
 	void Set_Geometry(Bit32u setHeads, Bit32u setCyl, Bit32u setSect, Bit32u setSectSize);
 	void Get_Geometry(Bit32u * getHeads, Bit32u *getCyl, Bit32u *getSect, Bit32u *getSectSize);
@@ -59,7 +63,7 @@ public:
 	imageDisk(FILE *imgFile, const char *imgName, Bit32u imgSizeK, bool isHardDisk);
 	imageDisk(const imageDisk&) = delete; // prevent copy
 	imageDisk& operator=(const imageDisk&) = delete; // prevent assignment
-	~imageDisk() { if(diskimg != NULL) { fclose(diskimg); }	};
+	~imageDisk();
 
 	bool hardDrive;
 	bool active;
@@ -70,8 +74,30 @@ public:
 	Bit32u sector_size;
 	Bit32u heads,cylinders,sectors;
 private:
+	/* When the host supports it the image is memory-mapped and sector
+	 * access becomes a memcpy; the FILE* stays as fallback and covers
+	 * accesses beyond the mapped size. */
+	Bit8u *mmap_base;
+	size_t mmap_size;
+	bool mmap_readonly;
 	Bit32u current_fpos;
 	enum { NONE,READ,WRITE } last_action;
+
+	/* Host-side sector cache for the FILE* path (win32 builds and
+	 * images that could not be mapped); 4-way set associative with LRU
+	 * eviction per set, write-through, sized from the [dos] diskcache
+	 * setting.  Mapped images bypass it - they already are the cache. */
+	struct CacheTag { Bit32u sect; Bit32u lru; bool valid; };
+	Bit8u *cache_data;
+	CacheTag *cache_tags;
+	Bitu cache_sets;
+	Bit32u cache_tick;
+	Bitu cache_kb;
+	void CacheAlloc(void);
+	void CacheFree(void);
+	Bit8u *CacheLookup(Bit32u sectnum);
+	Bit8u *CacheSlot(Bit32u sectnum);
+	void CacheInvalidate(Bit32u sectnum,Bitu count);
 };
 
 void updateDPT(void);
@@ -38,10 +38,16 @@ enum { CB_RETN,CB_RETF,CB_RETF8,CB_RETF_STI,CB_RETF_CLI,
 #define CB_SEG		0xF000
 #define CB_SOFFSET	0x1000
 
-enum {	
+enum {
 	CBRET_NONE=0,CBRET_STOP=1
 };
 
+/* Callbacks flagged fast are invoked by the interpreter cores right at
+   the callback instruction instead of bouncing through the emulation
+   loop; only handlers that always return CBRET_NONE qualify */
+extern bool CallBack_Fast[];
+void CALLBACK_SetFast(Bitu callback,bool fast);
+
 extern Bit8u lastint;
 
 static INLINE RealPt CALLBACK_RealPointer(Bitu callback) {
@@ -54,6 +54,7 @@ extern Bit32s CPU_CycleMax;
 extern Bit32s CPU_OldCycleMax;
 extern Bit32s CPU_CyclePercUsed;
 extern Bit32s CPU_CycleLimit;
+extern Bit32s CPU_DynCacheSize;
 extern Bit64s CPU_IODelayRemoved;
 extern bool CPU_CycleAutoAdjust;
 extern bool CPU_SkipCycleAutoAdjust;
@@ -84,6 +85,10 @@ void CPU_Enable_SkipAutoAdjust(void);
 void CPU_Disable_SkipAutoAdjust(void);
 void CPU_Reset_AutoAdjust(void);
 
+//Called from DOS_Execute with the (up to 8 char, not terminated) mcb
+//name of the program being started; restores a remembered cycle profile
+void CPU_NotifyExecutable(const char * stripname);
+
 
 //CPU Stuff
 
@@ -459,6 +464,12 @@ struct CPUBlock {
 	struct {
 		Bitu mask,notmask;
 		bool big;
+		/* pinned host mapping of the last stack page pushed/popped on;
+		   paging drops it whenever the linear mapping changes.  page 1
+		   never matches a page-aligned address, so it marks it invalid */
+		Bit32u cached_page;
+		HostPt cached_read;
+		HostPt cached_write;
 	} stack;
 	struct {
 		bool big;
@@ -478,6 +489,10 @@ struct CPUBlock {
 
 extern CPUBlock cpu;
 
+static INLINE void CPU_InvalidateStackCache(void) {
+	cpu.stack.cached_page=1;
+}
+
 static INLINE void CPU_SetFlagsd(Bitu word) {
 	Bitu mask=cpu.cpl ? FMASK_NORMAL : FMASK_ALL;
 	CPU_SetFlags(word,mask);
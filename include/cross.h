@@ -78,6 +78,12 @@ static inline float powf (float x, float y) { return (float) pow (x,y); }
 
 void CROSS_DetermineConfigPaths();
 
+/* thread placement controls, driven by the [performance] config section */
+class Section;
+void PERF_Init(Section* sec);
+void PERF_TuneEmulationThread(void);
+void PERF_TuneWorkerThread(void);
+
 class Cross {
 public:
 	static void GetPlatformConfigDir(std::string& in);
@@ -0,0 +1,46 @@
+/*
+ *  Copyright (C) 2002-2020  The DOSBox Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef DOSBOX_CTRLSOCK_H
+#define DOSBOX_CTRLSOCK_H
+
+#ifndef DOSBOX_DOSBOX_H
+#include "dosbox.h"
+#endif
+
+/* Local control socket for headless automation.  A unix stream socket
+   accepting one text command per line; everything queued on the socket is
+   executed in one batch per event poll, so a harness can push a whole
+   input sequence without paying a display round trip per key.
+
+   Commands:
+     key <name> <down|up|press>    inject a key through its mapper event
+     event <entry> <down|up|press> trigger any mapper event (hand_scrshot..)
+     cycles                        reply with the current cycle setting
+     digest                        reply with frame digest sequence and hash
+     text                          reply "ok <rows> <cols> <seq>" followed
+                                   by the text screen, one line per row
+   Replies are "ok ..." or "err ...", one line per command. */
+
+// create and listen on the socket; empty or failing paths disable the service
+void CTRLSOCK_Init(const char * path);
+void CTRLSOCK_Shutdown(void);
+// accept clients and run all queued commands; called from the event poll
+void CTRLSOCK_Events(void);
+
+#endif
@@ -25,6 +25,9 @@ void DEBUG_CheckExecuteBreakpoint(Bit16u seg, Bit32u off);
 bool DEBUG_ExitLoop(void);
 void DEBUG_RefreshPage(char scroll);
 Bitu DEBUG_EnableDebugger(void);
+void DEBUG_ProfileSample(void);
+
+extern bool DEBUG_Profiling;
 
 extern Bitu cycle_count;
 extern Bitu debugCallback;
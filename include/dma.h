@@ -30,6 +30,9 @@ enum DMAEvent {
 class DmaChannel;
 typedef void (* DMA_CallBack)(DmaChannel * chan,DMAEvent event);
 
+/* worst case is every 4k page of a 128k window in a different place */
+#define DMA_SPAN_MAX 33
+
 class DmaChannel {
 public:
 	Bit32u pagebase;
@@ -47,6 +50,18 @@ public:
 	bool tcount;
 	bool request;
 	DMA_CallBack callback;
+	/* Scatter-gather cache: the channel's wrap window resolved into
+	   contiguous host spans once per programming, so transfers become
+	   plain copies instead of per-page mapping and wrap arithmetic.
+	   Rebuilt lazily on the first transfer after an invalidation. */
+	struct {
+		Bit8u * host;	//Host pointer to the start of the span
+		Bit32u start;	//First byte offset inside the window
+		Bit32u len;
+	} spans[DMA_SPAN_MAX];
+	Bitu span_count;
+	Bit32u span_wrap;	//Byte mask of the window the spans cover
+	bool spans_ok;
 
 	DmaChannel(Bit8u num, bool dma16);
 	void DoCallBack(DMAEvent event) {
@@ -69,6 +84,7 @@ public:
 	void SetPage(Bit8u val) {
 		pagenum=val;
 		pagebase=(pagenum >> DMA16) << (16+DMA16);
+		spans_ok=false;
 	}
 	void Raise_Request(void) {
 		request=true;
@@ -78,6 +94,8 @@ public:
 	}
 	Bitu Read(Bitu size, Bit8u * buffer);
 	Bitu Write(Bitu size, Bit8u * buffer);
+	void BuildSpans(void);
+	void TransferBlock(Bitu addr,Bit8u * buffer,Bitu size,bool to_guest);
 };
 
 class DmaController {
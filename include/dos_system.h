@@ -21,6 +21,7 @@
 
 #include "dosbox.h"
 
+#include <iosfwd>
 #include <string>
 #include <vector>
 
@@ -132,11 +133,14 @@ private:
 	Bitu devnum;
 };
 
+struct SDL_semaphore;
+
 class localFile : public DOS_File {
 public:
 	localFile                   (const char* name, FILE * handle);
 	localFile                   (const localFile&) = delete; // prevent copying
 	localFile& operator=        (const localFile&) = delete; // prevent assignment
+	~localFile                  ();
 	bool Read                   (Bit8u * data,Bit16u * size);
 	bool Write                  (Bit8u * data,Bit16u * size);
 	bool Seek                   (Bit32u * pos,Bit32u type);
@@ -146,7 +150,13 @@ public:
 	void Flush                  (void);
 	void SetFlagReadOnlyMedium  () { read_only_medium = true; }
 	FILE * fhandle; //todo handle this properly
+protected:
+	void DrainWrites            (void);
 private:
+	bool QueueWrite             (Bit8u * data,Bit16u size);
+	SDL_semaphore * wb_done;    // posted by the write-behind thread per finished job
+	Bitu wb_queued;             // jobs queued but not yet drained
+	volatile bool wb_failed;    // a deferred write came up short
 	bool read_only_medium;
 	enum { NONE,READ,WRITE } last_action;
 };
@@ -157,6 +167,9 @@ private:
 #define MAX_OPENDIRS 2048
 //Can be high as it's only storage (16 bit variable)
 
+template <class STREAM_TYPE>
+class Archive;
+
 class DOS_Drive_Cache {
 public:
 	enum TDirSort { NOSORT, ALPHABETICAL, DIRALPHABETICAL, ALPHABETICALREV, DIRALPHABETICALREV };
@@ -188,6 +201,8 @@ public:
 	void  SetLabel             (const char* name,bool cdrom,bool allowupdate);
 	char* GetLabel             (void) { return label; };
 
+	void  SetSnapshotFile      (const char* file, bool trusted = false);
+
 	class CFileInfo {
 	public:
 		CFileInfo(void)
@@ -195,6 +210,8 @@ public:
 			  shortname{0},
 			  isOverlayDir(false),
 			  isDir(false),
+			  fromSnapshot(false),
+			  mtime(0),
 			  id(MAX_OPENDIRS),
 			  nextEntry(0),
 			  shortNr(0),
@@ -213,12 +230,17 @@ public:
 		char        shortname[DOS_NAMELENGTH_ASCII];
 		bool        isOverlayDir;
 		bool        isDir;
+		bool        fromSnapshot; // contents restored from a snapshot, not yet validated
+		time_t      mtime;        // host mtime when the directory was scanned
 		Bit16u      id;
 		Bitu        nextEntry;
 		unsigned    shortNr;
 		// contents
 		std::vector<CFileInfo*> fileList;
 		std::vector<CFileInfo*> longNameList;
+		// open-addressing index over the entries, keyed on both the
+		// host (long) and the generated 8.3 names
+		std::vector<CFileInfo*> nameHash;
 	};
 
 private:
@@ -226,6 +248,9 @@ private:
 	void DeleteFileInfo(CFileInfo *dir);
 
 	bool		RemoveTrailingDot	(char* shortname);
+	void		AddToNameHash		(CFileInfo* dir, CFileInfo* info);
+	CFileInfo*	FindShortName		(CFileInfo* dir, const char* name);
+	CFileInfo*	FindLongName		(CFileInfo* dir, const char* name);
 	Bits		GetLongName		(CFileInfo* info, char* shortname, const size_t shortname_len);
 	void		CreateShortName		(CFileInfo* dir, CFileInfo* info);
 	unsigned        CreateShortNameID       (CFileInfo* dir, const char* name);
@@ -240,6 +265,12 @@ private:
 	Bit16u		GetFreeID		(CFileInfo* dir);
 	void		Clear			(void);
 
+	bool		LoadSnapshot		(void);
+	void		SaveSnapshot		(void);
+	void		ValidateSnapshotDir	(CFileInfo* dir, const char* expand);
+	void		LoadSnapshotDir		(Archive<std::ifstream>& ar, CFileInfo* dir);
+	void		SaveSnapshotDir		(Archive<std::ofstream>& ar, CFileInfo* dir);
+
 	CFileInfo*	dirBase;
 	char		dirPath				[CROSS_LEN];
 	char		basePath			[CROSS_LEN];
@@ -254,6 +285,8 @@ private:
 	Bit16u		nextFreeFindFirst;
 
 	char		label				[CROSS_LEN];
+	char		snapshotFile		[CROSS_LEN];
+	bool		snapshotTrusted;
 	bool		updatelabel;
 };
 
@@ -34,6 +34,7 @@ class Section;
 typedef Bitu (LoopHandler)(void);
 
 void DOSBOX_RunMachine();
+void DOSBOX_RunTicks(Bitu ticks);
 void DOSBOX_SetLoop(LoopHandler * handler);
 void DOSBOX_SetNormalLoop();
 
@@ -63,6 +64,12 @@ extern SVGACards svgaCard;
 extern MachineType machine;
 extern bool SDLNetInited;
 extern bool mono_cga;
+extern bool DOSBOX_Deterministic;
+// fast-forward toggle: no pacing, muted mixer, most frames dropped
+extern bool DOSBOX_Turbo;
+
+// virtual clock base for deterministic mode: 2000-01-01 00:00:00 UTC
+#define DOSBOX_DETERMINISTIC_TIME_BASE 946684800
 
 #define IS_TANDY_ARCH ((machine==MCH_TANDY) || (machine==MCH_PCJR))
 #define IS_EGAVGA_ARCH ((machine==MCH_EGA) || (machine==MCH_VGA))
@@ -21,7 +21,9 @@
 
 #include "dosbox.h"
 
+#include <map>
 #include <memory>
+#include <unordered_map>
 #include <unordered_set>
 #include <string>
 #include <vector>
@@ -76,7 +78,9 @@ public:
 	virtual bool isRemovable(void);
 	virtual Bits UnMount(void);
 	const char* getBasedir() {return basedir;};
+	void SetReadOnly(void) {read_only = true;};
 protected:
+	bool read_only;
 	char basedir[CROSS_LEN];
 	struct {
 		char srch_dir[CROSS_LEN];
@@ -84,7 +88,28 @@ protected:
 
 private:
 	bool IsFirstEncounter(const std::string& filename);
+	bool FillSearchBatch(Bit16u id,Bit8u srch_attr,const char* srch_pattern);
 	std::unordered_set<std::string> write_protected_files;
+	// FindNext answers out of a prefetch buffer: one pass over the
+	// cached listing gathers a burst of matching entries, so a DIR over
+	// a big directory pays the search setup once per burst instead of
+	// once per entry. Batches live per search id, like srch_dir above,
+	// because several searches run at once on one drive (DIR /S,
+	// XCOPY /S); a shared batch would drop whatever a displaced search
+	// had prefetched but not yet served.
+	enum { SRCH_BATCH_SIZE = 32 };
+	struct {
+		struct {
+			char   name[DOS_NAMELENGTH_ASCII];
+			Bit32u size;
+			Bit16u date;
+			Bit16u time;
+			Bit8u  attr;
+		} entries[SRCH_BATCH_SIZE];
+		Bitu next = 0;
+		Bitu count = 0;
+		bool done = false;
+	} srchBatch[MAX_OPENDIRS];
 	struct {
 		Bit16u bytes_sector;
 		Bit8u sectors_cluster;
@@ -192,6 +217,7 @@ public:
 private:
 	Bit32u getClusterValue(Bit32u clustNum);
 	void setClusterValue(Bit32u clustNum, Bit32u clustValue);
+	Bit8u* getFatSectBuffer(Bit32u fatsectnum);
 	Bit32u getClustFirstSect(Bit32u clustNum);
 	bool FindNextInternal(Bit32u dirClustNumber, DOS_DTA & dta, direntry *foundEntry);
 	bool getDirClustNum(char * dir, Bit32u * clustNum, bool parDir);
@@ -210,8 +236,18 @@ private:
 
 	Bit32u cwdDirCluster;
 
-	Bit8u fatSectBuffer[1024];
-	Bit32u curFatSect;
+	/* Small direct-mapped cache of FAT sectors; each slot spans two
+	 * host sectors so a FAT12 entry may straddle the pair. */
+	static const Bit32u fatSectCacheSlots = 16;
+	struct fatSectCacheEntry {
+		Bit32u sectnum;
+		Bit8u data[1024];
+	};
+	fatSectCacheEntry fatSectCache[fatSectCacheSlots];
+
+	/* Cluster runs resolved on earlier walks, per chain start cluster;
+	 * cleared whenever a FAT entry is rewritten. */
+	std::map<Bit32u, std::vector<Bit32u> > chainCache;
 };
 
 class cdromDrive : public localDrive
@@ -312,6 +348,8 @@ struct isoDirEntry {
 #define IS_HIDDEN(fileFlags)	(fileFlags & ISO_HIDDEN)
 #define ISO_MAX_HASH_TABLE_SIZE 	100
 
+class CDROM_Interface_Image;
+
 class isoDrive : public DOS_Drive {
 public:
 	isoDrive(char driveLetter, const char* device_name, Bit8u mediaid, int &error);
@@ -347,14 +385,29 @@ private:
 	bool GetNextDirEntry(const int dirIterator, isoDirEntry* de);
 	void FreeDirIterator(const int dirIterator);
 	bool ReadCachedSector(Bit8u** buffer, const Bit32u sector);
-	
+
+	// a directory extent parsed once into memory; the image is read-only
+	// so the parsed form never goes stale while the disc stays in
+	struct CachedDir {
+		bool loaded = false;
+		std::vector<isoDirEntry> entries;
+		std::unordered_map<std::string, size_t> index;	// uppercased ident -> entries pos
+	};
+	CachedDir* GetCachedDir(const isoDirEntry* de);
+
 	struct DirIterator {
 		bool valid;
 		bool root;
+		CachedDir* cache;
+		Bit32u cachePos;
 		Bit32u currentSector;
 		Bit32u endSector;
 		Bit32u pos;
 	} dirIterators[MAX_OPENDIRS];
+
+	// directories indexed so far, keyed on their extent start sector;
+	// subdirectories only get parsed when a lookup first visits them
+	std::map<Bit32u, CachedDir> dirCache;
 	
 	int nextFreeDirIterator;
 	
@@ -369,6 +422,9 @@ private:
 	isoDirEntry rootEntry;
 	Bit8u mediaid;
 	char fileName[CROSS_LEN];
+	// the image parsed when this disc was mounted, kept for the drive's
+	// whole life so swapping it back in is a re-register, not a re-parse
+	CDROM_Interface_Image *keptImage;
 	Bit8u subUnit;
 	char driveLetter;
 	char discLabel[32];
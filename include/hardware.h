@@ -44,8 +44,18 @@ bool TS_Get_Address(Bitu& tsaddr, Bitu& tsirq, Bitu& tsdma);
 
 extern Bit8u adlib_commandreg;
 FILE * OpenCaptureFile(const char * type,const char * ext);
+/* Queue a block on the shared capture writer thread; order per handle is
+   preserved. Flush before seeking in or closing a handle with queued data. */
+void CAPTURE_WriteBlock(FILE * handle,const void * data,Bitu len);
+void CAPTURE_WriterFlush(void);
 
 void CAPTURE_AddWave(Bit32u freq, Bit32u len, Bit16s * data);
+/* Per-channel wave taps: independent wav sinks the mixer clones a single
+ * device's samples into, without another pass over the final mix
+ * (see MixerChannel::SetTap). Any number can be open at once. */
+void * CAPTURE_OpenWaveTap(const char * label,Bit32u freq);
+void CAPTURE_AddWaveTap(void * tap,Bitu len,const Bit16s * data);
+void CAPTURE_CloseWaveTap(void * tap);
 #define CAPTURE_FLAG_DBLW	0x1
 #define CAPTURE_FLAG_DBLH	0x2
 void CAPTURE_AddImage(Bitu width, Bitu height, Bitu bpp, Bitu pitch, Bitu flags, float fps, Bit8u * data, Bit8u * pal);
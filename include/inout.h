@@ -30,15 +30,26 @@
 typedef Bitu IO_ReadHandler(Bitu port,Bitu iolen);
 typedef void IO_WriteHandler(Bitu port,Bitu val,Bitu iolen);
 
-extern IO_WriteHandler * io_writehandlers[3][IO_MAX];
-extern IO_ReadHandler * io_readhandlers[3][IO_MAX];
-
 void IO_RegisterReadHandler(Bitu port,IO_ReadHandler * handler,Bitu mask,Bitu range=1);
 void IO_RegisterWriteHandler(Bitu port,IO_WriteHandler * handler,Bitu mask,Bitu range=1);
 
 void IO_FreeReadHandler(Bitu port,Bitu mask,Bitu range=1);
 void IO_FreeWriteHandler(Bitu port,Bitu mask,Bitu range=1);
 
+/* Devices with a fixed port topology can describe it as a static const
+ * table built at compile time and install or remove the whole map in
+ * one call, instead of a string of individual register calls on every
+ * launch. Either handler may be NULL for ports that only go one way. */
+struct IO_PortMapEntry {
+	Bit16u port;
+	Bit8u range;
+	Bit8u mask;
+	IO_ReadHandler * read;
+	IO_WriteHandler * write;
+};
+void IO_RegisterPortMap(const IO_PortMapEntry * map,Bitu count);
+void IO_FreePortMap(const IO_PortMapEntry * map,Bitu count);
+
 void IO_WriteB(Bitu port,Bitu val);
 void IO_WriteW(Bitu port,Bitu val);
 void IO_WriteD(Bitu port,Bitu val);
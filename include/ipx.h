@@ -116,6 +116,7 @@ public:
 
 	Bit8u* databuffer;	// received data is stored here until we get called
 	Bitu buflen;		// by Interrupt
+	Bitu bufcap;		// allocated size of databuffer
 
 #ifdef IPX_DEBUGMSG 
 	Bitu SerialNumber;
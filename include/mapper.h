@@ -38,6 +38,7 @@ void MAPPER_Run(bool pressed);
 void MAPPER_DisplayUI();
 void MAPPER_LosingFocus();
 bool MAPPER_IsUsingJoysticks();
+bool MAPPER_TriggerEvent(const char * entry,bool pressed);
 std::vector<std::string> MAPPER_GetEventNames(const std::string &prefix);
 void MAPPER_AutoType(std::vector<std::string> &sequence,
                      const uint32_t wait_ms,
@@ -206,6 +206,11 @@ void MEM_BlockRead(PhysPt pt,void * data,Bitu size);
 void MEM_BlockCopy(PhysPt dest,PhysPt src,Bitu size);
 void MEM_StrCopy(PhysPt pt,char * data,Bitu size);
 
+/* Resolve a guest range to a host pointer for zero-copy bulk transfers;
+ * returns null unless the whole range is contiguous plain RAM */
+HostPt MEM_GetHostReadPt(PhysPt pt,Bitu size);
+HostPt MEM_GetHostWritePt(PhysPt pt,Bitu size);
+
 void mem_memcpy(PhysPt dest,PhysPt src,Bitu size);
 Bitu mem_strlen(PhysPt pt);
 void mem_strcpy(PhysPt dest,PhysPt src);
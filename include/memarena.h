@@ -0,0 +1,45 @@
+/*
+ *  Copyright (C) 2002-2020  The DOSBox Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef DOSBOX_MEMARENA_H
+#define DOSBOX_MEMARENA_H
+
+#ifndef DOSBOX_DOSBOX_H
+#include "dosbox.h"
+#endif
+
+/* Backing store for the big long-lived buffers devices grab at init (video
+   memory, drive caches).  Blocks are taken straight from the host VM system
+   where possible, so they come back zeroed and pages that are never touched
+   never become resident - a machine that stays in text mode doesn't pay for
+   its full linear framebuffer.  Every block is booked against the subsystem
+   name that asked for it, which is what the usage dump reports. */
+
+// allocate a zeroed, page-aligned block booked against subsystem
+void * ARENA_Alloc(const char * subsystem,Bitu bytes);
+// release a block obtained from ARENA_Alloc; NULL is ignored
+void ARENA_Free(void * ptr);
+
+// book an allocation made elsewhere (negative bytes on release), for
+// subsystems with their own backing path like the guest ram base
+void ARENA_Account(const char * subsystem,Bits bytes);
+
+// per-subsystem totals through LOG_MSG; also behind the MEMS debugger command
+void ARENA_LogUsage(void);
+
+#endif
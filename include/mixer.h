@@ -44,6 +44,12 @@ extern Bit8u MixTemp[MIXER_BUFSIZE];
 #define MAX_AUDIO ((1<<(16-1))-1)
 #define MIN_AUDIO -(1<<(16-1))
 
+//Taps of the optional windowed-sinc resampler (see SetResampleQuality)
+#define MIXER_SINC_TAPS 8
+
+//Frames a channel buffers before flushing to its wave tap (see SetTap)
+#define MIXER_TAP_BUF 1024
+
 class MixerChannel {
 public:
 	MixerChannel(MIXER_Handler _handler, Bitu _freq, const char * _name);
@@ -53,9 +59,15 @@ public:
 	void MapChannels(Bit8u _left, Bit8u _right);
 	void UpdateVolume(void);
 	void SetFreq(Bitu _freq);
+	void UpdateFreq(void);         //Recompute the resampling step after a mixer rate change
+	void SetResampleQuality(bool use_sinc);
+	void SetTap(bool enable);      //Record this channel to its own wav file
+	bool Tapped(void) const;
 	void Mix(Bitu _needed);
 	void AddSilence(void);			//Fill up until needed
 
+	template<class Type,bool stereo,bool signeddata,bool nativeorder>
+	void LoadSample(const Type* data, Bitu pos);
 	template<class Type,bool stereo,bool signeddata,bool nativeorder>
 	void AddSamples(Bitu len, const Type* data);
 
@@ -90,6 +102,7 @@ public:
 private:
 	MixerChannel();
 	MIXER_Handler  handler;
+	Bitu           src_freq;       //Rate the device generates samples at
 	Bitu           freq_add;       //This gets added the frequency counter each mixer step
 	Bitu           freq_counter;   //When this flows over a new sample needs to be read from the device
 	Bitu           needed; 	       //Timing on how many samples were needed by the mixer
@@ -99,12 +112,24 @@ private:
 	float          scale[2];
 	Bit8u          channel_map[2]; //Output channel mapping
 	bool           interpolate;
+	bool           sinc;           //Use the windowed-sinc resampler
+	Bit8u          sinc_pos;       //Ring position in the sample history
+	//Last taps worth of input, stored twice so the filter reads linearly
+	Bit32s         sinc_hist[2][MIXER_SINC_TAPS * 2];
+	void TapFrame(Bits left,Bits right);
+	void *         tap;            //Opaque wav sink (hardware.cpp), NULL when off
+	Bitu           tap_used;       //Frames waiting in tap_buf
+	Bit16s         tap_buf[MIXER_TAP_BUF * 2];
 };
 
 MixerChannel * MIXER_AddChannel(MIXER_Handler handler,Bitu freq,const char * name);
 MixerChannel * MIXER_FindChannel(const char * name);
 /* Find the device you want to delete with findchannel "delchan gets deleted" */
-void MIXER_DelChannel(MixerChannel* delchan); 
+void MIXER_DelChannel(MixerChannel* delchan);
+
+/* Fast forward: pause the output device and mix into the silent sink so
+ * the channels keep getting consumed without real-time pacing */
+void MIXER_SetTurbo(bool enabled);
 
 /* Object to maintain a mixerchannel; As all objects it registers itself with create
  * and removes itself when destroyed. */
@@ -93,6 +93,9 @@ void PAGING_LinkPage_ReadOnly(Bitu lin_page,Bitu phys_page);
 void PAGING_UnlinkPages(Bitu lin_page,Bitu pages);
 /* This maps the page directly, only use when paging is disabled */
 void PAGING_MapPage(Bitu lin_page,Bitu phys_page);
+/* Remap several consecutive pages at once with targeted tlb invalidation;
+   mapped pages are linked immediately when paging is disabled */
+void PAGING_MapPages(Bitu lin_page,const Bitu * phys_pages,Bitu pages);
 bool PAGING_MakePhysPage(Bitu & page);
 bool PAGING_ForcePageInit(Bitu lin_addr);
 
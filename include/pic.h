@@ -48,16 +48,46 @@ static INLINE double PIC_FullIndex(void) {
 	return PIC_Ticks+(double)PIC_TickIndex();
 }
 
+// integer nanoseconds into the current tick; same clock the event queue
+// keeps internally, so scheduling through the NS calls stays exact
+static INLINE Bit64s PIC_TickIndexNS(void) {
+	return (Bit64s)PIC_TickIndexND()*1000000/CPU_CycleMax;
+}
+
 void PIC_ActivateIRQ(Bitu irq);
 void PIC_DeActivateIRQ(Bitu irq);
 
 void PIC_runIRQs(void);
 bool PIC_RunQueue(void);
 
-//Delay in milliseconds
+/* Delay in milliseconds; a conversion shim over the nanosecond queue
+   below, kept for the many callers whose rates don't need better */
 void PIC_AddEvent(PIC_EventHandler handler,float delay,Bitu val=0);
+//Delay in integer nanoseconds, for sub-ms device timing (fast serial, GUS)
+void PIC_AddEventNS(PIC_EventHandler handler,Bit64s delay_ns,Bitu val=0);
 void PIC_RemoveEvents(PIC_EventHandler handler);
 void PIC_RemoveSpecificEvents(PIC_EventHandler handler, Bitu val);
+//Absolute time (same scale as PIC_FullIndex) of the earliest queued
+//event, or -1 when the queue is empty; lets an embedder decide how long
+//an idle instance can sleep before calling DOSBOX_RunTicks again
+double PIC_NextEventTime(void);
+
+#define PIC_QUEUESIZE 512
+
+/* savestate support: the event queue is pointer-linked internally, so it
+   is moved in and out as a flat array of these */
+struct PICEventState {
+	PIC_EventHandler handler;
+	Bit64s index_ns;
+	Bitu value;
+	Bit64u seq;
+};
+Bitu PIC_SaveEvents(PICEventState * buf,Bitu max);
+void PIC_LoadEvents(const PICEventState * buf,Bitu count);
+/* opaque copies of the two interrupt controllers */
+Bitu PIC_ControllerStateSize(void);
+void PIC_SaveControllers(void * buf);
+void PIC_LoadControllers(const void * buf);
 
 void PIC_SetIRQMask(Bitu irq, bool masked);
 #endif
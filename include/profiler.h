@@ -0,0 +1,58 @@
+/*
+ *  Copyright (C) 2002-2020  The DOSBox Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef DOSBOX_PROFILER_H
+#define DOSBOX_PROFILER_H
+
+#ifndef DOSBOX_DOSBOX_H
+#include "dosbox.h"
+#endif
+
+/* Lightweight always-compiled-in profiler. Sections accumulate host time
+   while enabled; once per second the totals go out as one machine-readable
+   LOG_MSG line and a short summary in the window title. Toggled at runtime
+   through the mapper, so the cost when disabled is one branch per probe. */
+
+enum {
+	PROF_PIC = 0,	// PIC_RunQueue
+	PROF_CPU,		// core decode loop
+	PROF_RENDER,	// RENDER_EndUpdate (scaler + output)
+	PROF_MIXER,		// MIXER_MixData under the mixer lock
+	PROF_DISK,		// blocking host file I/O in drive_local
+	PROF_SECTION_COUNT
+};
+
+extern bool prof_enabled;
+
+// monotonic host time in microseconds; only meant for the probes below
+Bit64s PROF_Now(void);
+// add the time since start to a section's total
+void PROF_Account(Bitu section,Bit64s start);
+// interval bookkeeping and dumping, called once per emulation loop
+void PROF_Update(void);
+// mapper callback that switches profiling on and off
+void PROF_Toggle(bool pressed);
+// called when the scheduler notices the host fell behind; logs one line
+// attributing the stall to the worst single probe and handler call seen
+// since the previous stall report
+void PROF_Stall(Bitu behind_ms);
+
+#define PROF_START(v) Bit64s v = prof_enabled ? PROF_Now() : 0
+#define PROF_STOP(sec,v) do { if (prof_enabled) PROF_Account((sec),(v)); } while (0)
+
+#endif
@@ -59,7 +59,8 @@ typedef struct {
 	} src;
 	struct {
 		int count;
-		int max;
+		int max;		// -1 selects the automatic mode
+		int auto_max;	// skip the automatic mode settled on
 		Bitu index;
 		Bit8u hadSkip[RENDER_SKIP_CACHE];
 	} frameskip;
@@ -100,5 +101,8 @@ void RENDER_EndUpdate(bool abort);
 void RENDER_SetPal(Bit8u entry,Bit8u red,Bit8u green,Bit8u blue);
 bool RENDER_GetForceUpdate(void);
 void RENDER_SetForceUpdate(bool);
+/* Digest of the last presented frame; the sequence only moves when the
+   picture does. See the framedigest render property. */
+Bit64u RENDER_FrameDigest(Bit32u * sequence);
 
 #endif
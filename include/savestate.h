@@ -0,0 +1,39 @@
+/*
+ *  Copyright (C) 2002-2020  The DOSBox Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef DOSBOX_SAVESTATE_H
+#define DOSBOX_SAVESTATE_H
+
+/* Experimental in-memory snapshots, meant to shorten profiling and
+   benchmark iterations. A snapshot covers guest RAM, CPU/FPU state,
+   paging control registers and the PIC; device state (VGA, DMA, sound)
+   is NOT captured, so only restore within the same session and without
+   mode changes in between. Repeat saves are incremental: only RAM pages
+   that changed since the previous snapshot are copied. */
+
+// mapper callbacks
+void SAVESTATE_Save(bool pressed);
+void SAVESTATE_Load(bool pressed);
+
+/* Rewind keeps a bounded ring of once-per-emulated-second delta
+   snapshots while enabled; stepping back restores the previous one */
+void REWIND_Toggle(bool pressed);
+void REWIND_Step(bool pressed);
+void REWIND_Init(void);
+
+#endif
@@ -244,14 +244,30 @@ private:
 			canchange=_ch;
 		}
 	};
+	/* Wrapper around an update function together with the property it
+	 * applies. Sections register these for properties whose new value the
+	 * running device can pick up in place, so a runtime change skips the
+	 * destroy/init cycle. */
+	struct Update_wrapper {
+		std::string propname;
+		SectionFunction function;
+		Update_wrapper(std::string const& _prop,SectionFunction _fun) {
+			propname=_prop;
+			function=_fun;
+		}
+	};
 	std::list<Function_wrapper> initfunctions;
 	std::list<Function_wrapper> destroyfunctions;
+	std::list<Update_wrapper> updatefunctions;
 	std::string sectionname;
 public:
 	Section(std::string const& _sectionname):sectionname(_sectionname) {  }
 
 	void AddInitFunction(SectionFunction func,bool canchange=false);
 	void AddDestroyFunction(SectionFunction func,bool canchange=false);
+	void AddUpdateFunction(std::string const& propname,SectionFunction func);
+	bool HasUpdateFunction(std::string const& propname) const;
+	bool ExecuteUpdate(std::string const& propname);
 	void ExecuteInit(bool initall=true);
 	void ExecuteDestroy(bool destroyall=true);
 	const char* GetName() const {return sectionname.c_str();}
@@ -30,6 +30,8 @@
 
 #include <string>
 #include <list>
+#include <map>
+#include <vector>
 
 #define CMD_MAXLINE 4096
 #define CMD_MAXCMDS 20
@@ -51,13 +53,20 @@ public:
 	virtual bool ReadLine(char * line);
 	bool Goto(char * where);
 	void Shift(void);
+	//Drop the in-memory copy, for when the underlying file is rewritten
+	void InvalidateCache(void) { cached = false; cached_lines.clear(); labels.clear(); }
 	Bit16u file_handle;
-	Bit32u location;
+	Bit32u location; //next line to execute in cached_lines
 	bool echo;
 	DOS_Shell * shell;
 	BatchFile * prev;
 	CommandLine * cmd;
 	std::string filename;
+private:
+	bool CacheFile(void);
+	std::vector<std::string> cached_lines; //the file, read once and split into lines
+	std::map<std::string,Bitu> labels;     //upcased label -> line index, for GOTO
+	bool cached;
 };
 
 class AutoexecEditor;
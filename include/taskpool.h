@@ -0,0 +1,55 @@
+/*
+ *  Copyright (C) 2002-2020  The DOSBox Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef DOSBOX_TASKPOOL_H
+#define DOSBOX_TASKPOOL_H
+
+#ifndef DOSBOX_DOSBOX_H
+#include "dosbox.h"
+#endif
+
+/* Shared worker pool for the parallelisable side work (scaler tiles, frame
+   compression, screenshot encoding).  One pool sized to the host topology
+   instead of every subsystem spawning its own threads; the emulation thread
+   keeps priority because a core is left free for it and because it works on
+   the job itself while it would otherwise be waiting.  The dedicated
+   blocking-I/O threads (capture writer, CD prefetch, host write-behind,
+   MIDI) stay separate: they spend their life asleep, not on a core. */
+
+// part handler for a tiled job; called once per part, from the pool
+// workers and the submitting thread alike
+typedef void (*TASK_Handler)(Bitu part,Bitu parts,void * data);
+
+// spawn the workers; safe to call more than once
+void TASKPOOL_Init(void);
+// wind the workers down and log the occupancy counters
+void TASKPOOL_Shutdown(void);
+
+// number of pool workers; 0 means jobs run inline on the caller
+Bitu TASKPOOL_Workers(void);
+
+// run handler(part,parts,data) for every part, the caller included in the
+// work; returns when all parts have finished.  Only meant to be submitted
+// from the emulation thread - a nested call runs its job inline.
+void TASKPOOL_RunTiled(TASK_Handler handler,void * data,Bitu parts);
+
+// queue a detached one-shot task; returns false (caller runs it inline)
+// when there are no workers or the queue is full
+bool TASKPOOL_RunAsync(void (*func)(void *),void * data);
+
+#endif
@@ -30,6 +30,10 @@ typedef void (*TIMER_TickHandler)(void);
 
 /* Register a function that gets called everytime if 1 or more ticks pass */
 void TIMER_AddTickHandler(TIMER_TickHandler handler);
+/* As above, but called at a reduced rate (1000, 100 or 10 Hz) for handlers
+   that only poll occasionally; one-shot or self-timed work should use
+   PIC_AddEvent instead of a ticker */
+void TIMER_AddTickHandlerRate(TIMER_TickHandler handler,Bitu rate_hz);
 void TIMER_DelTickHandler(TIMER_TickHandler handler);
 
 /* This will add 1 milliscond to all timers */
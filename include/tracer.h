@@ -0,0 +1,42 @@
+/*
+ *  Copyright (C) 2002-2020  The DOSBox Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef DOSBOX_TRACER_H
+#define DOSBOX_TRACER_H
+
+#ifndef DOSBOX_PROFILER_H
+#include "profiler.h"
+#endif
+
+/* Scheduling trace recorder. While enabled it collects PIC event service
+   times, timer tick handlers, mixer callback occupancy and frame presents
+   into a preallocated buffer; on stop the buffer is written out in the
+   Chrome trace-event JSON format (chrome://tracing, Perfetto). Call sites
+   guard on trace_enabled so the disabled cost is one branch. */
+
+extern bool trace_enabled;
+
+// record a duration event; start comes from PROF_Now() taken at entry.
+// id distinguishes same-named events (usually a handler pointer)
+void TRACE_Complete(const char *cat,const char *name,const void *id,Bit64s start);
+// record a single point in time
+void TRACE_Instant(const char *cat,const char *name,const void *id);
+// mapper callback; stopping writes the trace file
+void TRACE_Toggle(bool pressed);
+
+#endif
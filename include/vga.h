@@ -167,6 +167,11 @@ typedef struct {
 	Drawmode mode;
 	bool vret_triggered;
 	bool vga_override;
+	bool change_tracked;	/* everything that can alter the picture goes through handlers/ports */
+	Bitu change_count;		/* bumped by vram writes and register changes that affect the output */
+	Bitu change_drawn;		/* change_count the frame on screen was rendered from */
+	Bitu change_age;		/* frames skipped since the last rendered frame */
+	Bit64u frame_hash;		/* content hash for modes without write tracking */
 } VGA_Draw;
 
 typedef struct {
@@ -272,6 +277,8 @@ typedef struct {
 	Bit8u color_plane_enable;
 	Bit8u color_select;
 	Bit8u index;
+	bool palette_reload;	// palette recombine deferred to the next
+							// drawn line; see VGA_ATTR_FlushPalette
 	Bit8u disabled; // Used for disabling the screen.
 					// Bit0: screen disabled by attribute controller index
 					// Bit1: screen disabled by sequencer index 1 bit 5
@@ -429,6 +436,7 @@ void VGA_ChangedBank(void);
 void VGA_DAC_CombineColor(Bit8u attr,Bit8u pal);
 void VGA_DAC_SetEntry(Bitu entry,Bit8u red,Bit8u green,Bit8u blue);
 void VGA_ATTR_SetPalette(Bit8u index,Bit8u val);
+void VGA_ATTR_FlushPalette(void);
 
 typedef enum {CGA, EGA, MONO} EGAMonitorMode;
 
@@ -455,6 +463,14 @@ void VGA_SetCGA2Table(Bit8u val0,Bit8u val1);
 void VGA_SetCGA4Table(Bit8u val0,Bit8u val1,Bit8u val2,Bit8u val3);
 void VGA_ActivateHardwareCursor(void);
 void VGA_KillDrawing(void);
+void VGA_FlushChainedWrites(void);
+
+/* Copy the visible text screen into 'buffer' (rows*cols characters, no
+   attributes, no terminators) straight out of video memory; much cheaper
+   than capture+ocr for harnesses asserting on screen content. Returns
+   the row count, 0 when the current mode is not a text mode. 'seq', when
+   given, receives a counter that only advances when the text changed. */
+Bitu VGA_GetTextScreen(char * buffer,Bitu buflen,Bitu * cols,Bit32u * seq);
 
 void VGA_SetOverride(bool vga_override);
 
@@ -525,6 +541,7 @@ extern Bit32u CGA_2_Table[16];
 extern Bit32u CGA_4_Table[256];
 extern Bit32u CGA_4_HiRes_Table[256];
 extern Bit32u CGA_16_Table[256];
+extern Bit32u CGA16_Comp_Table[256];
 extern Bit32u TXT_Font_Table[16];
 extern Bit32u TXT_FG_Table[16];
 extern Bit32u TXT_BG_Table[16];
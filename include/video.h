@@ -66,6 +66,9 @@ void GFX_Stop(void);
 void GFX_SwitchFullScreen(void);
 bool GFX_StartUpdate(uint8_t * &pixels, int &pitch);
 void GFX_EndUpdate( const Bit16u *changedLines );
+// returns a small delay correction (ms) that phase-aligns the emulated
+// frame start with the host vblank when presents are vsync-locked
+double GFX_GetFramePacingAdjust(double frame_ms);
 void GFX_GetSize(int &width, int &height, bool &fullscreen);
 void GFX_LosingFocus(void);
 
@@ -31,6 +31,7 @@
 */
 
 CallBack_Handler CallBack_Handlers[CB_MAX];
+bool CallBack_Fast[CB_MAX];
 char* CallBack_Description[CB_MAX];
 
 static Bitu call_stop,call_idle,call_default;
@@ -54,6 +55,12 @@ Bitu CALLBACK_Allocate(void) {
 
 void CALLBACK_DeAllocate(Bitu in) {
 	CallBack_Handlers[in]=&illegal_handler;
+	CallBack_Fast[in]=false;
+}
+
+void CALLBACK_SetFast(Bitu callback,bool fast) {
+	if (callback>=CB_MAX) return;
+	CallBack_Fast[callback]=fast;
 }
 
 
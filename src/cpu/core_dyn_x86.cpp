@@ -56,6 +56,11 @@
 #define CACHE_PAGES		(512)
 #define CACHE_BLOCKS	(64*1024)
 #define CACHE_ALIGN		(16)
+// second-tier translation: blocks that keep re-entering the dispatcher
+// get retranslated once with a larger opcode budget, see the dispatch
+// loop in CPU_Core_Dyn_X86_Run
+#define DYN_HOT_THRESHOLD	(64)
+#define DYN_HOT_MAXOPS		(96)
 #define DYN_HASH_SHIFT	(4)
 #define DYN_PAGE_HASH	(4096>>DYN_HASH_SHIFT)
 #define DYN_LINKS		(16)
@@ -297,8 +302,17 @@ restart_core:
 				goto restart_core;
 			}
 			CPU_CycleLeft+=old_cycles;
-			return nc_retcode; 
+			return nc_retcode;
 		}
+	} else if (GCC_UNLIKELY(++block->hotness==DYN_HOT_THRESHOLD) &&
+	           (!chandler->invalidation_map || (chandler->invalidation_map[ip_point&4095]<4))) {
+		// this block keeps coming back through the dispatcher, so spend
+		// translation effort on it once more with a larger opcode budget:
+		// register caching and the entry cycle check then span a longer
+		// trace, which is where almost all execution time is spent
+		block->Clear();
+		block=CreateCacheBlock(chandler,ip_point,DYN_HOT_MAXOPS);
+		block->hotness=DYN_HOT_THRESHOLD;	// already second tier, don't retrigger
 	}
 run_block:
 	cache.block.running=0;
@@ -48,6 +48,7 @@ public:
 		CacheBlock * from;
 	} link[2];
 	CacheBlock * crossblock;
+	Bitu hotness;						//Dispatcher entries, drives retranslation
 };
 
 static struct {
@@ -65,6 +66,9 @@ static struct {
 
 static CacheBlock link_blocks[2];
 
+static Bitu cache_total=CACHE_TOTAL;	// code arena size, set from dyncachesize at init
+static Bitu cache_wraps=0;				// times the arena filled up and translation restarted
+
 class CodePageHandler : public PageHandler {
 public:
 	CodePageHandler() {
@@ -443,6 +447,7 @@ skipresize:
 
 static void cache_closeblock(void) {
 	CacheBlock * block=cache.block.active;
+	block->hotness=0;
 	block->link[0].to=&link_blocks[0];
 	block->link[1].to=&link_blocks[1];
 	block->link[0].from=0;
@@ -476,7 +481,10 @@ static void cache_closeblock(void) {
 	}
 	/* Advance the active block pointer */
 	if (!block->cache.next) {
-//		LOG_MSG("Cache full restarting");
+		/* log at power of two counts so a thrashing title shows up without spamming */
+		cache_wraps++;
+		if ((cache_wraps&(cache_wraps-1))==0)
+			LOG_MSG("DYN86: Code cache filled %d time(s), raise dyncachesize if this keeps up",(int)cache_wraps);
 		cache.block.active=cache.block.first;
 	} else {
 		cache.block.active=block->cache.next;
@@ -515,7 +523,10 @@ static CacheBlock * cache_blocks=NULL;
 /* Define temporary pagesize so the MPROTECT case and the regular case share as much code as possible */
 #if (C_HAVE_MPROTECT)
 #define PAGESIZE_TEMP PAGESIZE
-#else 
+#ifndef MAP_ANONYMOUS
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+#else
 #define PAGESIZE_TEMP 4096
 #endif
 
@@ -526,6 +537,7 @@ static void cache_init(bool enable) {
 	if (enable) {
 		if (cache_initialized) return;
 		cache_initialized = true;
+		if (CPU_DynCacheSize>0) cache_total=(Bitu)CPU_DynCacheSize*1024*1024;
 		if (cache_blocks == NULL) {
 			cache_blocks=(CacheBlock*)malloc(CACHE_BLOCKS*sizeof(CacheBlock));
 			if(!cache_blocks) E_Exit("Allocating cache_blocks has failed");
@@ -539,12 +551,23 @@ static void cache_init(bool enable) {
 		}
 		if (cache_code_start_ptr==NULL) {
 #if defined (WIN32)
-			cache_code_start_ptr=(Bit8u*)VirtualAlloc(0,CACHE_TOTAL+CACHE_MAXSIZE+PAGESIZE_TEMP-1+PAGESIZE_TEMP,
+			cache_code_start_ptr=(Bit8u*)VirtualAlloc(0,cache_total+CACHE_MAXSIZE+PAGESIZE_TEMP-1+PAGESIZE_TEMP,
 				MEM_COMMIT,PAGE_EXECUTE_READWRITE);
 			if (!cache_code_start_ptr)
-				cache_code_start_ptr=(Bit8u*)malloc(CACHE_TOTAL+CACHE_MAXSIZE+PAGESIZE_TEMP-1+PAGESIZE_TEMP);
+				cache_code_start_ptr=(Bit8u*)malloc(cache_total+CACHE_MAXSIZE+PAGESIZE_TEMP-1+PAGESIZE_TEMP);
+#elif (C_HAVE_MPROTECT)
+			// map the arena directly so execute permission doesn't have to be
+			// forced onto heap pages; ask for huge page backing to cut the
+			// itlb misses of a large code working set
+			cache_code_start_ptr=(Bit8u*)mmap(NULL,cache_total+CACHE_MAXSIZE+PAGESIZE_TEMP-1+PAGESIZE_TEMP,
+				PROT_READ|PROT_WRITE|PROT_EXEC,MAP_PRIVATE|MAP_ANONYMOUS,-1,0);
+			if (cache_code_start_ptr==MAP_FAILED)
+				cache_code_start_ptr=(Bit8u*)malloc(cache_total+CACHE_MAXSIZE+PAGESIZE_TEMP-1+PAGESIZE_TEMP);
+#ifdef MADV_HUGEPAGE
+			else madvise(cache_code_start_ptr,cache_total+CACHE_MAXSIZE+PAGESIZE_TEMP-1+PAGESIZE_TEMP,MADV_HUGEPAGE);
+#endif
 #else
-			cache_code_start_ptr=(Bit8u*)malloc(CACHE_TOTAL+CACHE_MAXSIZE+PAGESIZE_TEMP-1+PAGESIZE_TEMP);
+			cache_code_start_ptr=(Bit8u*)malloc(cache_total+CACHE_MAXSIZE+PAGESIZE_TEMP-1+PAGESIZE_TEMP);
 #endif
 			if(!cache_code_start_ptr) E_Exit("Allocating dynamic core cache memory failed");
 
@@ -554,14 +577,14 @@ static void cache_init(bool enable) {
 			cache_code+=PAGESIZE_TEMP;
 
 #if (C_HAVE_MPROTECT)
-			if(mprotect(cache_code_link_blocks,CACHE_TOTAL+CACHE_MAXSIZE+PAGESIZE_TEMP,PROT_WRITE|PROT_READ|PROT_EXEC))
+			if(mprotect(cache_code_link_blocks,cache_total+CACHE_MAXSIZE+PAGESIZE_TEMP,PROT_WRITE|PROT_READ|PROT_EXEC))
 				LOG_MSG("Setting execute permission on the code cache has failed!");
 #endif
 			CacheBlock * block=cache_getblock();
 			cache.block.first=block;
 			cache.block.active=block;
 			block->cache.start=&cache_code[0];
-			block->cache.size=CACHE_TOTAL;
+			block->cache.size=cache_total;
 			block->cache.next=0;								//Last block in the list
 		}
 		/* Setup the default blocks for block linkage returns */
@@ -2099,6 +2099,12 @@ static CacheBlock * CreateCacheBlock(CodePageHandler * codepage,PhysPt start,Bit
 	bool fpu_used=false;
 #endif
 	while (max_opcodes--) {
+		// with enlarged opcode budgets (DYN_HOT_MAXOPS) the emitted code
+		// could outgrow the space cache_openblock guarantees, so stop
+		// decoding early; the remaining quarter of CACHE_MAXSIZE is ample
+		// for one more opcode plus the block exit code
+		if (GCC_UNLIKELY((Bitu)(cache.pos-decode.block->cache.start)>=
+		                 (CACHE_MAXSIZE-CACHE_MAXSIZE/4))) break;
 /* Init prefixes */
 		decode.big_addr=cpu.code.big;
 		decode.big_op=cpu.code.big;
@@ -20,51 +20,66 @@
 #include "dosbox.h"
 #if C_FPU
 
+/* the operand bounce helpers below run once per memory-form FPU
+   instruction; use the inline tlb accessors for them like the cpu cores
+   do for their own loads and stores */
+#if (!C_CORE_INLINE)
+#define LoadMw(off) mem_readw(off)
+#define LoadMd(off) mem_readd(off)
+#define SaveMw(off,val)	mem_writew(off,val)
+#define SaveMd(off,val)	mem_writed(off,val)
+#else
+#define LoadMw(off) mem_readw_inline(off)
+#define LoadMd(off) mem_readd_inline(off)
+#define SaveMw(off,val)	mem_writew_inline(off,val)
+#define SaveMd(off,val)	mem_writed_inline(off,val)
+#endif
+
 static void FPU_FLD_16(PhysPt addr) {
-	dyn_dh_fpu.temp.m1 = (Bit32u)mem_readw(addr);
+	dyn_dh_fpu.temp.m1 = (Bit32u)LoadMw(addr);
 }
 
 static void FPU_FST_16(PhysPt addr) {
-	mem_writew(addr,(Bit16u)dyn_dh_fpu.temp.m1);
+	SaveMw(addr,(Bit16u)dyn_dh_fpu.temp.m1);
 }
 
 static void FPU_FLD_32(PhysPt addr) {
-	dyn_dh_fpu.temp.m1 = mem_readd(addr);
+	dyn_dh_fpu.temp.m1 = LoadMd(addr);
 }
 
 static void FPU_FST_32(PhysPt addr) {
-	mem_writed(addr,dyn_dh_fpu.temp.m1);
+	SaveMd(addr,dyn_dh_fpu.temp.m1);
 }
 
 static void FPU_FLD_64(PhysPt addr) {
-	dyn_dh_fpu.temp.m1 = mem_readd(addr);
-	dyn_dh_fpu.temp.m2 = mem_readd(addr+4);
+	dyn_dh_fpu.temp.m1 = LoadMd(addr);
+	dyn_dh_fpu.temp.m2 = LoadMd(addr+4);
 }
 
 static void FPU_FST_64(PhysPt addr) {
-	mem_writed(addr,dyn_dh_fpu.temp.m1);
-	mem_writed(addr+4,dyn_dh_fpu.temp.m2);
+	SaveMd(addr,dyn_dh_fpu.temp.m1);
+	SaveMd(addr+4,dyn_dh_fpu.temp.m2);
 }
 
 static void FPU_FLD_80(PhysPt addr) {
-	dyn_dh_fpu.temp.m1 = mem_readd(addr);
-	dyn_dh_fpu.temp.m2 = mem_readd(addr+4);
-	dyn_dh_fpu.temp.m3 = mem_readw(addr+8);
+	dyn_dh_fpu.temp.m1 = LoadMd(addr);
+	dyn_dh_fpu.temp.m2 = LoadMd(addr+4);
+	dyn_dh_fpu.temp.m3 = LoadMw(addr+8);
 }
 
 static void FPU_FST_80(PhysPt addr) {
-	mem_writed(addr,dyn_dh_fpu.temp.m1);
-	mem_writed(addr+4,dyn_dh_fpu.temp.m2);
-	mem_writew(addr+8,dyn_dh_fpu.temp.m3);
+	SaveMd(addr,dyn_dh_fpu.temp.m1);
+	SaveMd(addr+4,dyn_dh_fpu.temp.m2);
+	SaveMw(addr+8,dyn_dh_fpu.temp.m3);
 }
 
 static void FPU_FLDCW_DH(PhysPt addr){
-	dyn_dh_fpu.cw = mem_readw(addr);
+	dyn_dh_fpu.cw = LoadMw(addr);
 	dyn_dh_fpu.temp.m1 = (Bit32u)(dyn_dh_fpu.cw|0x3f);
 }
 
 static void FPU_FNSTCW_DH(PhysPt addr){
-	mem_writew(addr,(Bit16u)(dyn_dh_fpu.cw&0xffff));
+	SaveMw(addr,(Bit16u)(dyn_dh_fpu.cw&0xffff));
 }
 
 static void FPU_FNINIT_DH(void){
@@ -164,6 +164,18 @@ CacheBlockDynRec * LinkBlocks(BlockReturn ret) {
 		block=temp_handler->FindCacheBlock(temp_ip & 4095);
 		if (block) { // found it, link the current block to
 			cache.block.running->LinkTo(ret==BR_Link2,block);
+		} else if (!temp_handler->invalidation_map || (temp_handler->invalidation_map[temp_ip&4095]<4)) {
+			// the target page contains code but this entry point has not
+			// been translated yet; translate it right away and patch the
+			// exit, so this edge (which may well cross a page boundary)
+			// runs JIT-to-JIT from now on instead of paying a second
+			// round trip through the dispatcher
+			CacheBlockDynRec * running=cache.block.running;
+			Bitu generation=cache.generation;
+			block=CreateCacheBlock(temp_handler,temp_ip,32);
+			// translating may have freed blocks (even the running one) to
+			// make room; only link if nothing was released in the meantime
+			if (cache.generation==generation) running->LinkTo(ret==BR_Link2,block);
 		}
 	}
 	return block;
@@ -65,6 +65,8 @@ static struct {
 		CacheBlockDynRec * running;		// the last block that was entered for execution
 	} block;
 	Bit8u * pos;		// position in the cache block
+	Bitu generation;	// bumped whenever a block is freed, used to detect
+						// invalidation while a new block is being translated
 	CodePageHandlerDynRec * free_pages;		// pointer to the free list
 	CodePageHandlerDynRec * used_pages;		// pointer to the list of used pages
 	CodePageHandlerDynRec * last_page;		// the last used page
@@ -79,6 +81,9 @@ static Bit8u * cache_code_link_blocks=NULL;
 static CacheBlockDynRec * cache_blocks=NULL;
 static CacheBlockDynRec link_blocks[2];		// default linking (specially marked)
 
+static Bitu cache_total=CACHE_TOTAL;	// code arena size, set from dyncachesize at init
+static Bitu cache_wraps=0;				// times the arena filled up and translation restarted
+
 
 // the CodePageHandlerDynRec class provides access to the contained
 // cache blocks and intercepts writes to the code for special treatment
@@ -381,6 +386,7 @@ static INLINE void cache_addunusedblock(CacheBlockDynRec * block) {
 	// block has become unused, add it to the freelist
 	block->cache.next=cache.block.free;
 	cache.block.free=block;
+	cache.generation++;		// invalidate any pending block links
 }
 
 static CacheBlockDynRec * cache_getblock(void) {
@@ -498,8 +504,11 @@ static void cache_closeblock(void) {
 		}
 	}
 	// advance the active block pointer
-	if (!block->cache.next || (block->cache.next->cache.start>(cache_code_start_ptr + CACHE_TOTAL - CACHE_MAXSIZE))) {
-//		LOG_MSG("Cache full restarting");
+	if (!block->cache.next || (block->cache.next->cache.start>(cache_code_start_ptr + cache_total - CACHE_MAXSIZE))) {
+		// log at power of two counts so a thrashing title shows up without spamming
+		cache_wraps++;
+		if ((cache_wraps&(cache_wraps-1))==0)
+			LOG_MSG("DYNREC: Code cache filled %d time(s), raise dyncachesize if this keeps up",(int)cache_wraps);
 		cache.block.active=cache.block.first;
 	} else {
 		cache.block.active=block->cache.next;
@@ -537,7 +546,10 @@ static void dyn_run_code(void);
 /* Define temporary pagesize so the MPROTECT case and the regular case share as much code as possible */
 #if (C_HAVE_MPROTECT)
 #define PAGESIZE_TEMP PAGESIZE
-#else 
+#ifndef MAP_ANONYMOUS
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+#else
 #define PAGESIZE_TEMP 4096
 #endif
 
@@ -549,6 +561,7 @@ static void cache_init(bool enable) {
 		// see if cache is already initialized
 		if (cache_initialized) return;
 		cache_initialized = true;
+		if (CPU_DynCacheSize>0) cache_total=(Bitu)CPU_DynCacheSize*1024*1024;
 		if (cache_blocks == NULL) {
 			// allocate the cache blocks memory
 			cache_blocks=(CacheBlockDynRec*)malloc(CACHE_BLOCKS*sizeof(CacheBlockDynRec));
@@ -565,12 +578,23 @@ static void cache_init(bool enable) {
 		if (cache_code_start_ptr==NULL) {
 			// allocate the code cache memory
 #if defined (WIN32)
-			cache_code_start_ptr=(Bit8u*)VirtualAlloc(0,CACHE_TOTAL+CACHE_MAXSIZE+PAGESIZE_TEMP-1+PAGESIZE_TEMP,
+			cache_code_start_ptr=(Bit8u*)VirtualAlloc(0,cache_total+CACHE_MAXSIZE+PAGESIZE_TEMP-1+PAGESIZE_TEMP,
 				MEM_COMMIT,PAGE_EXECUTE_READWRITE);
 			if (!cache_code_start_ptr)
-				cache_code_start_ptr=(Bit8u*)malloc(CACHE_TOTAL+CACHE_MAXSIZE+PAGESIZE_TEMP-1+PAGESIZE_TEMP);
+				cache_code_start_ptr=(Bit8u*)malloc(cache_total+CACHE_MAXSIZE+PAGESIZE_TEMP-1+PAGESIZE_TEMP);
+#elif (C_HAVE_MPROTECT)
+			// map the arena directly so execute permission doesn't have to be
+			// forced onto heap pages; ask for huge page backing to cut the
+			// itlb misses of an 8mb code working set
+			cache_code_start_ptr=(Bit8u*)mmap(NULL,cache_total+CACHE_MAXSIZE+PAGESIZE_TEMP-1+PAGESIZE_TEMP,
+				PROT_READ|PROT_WRITE|PROT_EXEC,MAP_PRIVATE|MAP_ANONYMOUS,-1,0);
+			if (cache_code_start_ptr==MAP_FAILED)
+				cache_code_start_ptr=(Bit8u*)malloc(cache_total+CACHE_MAXSIZE+PAGESIZE_TEMP-1+PAGESIZE_TEMP);
+#ifdef MADV_HUGEPAGE
+			else madvise(cache_code_start_ptr,cache_total+CACHE_MAXSIZE+PAGESIZE_TEMP-1+PAGESIZE_TEMP,MADV_HUGEPAGE);
+#endif
 #else
-			cache_code_start_ptr=(Bit8u*)malloc(CACHE_TOTAL+CACHE_MAXSIZE+PAGESIZE_TEMP-1+PAGESIZE_TEMP);
+			cache_code_start_ptr=(Bit8u*)malloc(cache_total+CACHE_MAXSIZE+PAGESIZE_TEMP-1+PAGESIZE_TEMP);
 #endif
 			if(!cache_code_start_ptr) E_Exit("Allocating dynamic cache failed");
 
@@ -581,14 +605,14 @@ static void cache_init(bool enable) {
 			cache_code=cache_code+PAGESIZE_TEMP;
 
 #if (C_HAVE_MPROTECT)
-			if(mprotect(cache_code_link_blocks,CACHE_TOTAL+CACHE_MAXSIZE+PAGESIZE_TEMP,PROT_WRITE|PROT_READ|PROT_EXEC))
+			if(mprotect(cache_code_link_blocks,cache_total+CACHE_MAXSIZE+PAGESIZE_TEMP,PROT_WRITE|PROT_READ|PROT_EXEC))
 				LOG_MSG("Setting execute permission on the code cache has failed");
 #endif
 			CacheBlockDynRec * block=cache_getblock();
 			cache.block.first=block;
 			cache.block.active=block;
 			block->cache.start=&cache_code[0];
-			block->cache.size=CACHE_TOTAL;
+			block->cache.size=cache_total;
 			block->cache.next=0;						// last block in the list
 		}
 		// setup the default blocks for block linkage returns
@@ -124,24 +124,24 @@ restart_prefix:
 		case 0x3b:dyn_dop_gvev(DOP_CMP);break;
 
 		// instructions 'op reg8,imm8'
-		case 0x04:dyn_dop_byte_imm(DOP_ADD,DRC_REG_EAX,0);break;
-		case 0x0c:dyn_dop_byte_imm(DOP_OR,DRC_REG_EAX,0);break;
-		case 0x14:dyn_dop_byte_imm(DOP_ADC,DRC_REG_EAX,0);break;
-		case 0x1c:dyn_dop_byte_imm(DOP_SBB,DRC_REG_EAX,0);break;
-		case 0x24:dyn_dop_byte_imm(DOP_AND,DRC_REG_EAX,0);break;
-		case 0x2c:dyn_dop_byte_imm(DOP_SUB,DRC_REG_EAX,0);break;
-		case 0x34:dyn_dop_byte_imm(DOP_XOR,DRC_REG_EAX,0);break;
-		case 0x3c:dyn_dop_byte_imm(DOP_CMP,DRC_REG_EAX,0);break;
+		case 0x04:dyn_dop_byte_imm_mem(DOP_ADD,DRC_REG_EAX,0);break;
+		case 0x0c:dyn_dop_byte_imm_mem(DOP_OR,DRC_REG_EAX,0);break;
+		case 0x14:dyn_dop_byte_imm_mem(DOP_ADC,DRC_REG_EAX,0);break;
+		case 0x1c:dyn_dop_byte_imm_mem(DOP_SBB,DRC_REG_EAX,0);break;
+		case 0x24:dyn_dop_byte_imm_mem(DOP_AND,DRC_REG_EAX,0);break;
+		case 0x2c:dyn_dop_byte_imm_mem(DOP_SUB,DRC_REG_EAX,0);break;
+		case 0x34:dyn_dop_byte_imm_mem(DOP_XOR,DRC_REG_EAX,0);break;
+		case 0x3c:dyn_dop_byte_imm_mem(DOP_CMP,DRC_REG_EAX,0);break;
 
 		// instructions 'op reg16/32,imm16/32'
 		case 0x05:dyn_dop_word_imm(DOP_ADD,DRC_REG_EAX);break;
-		case 0x0d:dyn_dop_word_imm_old(DOP_OR,DRC_REG_EAX,decode.big_op ? decode_fetchd() :  decode_fetchw());break;
-		case 0x15:dyn_dop_word_imm_old(DOP_ADC,DRC_REG_EAX,decode.big_op ? decode_fetchd() :  decode_fetchw());break;
-		case 0x1d:dyn_dop_word_imm_old(DOP_SBB,DRC_REG_EAX,decode.big_op ? decode_fetchd() :  decode_fetchw());break;
+		case 0x0d:dyn_dop_word_imm(DOP_OR,DRC_REG_EAX);break;
+		case 0x15:dyn_dop_word_imm(DOP_ADC,DRC_REG_EAX);break;
+		case 0x1d:dyn_dop_word_imm(DOP_SBB,DRC_REG_EAX);break;
 		case 0x25:dyn_dop_word_imm(DOP_AND,DRC_REG_EAX);break;
-		case 0x2d:dyn_dop_word_imm_old(DOP_SUB,DRC_REG_EAX,decode.big_op ? decode_fetchd() :  decode_fetchw());break;
-		case 0x35:dyn_dop_word_imm_old(DOP_XOR,DRC_REG_EAX,decode.big_op ? decode_fetchd() :  decode_fetchw());break;
-		case 0x3d:dyn_dop_word_imm_old(DOP_CMP,DRC_REG_EAX,decode.big_op ? decode_fetchd() :  decode_fetchw());break;
+		case 0x2d:dyn_dop_word_imm(DOP_SUB,DRC_REG_EAX);break;
+		case 0x35:dyn_dop_word_imm(DOP_XOR,DRC_REG_EAX);break;
+		case 0x3d:dyn_dop_word_imm(DOP_CMP,DRC_REG_EAX);break;
 
 		// push segment register onto stack
 		case 0x06:dyn_push_seg(DRC_SEG_ES);break;
@@ -397,12 +397,12 @@ restart_prefix:
 
 
 		// 'test reg8/16/32,imm8/16/32'
-		case 0xa8:dyn_dop_byte_imm(DOP_TEST,DRC_REG_EAX,0);break;
-		case 0xa9:dyn_dop_word_imm_old(DOP_TEST,DRC_REG_EAX,decode.big_op ? decode_fetchd() :  decode_fetchw());break;
+		case 0xa8:dyn_dop_byte_imm_mem(DOP_TEST,DRC_REG_EAX,0);break;
+		case 0xa9:dyn_dop_word_imm(DOP_TEST,DRC_REG_EAX);break;
 
 		// 'mov reg8/16/32,imm8/16/32'
 		case 0xb0:case 0xb1:case 0xb2:case 0xb3:case 0xb4:case 0xb5:case 0xb6:case 0xb7:	
-			dyn_mov_byte_imm(opcode&3,(opcode>>2)&1,decode_fetchb());
+			dyn_mov_byte_imm(opcode&3,(opcode>>2)&1);
 			break;
 		case 0xb8:case 0xb9:case 0xba:case 0xbb:case 0xbc:case 0xbd:case 0xbe:case 0xbf:	
 			dyn_mov_word_imm(opcode&7);break;
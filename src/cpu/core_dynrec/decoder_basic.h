@@ -705,7 +705,7 @@ static void dyn_check_exception(HostReg reg) {
 bool DRC_CALL_CONV mem_readb_checked_drc(PhysPt address) DRC_FC;
 bool DRC_CALL_CONV mem_readb_checked_drc(PhysPt address) {
 	HostPt tlb_addr=get_tlb_read(address);
-	if (tlb_addr) {
+	if (GCC_LIKELY(tlb_addr)) {
 		*((Bit8u*)(&core_dynrec.readdata))=host_readb(tlb_addr+address);
 		return false;
 	} else {
@@ -716,7 +716,7 @@ bool DRC_CALL_CONV mem_readb_checked_drc(PhysPt address) {
 bool DRC_CALL_CONV mem_writeb_checked_drc(PhysPt address,Bit8u val) DRC_FC;
 bool DRC_CALL_CONV mem_writeb_checked_drc(PhysPt address,Bit8u val) {
 	HostPt tlb_addr=get_tlb_write(address);
-	if (tlb_addr) {
+	if (GCC_LIKELY(tlb_addr)) {
 		host_writeb(tlb_addr+address,val);
 		return false;
 	} else return get_tlb_writehandler(address)->writeb_checked(address,val);
@@ -724,9 +724,9 @@ bool DRC_CALL_CONV mem_writeb_checked_drc(PhysPt address,Bit8u val) {
 
 bool DRC_CALL_CONV mem_readw_checked_drc(PhysPt address) DRC_FC;
 bool DRC_CALL_CONV mem_readw_checked_drc(PhysPt address) {
-	if ((address & 0xfff)<0xfff) {
+	if (GCC_LIKELY((address & 0xfff)<0xfff)) {
 		HostPt tlb_addr=get_tlb_read(address);
-		if (tlb_addr) {
+		if (GCC_LIKELY(tlb_addr)) {
 			*((Bit16u*)(&core_dynrec.readdata))=host_readw(tlb_addr+address);
 			return false;
 		} else return get_tlb_readhandler(address)->readw_checked(address, (Bit16u*)(&core_dynrec.readdata));
@@ -735,9 +735,9 @@ bool DRC_CALL_CONV mem_readw_checked_drc(PhysPt address) {
 
 bool DRC_CALL_CONV mem_readd_checked_drc(PhysPt address) DRC_FC;
 bool DRC_CALL_CONV mem_readd_checked_drc(PhysPt address) {
-	if ((address & 0xfff)<0xffd) {
+	if (GCC_LIKELY((address & 0xfff)<0xffd)) {
 		HostPt tlb_addr=get_tlb_read(address);
-		if (tlb_addr) {
+		if (GCC_LIKELY(tlb_addr)) {
 			*((Bit32u*)(&core_dynrec.readdata))=host_readd(tlb_addr+address);
 			return false;
 		} else return get_tlb_readhandler(address)->readd_checked(address, (Bit32u*)(&core_dynrec.readdata));
@@ -746,9 +746,9 @@ bool DRC_CALL_CONV mem_readd_checked_drc(PhysPt address) {
 
 bool DRC_CALL_CONV mem_writew_checked_drc(PhysPt address,Bit16u val) DRC_FC;
 bool DRC_CALL_CONV mem_writew_checked_drc(PhysPt address,Bit16u val) {
-	if ((address & 0xfff)<0xfff) {
+	if (GCC_LIKELY((address & 0xfff)<0xfff)) {
 		HostPt tlb_addr=get_tlb_write(address);
-		if (tlb_addr) {
+		if (GCC_LIKELY(tlb_addr)) {
 			host_writew(tlb_addr+address,val);
 			return false;
 		} else return get_tlb_writehandler(address)->writew_checked(address,val);
@@ -757,9 +757,9 @@ bool DRC_CALL_CONV mem_writew_checked_drc(PhysPt address,Bit16u val) {
 
 bool DRC_CALL_CONV mem_writed_checked_drc(PhysPt address,Bit32u val) DRC_FC;
 bool DRC_CALL_CONV mem_writed_checked_drc(PhysPt address,Bit32u val) {
-	if ((address & 0xfff)<0xffd) {
+	if (GCC_LIKELY((address & 0xfff)<0xffd)) {
 		HostPt tlb_addr=get_tlb_write(address);
-		if (tlb_addr) {
+		if (GCC_LIKELY(tlb_addr)) {
 			host_writed(tlb_addr+address,val);
 			return false;
 		} else return get_tlb_writehandler(address)->writed_checked(address,val);
@@ -227,13 +227,6 @@ static void dyn_dop_gvev_mov(void) {
 	}
 }
 
-static void dyn_dop_byte_imm(DualOps op,Bit8u reg,Bit8u idx) {
-	MOV_REG_BYTE_TO_HOST_REG_LOW_CANUSEWORD(FC_OP1,reg,idx);
-	gen_mov_byte_to_reg_low_imm_canuseword(FC_OP2,decode_fetchb());
-	dyn_dop_byte_gencall(op);
-	if ((op!=DOP_CMP) && (op!=DOP_TEST)) MOV_REG_BYTE_FROM_HOST_REG_LOW(FC_RETOP,reg,idx);
-}
-
 static void dyn_dop_byte_imm_mem(DualOps op,Bit8u reg,Bit8u idx) {
 	MOV_REG_BYTE_TO_HOST_REG_LOW_CANUSEWORD(FC_OP1,reg,idx);
 	Bitu val;
@@ -278,8 +271,13 @@ static void dyn_dop_word_imm_old(DualOps op,Bit8u reg,Bitu imm) {
 	if ((op!=DOP_CMP) && (op!=DOP_TEST)) MOV_REG_WORD_FROM_HOST_REG(FC_RETOP,reg,decode.big_op);
 }
 
-static void dyn_mov_byte_imm(Bit8u reg,Bit8u idx,Bit8u imm) {
-	gen_mov_byte_to_reg_low_imm(FC_TMP_BA1,imm);
+static void dyn_mov_byte_imm(Bit8u reg,Bit8u idx) {
+	Bitu val;
+	if (decode_fetchb_imm(val)) {
+		gen_mov_byte_to_reg_low(FC_TMP_BA1,(void*)val);
+	} else {
+		gen_mov_byte_to_reg_low_imm(FC_TMP_BA1,(Bit8u)val);
+	}
 	MOV_REG_BYTE_FROM_HOST_REG_LOW(FC_TMP_BA1,reg,idx);
 }
 
@@ -538,6 +536,7 @@ static void dyn_imul_gvev(Bitu immsize) {
 			break;
 	}
 
+	InvalidateFlags();	// imul kills all condition flags, see dyn_grp3_eb
 	if (decode.big_op) gen_call_function_raw((void*)dynrec_dimul_dword);
 	else gen_call_function_raw((void*)dynrec_dimul_word);
 
@@ -721,9 +720,14 @@ static void dyn_grp3_eb(void) {
 		dyn_sop_byte_gencall(SOP_NEG);
 		break;
 	case 0x4:	// mul Eb
+		// mul overwrites CF/OF and leaves the other arithmetic flags
+		// undefined, so pending lazy-flags producers are dead here and
+		// can be downgraded to their flag-less variants
+		InvalidateFlags();
 		gen_call_function_raw((void*)&dynrec_mul_byte);
 		return;
 	case 0x5:	// imul Eb
+		InvalidateFlags();
 		gen_call_function_raw((void*)&dynrec_imul_byte);
 		return;
 	case 0x6:	// div Eb
@@ -766,10 +770,12 @@ static void dyn_grp3_ev(void) {
 		dyn_sop_word_gencall(SOP_NEG,decode.big_op);
 		break;
 	case 0x4:	// mul Eb
+		InvalidateFlags();	// see dyn_grp3_eb
 		if (decode.big_op) gen_call_function_raw((void*)&dynrec_mul_dword);
 		else gen_call_function_raw((void*)&dynrec_mul_word);
 		return;
 	case 0x5:	// imul Eb
+		InvalidateFlags();
 		if (decode.big_op) gen_call_function_raw((void*)&dynrec_imul_dword);
 		else gen_call_function_raw((void*)&dynrec_imul_word);
 		return;
@@ -138,12 +138,24 @@ static INLINE Bit32u Fetchd() {
 
 #define EALookupTable (core.ea_table)
 
-Bits CPU_Core_Normal_Run(void) {
+// set when the running instantiation observes a code-size switch
+static bool mode_switched;
+
+template <bool is_big>
+static Bits Core_Normal_Run(void) {
 	while (CPU_Cycles-->0) {
+		if (GCC_UNLIKELY(cpu.code.big!=is_big)) {
+			/* the previous instruction loaded a code segment of the
+			   other size; hand back so the dispatcher reenters the
+			   matching instantiation */
+			mode_switched=true;
+			CPU_Cycles++;
+			return CBRET_NONE;
+		}
 		LOADIP;
-		core.opcode_index=cpu.code.big*0x200;
-		core.prefixes=cpu.code.big;
-		core.ea_table=&EATable[cpu.code.big*256];
+		core.opcode_index=is_big*0x200;
+		core.prefixes=is_big;
+		core.ea_table=&EATable[is_big*256];
 		BaseDS=SegBase(ds);
 		BaseSS=SegBase(ss);
 		core.base_val_ds=ds;
@@ -157,7 +169,10 @@ Bits CPU_Core_Normal_Run(void) {
 		cycle_count++;
 #endif
 restart_opcode:
-		switch (core.opcode_index+Fetchb()) {
+		// the mask is a no-op (opcode_index is at most OPCODE_SIZE|OPCODE_0F)
+		// but lets the compiler prove the switch operand range and emit the
+		// dispatch jump table without a per-instruction bounds check
+		switch ((core.opcode_index+Fetchb()) & 0x3ff) {
 		#include "core_normal/prefix_none.h"
 		#include "core_normal/prefix_0f.h"
 		#include "core_normal/prefix_66.h"
@@ -190,6 +205,17 @@ decode_end:
 	return CBRET_NONE;
 }
 
+Bits CPU_Core_Normal_Run(void) {
+	/* expanded once per code size so the per-instruction mode loads
+	   above fold to constants; 16 and 32 bit code segments each run in
+	   their own instantiation and transitions between them are rare */
+	for (;;) {
+		mode_switched=false;
+		Bits ret=cpu.code.big ? Core_Normal_Run<true>() : Core_Normal_Run<false>();
+		if (GCC_LIKELY(!mode_switched)) return ret;
+	}
+}
+
 Bits CPU_Core_Normal_Trap_Run(void) {
 	Bits oldCycles = CPU_Cycles;
 	CPU_Cycles = 1;
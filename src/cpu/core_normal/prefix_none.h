@@ -1099,6 +1099,14 @@
 				{
 					Bitu cb=Fetchw();
 					FillFlags();SAVEIP;
+					if (GCC_LIKELY(cb<CB_MAX && CallBack_Fast[cb])) {
+						/* hot handler that never stops the loop; run it
+						   here and resume at whatever cs:ip it left
+						   instead of bouncing through the outer loop */
+						if (GCC_UNLIKELY((*CallBack_Handlers[cb])()))
+							E_Exit("CALLBACK: Fast callback %d returned stop",(int)cb);
+						continue;
+					}
 					return cb;
 				}
 			default:
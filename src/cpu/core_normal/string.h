@@ -59,6 +59,74 @@ static void DoString(STRING_OP type) {
 		}
 	}
 	add_index=cpu.direction;
+	/* Fast path: bulk REP MOVS/STOS through linear RAM, page by page.
+	   Only forward transfers are handled; as soon as a page without a
+	   TLB host mapping (MMIO, guarded or uncommitted pages) is hit the
+	   remainder falls through to the per-element loops below. */
+	if (TEST_PREFIX_REP && (cpu.direction==1) && (count>1)) switch (type) {
+	case R_MOVSB:case R_MOVSW:case R_MOVSD:
+		{
+			Bitu width=(Bitu)1 << (type-R_MOVSB);
+			while (count>0) {
+				PhysPt si_addr=si_base+(PhysPt)si_index;
+				PhysPt di_addr=di_base+(PhysPt)di_index;
+				Bitu chunk=count*width;
+				/* stay inside the current source and destination pages */
+				Bitu left=4096-(si_addr & 4095);
+				if (chunk>left) chunk=left;
+				left=4096-(di_addr & 4095);
+				if (chunk>left) chunk=left;
+				/* honour 16 bit index wraparound */
+				if (add_mask==0xffff) {
+					left=0x10000-(si_index>di_index ? si_index : di_index);
+					if (chunk>left) chunk=left;
+				}
+				chunk-=chunk % width;
+				if (chunk<width) break;
+				HostPt src=get_tlb_read(si_addr);
+				HostPt dst=get_tlb_write(di_addr);
+				if (GCC_UNLIKELY(!src || !dst)) break;
+				/* an overlapping forward movs replicates the source
+				   pattern, which memcpy must not be trusted with */
+				if ((dst+di_addr>src+si_addr) && (dst+di_addr<src+si_addr+chunk)) break;
+				memcpy(dst+di_addr,src+si_addr,chunk);
+				si_index=(si_index+chunk) & add_mask;
+				di_index=(di_index+chunk) & add_mask;
+				count-=chunk/width;
+			}
+		}
+		break;
+	case R_STOSB:case R_STOSW:case R_STOSD:
+		{
+			Bitu width=(Bitu)1 << (type-R_STOSB);
+			while (count>0) {
+				PhysPt di_addr=di_base+(PhysPt)di_index;
+				Bitu chunk=count*width;
+				Bitu left=4096-(di_addr & 4095);
+				if (chunk>left) chunk=left;
+				if (add_mask==0xffff) {
+					left=0x10000-di_index;
+					if (chunk>left) chunk=left;
+				}
+				chunk-=chunk % width;
+				if (chunk<width) break;
+				HostPt dst=get_tlb_write(di_addr);
+				if (GCC_UNLIKELY(!dst)) break;
+				HostPt ptr=dst+di_addr;
+				if (type==R_STOSB) memset(ptr,reg_al,chunk);
+				else if (type==R_STOSW) {
+					for (Bitu i=0;i<chunk;i+=2) host_writew(ptr+i,reg_ax);
+				} else {
+					for (Bitu i=0;i<chunk;i+=4) host_writed(ptr+i,reg_eax);
+				}
+				di_index=(di_index+chunk) & add_mask;
+				count-=chunk/width;
+			}
+		}
+		break;
+	default:
+		break;
+	}
 	if (count) switch (type) {
 	case R_OUTSB:
 		for (;count>0;count--) {
@@ -48,31 +48,18 @@ static PhysPt EA_16_87_n(void) { return BaseDS+(Bit16u)(reg_bx+Fetchws()); }
 
 static Bit32u SIBZero=0;
 static Bit32u * SIBIndex[8]= { &reg_eax,&reg_ecx,&reg_edx,&reg_ebx,&SIBZero,&reg_ebp,&reg_esi,&reg_edi };
+static Bit32u * SIBBase[8]= { &reg_eax,&reg_ecx,&reg_edx,&reg_ebx,&reg_esp,&reg_ebp,&reg_esi,&reg_edi };
 
 static INLINE PhysPt Sib(Bitu mode) {
 	Bit8u sib=Fetchb();
+	Bitu rm=sib&7;
 	PhysPt base;
-	switch (sib&7) {
-	case 0:	/* EAX Base */
-		base=BaseDS+reg_eax;break;
-	case 1:	/* ECX Base */
-		base=BaseDS+reg_ecx;break;
-	case 2:	/* EDX Base */
-		base=BaseDS+reg_edx;break;
-	case 3:	/* EBX Base */
-		base=BaseDS+reg_ebx;break;
-	case 4:	/* ESP Base */
-		base=BaseSS+reg_esp;break;
-	case 5:	/* #1 Base */
-		if (!mode) {
-			base=BaseDS+Fetchd();break;
-		} else {
-			base=BaseSS+reg_ebp;break;
-		}
-	case 6:	/* ESI Base */
-		base=BaseDS+reg_esi;break;
-	case 7:	/* EDI Base */
-		base=BaseDS+reg_edi;break;
+	if (GCC_UNLIKELY(rm==5 && !mode)) {
+		/* mod 00 has no ebp base, a dword displacement instead */
+		base=BaseDS+Fetchd();
+	} else {
+		/* esp and ebp based addresses default to the stack segment */
+		base=(rm==4 || rm==5 ? BaseSS : BaseDS)+*SIBBase[rm];
 	}
 	base+=*SIBIndex[(sib >> 3) &7] << (sib >> 6);
 	return base;
@@ -116,6 +116,23 @@ static Bit8u prefetch_buffer[MAX_PQ_SIZE];
 static bool pq_valid=false;
 static Bitu pq_start;
 
+/* refill the queue with one paging lookup per page span: directly
+ * readable pages are block copied from the host pointer, anything
+ * behind a page handler falls back to byte loads */
+static void Prefetch_Fill(Bit8u * dst,PhysPt addr,Bitu len) {
+	while (len) {
+		Bitu chunk=4096-(addr&0xfff);
+		if (chunk>len) chunk=len;
+		HostPt tlb_addr=get_tlb_read(addr);
+		if (GCC_LIKELY(tlb_addr!=0)) {
+			memcpy(dst,tlb_addr+addr,chunk);
+		} else {
+			for (Bitu i=0;i<chunk;i++) dst[i]=LoadMb(addr+i);
+		}
+		dst+=chunk;addr+=chunk;len-=chunk;
+	}
+}
+
 static Bit8u Fetchb() {
 	Bit8u temp;
 	if (pq_valid && (core.cseip>=pq_start) && (core.cseip<pq_start+CPU_PrefetchQueueSize)) {
@@ -124,12 +141,12 @@ static Bit8u Fetchb() {
 			(core.cseip+1<pq_start+CPU_PrefetchQueueSize)) {
 			Bitu remaining_bytes=pq_start+CPU_PrefetchQueueSize-(core.cseip+1);
 			for (Bitu i=0; i<remaining_bytes; i++) prefetch_buffer[i]=prefetch_buffer[core.cseip+1-pq_start+i];
-			for (Bitu i=remaining_bytes; i<CPU_PrefetchQueueSize; i++) prefetch_buffer[i]=LoadMb(core.cseip+1+i);
+			Prefetch_Fill(prefetch_buffer+remaining_bytes,core.cseip+1+remaining_bytes,CPU_PrefetchQueueSize-remaining_bytes);
 			pq_start=core.cseip+1;
 			pq_valid=true;
 		}
 	} else {
-		for (Bitu i=0; i<CPU_PrefetchQueueSize; i++) prefetch_buffer[i]=LoadMb(core.cseip+i);
+		Prefetch_Fill(prefetch_buffer,core.cseip,CPU_PrefetchQueueSize);
 		pq_start=core.cseip;
 		pq_valid=true;
 		temp=prefetch_buffer[0];
@@ -150,12 +167,12 @@ static Bit16u Fetchw() {
 			(core.cseip+2<pq_start+CPU_PrefetchQueueSize)) {
 			Bitu remaining_bytes=pq_start+CPU_PrefetchQueueSize-(core.cseip+2);
 			for (Bitu i=0; i<remaining_bytes; i++) prefetch_buffer[i]=prefetch_buffer[core.cseip+2-pq_start+i];
-			for (Bitu i=remaining_bytes; i<CPU_PrefetchQueueSize; i++) prefetch_buffer[i]=LoadMb(core.cseip+2+i);
+			Prefetch_Fill(prefetch_buffer+remaining_bytes,core.cseip+2+remaining_bytes,CPU_PrefetchQueueSize-remaining_bytes);
 			pq_start=core.cseip+2;
 			pq_valid=true;
 		}
 	} else {
-		for (Bitu i=0; i<CPU_PrefetchQueueSize; i++) prefetch_buffer[i]=LoadMb(core.cseip+i);
+		Prefetch_Fill(prefetch_buffer,core.cseip,CPU_PrefetchQueueSize);
 		pq_start=core.cseip;
 		pq_valid=true;
 		temp=prefetch_buffer[0] | (prefetch_buffer[1]<<8);
@@ -178,12 +195,12 @@ static Bit32u Fetchd() {
 			(core.cseip+4<pq_start+CPU_PrefetchQueueSize)) {
 			Bitu remaining_bytes=pq_start+CPU_PrefetchQueueSize-(core.cseip+4);
 			for (Bitu i=0; i<remaining_bytes; i++) prefetch_buffer[i]=prefetch_buffer[core.cseip+4-pq_start+i];
-			for (Bitu i=remaining_bytes; i<CPU_PrefetchQueueSize; i++) prefetch_buffer[i]=LoadMb(core.cseip+4+i);
+			Prefetch_Fill(prefetch_buffer+remaining_bytes,core.cseip+4+remaining_bytes,CPU_PrefetchQueueSize-remaining_bytes);
 			pq_start=core.cseip+4;
 			pq_valid=true;
 		}
 	} else {
-		for (Bitu i=0; i<CPU_PrefetchQueueSize; i++) prefetch_buffer[i]=LoadMb(core.cseip+i);
+		Prefetch_Fill(prefetch_buffer,core.cseip,CPU_PrefetchQueueSize);
 		pq_start=core.cseip;
 		pq_valid=true;
 		temp=prefetch_buffer[0] | (prefetch_buffer[1]<<8) |
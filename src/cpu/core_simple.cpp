@@ -153,7 +153,9 @@ Bits CPU_Core_Simple_Run(void) {
 		cycle_count++;
 #endif
 restart_opcode:
-		switch (core.opcode_index+Fetchb()) {
+		// masking proves the operand range to the compiler so the dispatch
+		// jump table is emitted without a bounds check, see core_normal.cpp
+		switch ((core.opcode_index+Fetchb()) & 0x3ff) {
 
 		#include "core_normal/prefix_none.h"
 		#include "core_normal/prefix_0f.h"
@@ -18,9 +18,13 @@
 
 
 #include <assert.h>
+#include <map>
 #include <sstream>
 #include <stddef.h>
+#include <stdio.h>
+#include <string.h>
 #include "dosbox.h"
+#include "cross.h"
 #include "cpu.h"
 #include "memory.h"
 #include "debug.h"
@@ -56,6 +60,7 @@ Bit32s CPU_CyclePercUsed = 100;
 Bit32s CPU_CycleLimit = -1;
 Bit32s CPU_CycleUp = 0;
 Bit32s CPU_CycleDown = 0;
+Bit32s CPU_DynCacheSize = 0;
 Bit64s CPU_IODelayRemoved = 0;
 CPU_Decoder * cpudecoder;
 bool CPU_CycleAutoAdjust = false;
@@ -68,6 +73,74 @@ Bitu CPU_extflags_toggle=0;	// ID and AC flags may be toggled depending on emula
 
 Bitu CPU_PrefetchQueueSize=0;
 
+/* Per-title cycle profiles: with cycles=auto/max the adjuster spends
+   seconds ramping to a stable count after every launch. When enabled the
+   settled count is remembered per executable name and restored the
+   moment that executable is started again. */
+static std::map<std::string,Bit32s> cycle_profiles;
+static std::string cycle_profile_exe;		// title the adjuster is currently tuning
+static bool cycle_profiles_enabled=false;
+static bool cycle_profiles_loaded=false;
+static bool cycle_profiles_dirty=false;
+
+static void Cycle_Profile_Path(std::string& path) {
+	Cross::GetPlatformConfigDir(path);
+	path += "cycle_profiles.txt";
+}
+
+static void Cycle_Profile_Load(void) {
+	if (cycle_profiles_loaded) return;
+	cycle_profiles_loaded=true;
+	std::string path;
+	Cycle_Profile_Path(path);
+	FILE * f=fopen(path.c_str(),"r");
+	if (!f) return;
+	char line[128];
+	while (fgets(line,sizeof(line),f)) {
+		char exe[16];int cycles=0;
+		if (sscanf(line,"%15s %d",exe,&cycles)==2 && cycles>0)
+			cycle_profiles[exe]=(Bit32s)cycles;
+	}
+	fclose(f);
+}
+
+static void Cycle_Profile_Remember(void) {
+	if (cycle_profile_exe.empty() || !CPU_CycleAutoAdjust) return;
+	std::map<std::string,Bit32s>::iterator it=cycle_profiles.find(cycle_profile_exe);
+	if (it==cycle_profiles.end() || it->second!=CPU_CycleMax) {
+		cycle_profiles[cycle_profile_exe]=CPU_CycleMax;
+		cycle_profiles_dirty=true;
+	}
+}
+
+static void Cycle_Profile_Save(void) {
+	if (!cycle_profiles_dirty) return;
+	std::string path;
+	Cycle_Profile_Path(path);
+	FILE * f=fopen(path.c_str(),"w");
+	if (!f) return;
+	for (std::map<std::string,Bit32s>::iterator it=cycle_profiles.begin();it!=cycle_profiles.end();++it)
+		fprintf(f,"%s %d\n",it->first.c_str(),(int)it->second);
+	fclose(f);
+	cycle_profiles_dirty=false;
+}
+
+void CPU_NotifyExecutable(const char * stripname) {
+	if (!cycle_profiles_enabled || !CPU_CycleAutoAdjust) return;
+	Cycle_Profile_Load();
+	/* bank what the adjuster reached for the previous title */
+	Cycle_Profile_Remember();
+	char exe[9];
+	memcpy(exe,stripname,8);exe[8]=0;	// mcb name field has no terminator at 8 chars
+	if (!exe[0]) return;
+	cycle_profile_exe=exe;
+	std::map<std::string,Bit32s>::iterator it=cycle_profiles.find(cycle_profile_exe);
+	if (it==cycle_profiles.end()) return;
+	CPU_CycleMax=it->second;
+	if (CPU_CycleLimit>0 && CPU_CycleMax>CPU_CycleLimit) CPU_CycleMax=CPU_CycleLimit;
+	LOG(LOG_CPU,LOG_NORMAL)("Restored %d cycles for %s",(int)CPU_CycleMax,exe);
+}
+
 void CPU_Core_Full_Init(void);
 void CPU_Core_Normal_Init(void);
 void CPU_Core_Simple_Init(void);
@@ -134,26 +207,62 @@ void Descriptor:: Save(PhysPt address) {
 }
 
 
+/* refresh the pinned stack page from the tlb after a slow stack access;
+   only pages with a direct mapping in both directions get pinned */
+static INLINE void CPU_CacheStackPage(PhysPt addr) {
+	cpu.stack.cached_read=get_tlb_read(addr);
+	cpu.stack.cached_write=get_tlb_write(addr);
+	if (cpu.stack.cached_read && cpu.stack.cached_write)
+		cpu.stack.cached_page=addr & ~0xfffu;
+	else cpu.stack.cached_page=1;
+}
+
 void CPU_Push16(Bitu value) {
 	Bit32u new_esp=(reg_esp&cpu.stack.notmask)|((reg_esp-2)&cpu.stack.mask);
-	mem_writew(SegPhys(ss) + (new_esp & cpu.stack.mask) ,value);
+	PhysPt addr=SegPhys(ss) + (new_esp & cpu.stack.mask);
+	if (GCC_LIKELY(((addr & ~0xfffu)==cpu.stack.cached_page) && ((addr & 0xfff)<0xfff))) {
+		host_writew(cpu.stack.cached_write+addr,(Bit16u)value);
+	} else {
+		mem_writew(addr,value);
+		CPU_CacheStackPage(addr);
+	}
 	reg_esp=new_esp;
 }
 
 void CPU_Push32(Bitu value) {
 	Bit32u new_esp=(reg_esp&cpu.stack.notmask)|((reg_esp-4)&cpu.stack.mask);
-	mem_writed(SegPhys(ss) + (new_esp & cpu.stack.mask) ,value);
+	PhysPt addr=SegPhys(ss) + (new_esp & cpu.stack.mask);
+	if (GCC_LIKELY(((addr & ~0xfffu)==cpu.stack.cached_page) && ((addr & 0xfff)<0xffd))) {
+		host_writed(cpu.stack.cached_write+addr,(Bit32u)value);
+	} else {
+		mem_writed(addr,value);
+		CPU_CacheStackPage(addr);
+	}
 	reg_esp=new_esp;
 }
 
 Bitu CPU_Pop16(void) {
-	Bitu val=mem_readw(SegPhys(ss) + (reg_esp & cpu.stack.mask));
+	PhysPt addr=SegPhys(ss) + (reg_esp & cpu.stack.mask);
+	Bitu val;
+	if (GCC_LIKELY(((addr & ~0xfffu)==cpu.stack.cached_page) && ((addr & 0xfff)<0xfff))) {
+		val=host_readw(cpu.stack.cached_read+addr);
+	} else {
+		val=mem_readw(addr);
+		CPU_CacheStackPage(addr);
+	}
 	reg_esp=(reg_esp&cpu.stack.notmask)|((reg_esp+2)&cpu.stack.mask);
 	return val;
 }
 
 Bitu CPU_Pop32(void) {
-	Bitu val=mem_readd(SegPhys(ss) + (reg_esp & cpu.stack.mask));
+	PhysPt addr=SegPhys(ss) + (reg_esp & cpu.stack.mask);
+	Bitu val;
+	if (GCC_LIKELY(((addr & ~0xfffu)==cpu.stack.cached_page) && ((addr & 0xfff)<0xffd))) {
+		val=host_readd(cpu.stack.cached_read+addr);
+	} else {
+		val=mem_readd(addr);
+		CPU_CacheStackPage(addr);
+	}
 	reg_esp=(reg_esp&cpu.stack.notmask)|((reg_esp+4)&cpu.stack.mask);
 	return val;
 }
@@ -567,16 +676,24 @@ void CPU_Interrupt(Bitu num,Bitu type,Bitu oldeip) {
 	};
 #endif
 	if (!cpu.pmode) {
-		/* Save everything on a 16-bit stack */
-		CPU_Push16(reg_flags & 0xffff);
-		CPU_Push16(SegValue(cs));
-		CPU_Push16(oldeip);
+		/* Save everything on a 16-bit stack; the mask juggling and the
+		   stack base only need deriving once for the three pushes */
+		const Bit32u mask=cpu.stack.mask;
+		const Bit32u notmask=cpu.stack.notmask;
+		const PhysPt sbase=SegPhys(ss);
+		Bit32u new_esp=(reg_esp&notmask)|((reg_esp-2)&mask);
+		mem_writew(sbase+(new_esp&mask),reg_flags & 0xffff);
+		new_esp=(new_esp&notmask)|((new_esp-2)&mask);
+		mem_writew(sbase+(new_esp&mask),SegValue(cs));
+		new_esp=(new_esp&notmask)|((new_esp-2)&mask);
+		mem_writew(sbase+(new_esp&mask),oldeip);
+		reg_esp=new_esp;
 		SETFLAGBIT(IF,false);
 		SETFLAGBIT(TF,false);
-		/* Get the new CS:IP from vector table */
-		PhysPt base=cpu.idt.GetBase();
-		reg_eip=mem_readw(base+(num << 2));
-		Segs.val[cs]=mem_readw(base+(num << 2)+2);
+		/* Get the new CS:IP from the vector table in one dword read */
+		Bit32u vec=mem_readd(cpu.idt.GetBase()+(num << 2));
+		reg_eip=vec & 0xffff;
+		Segs.val[cs]=vec >> 16;
 		Segs.phys[cs]=Segs.val[cs]<<4;
 		cpu.code.big=false;
 		return;
@@ -770,9 +887,19 @@ void CPU_IRET(bool use32,Bitu oldeip) {
 			SegSet16(cs,CPU_Pop32());
 			CPU_SetFlags(CPU_Pop32(),FMASK_ALL);
 		} else {
-			reg_eip=CPU_Pop16();
-			SegSet16(cs,CPU_Pop16());
-			CPU_SetFlags(CPU_Pop16(),FMASK_ALL & 0xffff);
+			/* the usual return from a hardware interrupt; pop with the
+			   stack state derived once, mirroring the entry path */
+			const Bit32u mask=cpu.stack.mask;
+			const Bit32u notmask=cpu.stack.notmask;
+			const PhysPt sbase=SegPhys(ss);
+			Bit32u sp=reg_esp;
+			reg_eip=mem_readw(sbase+(sp&mask));
+			sp=(sp&notmask)|((sp+2)&mask);
+			SegSet16(cs,mem_readw(sbase+(sp&mask)));
+			sp=(sp&notmask)|((sp+2)&mask);
+			Bitu new_flags=mem_readw(sbase+(sp&mask));
+			reg_esp=(sp&notmask)|((sp+2)&mask);
+			CPU_SetFlags(new_flags,FMASK_ALL & 0xffff);
 		}
 		cpu.code.big=false;
 		DestroyConditionFlags();
@@ -2209,6 +2336,7 @@ public:
 		cpu.stack.mask=0xffff;
 		cpu.stack.notmask=0xffff0000;
 		cpu.stack.big=false;
+		CPU_InvalidateStackCache();
 		cpu.trap_skip=false;
 		cpu.idt.SetBase(0);
 		cpu.idt.SetLimit(1023);
@@ -2323,6 +2451,10 @@ public:
 
 		CPU_CycleUp=section->Get_int("cycleup");
 		CPU_CycleDown=section->Get_int("cycledown");
+		CPU_DynCacheSize=section->Get_int("dyncachesize");
+		cycle_profiles_enabled=section->Get_bool("cycleprofiles");
+		if (DOSBOX_Deterministic && CPU_CycleAutoAdjust)
+			LOG_MSG("CPU: Deterministic mode needs a fixed cycles setting; auto/max cycles won't reproduce");
 		std::string core(section->Get_string("core"));
 		cpudecoder=&CPU_Core_Normal_Run;
 		if (core == "normal") {
@@ -2414,6 +2546,10 @@ public:
 static CPU * test;
 
 void CPU_ShutDown(Section* sec) {
+	if (cycle_profiles_enabled) {
+		Cycle_Profile_Remember();
+		Cycle_Profile_Save();
+	}
 #if (C_DYNAMIC_X86)
 	CPU_Core_Dyn_X86_Cache_Close();
 #elif (C_DYNREC)
@@ -2422,9 +2558,18 @@ void CPU_ShutDown(Section* sec) {
 	delete test;
 }
 
+/* Cycle settings can be retuned on the running module, no need to tear
+   the cpu down for them. */
+static void CPU_UpdateCycles(Section* sec) {
+	test->Change_Config(sec);
+}
+
 void CPU_Init(Section* sec) {
 	test = new CPU(sec);
 	sec->AddDestroyFunction(&CPU_ShutDown,true);
+	sec->AddUpdateFunction("cycles",&CPU_UpdateCycles);
+	sec->AddUpdateFunction("cycleup",&CPU_UpdateCycles);
+	sec->AddUpdateFunction("cycledown",&CPU_UpdateCycles);
 }
 //initialize static members
 bool CPU::inited=false;
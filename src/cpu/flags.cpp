@@ -460,6 +460,107 @@ Bit32u get_PF(void) {
 	return 0;
 }
 
+/* Compound conditions for the Jcc macros. The dominant last-operations
+   before a conditional jump (cmp/sub and the logic ops) have closed
+   forms, so these evaluate with one type dispatch instead of chaining
+   two or three of the getters above. */
+
+/* BE: CF || ZF */
+Bit32u get_BE(void) {
+	switch (lflags.type) {
+	case t_SUBb:
+	case t_CMPb:
+		return (lf_var1b<=lf_var2b);
+	case t_SUBw:
+	case t_CMPw:
+		return (lf_var1w<=lf_var2w);
+	case t_SUBd:
+	case t_CMPd:
+		return (lf_var1d<=lf_var2d);
+	case t_ORb:
+	case t_ANDb:
+	case t_XORb:
+	case t_TESTb:
+		return (lf_resb==0);
+	case t_ORw:
+	case t_ANDw:
+	case t_XORw:
+	case t_TESTw:
+		return (lf_resw==0);
+	case t_ORd:
+	case t_ANDd:
+	case t_XORd:
+	case t_TESTd:
+		return (lf_resd==0);
+	default:
+		return get_CF() || get_ZF();
+	}
+}
+
+/* L: SF != OF */
+Bit32u get_L(void) {
+	switch (lflags.type) {
+	case t_SUBb:
+	case t_CMPb:
+		return (((Bit8s)lf_var1b)<((Bit8s)lf_var2b));
+	case t_SUBw:
+	case t_CMPw:
+		return (((Bit16s)lf_var1w)<((Bit16s)lf_var2w));
+	case t_SUBd:
+	case t_CMPd:
+		return (((Bit32s)lf_var1d)<((Bit32s)lf_var2d));
+	case t_ORb:
+	case t_ANDb:
+	case t_XORb:
+	case t_TESTb:
+		return (lf_resb & 0x80);
+	case t_ORw:
+	case t_ANDw:
+	case t_XORw:
+	case t_TESTw:
+		return (lf_resw & 0x8000);
+	case t_ORd:
+	case t_ANDd:
+	case t_XORd:
+	case t_TESTd:
+		return (lf_resd & 0x80000000);
+	default:
+		return ((get_SF()!=0) != (get_OF()!=0));
+	}
+}
+
+/* LE: ZF || (SF != OF) */
+Bit32u get_LE(void) {
+	switch (lflags.type) {
+	case t_SUBb:
+	case t_CMPb:
+		return (((Bit8s)lf_var1b)<=((Bit8s)lf_var2b));
+	case t_SUBw:
+	case t_CMPw:
+		return (((Bit16s)lf_var1w)<=((Bit16s)lf_var2w));
+	case t_SUBd:
+	case t_CMPd:
+		return (((Bit32s)lf_var1d)<=((Bit32s)lf_var2d));
+	case t_ORb:
+	case t_ANDb:
+	case t_XORb:
+	case t_TESTb:
+		return (((Bit8s)lf_resb)<=0);
+	case t_ORw:
+	case t_ANDw:
+	case t_XORw:
+	case t_TESTw:
+		return (((Bit16s)lf_resw)<=0);
+	case t_ORd:
+	case t_ANDd:
+	case t_XORd:
+	case t_TESTd:
+		return (((Bit32s)lf_resd)<=0);
+	default:
+		return get_ZF() || ((get_SF()!=0) != (get_OF()!=0));
+	}
+}
+
 
 #if 0
 
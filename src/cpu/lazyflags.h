@@ -26,6 +26,10 @@ Bit32u get_ZF(void);
 Bit32u get_SF(void);
 Bit32u get_OF(void);
 Bit32u get_PF(void);
+//Compound conditions evaluated with a single type dispatch
+Bit32u get_BE(void);
+Bit32u get_L(void);
+Bit32u get_LE(void);
 
 Bitu FillFlags(void);
 void FillFlagsNoCFOF(void);
@@ -90,16 +94,16 @@ extern LazyFlags lflags;
 #define TFLG_NB		(!get_CF())
 #define TFLG_Z		(get_ZF())
 #define TFLG_NZ		(!get_ZF())
-#define TFLG_BE		(get_CF() || get_ZF())
-#define TFLG_NBE	(!get_CF() && !get_ZF())
+#define TFLG_BE		(get_BE())
+#define TFLG_NBE	(!get_BE())
 #define TFLG_S		(get_SF())
 #define TFLG_NS		(!get_SF())
 #define TFLG_P		(get_PF())
 #define TFLG_NP		(!get_PF())
-#define TFLG_L		((get_SF()!=0) != (get_OF()!=0))
-#define TFLG_NL		((get_SF()!=0) == (get_OF()!=0))
-#define TFLG_LE		(get_ZF()  || ((get_SF()!=0) != (get_OF()!=0)))
-#define TFLG_NLE	(!get_ZF() && ((get_SF()!=0) == (get_OF()!=0)))
+#define TFLG_L		(get_L())
+#define TFLG_NL		(!get_L())
+#define TFLG_LE		(get_LE())
+#define TFLG_NLE	(!get_LE())
 
 //Types of Flag changing instructions
 enum {
@@ -177,17 +177,54 @@ static INLINE void InitPageUpdateLink(Bitu relink,PhysPt addr) {
 	if (relink>1) PAGING_LinkPage_ReadOnly(addr>>12,relink);
 }
 
+/* A tlb miss walks two levels of guest page tables, but the directory half
+   of the walk keeps hitting the same handful of entries, so cache the pde
+   by directory index. Validation is a generation counter: everything that
+   may change the translation (cr3 load, tlb flush, invlpg) just bumps the
+   generation instead of touching the array. Only the directory level is
+   cached; page table entries are spread over far more pages and rarely
+   repeat between misses. */
+struct PDECacheEntry {
+	Bit32u gen;
+	Bit32u pde;
+};
+static PDECacheEntry pde_cache[1024];
+static Bit32u pde_cache_gen=1;		// generation 0 marks a never filled slot
+
+static INLINE void PDECacheFlush(void) {
+	if (GCC_UNLIKELY(++pde_cache_gen==0)) {
+		memset(pde_cache,0,sizeof(pde_cache));
+		pde_cache_gen=1;
+	}
+}
+
+static INLINE Bit32u PDE_Read(Bitu d_index) {
+	PDECacheEntry * cached=&pde_cache[d_index];
+	if (cached->gen!=pde_cache_gen) {
+		cached->pde=phys_readd((paging.base.page<<12)+d_index*4);
+		cached->gen=pde_cache_gen;
+	}
+	return cached->pde;
+}
+
+// write back a modified pde (accessed bit) and keep the cache current
+static INLINE void PDE_Update(Bitu d_index,Bit32u pde) {
+	phys_writed((paging.base.page<<12)+d_index*4,pde);
+	pde_cache[d_index].pde=pde;
+	pde_cache[d_index].gen=pde_cache_gen;
+}
+
 static INLINE void InitPageCheckPresence(PhysPt lin_addr,bool writing,X86PageEntry& table,X86PageEntry& entry) {
 	Bitu lin_page=lin_addr >> 12;
 	Bitu d_index=lin_page >> 10;
 	Bitu t_index=lin_page & 0x3ff;
-	Bitu table_addr=(paging.base.page<<12)+d_index*4;
-	table.load=phys_readd(table_addr);
+	table.load=PDE_Read(d_index);
 	if (!table.block.p) {
 		LOG(LOG_PAGING,LOG_NORMAL)("NP Table");
-		PAGING_PageFault(lin_addr,table_addr,
+		PAGING_PageFault(lin_addr,(paging.base.page<<12)+d_index*4,
 			(writing?0x02:0x00) | (((cpu.cpl&cpu.mpl)==0)?0x00:0x04));
-		table.load=phys_readd(table_addr);
+		pde_cache[d_index].gen=0;	// fault handler may have rewritten the pde
+		table.load=PDE_Read(d_index);
 		if (GCC_UNLIKELY(!table.block.p))
 			E_Exit("Pagefault didn't correct table");
 	}
@@ -207,8 +244,7 @@ static INLINE bool InitPageCheckPresence_CheckOnly(PhysPt lin_addr,bool writing,
 	Bitu lin_page=lin_addr >> 12;
 	Bitu d_index=lin_page >> 10;
 	Bitu t_index=lin_page & 0x3ff;
-	Bitu table_addr=(paging.base.page<<12)+d_index*4;
-	table.load=phys_readd(table_addr);
+	table.load=PDE_Read(d_index);
 	if (!table.block.p) {
 		paging.cr2=lin_addr;
 		cpu.exception.which=EXCEPTION_PF;
@@ -376,7 +412,7 @@ public:
 
 			if (!table.block.a) {
 				table.block.a=1;		// set page table accessed
-				phys_writed((paging.base.page<<12)+(lin_page >> 10)*4,table.load);
+				PDE_Update(lin_page >> 10,table.load);
 			}
 			if ((!entry.block.a) || (!entry.block.d)) {
 				entry.block.a=1;		// set page accessed
@@ -455,7 +491,7 @@ public:
 
 			if (!table.block.a) {
 				table.block.a=1;		//Set access
-				phys_writed((paging.base.page<<12)+(lin_page >> 10)*4,table.load);
+				PDE_Update(lin_page >> 10,table.load);
 			}
 			if (!entry.block.a) {
 				entry.block.a=1;					//Set access
@@ -537,7 +573,7 @@ public:
 
 			if (!table.block.a) {
 				table.block.a=1;		//Set access
-				phys_writed((paging.base.page<<12)+(lin_page >> 10)*4,table.load);
+				PDE_Update(lin_page >> 10,table.load);
 			}
 			if ((!entry.block.a) || (!entry.block.d)) {
 				entry.block.a=1;	//Set access
@@ -588,7 +624,7 @@ public:
 
 			if (!table.block.a) {
 				table.block.a=1;		//Set access
-				phys_writed((paging.base.page<<12)+(lin_page >> 10)*4,table.load);
+				PDE_Update(lin_page >> 10,table.load);
 			}
 			if (!entry.block.a) {
 				entry.block.a=1;	//Set access
@@ -609,7 +645,7 @@ bool PAGING_MakePhysPage(Bitu & page) {
 		Bitu d_index=page >> 10;
 		Bitu t_index=page & 0x3ff;
 		X86PageEntry table;
-		table.load=phys_readd((paging.base.page<<12)+d_index*4);
+		table.load=PDE_Read(d_index);
 		if (!table.block.p) return false;
 		X86PageEntry entry;
 		entry.load=phys_readd((table.block.base<<12)+t_index*4);
@@ -652,32 +688,65 @@ void PAGING_InitTLB(void) {
 		paging.tlb.writehandler[i]=&init_page_handler;
 	}
 	paging.links.used=0;
+	CPU_InvalidateStackCache();
+	PDECacheFlush();
 }
 
 void PAGING_ClearTLB(void) {
 	Bit32u * entries=&paging.links.entries[0];
 	for (;paging.links.used>0;paging.links.used--) {
 		Bitu page=*entries++;
+		if (paging.tlb.readhandler[page]==&init_page_handler) continue;	//stale slot, entry already reset
 		paging.tlb.read[page]=0;
 		paging.tlb.write[page]=0;
 		paging.tlb.readhandler[page]=&init_page_handler;
 		paging.tlb.writehandler[page]=&init_page_handler;
 	}
 	paging.links.used=0;
+	CPU_InvalidateStackCache();
+	PDECacheFlush();
 }
 
 void PAGING_UnlinkPages(Bitu lin_page,Bitu pages) {
+	if ((cpu.stack.cached_page>>12)>=lin_page && (cpu.stack.cached_page>>12)<lin_page+pages)
+		CPU_InvalidateStackCache();
+	PDECacheFlush();	// invlpg ends up here, so drop cached pdes as well
 	for (;pages>0;pages--) {
-		paging.tlb.read[lin_page]=0;
-		paging.tlb.write[lin_page]=0;
-		paging.tlb.readhandler[lin_page]=&init_page_handler;
-		paging.tlb.writehandler[lin_page]=&init_page_handler;
+		if (paging.tlb.readhandler[lin_page]!=&init_page_handler) {
+			paging.tlb.read[lin_page]=0;
+			paging.tlb.write[lin_page]=0;
+			paging.tlb.readhandler[lin_page]=&init_page_handler;
+			paging.tlb.writehandler[lin_page]=&init_page_handler;
+		}
 		lin_page++;
 	}
 }
 
+/* Unlinking or remapping a page resets its tlb entry but leaves the old slot
+   in the link table behind, so fault-heavy guests fill the table with dead
+   slots long before that many pages are really linked. When the table runs
+   full, dropping those dead slots (and duplicates) is far cheaper than the
+   refault storm a full ClearTLB causes. Returns false if nothing was freed. */
+static Bit8u paging_link_marks[TLB_SIZE/8];
+
+static bool PAGING_CompactLinks(void) {
+	memset(paging_link_marks,0,sizeof(paging_link_marks));
+	Bitu used=0;
+	for (Bitu i=0;i<paging.links.used;i++) {
+		Bitu page=paging.links.entries[i];
+		if (paging.tlb.readhandler[page]==&init_page_handler) continue;
+		if (paging_link_marks[page>>3] & (1 << (page&7))) continue;
+		paging_link_marks[page>>3] |= (Bit8u)(1 << (page&7));
+		paging.links.entries[used++]=page;
+	}
+	if (used>=paging.links.used) return false;
+	paging.links.used=used;
+	return true;
+}
+
 void PAGING_MapPage(Bitu lin_page,Bitu phys_page) {
 	if (lin_page<LINK_START) {
+		if ((cpu.stack.cached_page>>12)==lin_page) CPU_InvalidateStackCache();
 		paging.firstmb[lin_page]=phys_page;
 		paging.tlb.read[lin_page]=0;
 		paging.tlb.write[lin_page]=0;
@@ -691,14 +760,17 @@ void PAGING_MapPage(Bitu lin_page,Bitu phys_page) {
 void PAGING_LinkPage(Bitu lin_page,Bitu phys_page) {
 	PageHandler * handler=MEM_GetPageHandler(phys_page);
 	Bitu lin_base=lin_page << 12;
-	if (lin_page>=TLB_SIZE || phys_page>=TLB_SIZE) 
+	if (lin_page>=TLB_SIZE || phys_page>=TLB_SIZE)
 		E_Exit("Illegal page");
 
 	if (paging.links.used>=PAGING_LINKS) {
-		LOG(LOG_PAGING,LOG_NORMAL)("Not enough paging links, resetting cache");
-		PAGING_ClearTLB();
+		if (!PAGING_CompactLinks()) {
+			LOG(LOG_PAGING,LOG_NORMAL)("Not enough paging links, resetting cache");
+			PAGING_ClearTLB();
+		}
 	}
 
+	if ((cpu.stack.cached_page>>12)==lin_page) CPU_InvalidateStackCache();
 	paging.tlb.phys_page[lin_page]=phys_page;
 	if (handler->flags & PFLAG_READABLE) paging.tlb.read[lin_page]=handler->GetHostReadPt(phys_page)-lin_base;
 	else paging.tlb.read[lin_page]=0;
@@ -713,14 +785,17 @@ void PAGING_LinkPage(Bitu lin_page,Bitu phys_page) {
 void PAGING_LinkPage_ReadOnly(Bitu lin_page,Bitu phys_page) {
 	PageHandler * handler=MEM_GetPageHandler(phys_page);
 	Bitu lin_base=lin_page << 12;
-	if (lin_page>=TLB_SIZE || phys_page>=TLB_SIZE) 
+	if (lin_page>=TLB_SIZE || phys_page>=TLB_SIZE)
 		E_Exit("Illegal page");
 
 	if (paging.links.used>=PAGING_LINKS) {
-		LOG(LOG_PAGING,LOG_NORMAL)("Not enough paging links, resetting cache");
-		PAGING_ClearTLB();
+		if (!PAGING_CompactLinks()) {
+			LOG(LOG_PAGING,LOG_NORMAL)("Not enough paging links, resetting cache");
+			PAGING_ClearTLB();
+		}
 	}
 
+	if ((cpu.stack.cached_page>>12)==lin_page) CPU_InvalidateStackCache();
 	paging.tlb.phys_page[lin_page]=phys_page;
 	if (handler->flags & PFLAG_READABLE) paging.tlb.read[lin_page]=handler->GetHostReadPt(phys_page)-lin_base;
 	else paging.tlb.read[lin_page]=0;
@@ -751,6 +826,8 @@ void PAGING_InitTLBBank(tlb_entry **bank) {
 void PAGING_InitTLB(void) {
 	InitTLBInt(paging.tlbh);
  	paging.links.used=0;
+	CPU_InvalidateStackCache();
+	PDECacheFlush();
 }
 
 void PAGING_ClearTLB(void) {
@@ -758,27 +835,55 @@ void PAGING_ClearTLB(void) {
 	for (;paging.links.used>0;paging.links.used--) {
 		Bitu page=*entries++;
 		tlb_entry *entry = get_tlb_entry(page<<12);
+		if (entry->readhandler==&init_page_handler) continue;	//stale slot, entry already reset
 		entry->read=0;
 		entry->write=0;
 		entry->readhandler=&init_page_handler;
 		entry->writehandler=&init_page_handler;
 	}
 	paging.links.used=0;
+	CPU_InvalidateStackCache();
+	PDECacheFlush();
 }
 
 void PAGING_UnlinkPages(Bitu lin_page,Bitu pages) {
+	if ((cpu.stack.cached_page>>12)>=lin_page && (cpu.stack.cached_page>>12)<lin_page+pages)
+		CPU_InvalidateStackCache();
+	PDECacheFlush();	// invlpg ends up here, so drop cached pdes as well
 	for (;pages>0;pages--) {
 		tlb_entry *entry = get_tlb_entry(lin_page<<12);
-		entry->read=0;
-		entry->write=0;
-		entry->readhandler=&init_page_handler;
-		entry->writehandler=&init_page_handler;
+		if (entry->readhandler!=&init_page_handler) {
+			entry->read=0;
+			entry->write=0;
+			entry->readhandler=&init_page_handler;
+			entry->writehandler=&init_page_handler;
+		}
 		lin_page++;
 	}
 }
 
+/* Same idea as the full tlb variant: drop dead and duplicate slots from the
+   link table before falling back to a full reset. */
+static Bit8u paging_link_marks[(TLB_SIZE*(TLB_BANKS+1))/8];
+
+static bool PAGING_CompactLinks(void) {
+	memset(paging_link_marks,0,sizeof(paging_link_marks));
+	Bitu used=0;
+	for (Bitu i=0;i<paging.links.used;i++) {
+		Bitu page=paging.links.entries[i];
+		if (get_tlb_entry(page<<12)->readhandler==&init_page_handler) continue;
+		if (paging_link_marks[page>>3] & (1 << (page&7))) continue;
+		paging_link_marks[page>>3] |= (Bit8u)(1 << (page&7));
+		paging.links.entries[used++]=page;
+	}
+	if (used>=paging.links.used) return false;
+	paging.links.used=used;
+	return true;
+}
+
 void PAGING_MapPage(Bitu lin_page,Bitu phys_page) {
 	if (lin_page<LINK_START) {
+		if ((cpu.stack.cached_page>>12)==lin_page) CPU_InvalidateStackCache();
 		paging.firstmb[lin_page]=phys_page;
 		paging.tlbh[lin_page].read=0;
 		paging.tlbh[lin_page].write=0;
@@ -792,14 +897,17 @@ void PAGING_MapPage(Bitu lin_page,Bitu phys_page) {
 void PAGING_LinkPage(Bitu lin_page,Bitu phys_page) {
 	PageHandler * handler=MEM_GetPageHandler(phys_page);
 	Bitu lin_base=lin_page << 12;
-	if (lin_page>=(TLB_SIZE*(TLB_BANKS+1)) || phys_page>=(TLB_SIZE*(TLB_BANKS+1))) 
+	if (lin_page>=(TLB_SIZE*(TLB_BANKS+1)) || phys_page>=(TLB_SIZE*(TLB_BANKS+1)))
 		E_Exit("Illegal page");
 
 	if (paging.links.used>=PAGING_LINKS) {
-		LOG(LOG_PAGING,LOG_NORMAL)("Not enough paging links, resetting cache");
-		PAGING_ClearTLB();
+		if (!PAGING_CompactLinks()) {
+			LOG(LOG_PAGING,LOG_NORMAL)("Not enough paging links, resetting cache");
+			PAGING_ClearTLB();
+		}
 	}
 
+	if ((cpu.stack.cached_page>>12)==lin_page) CPU_InvalidateStackCache();
 	tlb_entry *entry = get_tlb_entry(lin_base);
 	entry->phys_page=phys_page;
 	if (handler->flags & PFLAG_READABLE) entry->read=handler->GetHostReadPt(phys_page)-lin_base;
@@ -815,14 +923,17 @@ void PAGING_LinkPage(Bitu lin_page,Bitu phys_page) {
 void PAGING_LinkPage_ReadOnly(Bitu lin_page,Bitu phys_page) {
 	PageHandler * handler=MEM_GetPageHandler(phys_page);
 	Bitu lin_base=lin_page << 12;
-	if (lin_page>=(TLB_SIZE*(TLB_BANKS+1)) || phys_page>=(TLB_SIZE*(TLB_BANKS+1))) 
+	if (lin_page>=(TLB_SIZE*(TLB_BANKS+1)) || phys_page>=(TLB_SIZE*(TLB_BANKS+1)))
 		E_Exit("Illegal page");
 
 	if (paging.links.used>=PAGING_LINKS) {
-		LOG(LOG_PAGING,LOG_NORMAL)("Not enough paging links, resetting cache");
-		PAGING_ClearTLB();
+		if (!PAGING_CompactLinks()) {
+			LOG(LOG_PAGING,LOG_NORMAL)("Not enough paging links, resetting cache");
+			PAGING_ClearTLB();
+		}
 	}
 
+	if ((cpu.stack.cached_page>>12)==lin_page) CPU_InvalidateStackCache();
 	tlb_entry *entry = get_tlb_entry(lin_base);
 	entry->phys_page=phys_page;
 	if (handler->flags & PFLAG_READABLE) entry->read=handler->GetHostReadPt(phys_page)-lin_base;
@@ -836,12 +947,32 @@ void PAGING_LinkPage_ReadOnly(Bitu lin_page,Bitu phys_page) {
 
 #endif
 
+/* Remap a run of linear pages in one operation, invalidating just their own
+   tlb entries instead of clearing the whole link cache. With paging disabled
+   the new backing is linked right away so the first access after a remap
+   already takes the fast path; with paging enabled the old backing might be
+   visible through other linear addresses as well, so fall back to a full
+   clear like the per-page path did. */
+void PAGING_MapPages(Bitu lin_page,const Bitu * phys_pages,Bitu pages) {
+	for (Bitu i=0;i<pages;i++) {
+		const Bitu lin=lin_page+i;
+		if (lin<LINK_START) {
+			paging.firstmb[lin]=(Bit32u)phys_pages[i];
+			PAGING_UnlinkPages(lin,1);
+			if (!paging.enabled) PAGING_LinkPage(lin,phys_pages[i]);
+		} else {
+			PAGING_LinkPage(lin,phys_pages[i]);
+		}
+	}
+	if (paging.enabled) PAGING_ClearTLB();
+}
 
 void PAGING_SetDirBase(Bitu cr3) {
 	paging.cr3=cr3;
 	
 	paging.base.page=cr3 >> 12;
 	paging.base.addr=cr3 & ~4095;
+	PDECacheFlush();	// cached pdes belong to the old directory
 //	LOG(LOG_PAGING,LOG_NORMAL)("CR3:%X Base %X",cr3,paging.base.page);
 	if (paging.enabled) {
 		PAGING_ClearTLB();
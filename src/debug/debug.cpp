@@ -21,7 +21,9 @@
 #if C_DEBUG
 
 #include <string.h>
+#include <algorithm>
 #include <list>
+#include <map>
 #include <vector>
 #include <ctype.h>
 #include <fstream>
@@ -43,6 +45,7 @@ using namespace std;
 #include "timer.h"
 #include "paging.h"
 #include "support.h"
+#include "memarena.h"
 #include "shell.h"
 #include "programs.h"
 #include "debug_inc.h"
@@ -64,6 +67,8 @@ static void DrawCode(void);
 static void DEBUG_RaiseTimerIrq(void);
 static void SaveMemory(Bit16u seg, Bit32u ofs1, Bit32u num);
 static void SaveMemoryBin(Bit16u seg, Bit32u ofs1, Bit32u num);
+static void SnapshotMemory(Bit16u seg, Bit32u ofs1, Bit8u* buf, Bitu num);
+static void SearchMemory(Bit16u seg, Bit32u ofs1, Bit32u num, Bit8u* pat, Bitu patlen);
 static void LogMCBS(void);
 static void LogGDT(void);
 static void LogLDT(void);
@@ -112,6 +117,46 @@ bool	logHeavy	= false;
 #endif
 
 
+// Sampling profiler of guest execution; PIC_RunQueue feeds it one
+// cs:eip sample per emulated millisecond while it is enabled
+#define PROFILE_MAXSAMPLES	65536
+static Bit32u	profileSamples[PROFILE_MAXSAMPLES];
+static Bitu		profileHead		= 0;
+static Bitu		profileCount	= 0;
+bool	DEBUG_Profiling	= false;
+
+void DEBUG_ProfileSample(void) {
+	profileSamples[profileHead++] = SegPhys(cs)+reg_eip;
+	if (profileHead >= PROFILE_MAXSAMPLES) profileHead = 0;
+	profileCount++;
+}
+
+static bool ProfileBucketUsed(const pair<Bit32u,Bit32u>& a,const pair<Bit32u,Bit32u>& b) {
+	return a.second > b.second;
+}
+
+static void LogProfile(void) {
+	Bitu stored = (profileCount < PROFILE_MAXSAMPLES) ? profileCount : PROFILE_MAXSAMPLES;
+	if (!stored) {
+		DEBUG_ShowMsg("DEBUG: No profile samples collected. Use PROFILE to start sampling.\n");
+		return;
+	}
+	// flat profile, bucketed per 256 byte region of physical address space
+	map<Bit32u,Bit32u> buckets;
+	for (Bitu i=0; i<stored; i++) buckets[profileSamples[i]>>8]++;
+	vector< pair<Bit32u,Bit32u> > flat(buckets.begin(),buckets.end());
+	sort(flat.begin(),flat.end(),ProfileBucketUsed);
+	DEBUG_ShowMsg("DEBUG: Profile: %u samples kept of %u taken, %u hot regions:\n",
+		(Bit32u)stored,(Bit32u)profileCount,(Bit32u)flat.size());
+	Bitu shown = (flat.size() < 16) ? flat.size() : 16;
+	for (Bitu i=0; i<shown; i++) {
+		Bit32u base = flat[i].first << 8;
+		DEBUG_ShowMsg("  %08X-%08X %6u samples (%5.1f%%)\n",base,base+0xff,
+			flat[i].second,flat[i].second*100.0/stored);
+	}
+}
+
+
 
 static struct  {
 	Bit32u eax,ebx,ecx,edx,esi,edi,ebp,esp,eip;
@@ -316,6 +361,8 @@ public:
 	static void				ActivateBreakpointsExceptAt(PhysPt adr);
 	static bool				CheckBreakpoint		(PhysPt adr);
 	static bool				CheckBreakpoint		(Bitu seg, Bitu off);
+	static bool				CheckMemoryBreakpoints(void);
+	static void				UpdateMemoryWatches	(void);
 	static bool				CheckIntBreakpoint	(PhysPt adr, Bit8u intNr, Bit16u ahValue, Bit16u alValue);
 	static CBreakpoint*		FindPhysBreakpoint	(Bit16u seg, Bit32u off, bool once);
 	static CBreakpoint*		FindOtherActiveBreakpoint(PhysPt adr, CBreakpoint* skip);
@@ -427,6 +474,7 @@ void CBreakpoint::ActivateBreakpoints()
 	std::list<CBreakpoint*>::iterator i;
 	for (i = BPoints.begin(); i != BPoints.end(); ++i)
 		(*i)->Activate(true);
+	UpdateMemoryWatches();
 }
 
 void CBreakpoint::DeactivateBreakpoints()
@@ -435,6 +483,7 @@ void CBreakpoint::DeactivateBreakpoints()
 	std::list<CBreakpoint*>::iterator i;
 	for (i = BPoints.begin(); i != BPoints.end(); ++i)
 		(*i)->Activate(false);
+	UpdateMemoryWatches();
 }
 
 void CBreakpoint::ActivateBreakpointsExceptAt(PhysPt adr)
@@ -448,8 +497,136 @@ void CBreakpoint::ActivateBreakpointsExceptAt(PhysPt adr)
 			continue;
 		bp->Activate(true);
 	};
+	UpdateMemoryWatches();
+};
+
+/* Page-protection watchpoint engine. Re-reading every watched byte
+   after each instruction is what makes memory breakpoints slow the
+   whole machine down; instead a trapping PageHandler is swapped onto
+   each watched physical page. Reads keep their direct TLB mapping,
+   only writes to a watched page take the virtual-call detour that
+   rechecks the breakpoints, and while the traps cover every watch the
+   per-instruction poll skips memory breakpoints entirely. Falls back
+   to polling when a watch cannot be resolved to a page or there are
+   more pages than trap slots. */
+#define MEMWATCH_MAX 8
+
+static bool memwatch_active = false;
+
+class CMemWatchHandler : public PageHandler {
+public:
+	CMemWatchHandler(void) : old_handler(0), phys_page(0) { flags = PFLAG_NOCODE; }
+	void Install(Bitu page) {
+		old_handler = MEM_GetPageHandler(page);
+		phys_page = page;
+		// reads stay as fast as the original mapping allows; the
+		// missing PFLAG_WRITEABLE forces writes through the hooks
+		flags = (old_handler->flags & PFLAG_READABLE) | PFLAG_NOCODE;
+		MEM_SetPageHandler(page,1,this);
+	}
+	void Uninstall(void) {
+		if (!old_handler) return;
+		MEM_SetPageHandler(phys_page,1,old_handler);
+		old_handler = 0;
+	}
+	bool IsInstalled(void) const { return old_handler != 0; }
+
+	Bitu readb(PhysPt addr) { return old_handler->readb(addr); }
+	Bitu readw(PhysPt addr) { return old_handler->readw(addr); }
+	Bitu readd(PhysPt addr) { return old_handler->readd(addr); }
+	HostPt GetHostReadPt(Bitu page) { return old_handler->GetHostReadPt(page); }
+	void writeb(PhysPt addr,Bitu val) {
+		if (old_handler->flags & PFLAG_WRITEABLE)
+			host_writeb(old_handler->GetHostWritePt(phys_page)+(addr&0xfff),(Bit8u)val);
+		else old_handler->writeb(addr,val);
+		if (CBreakpoint::CheckMemoryBreakpoints()) DEBUG_EnableDebugger();
+	}
+	void writew(PhysPt addr,Bitu val) {
+		if (old_handler->flags & PFLAG_WRITEABLE)
+			host_writew(old_handler->GetHostWritePt(phys_page)+(addr&0xfff),(Bit16u)val);
+		else old_handler->writew(addr,val);
+		if (CBreakpoint::CheckMemoryBreakpoints()) DEBUG_EnableDebugger();
+	}
+	void writed(PhysPt addr,Bitu val) {
+		if (old_handler->flags & PFLAG_WRITEABLE)
+			host_writed(old_handler->GetHostWritePt(phys_page)+(addr&0xfff),(Bit32u)val);
+		else old_handler->writed(addr,val);
+		if (CBreakpoint::CheckMemoryBreakpoints()) DEBUG_EnableDebugger();
+	}
+private:
+	PageHandler* old_handler;
+	Bitu phys_page;
 };
 
+static CMemWatchHandler memwatch[MEMWATCH_MAX];
+
+bool CBreakpoint::CheckMemoryBreakpoints(void)
+// Re-reads all active memory breakpoints; true if a watched value changed
+{
+	std::list<CBreakpoint*>::iterator i;
+	for (i=BPoints.begin(); i != BPoints.end(); ++i) {
+		CBreakpoint* bp = (*i);
+		if (!bp->IsActive()) continue;
+		if ((bp->GetType()!=BKPNT_MEMORY) && (bp->GetType()!=BKPNT_MEMORY_PROT) && (bp->GetType()!=BKPNT_MEMORY_LINEAR)) continue;
+		if (bp->GetType()==BKPNT_MEMORY_PROT) {
+			if (!cpu.pmode) continue;
+			Descriptor desc;
+			if (!cpu.gdt.GetDescriptor(bp->GetSegment(),desc)) continue;
+			if (desc.GetLimit()==0) continue;
+		}
+		Bitu address;
+		if (bp->GetType()==BKPNT_MEMORY_LINEAR) address = bp->GetOffset();
+		else address = GetAddress(bp->GetSegment(),bp->GetOffset());
+		Bit8u value=0;
+		if (mem_readb_checked(address,&value)) continue;
+		if (bp->GetValue() != value) {
+			DEBUG_ShowMsg("DEBUG: Memory breakpoint %s: %04X:%04X - %02X -> %02X\n",(bp->GetType()==BKPNT_MEMORY_PROT)?"(Prot)":"",bp->GetSegment(),bp->GetOffset(),bp->GetValue(),value);
+			bp->SetValue(value);
+			return true;
+		}
+	}
+	return false;
+}
+
+void CBreakpoint::UpdateMemoryWatches(void)
+{
+	Bitu n;
+	for (n=0;n<MEMWATCH_MAX;n++) memwatch[n].Uninstall();
+	memwatch_active = false;
+
+	Bitu pages[MEMWATCH_MAX];
+	Bitu count = 0;
+	bool failed = false;
+	std::list<CBreakpoint*>::iterator i;
+	for (i=BPoints.begin(); i != BPoints.end(); ++i) {
+		CBreakpoint* bp = (*i);
+		if (!bp->IsActive()) continue;
+		if ((bp->GetType()!=BKPNT_MEMORY) && (bp->GetType()!=BKPNT_MEMORY_PROT) && (bp->GetType()!=BKPNT_MEMORY_LINEAR)) continue;
+		Bitu address;
+		if (bp->GetType()==BKPNT_MEMORY_LINEAR) address = bp->GetOffset();
+		else address = GetAddress(bp->GetSegment(),bp->GetOffset());
+		Bit8u value;
+		// the read also primes the TLB entry so the page translation
+		// below is valid, and snapshots the baseline value
+		if (mem_readb_checked(address,&value)) { failed = true; break; }
+		bp->SetValue(value);
+		Bitu page = PAGING_GetPhysicalPage(address) >> 12;
+		Bitu m;
+		for (m=0;m<count;m++) if (pages[m]==page) break;
+		if (m==count) {
+			if (count==MEMWATCH_MAX) { failed = true; break; }
+			pages[count++] = page;
+		}
+	}
+	if (failed || !count) {
+		PAGING_ClearTLB();
+		return; // the per-instruction poll covers whatever is left
+	}
+	for (n=0;n<count;n++) memwatch[n].Install(pages[n]);
+	memwatch_active = true;
+	PAGING_ClearTLB();
+}
+
 bool CBreakpoint::CheckBreakpoint(Bitu seg, Bitu off)
 // Checks if breakpoint is valid and should stop execution
 {
@@ -480,8 +657,9 @@ bool CBreakpoint::CheckBreakpoint(Bitu seg, Bitu off)
 			return true;
 		} 
 #if C_HEAVY_DEBUG
-		// Memory breakpoint support
-		else if (bp->IsActive()) {
+		// Memory breakpoint support; skipped while the page-protection
+		// traps cover every watch
+		else if (bp->IsActive() && !memwatch_active) {
 			if ((bp->GetType()==BKPNT_MEMORY) || (bp->GetType()==BKPNT_MEMORY_PROT) || (bp->GetType()==BKPNT_MEMORY_LINEAR)) {
 				// Watch Protected Mode Memoryonly in pmode
 				if (bp->GetType()==BKPNT_MEMORY_PROT) {
@@ -683,8 +861,9 @@ static bool StepOver()
 			CBreakpoint::AddBreakpoint(SegValue(cs),reg_eip+size, true);
 		debugging=false;
 		DrawCode();
+		doupdate();
 		return true;
-	} 
+	}
 	return false;
 };
 
@@ -692,6 +871,7 @@ bool DEBUG_ExitLoop(void)
 {
 #if C_HEAVY_DEBUG
 	DrawVariables();
+	doupdate();
 #endif
 
 	if (exitLoop) {
@@ -724,7 +904,7 @@ static void DrawData(void) {
 			add++;
 		};
 	}	
-	wrefresh(dbg.win_data);
+	wnoutrefresh(dbg.win_data);
 };
 
 static void DrawRegisters(void) {
@@ -797,16 +977,31 @@ static void DrawRegisters(void) {
 
 	wattrset(dbg.win_reg,0);
 	mvwprintw(dbg.win_reg,3,60,"%u       ",cycle_count);
-	wrefresh(dbg.win_reg);
+	wnoutrefresh(dbg.win_reg);
 };
 
+/* decode cache for the code view; DasmI386 per line per refresh is what
+   makes single-stepping with the GUI open crawl. Entries revalidate
+   against the instruction bytes, which the hex column reads anyway, so
+   self-modifying code shows up without any write hooks */
+#define DISASM_CACHE_SIZE 64
+static struct DisasmCacheEntry {
+	PhysPt start;
+	Bit32u eip;
+	bool big;
+	bool valid;
+	Bit8u size;
+	Bit8u bytes[16];
+	char text[80];
+} disasmCache[DISASM_CACHE_SIZE];
+
 static void DrawCode(void) {
-	bool saveSel; 
+	bool saveSel;
 	Bit32u disEIP = codeViewData.useEIP;
 	PhysPt start  = GetAddress(codeViewData.useCS,codeViewData.useEIP);
 	char dline[200];Bitu size;Bitu c;
 	static char line20[21] = "                    ";
-	
+
 	for (int i=0;i<10;i++) {
 		saveSel = false;
 		if (has_colors()) {
@@ -833,15 +1028,35 @@ static void DrawCode(void) {
 		}
 
 
-		Bitu drawsize=size=DasmI386(dline, start, disEIP, cpu.code.big);
+		Bit8u instrBytes[16];
+		for (c=0;c<16;c++) {
+			if (mem_readb_checked(start+c,&instrBytes[c])) instrBytes[c]=0;
+		}
+		DisasmCacheEntry* cached = &disasmCache[start & (DISASM_CACHE_SIZE-1)];
+		if (cached->valid && cached->start==start && cached->eip==disEIP &&
+		    cached->big==cpu.code.big &&
+		    memcmp(cached->bytes,instrBytes,cached->size)==0) {
+			strcpy(dline,cached->text);
+			size=cached->size;
+		} else {
+			size=DasmI386(dline, start, disEIP, cpu.code.big);
+			if (size<=16 && strlen(dline)<sizeof(cached->text)) {
+				cached->start=start;
+				cached->eip=disEIP;
+				cached->big=cpu.code.big;
+				cached->size=(Bit8u)size;
+				memcpy(cached->bytes,instrBytes,size);
+				strcpy(cached->text,dline);
+				cached->valid=true;
+			} else cached->valid=false;
+		}
+		Bitu drawsize=size;
 		bool toolarge = false;
 		mvwprintw(dbg.win_code,i,0,"%04X:%04X  ",codeViewData.useCS,disEIP);
-		
+
 		if (drawsize>10) { toolarge = true; drawsize = 9; };
 		for (c=0;c<drawsize;c++) {
-			Bit8u value;
-			if (mem_readb_checked(start+c,&value)) value=0;
-			wprintw(dbg.win_code,"%02X",value);
+			wprintw(dbg.win_code,"%02X",instrBytes[c]);
 		}
 		if (toolarge) { waddstr(dbg.win_code,".."); drawsize++; };
 		// Spacepad up to 20 characters
@@ -895,7 +1110,7 @@ static void DrawCode(void) {
 	}
 
 	wattrset(dbg.win_code,0);
-	wrefresh(dbg.win_code);
+	wnoutrefresh(dbg.win_code);
 }
 
 static void SetCodeWinStart()
@@ -1031,6 +1246,26 @@ bool ParseCommand(char* str) {
 		return true;
 	};
 
+	if (command == "MEMS") { // Show host memory accounting
+		ARENA_LogUsage();
+		return true;
+	};
+
+	if (command == "MEMSEARCH") { // Search byte pattern in memory
+		Bit16u seg = (Bit16u)GetHexValue(found,found); found++;
+		Bit32u ofs = GetHexValue(found,found); found++;
+		Bit32u num = GetHexValue(found,found); found++;
+		Bit8u pattern[128];
+		Bitu patlen = 0;
+		while (patlen < sizeof(pattern)) {
+			while (*found == ' ') found++;
+			if (!*found) break;
+			pattern[patlen++] = (Bit8u)GetHexValue(found,found);
+		}
+		SearchMemory(seg,ofs,num,pattern,patlen);
+		return true;
+	};
+
 	if (command == "IV") { // Insert variable
 		Bit16u seg = (Bit16u)GetHexValue(found,found); found++;
 		Bit32u ofs = (Bit16u)GetHexValue(found,found); found++;
@@ -1076,6 +1311,12 @@ bool ParseCommand(char* str) {
 		return true;
 	};
 
+	if (command == "BINLOG") { // Format and flush the binary log ring
+		BINLOG_Dump();
+		DEBUG_ShowMsg("DEBUG: Binary log flushed.\n");
+		return true;
+	};
+
 	if (command == "SR") { // Set register value
 		DEBUG_ShowMsg("DEBUG: Set Register %s.\n",(ChangeRegister(found)?"success":"failure"));
 		return true;
@@ -1251,6 +1492,7 @@ bool ParseCommand(char* str) {
 		CBreakpoint::ActivateBreakpointsExceptAt(SegPhys(cs)+reg_eip-1);
 		debugging = false;
 		DrawCode();
+		doupdate();
 		DOSBOX_SetNormalLoop();
 		CPU_HW_Interrupt(intNr);
 		return true;
@@ -1304,11 +1546,26 @@ bool ParseCommand(char* str) {
 	};
 
 	if(command == "TIMERIRQ") { //Start a timer irq
-		DEBUG_RaiseTimerIrq(); 
+		DEBUG_RaiseTimerIrq();
 		DEBUG_ShowMsg("Debug: Timer Int started.\n");
 		return true;
 	};
 
+	if (command == "PROFILE") { // Toggle guest-code sampling / show report
+		stream >> command;
+		if (command == "REPORT") {
+			LogProfile();
+			return true;
+		}
+		DEBUG_Profiling = !DEBUG_Profiling;
+		if (DEBUG_Profiling) {
+			profileHead = 0;
+			profileCount = 0;
+		}
+		DEBUG_ShowMsg("DEBUG: Guest-code sampling %s.\n",DEBUG_Profiling?"started":"stopped");
+		return true;
+	};
+
 
 #if C_HEAVY_DEBUG
 	if (command == "HEAVYLOG") { // Create Cpu log file
@@ -1355,9 +1612,12 @@ bool ParseCommand(char* str) {
 		DEBUG_ShowMsg("LV [filename]             - Load var list from file.\n");
 
 		DEBUG_ShowMsg("ADDLOG [message]          - Add message to the log file.\n");
+		DEBUG_ShowMsg("BINLOG                    - Format and flush the binary log ring.\n");
 
 		DEBUG_ShowMsg("MEMDUMP [seg]:[off] [len] - Write memory to file memdump.txt.\n");
 		DEBUG_ShowMsg("MEMDUMPBIN [s]:[o] [len]  - Write memory to file memdump.bin.\n");
+		DEBUG_ShowMsg("MEMSEARCH [s]:[o] [len] [byte] [.].. - Search byte pattern in memory.\n");
+		DEBUG_ShowMsg("MEMS                      - Show host memory use per subsystem.\n");
 		DEBUG_ShowMsg("SELINFO [segName]         - Show selector info.\n");
 
 		DEBUG_ShowMsg("INTVEC [filename]         - Writes interrupt vector table to file.\n");
@@ -1368,6 +1628,7 @@ bool ParseCommand(char* str) {
 		DEBUG_ShowMsg("LDT                       - Lists descriptors of the LDT.\n");
 		DEBUG_ShowMsg("IDT                       - Lists descriptors of the IDT.\n");
 		DEBUG_ShowMsg("PAGING [page]             - Display content of page table.\n");
+		DEBUG_ShowMsg("PROFILE [report]          - Toggle guest-code sampling / show flat profile.\n");
 		DEBUG_ShowMsg("EXTEND                    - Toggle additional info.\n");
 		DEBUG_ShowMsg("TIMERIRQ                  - Run the system timer.\n");
 
@@ -1717,6 +1978,7 @@ Bit32u DEBUG_CheckKeys(void) {
 		case KEY_F(5):	// Run Program
 				debugging=false;
 				DrawCode(); // update code window to show "running" status
+				doupdate();
 
 				skipFirstInstruction = true; // for heavy debugger
 				CPU_Cycles = 1;
@@ -1868,6 +2130,9 @@ void DEBUG_DrawScreen(void) {
 	DrawCode();
 	DrawRegisters();
 	DrawVariables();
+	/* panels above only mark their windows dirty; one doupdate pushes
+	   the whole batch to the terminal */
+	doupdate();
 }
 
 static void DEBUG_RaiseTimerIrq(void) {
@@ -2360,16 +2625,63 @@ static void SaveMemoryBin(Bit16u seg, Bit32u ofs1, Bit32u num) {
 		return;
 	}
 
-	for (Bitu x = 0; x < num;x++) {
-		Bit8u val;
-		if (mem_readb_checked(GetAddress(seg,ofs1+x),&val)) val=0;
-		fwrite(&val,1,1,f);
-	}
+	Bit8u* buf = new Bit8u[num ? num : 1];
+	SnapshotMemory(seg,ofs1,buf,num);
+	fwrite(buf,1,num,f);
+	delete [] buf;
 
 	fclose(f);
 	DEBUG_ShowMsg("DEBUG: Memory dump binary success.\n");
 }
 
+/* bulk snapshot of guest memory; reads page-wise through MEM_BlockRead
+   (which memcpys whole TLB runs) instead of a mem_readb per byte, and
+   zero-fills unmapped pages so a scan over a partially committed arena
+   cannot fault inside the debugger */
+static void SnapshotMemory(Bit16u seg, Bit32u ofs1, Bit8u* buf, Bitu num) {
+	Bitu done = 0;
+	while (done < num) {
+		PhysPt address = GetAddress(seg,ofs1+(Bit32u)done);
+		Bitu chunk = 4096 - (address & 4095);
+		if (chunk > num - done) chunk = num - done;
+		Bit8u probe;
+		if (mem_readb_checked(address,&probe)) memset(buf+done,0,chunk);
+		else MEM_BlockRead(address,buf+done,chunk);
+		done += chunk;
+	}
+}
+
+#define SEARCH_MAX_SHOWN 32
+
+static void SearchMemory(Bit16u seg, Bit32u ofs1, Bit32u num, Bit8u* pat, Bitu patlen) {
+	if (!patlen || patlen > num) {
+		DEBUG_ShowMsg("DEBUG: No pattern given.\n");
+		return;
+	}
+	/* scan a snapshot with memchr/memcmp; the libc versions are
+	   vectorized and beat per-byte guest reads by orders of magnitude
+	   on the multi-megabyte ranges cheat-table scans cover */
+	Bit8u* buf = new Bit8u[num];
+	SnapshotMemory(seg,ofs1,buf,num);
+	Bitu hits = 0;
+	Bit8u* cur = buf;
+	Bit8u* end = buf + num - patlen + 1;
+	while (cur < end) {
+		Bit8u* hit = (Bit8u*)memchr(cur,pat[0],end-cur);
+		if (!hit) break;
+		if (patlen == 1 || memcmp(hit+1,pat+1,patlen-1) == 0) {
+			if (hits < SEARCH_MAX_SHOWN)
+				DEBUG_ShowMsg("DEBUG: Match at %04X:%08X\n",seg,ofs1+(Bit32u)(hit-buf));
+			hits++;
+		}
+		cur = hit + 1;
+	}
+	if (hits > SEARCH_MAX_SHOWN)
+		DEBUG_ShowMsg("DEBUG: (further matches not listed)\n");
+	DEBUG_ShowMsg("DEBUG: %d match(es) in %d bytes.\n",(int)hits,(int)num);
+	delete [] buf;
+}
+
 static void OutputVecTable(char* filename) {
 	FILE* f = fopen(filename, "wt");
 	if (!f)
@@ -2428,7 +2740,7 @@ static void DrawVariables(void) {
 		}
 	}
 
-	if (windowchanges) wrefresh(dbg.win_var);
+	if (windowchanges) wnoutrefresh(dbg.win_var);
 };
 #undef DEBUG_VAR_BUF_LEN
 // HEAVY DEBUGGING STUFF
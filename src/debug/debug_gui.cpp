@@ -82,7 +82,10 @@ void DEBUG_ShowMsg(char const* format,...) {
 
 	logBuffPos = logBuff.end();
 	wprintw(dbg.win_out,"%s",buf);
-	wrefresh(dbg.win_out);
+	/* batch with any window marked dirty above (e.g. the repage);
+	   doupdate pushes everything in one terminal write */
+	wnoutrefresh(dbg.win_out);
+	doupdate();
 }
 
 void DEBUG_RefreshPage(char scroll) {
@@ -94,7 +97,9 @@ void DEBUG_RefreshPage(char scroll) {
 	int rem_lines = maxy;
 	if(rem_lines == -1) return;
 
-	wclear(dbg.win_out);
+	/* werase, not wclear; a full clearok repaint per scroll step makes
+	   paging through the log flicker and hammer the terminal */
+	werase(dbg.win_out);
 
 	while (rem_lines > 0 && i!=logBuff.begin()) {
 		--i;
@@ -104,18 +109,176 @@ void DEBUG_RefreshPage(char scroll) {
 		mvwprintw(dbg.win_out,rem_lines-1, 0, const_cast<char*>((*i).c_str()));
 	}
 	mvwprintw(dbg.win_out,maxy-1, 0, "");
-	wrefresh(dbg.win_out);
+	wnoutrefresh(dbg.win_out);
+	doupdate();
+}
+
+/* Binary deferred logging. With binarylog=true in [log], messages from
+   enabled groups are captured as raw records (the format string literal
+   doubles as the message id, arguments are copied unformatted) into a
+   fixed ring written only by the emulation thread. Formatting happens
+   once, when the ring is dumped at shutdown or by the BINLOG debugger
+   command, so leaving detailed device logging on costs a format-string
+   scan and a few stores per message instead of a vsprintf and a curses
+   update. */
+#define BINLOG_RECORDS 16384
+#define BINLOG_ARGS 4
+#define BINLOG_STRLEN 32
+
+struct BinLogRecord {
+	const char* format;
+	Bit32u cycles;
+	Bit8u type;
+	Bit8u severity;
+	Bit8u argcount;
+	Bit8u strmask;	/* which args index strpool instead of holding a value */
+	Bit64u args[BINLOG_ARGS];
+	char strpool[2][BINLOG_STRLEN];
+};
+
+static BinLogRecord* binlog = NULL;
+static Bitu binlog_head = 0;
+static Bitu binlog_count = 0;
+static bool binlog_enabled = false;
+
+/* capture the arguments a printf of this format would consume; false
+   means an unsupported conversion and the caller formats as text */
+static bool BINLOG_Record(Bit8u type,Bit8u severity,const char* format,va_list args) {
+	BinLogRecord* r = &binlog[binlog_head];
+	r->format = format;
+	r->cycles = static_cast<Bit32u>(cycle_count);
+	r->type = type;
+	r->severity = severity;
+	r->strmask = 0;
+	Bitu argn = 0, strn = 0;
+	const char* f = format;
+	while (*f) {
+		if (*f++ != '%') continue;
+		if (*f == '%') { f++; continue; }
+		while (*f && strchr("-+ #0.123456789",*f)) f++;
+		Bitu longs = 0;
+		while (*f == 'l') { longs++; f++; }
+		while (*f == 'h') f++;
+		if (argn == BINLOG_ARGS) return false;
+		switch (*f) {
+		case 'd': case 'i': case 'c':
+			if (longs>=2) r->args[argn++] = (Bit64u)va_arg(args,long long);
+			else if (longs) r->args[argn++] = (Bit64u)va_arg(args,long);
+			else r->args[argn++] = (Bit64u)(Bit64s)va_arg(args,int);
+			break;
+		case 'u': case 'o': case 'x': case 'X':
+			if (longs>=2) r->args[argn++] = (Bit64u)va_arg(args,unsigned long long);
+			else if (longs) r->args[argn++] = (Bit64u)va_arg(args,unsigned long);
+			else r->args[argn++] = (Bit64u)va_arg(args,unsigned int);
+			break;
+		case 'f': case 'e': case 'g': case 'E': case 'G': {
+			double d = va_arg(args,double);
+			memcpy(&r->args[argn++],&d,sizeof(d));
+			break;
+		}
+		case 's': {
+			if (strn == 2) return false;
+			const char* s = va_arg(args,const char*);
+			safe_strncpy(r->strpool[strn],s?s:"(null)",BINLOG_STRLEN);
+			r->strmask |= (Bit8u)(1 << argn);
+			r->args[argn++] = strn++;
+			break;
+		}
+		case 'p':
+			r->args[argn++] = (Bit64u)(uintptr_t)va_arg(args,void*);
+			break;
+		default:
+			return false;
+		}
+		f++;
+	}
+	r->argcount = (Bit8u)argn;
+	binlog_head = (binlog_head + 1) & (BINLOG_RECORDS - 1);
+	if (binlog_count < BINLOG_RECORDS) binlog_count++;
+	return true;
+}
+
+static void BINLOG_DumpRecord(FILE* f,BinLogRecord* r) {
+	fprintf(f,"%10u: %s:",r->cycles,loggrp[r->type].front);
+	const char* p = r->format;
+	Bitu argn = 0;
+	while (*p) {
+		if (*p != '%') { fputc(*p++,f); continue; }
+		const char* start = p++;
+		if (*p == '%') { fputc('%',f); p++; continue; }
+		while (*p && strchr("-+ #0.123456789",*p)) p++;
+		while (*p == 'l' || *p == 'h') p++;
+		char conv = *p;
+		if (!conv || argn >= r->argcount) break;
+		/* rebuild the spec with the stored flags/width but a 64-bit
+		   length modifier to match how the argument was captured */
+		char spec[40]; Bitu si = 0;
+		spec[si++] = '%';
+		for (const char* q = start+1; q < p && si < 32; q++)
+			if (*q != 'l' && *q != 'h') spec[si++] = *q;
+		switch (conv) {
+		case 'd': case 'i':
+			spec[si++]='l'; spec[si++]='l'; spec[si++]=conv; spec[si]=0;
+			fprintf(f,spec,(long long)r->args[argn++]);
+			break;
+		case 'u': case 'o': case 'x': case 'X': case 'p':
+			spec[si++]='l'; spec[si++]='l'; spec[si++]=(conv=='p')?'x':conv; spec[si]=0;
+			fprintf(f,spec,(unsigned long long)r->args[argn++]);
+			break;
+		case 'c':
+			spec[si++]=conv; spec[si]=0;
+			fprintf(f,spec,(int)r->args[argn++]);
+			break;
+		case 'f': case 'e': case 'g': case 'E': case 'G': {
+			double d; memcpy(&d,&r->args[argn++],sizeof(d));
+			spec[si++]=conv; spec[si]=0;
+			fprintf(f,spec,d);
+			break;
+		}
+		case 's':
+			spec[si++]='s'; spec[si]=0;
+			fprintf(f,spec,r->strpool[r->args[argn++] & 1]);
+			break;
+		default:
+			argn++;
+			break;
+		}
+		p++;
+	}
+	fputc('\n',f);
+}
+
+void BINLOG_Dump(void) {
+	if (!binlog || !binlog_count) return;
+	FILE* f = debuglog ? debuglog : fopen("BINLOG.TXT","wt");
+	if (!f) return;
+	Bitu start = (binlog_head + BINLOG_RECORDS - binlog_count) & (BINLOG_RECORDS - 1);
+	for (Bitu n = 0; n < binlog_count; n++)
+		BINLOG_DumpRecord(f,&binlog[(start + n) & (BINLOG_RECORDS - 1)]);
+	if (f != debuglog) fclose(f);
+	else fflush(f);
+	binlog_count = 0;
 }
 
 void LOG::operator() (char const* format, ...){
-	char buf[512];
+	if (d_type>=LOG_MAX) return;
+	if ((d_severity!=LOG_ERROR) && (!loggrp[d_type].enabled)) return;
+
 	va_list msg;
 	va_start(msg,format);
+	if (binlog_enabled && binlog) {
+		va_list rec;
+		va_copy(rec,msg);
+		bool captured = BINLOG_Record((Bit8u)d_type,(Bit8u)d_severity,format,rec);
+		va_end(rec);
+		if (captured) {
+			va_end(msg);
+			return;
+		}
+	}
+	char buf[512];
 	vsprintf(buf,format,msg);
 	va_end(msg);
-
-	if (d_type>=LOG_MAX) return;
-	if ((d_severity!=LOG_ERROR) && (!loggrp[d_type].enabled)) return;
 	DEBUG_ShowMsg("%10u: %s:%s\n",static_cast<Bit32u>(cycle_count),loggrp[d_type].front,buf);
 }
 
@@ -202,6 +365,10 @@ static void MakePairs(void) {
 	init_pair(PAIR_GREY_RED, COLOR_WHITE/*| FOREGROUND_INTENSITY */, COLOR_RED);
 }
 static void LOG_Destroy(Section*) {
+	BINLOG_Dump();
+	delete [] binlog;
+	binlog = 0;
+	binlog_enabled = false;
 	if(debuglog) fclose(debuglog);
 	debuglog = 0;
 }
@@ -214,6 +381,9 @@ static void LOG_Init(Section * sec) {
 	} else {
 		debuglog = 0;
 	}
+	binlog_enabled = sect->Get_bool("binarylog");
+	if (binlog_enabled && !binlog)
+		binlog = new BinLogRecord[BINLOG_RECORDS];
 	sect->AddDestroyFunction(&LOG_Destroy);
 	char buf[64];
 	for (Bitu i = LOG_ALL + 1;i < LOG_MAX;i++) { //Skip LOG_ALL, it is always enabled
@@ -260,6 +430,10 @@ void LOG_StartUp(void) {
 	Section_prop * sect=control->AddSection_prop("log",LOG_Init);
 	Prop_string* Pstring = sect->Add_string("logfile",Property::Changeable::Always,"");
 	Pstring->Set_help("file where the log messages will be saved to");
+	Prop_bool* Pbinlog = sect->Add_bool("binarylog",Property::Changeable::Always,false);
+	Pbinlog->Set_help("Capture log messages unformatted in a memory ring and only format\n"
+	                  "them at shutdown (or with the BINLOG debugger command); keeps\n"
+	                  "detailed logging cheap enough to leave enabled.");
 	char buf[64];
 	for (Bitu i = LOG_ALL + 1;i < LOG_MAX;i++) {
 		safe_strncpy(buf,loggrp[i].front, sizeof(buf));
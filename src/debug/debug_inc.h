@@ -31,6 +31,9 @@
 
 void DBGUI_StartUp(void);
 
+/* format and flush the binary log ring (debug_gui.cpp) */
+void BINLOG_Dump(void);
+
 struct DBGBlock {
 	WINDOW * win_main;					/* The Main Window */
 	WINDOW * win_reg;					/* Register Window */
@@ -20,6 +20,7 @@
 #ifndef __CDROM_INTERFACE__
 #define __CDROM_INTERFACE__
 
+#include <array>
 #include <cstring>
 #include <fstream>
 #include <iostream>
@@ -57,6 +58,11 @@
 #define BYTES_PER_REDBOOK_PCM_FRAME       4u // 2 bytes/sample * 2 samples/frame
 #define MAX_REDBOOK_BYTES (MAX_REDBOOK_FRAMES * BYTES_PER_RAW_REDBOOK_FRAME) // length of a CDROM in bytes
 #define MAX_REDBOOK_DURATION_MS (99 * 60 * 1000) // 99 minute CDROM in milliseconds
+#define CDDA_PREFETCH_FRAMES          16384u // PCM frames decoded ahead of the play cursor (~1/3 s, ~25 sectors)
+#define CDDA_PREFETCH_CHUNK            2048u // PCM frames decoded per prefetch-thread pass
+#define CDDA_PREFETCH_PRIME               2u // chunks decoded up-front when playback starts
+#define DATA_SECTOR_CACHE_SLOTS         128u // cooked sectors kept per image in the LRU read cache (256 KB)
+#define DATA_SECTOR_READAHEAD             8u // sectors fetched per miss while the reads are sequential
 
 
 struct TMSF
@@ -178,6 +184,11 @@ private:
 		int             getLength();
 	private:
 		std::ifstream   *file;
+		// read-only mapping of the image; sector reads become a
+		// page-cache memcpy and the ifstream stays as fallback
+		Bit8u           *mmap_base;
+		size_t          mmap_size;
+		size_t          mmap_pos;
 	};
 
 	class AudioFile : public TrackFile {
@@ -234,6 +245,13 @@ public:
 	bool	LoadUnloadMedia         (bool unload);
 	bool	ReadSector              (uint8_t *buffer, const bool raw, const uint32_t sector);
 	bool	HasDataTrack            (void);
+	// re-register a kept instance as the active image for a sub-unit;
+	// the disc swapper uses this to put an already-parsed image back in
+	// without re-reading the cue sheet or reopening the track files
+	void	Reactivate              (Bit8u _subUnit) {
+		subUnit = _subUnit;
+		images[_subUnit] = this;
+	}
 	static CDROM_Interface_Image* images[26];
 
 private:
@@ -245,11 +263,21 @@ private:
 		MixerChannel             *channel           = nullptr;
 		CDROM_Interface_Image    *cd                = nullptr;
 		void (MixerChannel::*addFrames) (Bitu, const Bit16s*) = nullptr;
+		SDL_Thread               *decodeThread      = nullptr;
+		SDL_mutex                *decodeMutex       = nullptr;
+		SDL_sem                  *decodeWork        = nullptr;
 		uint32_t                 playedTrackFrames  = 0;
 		uint32_t                 totalTrackFrames   = 0;
 		uint32_t                 startSector        = 0;
 		uint32_t                 totalRedbookFrames = 0;
+		// prefetch ring; in/out are absolute frame counts, guarded by mutex
+		uint32_t                 ringIn             = 0;
+		uint32_t                 ringOut            = 0;
+		int16_t                  ring[CDDA_PREFETCH_FRAMES * REDBOOK_CHANNELS] = {0};
 		int16_t                  buffer[MIXER_BUFSIZE * REDBOOK_CHANNELS] = {0};
+		uint8_t                  trackChannels      = REDBOOK_CHANNELS;
+		bool                     ringEof            = false;
+		bool                     decodeQuit         = false;
 		bool                     isPlaying          = false;
 		bool                     isPaused           = false;
 	} player;
@@ -260,7 +288,10 @@ private:
 	                 const uint16_t sectorSize,
 	                 const bool mode2);
 	std::vector<Track>::iterator GetTrack(const uint32_t sector);
+	uint8_t* CacheLookup(const uint32_t sector);
+	uint8_t* CacheSlot(const uint32_t sector);
 	static void CDAudioCallBack (Bitu desired_frames);
+	static int  CDAudioPrefetch (void *unused);
 
 	// Private functions for cue sheet processing
 	bool  LoadCueSheet(char *cuefile);
@@ -273,11 +304,27 @@ private:
 	               const int32_t prestart,
 	               uint32_t      &totalPregap,
 	               uint32_t      currPregap);
+	/**
+	 *  LRU cache over cooked data sectors, shared by the MSCDEX and ISO
+	 *  filesystem read paths. Misses during sequential runs are widened
+	 *  to a span of following sectors fetched with a single image read,
+	 *  matching titles that stream video or audio from the disc.
+	 */
+	struct SectorCacheEntry {
+		uint32_t sector = MAX_REDBOOK_FRAMES; // tag; defaults beyond any valid sector
+		uint32_t age    = 0;
+		uint8_t  data[BYTES_PER_COOKED_REDBOOK_FRAME] = {0};
+	};
+
 	// member variables
+	std::array<SectorCacheEntry, DATA_SECTOR_CACHE_SLOTS> sectorCache = {};
 	std::vector<Track>   tracks;
 	std::vector<uint8_t> readBuffer;
+	std::vector<uint8_t> chunkBuffer;
 	std::string          mcn;
 	static int           refCount;
+	uint32_t             sectorCacheTick = 0;
+	uint32_t             lastDataSector = MAX_REDBOOK_FRAMES;
 	uint8_t              subUnit;
 };
 
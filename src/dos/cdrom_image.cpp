@@ -19,6 +19,7 @@
 // #define DEBUG 1
 
 #include "cdrom.h"
+#include <algorithm>
 #include <cassert>
 #include <cctype>
 #include <chrono>
@@ -34,6 +35,9 @@
 
 #if !defined(WIN32)
 #include <libgen.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
 #else
 #include <cstring>
 #endif
@@ -92,15 +96,43 @@ uint32_t CDROM_Interface_Image::TrackFile::adjustOverRead(const uint32_t offset,
 
 CDROM_Interface_Image::BinaryFile::BinaryFile(const char *filename, bool &error)
         : TrackFile(BYTES_PER_RAW_REDBOOK_FRAME),
-          file(nullptr)
+          file(nullptr),
+          mmap_base(nullptr),
+          mmap_size(0),
+          mmap_pos(0)
 {
 	file = new ifstream(filename, ios::in | ios::binary);
 	// If new fails, an exception is generated and scope leaves this constructor
 	error = file->fail();
+#if !defined(WIN32)
+	if (!error) {
+		const int fd = open(filename, O_RDONLY);
+		if (fd >= 0) {
+			struct stat status;
+			if (fstat(fd, &status) == 0 && status.st_size > 0) {
+				void *map = mmap(nullptr, (size_t)status.st_size,
+				                 PROT_READ, MAP_SHARED, fd, 0);
+				if (map != MAP_FAILED) {
+					mmap_base = (Bit8u *)map;
+					mmap_size = (size_t)status.st_size;
+					// FMV titles stream the image front to back
+					madvise(map, mmap_size, MADV_SEQUENTIAL);
+				}
+			}
+			close(fd); // the mapping outlives the descriptor
+		}
+	}
+#endif
 }
 
 CDROM_Interface_Image::BinaryFile::~BinaryFile()
 {
+#if !defined(WIN32)
+	if (mmap_base) {
+		munmap(mmap_base, mmap_size);
+		mmap_base = nullptr;
+	}
+#endif
 	// Guard: only cleanup if needed
 	if (file == nullptr)
 		return;
@@ -125,6 +157,11 @@ bool CDROM_Interface_Image::BinaryFile::read(uint8_t *buffer,
 	if (adjusted_bytes == 0) // no work to do!
 		return true;
 
+	if (mmap_base && offset + adjusted_bytes <= mmap_size) {
+		memcpy(buffer, mmap_base + offset, adjusted_bytes);
+		mmap_pos = offset + adjusted_bytes;
+		return true;
+	}
 	file->read((char *)buffer, adjusted_bytes);
 	return !file->fail();
 }
@@ -132,6 +169,9 @@ bool CDROM_Interface_Image::BinaryFile::read(uint8_t *buffer,
 int CDROM_Interface_Image::BinaryFile::getLength()
 {
 	// Return our cached result if we've already been asked before
+	if (length_redbook_bytes < 0 && mmap_base) {
+		length_redbook_bytes = static_cast<int>(mmap_size);
+	}
 	if (length_redbook_bytes < 0 && file) {
 		file->seekg(0, ios::end);
 		/**
@@ -167,6 +207,10 @@ bool CDROM_Interface_Image::BinaryFile::seek(const uint32_t offset)
 	if (!offsetInsideTrack(offset))
 		return false;
 
+	if (mmap_base && offset <= mmap_size) {
+		mmap_pos = offset;
+		return true;
+	}
 	file->seekg(offset, ios::beg);
 
 	// If the first seek attempt failed, then try harder
@@ -186,6 +230,14 @@ uint32_t CDROM_Interface_Image::BinaryFile::decode(int16_t *buffer,
 	assertm(desired_track_frames <= MAX_REDBOOK_FRAMES,
 	        "Requested number of frames exceeds the maximum for a CDROM");
 
+	if (mmap_base) {
+		size_t bytes = desired_track_frames * BYTES_PER_REDBOOK_PCM_FRAME;
+		if (bytes > mmap_size - mmap_pos)
+			bytes = mmap_size - mmap_pos;
+		memcpy(buffer, mmap_base + mmap_pos, bytes);
+		mmap_pos += bytes;
+		return ceil_udivide(static_cast<uint32_t>(bytes), BYTES_PER_REDBOOK_PCM_FRAME);
+	}
 	file->read((char*)buffer, desired_track_frames * BYTES_PER_REDBOOK_PCM_FRAME);
 	/**
 	 *  Note: gcount returns a signed type, but according to specification:
@@ -473,6 +525,20 @@ CDROM_Interface_Image::CDROM_Interface_Image(Bit8u _subUnit)
 			player.channel = player.mixerChannel.Install(&CDAudioCallBack, 0, "CDAUDIO");
 			player.channel->Enable(false); // only enabled during playback periods
 		}
+		if (!player.decodeMutex)
+			player.decodeMutex = SDL_CreateMutex();
+
+		if (!player.decodeWork)
+			player.decodeWork = SDL_CreateSemaphore(0);
+
+		if (!player.decodeThread && player.decodeMutex && player.decodeWork) {
+			player.decodeQuit = false;
+			player.decodeThread = SDL_CreateThread(CDAudioPrefetch, "CDPrefetch", NULL);
+			// without the thread the callback simply decodes in-line
+			if (!player.decodeThread)
+				LOG_MSG("CDROM: Couldn't start the CD-DA prefetch thread, "
+				        "so decoding synchronously");
+		}
 #ifdef DEBUG
 		LOG_MSG("CDROM: Initialized the CDAUDIO mixer channel and mutex");
 #endif
@@ -487,6 +553,22 @@ CDROM_Interface_Image::~CDROM_Interface_Image()
 	// Stop playback before wiping out the CD Player
 	if (refCount == 0 && player.cd) {
 		StopAudio();
+
+		// Wind down the prefetch thread before releasing its primitives
+		if (player.decodeThread) {
+			player.decodeQuit = true;
+			SDL_SemPost(player.decodeWork);
+			SDL_WaitThread(player.decodeThread, NULL);
+			player.decodeThread = nullptr;
+		}
+		if (player.decodeWork) {
+			SDL_DestroySemaphore(player.decodeWork);
+			player.decodeWork = nullptr;
+		}
+		if (player.decodeMutex) {
+			SDL_DestroyMutex(player.decodeMutex);
+			player.decodeMutex = nullptr;
+		}
 		SDL_DestroyMutex(player.mutex);
 		player.mutex = nullptr;
 #ifdef DEBUG
@@ -500,6 +582,11 @@ CDROM_Interface_Image::~CDROM_Interface_Image()
 
 bool CDROM_Interface_Image::SetDevice(char* path)
 {
+	// A new image invalidates anything cached from the previous one
+	for (auto &entry : sectorCache)
+		entry.sector = MAX_REDBOOK_FRAMES;
+	lastDataSector = MAX_REDBOOK_FRAMES;
+
 	const bool result = LoadCueSheet(path) || LoadIsoFile(path);
 	if (!result) {
 		// print error message on dosbox console
@@ -709,11 +796,20 @@ bool CDROM_Interface_Image::PlayAudioSector(const uint32_t start, uint32_t len)
 	                                0u, track->length - 1)
 	                        * track->sectorSize);
 
+	/**
+	 *  Hold off the prefetch thread, which shares the track file's decode
+	 *  position, for the span between seeking and flushing its ring below.
+	 */
+	if (player.decodeMutex)
+		SDL_LockMutex(player.decodeMutex);
+
 	// Guard: Bail if our track could not be seeked
 	if (!track_file->seek(offset)) {
 		LOG_MSG("CDROM: Track %d failed to seek to byte %u, so cancelling playback",
 		        track->number,
 		        offset);
+		if (player.decodeMutex)
+			SDL_UnlockMutex(player.decodeMutex);
 		StopAudio();
 		return false;
 	}
@@ -729,6 +825,8 @@ bool CDROM_Interface_Image::PlayAudioSector(const uint32_t start, uint32_t len)
 	 */
 	if (SDL_LockMutex(player.mutex) < 0) {
 		LOG_MSG("CDROM: PlayAudioSector couldn't lock our player for exclusive access");
+		if (player.decodeMutex)
+			SDL_UnlockMutex(player.decodeMutex);
 		StopAudio();
 		return false;
 	}
@@ -741,6 +839,12 @@ bool CDROM_Interface_Image::PlayAudioSector(const uint32_t start, uint32_t len)
 	player.isPlaying = true;
 	player.isPaused = false;
 
+	// Flush any frames the prefetcher decoded prior to the seek
+	player.trackChannels = track_channels;
+	player.ringIn = 0;
+	player.ringOut = 0;
+	player.ringEof = false;
+
 	// Assign the mixer function associated with this track's content type
 	if (track_file->getEndian() == AUDIO_S16SYS) {
 		player.addFrames = track_channels ==  2  ? &MixerChannel::AddSamples_s16 \
@@ -792,9 +896,39 @@ bool CDROM_Interface_Image::PlayAudioSector(const uint32_t start, uint32_t len)
 	// Guard: release the lock in this data
     if (SDL_UnlockMutex(player.mutex) < 0) {
         LOG_MSG("CDROM: PlayAudioSector couldn't unlock this thread");
+		if (player.decodeMutex)
+			SDL_UnlockMutex(player.decodeMutex);
 		StopAudio();
 		return false;
     }
+	/**
+	 *  Prime the ring with the first chunks before releasing the decode
+	 *  lock: the channel is already enabled, but the callback takes the
+	 *  decode lock first, so it can't run until we're done.  Without
+	 *  this, the first callback after a track start inline-decodes a
+	 *  whole mixer block's worth of audio in one burst.
+	 */
+	if (player.decodeThread) {
+		uint32_t primed = 0;
+		while (primed < CDDA_PREFETCH_PRIME * CDDA_PREFETCH_CHUNK) {
+			const uint32_t todo = min(CDDA_PREFETCH_CHUNK,
+			                          CDDA_PREFETCH_FRAMES - primed);
+			const uint32_t decoded = track_file->decode(
+			        player.ring + primed * track_channels, todo);
+			if (!decoded)
+				break;
+			primed += decoded;
+		}
+		SDL_LockMutex(player.mutex);
+		player.ringIn = primed;
+		SDL_UnlockMutex(player.mutex);
+	}
+	if (player.decodeMutex)
+		SDL_UnlockMutex(player.decodeMutex);
+
+	// Wake the prefetch thread to keep the ring topped up from here on
+	if (player.decodeThread)
+		SDL_SemPost(player.decodeWork);
 	return true;
 }
 
@@ -945,8 +1079,48 @@ track_iter CDROM_Interface_Image::GetTrack(const uint32_t sector)
 	return track;
 }
 
+// Return the cached copy of a cooked sector, or nullptr when absent
+uint8_t* CDROM_Interface_Image::CacheLookup(const uint32_t sector)
+{
+	for (auto &entry : sectorCache) {
+		if (entry.sector == sector) {
+			entry.age = ++sectorCacheTick;
+			return entry.data;
+		}
+	}
+	return nullptr;
+}
+
+// Re-tag the least-recently-used slot for the given sector and return
+// its payload area, ready to be filled
+uint8_t* CDROM_Interface_Image::CacheSlot(const uint32_t sector)
+{
+	auto *lru = &sectorCache[0];
+	for (auto &entry : sectorCache) {
+		if (entry.sector == sector) { // re-fetch of a cached sector
+			lru = &entry;
+			break;
+		}
+		if (entry.age < lru->age)
+			lru = &entry;
+	}
+	lru->sector = sector;
+	lru->age = ++sectorCacheTick;
+	return lru->data;
+}
+
 bool CDROM_Interface_Image::ReadSector(uint8_t *buffer, const bool raw, const uint32_t sector)
 {
+	// Cooked reads are first served from the LRU sector cache
+	if (!raw) {
+		const uint8_t *cached = CacheLookup(sector);
+		if (cached) {
+			memcpy(buffer, cached, BYTES_PER_COOKED_REDBOOK_FRAME);
+			lastDataSector = sector;
+			return true;
+		}
+	}
+
 	track_const_iter track = GetTrack(sector);
 
 	// Guard: Bail if the requested sector fell outside our tracks
@@ -958,15 +1132,17 @@ bool CDROM_Interface_Image::ReadSector(uint8_t *buffer, const bool raw, const ui
 #endif
 		return false;
 	}
-	uint32_t offset = track->skip + (sector - track->start) * track->sectorSize;
+	const uint32_t offset = track->skip + (sector - track->start) * track->sectorSize;
 	const uint16_t length = (raw ? BYTES_PER_RAW_REDBOOK_FRAME : BYTES_PER_COOKED_REDBOOK_FRAME);
 	if (track->sectorSize != BYTES_PER_RAW_REDBOOK_FRAME && raw) {
 		return false;
 	}
-	if (track->sectorSize == BYTES_PER_RAW_REDBOOK_FRAME && !track->mode2 && !raw)
-		offset += 16;
-	if (track->mode2 && !raw)
-		offset += 24;
+	// Offset of the cooked payload within each of the track's sectors
+	uint32_t cooked_skip = 0;
+	if (track->sectorSize == BYTES_PER_RAW_REDBOOK_FRAME && !track->mode2)
+		cooked_skip = 16;
+	if (track->mode2)
+		cooked_skip = 24;
 
 #if 0 // Excessively verbose.. only enable if needed
 #ifdef DEBUG
@@ -977,7 +1153,54 @@ bool CDROM_Interface_Image::ReadSector(uint8_t *buffer, const bool raw, const ui
 	        length);
 #endif
 #endif
-	return track->file->read(buffer, offset, length);
+	if (raw) {
+		// Serialize with the prefetch thread, which shares the file's read state
+		if (player.decodeMutex)
+			SDL_LockMutex(player.decodeMutex);
+		const bool result = track->file->read(buffer, offset, length);
+		if (player.decodeMutex)
+			SDL_UnlockMutex(player.decodeMutex);
+		return result;
+	}
+
+	/**
+	 *  Cooked cache miss: fetch the sector, widened to a run of following
+	 *  sectors when the reads have been sequential, so that a streaming
+	 *  title costs one image read per run instead of one per sector.
+	 */
+	uint32_t num_sectors = 1;
+	if (sector == lastDataSector + 1) {
+		const uint32_t track_end = track->start + track->length;
+		num_sectors = std::min(DATA_SECTOR_READAHEAD, track_end - sector);
+	}
+	lastDataSector = sector;
+
+	const uint32_t span = num_sectors * track->sectorSize;
+	if (chunkBuffer.size() < span)
+		chunkBuffer.resize(span);
+
+	// Serialize with the prefetch thread, which shares the file's read state
+	if (player.decodeMutex)
+		SDL_LockMutex(player.decodeMutex);
+	bool result = track->file->read(chunkBuffer.data(), offset, span);
+	if (!result && num_sectors > 1) {
+		// A trimmed track file can cut the run short; retry unwidened
+		num_sectors = 1;
+		result = track->file->read(chunkBuffer.data(), offset, track->sectorSize);
+	}
+	if (player.decodeMutex)
+		SDL_UnlockMutex(player.decodeMutex);
+	if (!result)
+		return false;
+
+	// Populate the cache with the fetched run and copy out the requested sector
+	for (uint32_t i = 0; i < num_sectors; ++i)
+		memcpy(CacheSlot(sector + i),
+		       chunkBuffer.data() + i * track->sectorSize + cooked_skip,
+		       BYTES_PER_COOKED_REDBOOK_FRAME);
+
+	memcpy(buffer, chunkBuffer.data() + cooked_skip, BYTES_PER_COOKED_REDBOOK_FRAME);
+	return result;
 }
 
 
@@ -1011,14 +1234,45 @@ void CDROM_Interface_Image::CDAudioCallBack(Bitu desired_track_frames)
 		return;
 	}
 
-	// Ensure we have exclusive access to update our player members
+	/**
+	 *  Ensure the prefetch thread isn't mid-decode and that we have
+	 *  exclusive access to update our player members. The decode lock
+	 *  is always taken first to keep the lock order consistent.
+	 */
+	if (player.decodeMutex && SDL_LockMutex(player.decodeMutex) < 0) {
+		LOG_MSG("CDROM: CDAudioCallBack couldn't lock the decoder");
+		return;
+	}
 	if (SDL_LockMutex(player.mutex) < 0) {
 		LOG_MSG("CDROM: CDAudioCallBack couldn't lock this thread");
+		if (player.decodeMutex)
+			SDL_UnlockMutex(player.decodeMutex);
 		return;
 	}
 
-	const uint32_t decoded_track_frames = track_file->decode(player.buffer,
-	                                                         static_cast<uint32_t>(desired_track_frames));
+	// Drain the frames the prefetch thread has decoded ahead of us
+	const uint8_t chan_count = player.trackChannels;
+	uint32_t decoded_track_frames = 0;
+	while (decoded_track_frames < desired_track_frames
+	       && player.ringOut != player.ringIn) {
+		const uint32_t pos = player.ringOut % CDDA_PREFETCH_FRAMES;
+		const uint32_t todo = min(min(static_cast<uint32_t>(desired_track_frames)
+		                              - decoded_track_frames,
+		                              player.ringIn - player.ringOut),
+		                          CDDA_PREFETCH_FRAMES - pos);
+		memcpy(player.buffer + decoded_track_frames * chan_count,
+		       player.ring + pos * chan_count,
+		       todo * chan_count * sizeof(int16_t));
+		player.ringOut += todo;
+		decoded_track_frames += todo;
+	}
+
+	// On an underrun (or without a prefetch thread) decode the rest in-line
+	if (decoded_track_frames < desired_track_frames) {
+		decoded_track_frames += track_file->decode(
+		        player.buffer + decoded_track_frames * chan_count,
+		        static_cast<uint32_t>(desired_track_frames) - decoded_track_frames);
+	}
 	player.playedTrackFrames += decoded_track_frames;
 
 	/**
@@ -1049,14 +1303,81 @@ void CDROM_Interface_Image::CDAudioCallBack(Bitu desired_track_frames)
 		                                        - played_redbook_frames;
 		if (SDL_UnlockMutex(player.mutex) < 0) {
 			LOG_MSG("CDROM: CDAudioCallBack couldn't unlock to move to next track");
+			if (player.decodeMutex)
+				SDL_UnlockMutex(player.decodeMutex);
 			return;
 		}
+		if (player.decodeMutex)
+			SDL_UnlockMutex(player.decodeMutex);
 		player.cd->PlayAudioSector(new_redbook_start_frame, remaining_redbook_frames);
 		return;
 	}
 	if (SDL_UnlockMutex(player.mutex) < 0) {
 		LOG_MSG("CDROM: CDAudioCallBack couldn't unlock our player before returning");
 	}
+	if (player.decodeMutex)
+		SDL_UnlockMutex(player.decodeMutex);
+
+	// Wake the prefetch thread to top the ring back up
+	if (player.decodeThread)
+		SDL_SemPost(player.decodeWork);
+}
+
+int CDROM_Interface_Image::CDAudioPrefetch(void *unused)
+{
+	(void)unused; // unused but present for the SDL thread interface
+	while (true) {
+		SDL_SemWait(player.decodeWork);
+		if (player.decodeQuit)
+			return 0;
+
+		// Decode in chunks until the ring is topped up or the track runs dry
+		while (!player.decodeQuit) {
+			if (SDL_LockMutex(player.decodeMutex) < 0)
+				break;
+
+			// Reserve the track_file for the scope of this chunk
+			std::shared_ptr<TrackFile> track_file = player.trackFile.lock();
+
+			uint32_t in = 0;
+			uint8_t chan_count = REDBOOK_CHANNELS;
+			bool wanted = false;
+			if (track_file && SDL_LockMutex(player.mutex) == 0) {
+				in = player.ringIn;
+				chan_count = player.trackChannels;
+				wanted = player.isPlaying
+				         && !player.ringEof
+				         && CDDA_PREFETCH_FRAMES - (in - player.ringOut)
+				            >= CDDA_PREFETCH_CHUNK;
+				SDL_UnlockMutex(player.mutex);
+			}
+			if (!wanted) {
+				SDL_UnlockMutex(player.decodeMutex);
+				break;
+			}
+
+			/**
+			 *  Decode into our contiguous slice of the ring without
+			 *  holding the player lock: only this thread advances
+			 *  ringIn, and seeks flush the ring under the decode
+			 *  lock, so the slice can't be repurposed while we fill
+			 *  it.
+			 */
+			const uint32_t pos = in % CDDA_PREFETCH_FRAMES;
+			const uint32_t todo = min(CDDA_PREFETCH_CHUNK,
+			                          CDDA_PREFETCH_FRAMES - pos);
+			const uint32_t decoded = track_file->decode(
+			        player.ring + pos * chan_count, todo);
+
+			SDL_LockMutex(player.mutex);
+			if (decoded)
+				player.ringIn = in + decoded;
+			else // let the callback run its end-of-track handling
+				player.ringEof = true;
+			SDL_UnlockMutex(player.mutex);
+			SDL_UnlockMutex(player.decodeMutex);
+		}
+	}
 }
 
 bool CDROM_Interface_Image::LoadIsoFile(char* filename)
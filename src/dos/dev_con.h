@@ -137,9 +137,24 @@ bool device_CON::Write(Bit8u * data,Bit16u * size) {
 				} while(col%8);
 				count++;
 				continue;
-			} else { 
-				Output(data[count]);
-				count++;
+			} else {
+				/* Scan ahead for a run of ordinary characters and emit
+				   it in one burst, so the bios cursor is committed once
+				   per run instead of per character. Escapes, tabs and
+				   the bell (it idles the cpu) still go char-by-char. */
+				Bit16u run=count;
+				while (run<*size && data[run]!='\033' && data[run]!=7
+				       && !(data[run]=='\t' && !dos.direct_output)) run++;
+				if (run-count>1) {
+					if (dos.internal_output || ansi.enabled)
+						INT10_TeletypeOutputStringAttr(data+count,run-count,ansi.attr,true);
+					else
+						INT10_TeletypeOutputStringAttr(data+count,run-count,7,CurMode->type!=M_TEXT);
+					count=run;
+				} else {
+					Output(data[count]);
+					count++;
+				}
 				continue;
 		}
 	}
@@ -20,6 +20,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <SDL.h>
 #include "dosbox.h"
 #include "bios.h"
 #include "mem.h"
@@ -642,11 +643,14 @@ static Bitu DOS_21Handler(void) {
 		}
 		break;
 	case 0x3f:		/* READ Read from file or device */
-		{ 
+		{
 			Bit16u toread=reg_cx;
 			dos.echo=true;
-			if (DOS_ReadFile(reg_bx,dos_copybuf,&toread)) {
-				MEM_BlockWrite(SegPhys(ds)+reg_dx,dos_copybuf,toread);
+			/* Let the drive layer fill the guest buffer directly when
+			 * it resolves to plain RAM, skipping the dos_copybuf bounce */
+			HostPt direct=MEM_GetHostWritePt(SegPhys(ds)+reg_dx,toread);
+			if (DOS_ReadFile(reg_bx,direct?direct:dos_copybuf,&toread)) {
+				if (!direct) MEM_BlockWrite(SegPhys(ds)+reg_dx,dos_copybuf,toread);
 				reg_ax=toread;
 				CALLBACK_SCF(false);
 			} else {
@@ -660,8 +664,9 @@ static Bitu DOS_21Handler(void) {
 	case 0x40:					/* WRITE Write to file or device */
 		{
 			Bit16u towrite=reg_cx;
-			MEM_BlockRead(SegPhys(ds)+reg_dx,dos_copybuf,towrite);
-			if (DOS_WriteFile(reg_bx,dos_copybuf,&towrite)) {
+			HostPt direct=MEM_GetHostReadPt(SegPhys(ds)+reg_dx,towrite);
+			if (!direct) MEM_BlockRead(SegPhys(ds)+reg_dx,dos_copybuf,towrite);
+			if (DOS_WriteFile(reg_bx,direct?direct:dos_copybuf,&towrite)) {
 				reg_ax=towrite;
 	   			CALLBACK_SCF(false);
 			} else {
@@ -1165,6 +1170,22 @@ static Bitu DOS_20Handler(void) {
 	return CBRET_NONE;
 }
 
+static Bitu DOS_28Handler(void) {
+	// DOS idle interrupt: called by DOS and well-behaved programs in
+	// their input wait loops to signal that nothing useful is being
+	// done. Any TSRs hooked in front of this default handler (print
+	// spoolers etc.) have already run by the time we get here, so
+	// give the host timeslice back instead of burning a core on the
+	// caller's polling loop. A short warmup avoids penalizing
+	// programs that only touch INT 28h in passing.
+	static Bit32u idle_calls=0;
+	if (++idle_calls>=4) {
+		idle_calls=4;	// keep yielding but don't let the counter wrap
+		SDL_Delay(1);
+	}
+	return CBRET_NONE;
+}
+
 static Bitu DOS_27Handler(void) {
 	// Terminate & stay resident
 	Bit16u para = (reg_dx/16)+((reg_dx % 16)>0);
@@ -1215,6 +1236,8 @@ public:
 
 		callback[1].Install(DOS_21Handler,CB_INT21,"DOS Int 21");
 		callback[1].Set_RealVec(0x21);
+		// the int 21 handler never stops the loop, let the cores run it in place
+		CALLBACK_SetFast(callback[1].Get_callback(),true);
 	//Pseudo code for int 21
 	// sti
 	// callback 
@@ -1230,7 +1253,7 @@ public:
 		callback[4].Install(DOS_27Handler,CB_IRET,"DOS Int 27");
 		callback[4].Set_RealVec(0x27);
 
-		callback[5].Install(NULL,CB_IRET,"DOS Int 28");
+		callback[5].Install(DOS_28Handler,CB_IRET,"DOS Int 28");
 		callback[5].Set_RealVec(0x28);
 
 		callback[6].Install(NULL,CB_INT29,"CON Output Int 29");
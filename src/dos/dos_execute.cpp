@@ -472,6 +472,7 @@ bool DOS_Execute(char * name,PhysPt block_pt,Bit8u flags) {
 		DOS_MCB pspmcb(dos.psp()-1);
 		pspmcb.SetFileName(stripname);
 		DOS_UpdatePSPName();
+		CPU_NotifyExecutable(stripname);
 	}
 
 	if (flags==LOAD) {
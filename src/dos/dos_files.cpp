@@ -43,6 +43,22 @@
 DOS_File * Files[DOS_FILES];
 DOS_Drive * Drives[DOS_DRIVES];
 
+/* Resolving a path is a pure string transform of the raw name, the target
+ * drive and that drive's current directory, so a small LRU over those inputs
+ * can skip the per-character parser for applications that touch the same
+ * files over and over. Keying on the current directory also means a CHDIR
+ * simply stops matching old entries; no invalidation hooks are needed. */
+#define MAKENAME_CACHE_SIZE 16
+static struct {
+	char name[DOS_PATHLENGTH];
+	char curdir[DOS_PATHLENGTH];
+	char fullname[DOS_PATHLENGTH];
+	Bit32u age;
+	Bit8u drive;
+	bool used;
+} makename_cache[MAKENAME_CACHE_SIZE];
+static Bit32u makename_tick = 0;
+
 Bit8u DOS_GetDefaultDrive(void) {
 //	return DOS_SDA(DOS_SDA_SEG,DOS_SDA_OFS).GetDrive();
 	Bit8u d = DOS_SDA(DOS_SDA_SEG,DOS_SDA_OFS).GetDrive();
@@ -73,9 +89,19 @@ bool DOS_MakeName(char const * const name,char * const fullname,Bit8u * drive) {
 		*drive=(name_int[0] | 0x20)-'a';
 		name_int+=2;
 	}
-	if (*drive>=DOS_DRIVES || !Drives[*drive]) { 
+	if (*drive>=DOS_DRIVES || !Drives[*drive]) {
 		DOS_SetError(DOSERR_PATH_NOT_FOUND);
-		return false; 
+		return false;
+	}
+	/* Check for a cached resolution of this name */
+	for (Bitu i=0;i<MAKENAME_CACHE_SIZE;i++) {
+		if (makename_cache[i].used && makename_cache[i].drive==*drive &&
+		    strcmp(makename_cache[i].name,name_int)==0 &&
+		    strcmp(makename_cache[i].curdir,Drives[*drive]->curdir)==0) {
+			strcpy(fullname,makename_cache[i].fullname);
+			makename_cache[i].age = ++makename_tick;
+			return true;
+		}
 	}
 	r=0;w=0;
 	while (name_int[r]!=0 && (r<DOS_PATHLENGTH)) {
@@ -189,7 +215,21 @@ bool DOS_MakeName(char const * const name,char * const fullname,Bit8u * drive) {
 		}
 		tempdir[w++]=upname[r++];
 	}
-	return true;	
+	/* Remember the resolution, evicting the least-recently-used slot */
+	if (strlen(name_int)<DOS_PATHLENGTH) {
+		Bitu slot=0;
+		for (Bitu i=0;i<MAKENAME_CACHE_SIZE;i++) {
+			if (!makename_cache[i].used) { slot=i;break; }
+			if (makename_cache[i].age<makename_cache[slot].age) slot=i;
+		}
+		strcpy(makename_cache[slot].name,name_int);
+		strcpy(makename_cache[slot].curdir,Drives[*drive]->curdir);
+		strcpy(makename_cache[slot].fullname,fullname);
+		makename_cache[slot].drive=*drive;
+		makename_cache[slot].age=++makename_tick;
+		makename_cache[slot].used=true;
+	}
+	return true;
 }
 
 bool DOS_GetCurrentDir(Bit8u drive,char * const buffer) {
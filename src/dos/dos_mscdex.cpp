@@ -118,7 +118,7 @@ public:
 	int			RemoveDrive			(Bit16u _drive);
 	int			AddDrive			(Bit16u _drive, char* physicalPath, Bit8u& subUnit);
 	bool 		HasDrive			(Bit16u drive);
-	void		ReplaceDrive		(CDROM_Interface* newCdrom, Bit8u subUnit);
+	void		ReplaceDrive		(CDROM_Interface* newCdrom, Bit8u subUnit, bool deleteOld);
 	void		GetDrives			(PhysPt data);
 	void		GetDriverInfo		(PhysPt data);
 	bool		GetVolumeName		(Bit8u subUnit, char* name);
@@ -372,10 +372,12 @@ bool CMscdex::HasDrive(Bit16u drive) {
 	return (GetSubUnit(drive) != 0xff);
 }
 
-void CMscdex::ReplaceDrive(CDROM_Interface* newCdrom, Bit8u subUnit) {
+void CMscdex::ReplaceDrive(CDROM_Interface* newCdrom, Bit8u subUnit, bool deleteOld) {
 	if (cdrom[subUnit] != NULL) {
 		StopAudio(subUnit);
-		delete cdrom[subUnit];
+		// the disc swapper keeps the outgoing image parsed so it can be
+		// handed straight back on the next swap; only delete when asked
+		if (deleteOld) delete cdrom[subUnit];
 	}
 	cdrom[subUnit] = newCdrom;
 }
@@ -1288,9 +1290,9 @@ bool MSCDEX_HasDrive(char driveLetter)
 	return mscdex->HasDrive(driveLetter-'A');
 }
 
-void MSCDEX_ReplaceDrive(CDROM_Interface* cdrom, Bit8u subUnit)
+void MSCDEX_ReplaceDrive(CDROM_Interface* cdrom, Bit8u subUnit, bool deleteOld)
 {
-	mscdex->ReplaceDrive(cdrom, subUnit);
+	mscdex->ReplaceDrive(cdrom, subUnit, deleteOld);
 }
 
 Bit8u MSCDEX_GetSubUnit(char driveLetter)
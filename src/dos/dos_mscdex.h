@@ -25,7 +25,7 @@
 int   MSCDEX_AddDrive(char driveLetter, const char *physicalPath, Bit8u &subUnit);
 int   MSCDEX_RemoveDrive(char driveLetter);
 bool  MSCDEX_HasDrive(char driveLetter);
-void  MSCDEX_ReplaceDrive(CDROM_Interface *cdrom, Bit8u subUnit);
+void  MSCDEX_ReplaceDrive(CDROM_Interface *cdrom, Bit8u subUnit, bool deleteOld);
 Bit8u MSCDEX_GetSubUnit(char driveLetter);
 bool  MSCDEX_GetVolumeName(Bit8u subUnit, char *name);
 bool  MSCDEX_HasMediaChanged(Bit8u subUnit);
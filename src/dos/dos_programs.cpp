@@ -40,6 +40,7 @@
 #include "dma.h"
 #include "shell.h"
 #include "program_autotype.h"
+#include "program_benchmark.h"
 
 #if defined(WIN32)
 #ifndef S_ISDIR
@@ -180,6 +181,11 @@ public:
 		bool path_relative_to_last_config = false;
 		if (cmd->FindExist("-pr",true)) path_relative_to_last_config = true;
 
+		/* read-only mounts reject all writes; mainly useful together
+		 * with -cachefile so many instances can share one directory and
+		 * one cache snapshot without revalidation scans */
+		bool readonly = cmd->FindExist("-ro",true);
+
 		/* Check for unmounting */
 		if (cmd->FindString("-u",umount,false)) {
 			WriteOut(UnmountHelper(umount[0]), toupper(umount[0]));
@@ -385,6 +391,7 @@ public:
 					Drives[drive - 'A'] = 0;
 				} else {
 					newdrive = new localDrive(temp_line.c_str(),sizes[0],bit8size,sizes[2],sizes[3],mediaid);
+					if (readonly) static_cast<localDrive*>(newdrive)->SetReadOnly();
 				}
 			}
 		} else {
@@ -408,6 +415,14 @@ public:
 			label = drive; label += "_FLOPPY";
 			newdrive->dirCache.SetLabel(label.c_str(),iscdrom,true);
 		}
+		/* restore the directory cache from a snapshot file (written back
+		 * on unmount/shutdown) to skip host scans on slow filesystems;
+		 * scoped so the usage gotos do not cross the initialization */
+		{
+			std::string cache_file;
+			if (cmd->FindString("-cachefile",cache_file,true))
+				newdrive->dirCache.SetSnapshotFile(cache_file.c_str(),readonly);
+		}
 		if (type == "floppy") incrementFDD();
 		return;
 showusage:
@@ -1169,6 +1184,36 @@ static void INTRO_ProgramStart(Program * * make) {
 	*make=new INTRO;
 }
 
+/* Remember autodetected image geometry per file identity, so remounting
+   the same image within a session skips the probe. Identity includes size
+   and mtime; an image modified outside dosbox gets re-probed. */
+struct ImgGeomCache {
+	std::string path;
+	off_t size;
+	time_t mtime;
+	Bit16u sizes[4];
+};
+static std::vector<ImgGeomCache> img_geom_cache;
+
+static bool ImgGeomCache_Get(const char* path, const struct stat &st, Bit16u * sizes) {
+	for (std::vector<ImgGeomCache>::iterator it = img_geom_cache.begin(); it != img_geom_cache.end(); ++it) {
+		if (it->path == path && it->size == st.st_size && it->mtime == st.st_mtime) {
+			memcpy(sizes, it->sizes, sizeof(it->sizes));
+			return true;
+		}
+	}
+	return false;
+}
+
+static void ImgGeomCache_Add(const char* path, const struct stat &st, const Bit16u * sizes) {
+	ImgGeomCache entry;
+	entry.path = path;
+	entry.size = st.st_size;
+	entry.mtime = st.st_mtime;
+	memcpy(entry.sizes, sizes, sizeof(entry.sizes));
+	img_geom_cache.push_back(entry);
+}
+
 class IMGMOUNT : public Program {
 public:
 	void Run(void) {
@@ -1317,33 +1362,40 @@ public:
 
 		if (fstype=="fat") {
 			if (imgsizedetect) {
-				FILE * diskfile = fopen_wrap(temp_line.c_str(), "rb+");
-				if (!diskfile) {
-					WriteOut(MSG_Get("PROGRAM_IMGMOUNT_INVALID_IMAGE"));
-					return;
-				}
-				fseek(diskfile, 0L, SEEK_END);
-				Bit32u fcsize = (Bit32u)(ftell(diskfile) / 512L);
-				Bit8u buf[512];
-				fseek(diskfile, 0L, SEEK_SET);
-				if (fread(buf,sizeof(Bit8u),512,diskfile)<512) {
+				struct stat imgstat;
+				const bool have_stat = (stat(temp_line.c_str(), &imgstat) == 0);
+				if (have_stat && ImgGeomCache_Get(temp_line.c_str(), imgstat, sizes)) {
+					LOG_MSG("autosized image file (cached): %d:%d:%d:%d",sizes[0],sizes[1],sizes[2],sizes[3]);
+				} else {
+					FILE * diskfile = fopen_wrap(temp_line.c_str(), "rb+");
+					if (!diskfile) {
+						WriteOut(MSG_Get("PROGRAM_IMGMOUNT_INVALID_IMAGE"));
+						return;
+					}
+					fseek(diskfile, 0L, SEEK_END);
+					Bit32u fcsize = (Bit32u)(ftell(diskfile) / 512L);
+					Bit8u buf[512];
+					fseek(diskfile, 0L, SEEK_SET);
+					if (fread(buf,sizeof(Bit8u),512,diskfile)<512) {
+						fclose(diskfile);
+						WriteOut(MSG_Get("PROGRAM_IMGMOUNT_INVALID_IMAGE"));
+						return;
+					}
 					fclose(diskfile);
-					WriteOut(MSG_Get("PROGRAM_IMGMOUNT_INVALID_IMAGE"));
-					return;
-				}
-				fclose(diskfile);
-				if ((buf[510]!=0x55) || (buf[511]!=0xaa)) {
-					WriteOut(MSG_Get("PROGRAM_IMGMOUNT_INVALID_GEOMETRY"));
-					return;
-				}
-				Bitu sectors=(Bitu)(fcsize/(16*63));
-				if (sectors*16*63!=fcsize) {
-					WriteOut(MSG_Get("PROGRAM_IMGMOUNT_INVALID_GEOMETRY"));
-					return;
-				}
-				sizes[0]=512;	sizes[1]=63;	sizes[2]=16;	sizes[3]=sectors;
+					if ((buf[510]!=0x55) || (buf[511]!=0xaa)) {
+						WriteOut(MSG_Get("PROGRAM_IMGMOUNT_INVALID_GEOMETRY"));
+						return;
+					}
+					Bitu sectors=(Bitu)(fcsize/(16*63));
+					if (sectors*16*63!=fcsize) {
+						WriteOut(MSG_Get("PROGRAM_IMGMOUNT_INVALID_GEOMETRY"));
+						return;
+					}
+					sizes[0]=512;	sizes[1]=63;	sizes[2]=16;	sizes[3]=sectors;
+					if (have_stat) ImgGeomCache_Add(temp_line.c_str(), imgstat, sizes);
 
-				LOG_MSG("autosized image file: %d:%d:%d:%d",sizes[0],sizes[1],sizes[2],sizes[3]);
+					LOG_MSG("autosized image file: %d:%d:%d:%d",sizes[0],sizes[1],sizes[2],sizes[3]);
+				}
 			}
 
 			if (Drives[drive - 'A']) {
@@ -1770,6 +1822,7 @@ void DOS_SetupPrograms(void) {
 
 	/*regular setup*/
 	PROGRAMS_MakeFile("AUTOTYPE.COM", AUTOTYPE_ProgramStart);
+	PROGRAMS_MakeFile("BENCHMARK.COM", BENCHMARK_ProgramStart);
 	PROGRAMS_MakeFile("MOUNT.COM",MOUNT_ProgramStart);
 	PROGRAMS_MakeFile("MEM.COM",MEM_ProgramStart);
 	PROGRAMS_MakeFile("LOADFIX.COM",LOADFIX_ProgramStart);
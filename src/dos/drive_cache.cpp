@@ -18,8 +18,11 @@
 
 #include "dos_system.h"
 
+#include <sys/stat.h>
 #include <algorithm>
 #include <cassert>
+#include <cctype>
+#include <fstream>
 #include <iterator>
 #include <vector>
 
@@ -27,6 +30,10 @@
 #include "dos_inc.h"
 #include "drives.h"
 #include "support.h"
+#include "../libs/decoders/archive.h"
+
+// Identifies a valid versioned directory cache snapshot
+#define DIRCACHE_SNAPSHOT_IDENTIFIER "dc-v1"
 
 int fileInfoCounter = 0;
 
@@ -50,8 +57,124 @@ bool SortByDirNameRev(DOS_Drive_Cache::CFileInfo* const &a, DOS_Drive_Cache::CFi
 	return strcmp(a->shortname,b->shortname)>0;
 }
 
+// case-insensitive fnv-1a, so one table serves the case-sensitive
+// short names and the possibly case-insensitive host names alike
+static Bitu HashName(const char* name) {
+	Bitu hash = 2166136261u;
+	while (*name) {
+		hash ^= (Bit8u)tolower(*name++);
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+static void HashInsert(std::vector<DOS_Drive_Cache::CFileInfo*>& table, DOS_Drive_Cache::CFileInfo* info) {
+	const Bitu mask = table.size()-1;
+	Bitu slot = HashName(info->shortname) & mask;
+	while (table[slot]) slot = (slot+1) & mask;
+	table[slot] = info;
+	// entries with a generated 8.3 name get keyed under both names
+	if (strcmp(info->orgname,info->shortname)!=0) {
+		slot = HashName(info->orgname) & mask;
+		while (table[slot]) slot = (slot+1) & mask;
+		table[slot] = info;
+	}
+}
+
+void DOS_Drive_Cache::AddToNameHash(CFileInfo* dir, CFileInfo* info) {
+	// grow to keep the table at most half full with two keys per entry
+	if (dir->fileList.size()*4 >= dir->nameHash.size()) {
+		std::vector<CFileInfo*>::size_type newSize = 64;
+		while (newSize <= dir->fileList.size()*4) newSize <<= 1;
+		dir->nameHash.assign(newSize,nullptr);
+		// info is already part of the file list at this point
+		for (Bitu i=0; i<dir->fileList.size(); i++)
+			HashInsert(dir->nameHash,dir->fileList[i]);
+		return;
+	}
+	HashInsert(dir->nameHash,info);
+}
+
+DOS_Drive_Cache::CFileInfo* DOS_Drive_Cache::FindShortName(CFileInfo* dir, const char* name) {
+	if (dir->nameHash.empty()) return nullptr;
+	const Bitu mask = dir->nameHash.size()-1;
+	Bitu slot = HashName(name) & mask;
+	while (CFileInfo* info = dir->nameHash[slot]) {
+		if (strcmp(name,info->shortname)==0) return info;
+		slot = (slot+1) & mask;
+	}
+	return nullptr;
+}
+
+DOS_Drive_Cache::CFileInfo* DOS_Drive_Cache::FindLongName(CFileInfo* dir, const char* name) {
+	if (dir->nameHash.empty()) return nullptr;
+	const Bitu mask = dir->nameHash.size()-1;
+	Bitu slot = HashName(name) & mask;
+	while (CFileInfo* info = dir->nameHash[slot]) {
+#if defined (WIN32)
+		if (strcasecmp(name,info->orgname)==0) return info;
+#else
+		if (strcmp(name,info->orgname)==0) return info;
+#endif
+		slot = (slot+1) & mask;
+	}
+	return nullptr;
+}
+
+// Host mtime of a directory, or 0 if it cannot be queried. Decides
+// whether snapshot-restored contents can still be trusted.
+static time_t host_dir_mtime(const char* path) {
+	char tmp[CROSS_LEN];
+	safe_strcpy(tmp,path);
+	// strip a trailing separator, stat() on WIN32 rejects it
+	const size_t len = strlen(tmp);
+	if (len>1 && tmp[len-1]==CROSS_FILESPLIT) tmp[len-1] = 0;
+	struct stat status;
+	if (stat(tmp,&status)!=0) return 0;
+	return status.st_mtime;
+}
+
+// CFileInfo nodes come and go in bursts: every FindFirst copies the whole
+// directory listing into a fresh tree and FindNext tears it down again,
+// which makes the drive cache dominate malloc traffic during searches.
+// Recycle the nodes through a free list instead of going to the heap.
+static struct FileInfoPool {
+	std::vector<DOS_Drive_Cache::CFileInfo*> free_list;
+	~FileInfoPool() {
+		for (auto p : free_list) delete p;
+	}
+} fileInfoPool;
+
+static DOS_Drive_Cache::CFileInfo* AcquireFileInfo(void) {
+	if (fileInfoPool.free_list.empty()) return new DOS_Drive_Cache::CFileInfo;
+	DOS_Drive_Cache::CFileInfo* info = fileInfoPool.free_list.back();
+	fileInfoPool.free_list.pop_back();
+	return info;
+}
+
+static void ReleaseFileInfo(DOS_Drive_Cache::CFileInfo* info) {
+	// children go back as well; reset the node to freshly constructed
+	// state but keep the vector capacities for the next listing
+	for (auto p : info->fileList) {
+		if (p) ReleaseFileInfo(p);
+	}
+	info->fileList.clear();
+	info->longNameList.clear();
+	info->nameHash.clear();
+	info->orgname[0] = 0;
+	info->shortname[0] = 0;
+	info->isOverlayDir = false;
+	info->isDir = false;
+	info->fromSnapshot = false;
+	info->mtime = 0;
+	info->id = MAX_OPENDIRS;
+	info->nextEntry = 0;
+	info->shortNr = 0;
+	fileInfoPool.free_list.push_back(info);
+}
+
 DOS_Drive_Cache::DOS_Drive_Cache(void)
-	: dirBase(new CFileInfo),
+	: dirBase(AcquireFileInfo()),
 	  dirPath{0},
 	  basePath{0},
 	  sortDirType(DIRALPHABETICAL),
@@ -63,12 +186,14 @@ DOS_Drive_Cache::DOS_Drive_Cache(void)
 	  dirFindFirst{nullptr},
 	  nextFreeFindFirst(0),
 	  label{0},
+	  snapshotFile{0},
+	  snapshotTrusted(false),
 	  updatelabel(true)
 {
 }
 
 DOS_Drive_Cache::DOS_Drive_Cache(const char* path)
-	: dirBase(new CFileInfo),
+	: dirBase(AcquireFileInfo()),
 	  dirPath{0},
 	  basePath{0},
 	  sortDirType(DIRALPHABETICAL),
@@ -80,12 +205,16 @@ DOS_Drive_Cache::DOS_Drive_Cache(const char* path)
 	  dirFindFirst{nullptr},
 	  nextFreeFindFirst(0),
 	  label{0},
+	  snapshotFile{0},
+	  snapshotTrusted(false),
 	  updatelabel(true)
 {
 	SetBaseDir(path);
 }
 
 DOS_Drive_Cache::~DOS_Drive_Cache(void) {
+	if (snapshotFile[0] && !snapshotTrusted)
+		SaveSnapshot();
 	Clear();
 	for (Bit32u i=0; i<MAX_OPENDIRS; i++) {
 		DeleteFileInfo(dirFindFirst[i]);
@@ -104,7 +233,7 @@ void DOS_Drive_Cache::Clear(void) {
 void DOS_Drive_Cache::EmptyCache(void) {
 	// Empty Cache and reinit
 	Clear();
-	dirBase		= new CFileInfo;
+	dirBase		= AcquireFileInfo();
 	save_dir	= nullptr;
 	srchNr		= 0;
 	SetBaseDir(basePath);
@@ -121,6 +250,145 @@ void DOS_Drive_Cache::SetLabel(const char* vname,bool cdrom,bool allowupdate) {
 	LOG(LOG_DOSMISC,LOG_NORMAL)("DIRCACHE: Set volume label to %s",label);
 }
 
+void DOS_Drive_Cache::SetSnapshotFile(const char* file, bool trusted) {
+	safe_strcpy(snapshotFile, file);
+	if (!snapshotFile[0]) return;
+	// a trusted snapshot (read-only mounts shared between instances) is
+	// taken as authoritative: no per-directory revalidation against the
+	// host and no write-back, so every instance after the first runs off
+	// the one shared file
+	if (LoadSnapshot() && trusted)
+		snapshotTrusted = true;
+}
+
+void DOS_Drive_Cache::LoadSnapshotDir(Archive<std::ifstream>& ar, CFileInfo* dir) {
+	int64_t mtime;
+	uint32_t numEntries;
+	ar >> mtime >> numEntries;
+	// a directory that was already scanned this session is fresher than
+	// the snapshot; keep its entries but still walk the serialized node
+	// so cached subtrees below it get restored
+	const bool restore = dir->fileList.empty();
+	for (uint32_t i=0; i<numEntries; i++) {
+		std::string name;
+		bool is_directory;
+		ar >> name >> is_directory;
+		if (restore) CreateEntry(dir,name.c_str(),is_directory);
+	}
+	if (restore && numEntries) {
+		dir->fromSnapshot = true;
+		dir->mtime = (time_t)mtime;
+	}
+	uint32_t numSubDirs;
+	ar >> numSubDirs;
+	for (uint32_t i=0; i<numSubDirs; i++) {
+		std::string name;
+		ar >> name;
+		CFileInfo* sub = nullptr;
+		for (Bit32u n=0; n<dir->fileList.size(); n++) {
+			if (dir->fileList[n]->isDir && strcmp(dir->fileList[n]->orgname,name.c_str())==0) {
+				sub = dir->fileList[n];
+				break;
+			}
+		}
+		if (sub) {
+			LoadSnapshotDir(ar,sub);
+		} else {
+			// the directory vanished from the host; parse its node into
+			// a scratch entry to keep the stream in sync, then drop it
+			CFileInfo scratch;
+			LoadSnapshotDir(ar,&scratch);
+		}
+	}
+}
+
+bool DOS_Drive_Cache::LoadSnapshot(void) {
+	std::ifstream infile(snapshotFile, std::ios_base::binary);
+	if (!infile.is_open())
+		return false;
+	try {
+		Archive<std::ifstream> ar(infile);
+		std::string identifier;
+		ar >> identifier;
+		if (identifier != DIRCACHE_SNAPSHOT_IDENTIFIER)
+			return false;
+		std::string base;
+		ar >> base;
+		// snapshots are tied to the directory they were taken from
+		if (base != basePath)
+			return false;
+		LoadSnapshotDir(ar,dirBase);
+	} catch (const std::exception&) {
+		// truncated or corrupt snapshot: throw away whatever partial
+		// state it produced and fall back to plain host scans
+		LOG(LOG_DOSMISC,LOG_WARN)("DIRCACHE: Discarding malformed snapshot %s",snapshotFile);
+		EmptyCache();
+		return false;
+	}
+	LOG(LOG_DOSMISC,LOG_NORMAL)("DIRCACHE: Restored directory snapshot %s",snapshotFile);
+	return true;
+}
+
+void DOS_Drive_Cache::SaveSnapshotDir(Archive<std::ofstream>& ar, CFileInfo* dir) {
+	// overlay entries are virtual and get rebuilt by the overlay drive,
+	// so they are left out of the snapshot
+	uint32_t numEntries = 0;
+	for (Bit32u i=0; i<dir->fileList.size(); i++) {
+		if (!dir->fileList[i]->isOverlayDir) numEntries++;
+	}
+	ar << (int64_t)dir->mtime << numEntries;
+	for (Bit32u i=0; i<dir->fileList.size(); i++) {
+		CFileInfo* info = dir->fileList[i];
+		if (info->isOverlayDir) continue;
+		ar << std::string(info->orgname) << info->isDir;
+	}
+	uint32_t numSubDirs = 0;
+	for (Bit32u i=0; i<dir->fileList.size(); i++) {
+		CFileInfo* info = dir->fileList[i];
+		if (info->isDir && !info->isOverlayDir && !info->fileList.empty() &&
+		    strcmp(info->orgname,".")!=0 && strcmp(info->orgname,"..")!=0)
+			numSubDirs++;
+	}
+	ar << numSubDirs;
+	for (Bit32u i=0; i<dir->fileList.size(); i++) {
+		CFileInfo* info = dir->fileList[i];
+		if (info->isDir && !info->isOverlayDir && !info->fileList.empty() &&
+		    strcmp(info->orgname,".")!=0 && strcmp(info->orgname,"..")!=0) {
+			ar << std::string(info->orgname);
+			SaveSnapshotDir(ar,info);
+		}
+	}
+}
+
+void DOS_Drive_Cache::SaveSnapshot(void) {
+	if (!dirBase || dirBase->fileList.empty())
+		return;
+	std::ofstream outfile(snapshotFile, std::ios_base::trunc | std::ios_base::binary);
+	// writing the snapshot is optional; without write access the
+	// directories are simply scanned again on the next mount
+	if (!outfile.is_open())
+		return;
+	Archive<std::ofstream> ar(outfile);
+	ar << std::string(DIRCACHE_SNAPSHOT_IDENTIFIER) << std::string(basePath);
+	SaveSnapshotDir(ar,dirBase);
+}
+
+void DOS_Drive_Cache::ValidateSnapshotDir(CFileInfo* dir, const char* expand) {
+	if (!dir->fromSnapshot) return;
+	if (snapshotTrusted) return;
+	dir->fromSnapshot = false;
+	if (host_dir_mtime(expand) == dir->mtime) return;
+	// the host directory changed since the snapshot was taken: drop the
+	// restored contents so the caller rescans it like an uncached dir
+	for (Bit32u i=0; i<dir->fileList.size(); i++) {
+		DeleteFileInfo(dir->fileList[i]);
+		dir->fileList[i] = nullptr;
+	}
+	dir->fileList.clear();
+	dir->longNameList.clear();
+	dir->nameHash.clear();
+}
+
 Bit16u DOS_Drive_Cache::GetFreeID(CFileInfo* dir) {
 	if (dir->id != MAX_OPENDIRS)
 		return dir->id;
@@ -343,6 +611,7 @@ void DOS_Drive_Cache::CacheOut(const char* path, bool ignoreLastDir) {
 	// clear lists
 	dir->fileList.clear();
 	dir->longNameList.clear();
+	dir->nameHash.clear();
 	save_dir = nullptr;
 }
 
@@ -366,6 +635,17 @@ bool DOS_Drive_Cache::GetShortName(const char* fullname, char* shortname) {
 	if (GCC_UNLIKELY(filelist_size<=0))
 		return false;
 
+	if (!curDir->nameHash.empty()) {
+		CFileInfo* info = FindLongName(curDir,pos);
+		// shortNr is only set for entries with a generated 8.3 name,
+		// i.e. exactly the longNameList members the walk below finds
+		if (info && info->shortNr) {
+			safe_strncpy(shortname, info->shortname, DOS_NAMELENGTH_ASCII);
+			return true;
+		}
+		return false;
+	}
+
 	// The orgname part of the list is not sorted (shortname is)! So we can only walk through it.
 	for(Bitu i = 0; i < filelist_size; i++) {
 #if defined (WIN32)
@@ -513,19 +793,24 @@ Bits DOS_Drive_Cache::GetLongName(CFileInfo* curDir, char* shortName, const size
 
 	// Remove dot, if no extension...
 	RemoveTrailingDot(shortName);
-	// Search long name and return array number of element
-	Bits low	= 0;
-	Bits high	= (Bits)(filelist_size-1);
-	Bits mid,res;
-	while (low<=high) {
-		mid = (low+high)/2;
-		res = strcmp(shortName,curDir->fileList[mid]->shortname);
-		if (res>0)	low  = mid+1; else
-		if (res<0)	high = mid-1; else
-		{	// Found
-			safe_strncpy(shortName, curDir->fileList[mid]->orgname, shortName_len);
-			return mid;
-		};
+	// The hash decides existence; the binary search below is kept to
+	// supply the array index the callers expect on a hit.
+	const bool mayExist = curDir->nameHash.empty() || FindShortName(curDir,shortName);
+	if (mayExist) {
+		// Search long name and return array number of element
+		Bits low	= 0;
+		Bits high	= (Bits)(filelist_size-1);
+		Bits mid,res;
+		while (low<=high) {
+			mid = (low+high)/2;
+			res = strcmp(shortName,curDir->fileList[mid]->shortname);
+			if (res>0)	low  = mid+1; else
+			if (res<0)	high = mid-1; else
+			{	// Found
+				safe_strncpy(shortName, curDir->fileList[mid]->orgname, shortName_len);
+				return mid;
+			};
+		}
 	}
 #ifdef WINE_DRIVE_SUPPORT
 	if (strlen(shortName) < 8 || shortName[4] != '~' || shortName[5] == '.' || shortName[6] == '.' || shortName[7] == '.') return -1; // not available
@@ -533,7 +818,7 @@ Bits DOS_Drive_Cache::GetLongName(CFileInfo* curDir, char* shortName, const size
 	// The above test is rather strict as the following loop can be really slow if filelist_size is large.
 	char buff[CROSS_LEN];
 	for (Bitu i = 0; i < filelist_size; i++) {
-		res = wine_hash_short_file_name(curDir->fileList[i]->orgname,buff);
+		Bits res = wine_hash_short_file_name(curDir->fileList[i]->orgname,buff);
 		buff[res] = 0;
 		if (!strcmp(shortName,buff)) {	
 			// Found
@@ -687,7 +972,9 @@ DOS_Drive_Cache::CFileInfo* DOS_Drive_Cache::FindDirInfo(const char* path, char*
 	start += strlen(basePath);
 	safe_strncpy(expandedPath, basePath, CROSS_LEN);
 
-	// hehe, baseDir should be cached in... 
+	ValidateSnapshotDir(curDir,basePath);
+
+	// hehe, baseDir should be cached in...
 	if (!IsCachedIn(curDir)) {
 		safe_strcpy(work, basePath);
 		if (OpenDir(curDir,work,id)) {
@@ -726,6 +1013,7 @@ DOS_Drive_Cache::CFileInfo* DOS_Drive_Cache::FindDirInfo(const char* path, char*
 		if ((nextDir>=0) && curDir->fileList[nextDir]->isDir) {
 			curDir = curDir->fileList[nextDir];
 			safe_strcpy(curDir->orgname, dir);
+			ValidateSnapshotDir(curDir,expandedPath);
 			if (!IsCachedIn(curDir)) {
 				if (OpenDir(curDir,expandedPath,id)) {
 					char buffer[CROSS_LEN];
@@ -793,7 +1081,7 @@ bool DOS_Drive_Cache::OpenDir(CFileInfo* dir, const char* expand, Bit16u& id) {
 }
 
 void DOS_Drive_Cache::CreateEntry(CFileInfo* dir, const char* name, bool is_directory) {
-	CFileInfo* info = new CFileInfo;
+	CFileInfo* info = AcquireFileInfo();
 	safe_strcpy(info->orgname, name);
 	info->shortNr = 0;
 	info->isDir = is_directory;
@@ -825,10 +1113,11 @@ void DOS_Drive_Cache::CreateEntry(CFileInfo* dir, const char* name, bool is_dire
 		// empty file list, append
 		dir->fileList.push_back(info);
 	}
+	AddToNameHash(dir,info);
 }
 
 void DOS_Drive_Cache::CopyEntry(CFileInfo* dir, CFileInfo* from) {
-	CFileInfo* info = new CFileInfo;
+	CFileInfo* info = AcquireFileInfo();
 	// just copy things into new fileinfo
 	safe_strcpy(info->orgname, from->orgname);
 	safe_strcpy(info->shortname, from->shortname);
@@ -866,6 +1155,10 @@ bool DOS_Drive_Cache::ReadDir(Bit16u id, char* &result) {
 		// close dir
 		close_directory(dirp);
 
+		// remember the host mtime so a later snapshot of this
+		// directory can be validated against it
+		dirSearch[id]->mtime = host_dir_mtime(dirPath);
+
 		// Info
 /*		if (!dirp) {
 			LOG_DEBUG("DIR: Error Caching in %s",dirPath);			
@@ -931,7 +1224,7 @@ bool DOS_Drive_Cache::FindFirst(char* path, Bit16u& id) {
 	   
 	}
 	assert(dirFindFirst[dirFindFirstID] == nullptr);
-	dirFindFirst[dirFindFirstID] = new CFileInfo();
+	dirFindFirst[dirFindFirstID] = AcquireFileInfo();
 	dirFindFirst[dirFindFirstID]->nextEntry = 0;
 
 	// Copy entries to use with FindNext
@@ -982,6 +1275,6 @@ void DOS_Drive_Cache::ClearFileInfo(CFileInfo *dir) {
 void DOS_Drive_Cache::DeleteFileInfo(CFileInfo *dir) {
 	if (dir) {
 		ClearFileInfo(dir);
-		delete dir;
+		ReleaseFileInfo(dir);
 	}
 }
@@ -301,6 +301,18 @@ Bit32u fatDrive::getClustFirstSect(Bit32u clustNum) {
 	return ((clustNum - 2) * bootbuffer.sectorspercluster) + firstDataSector;
 }
 
+Bit8u* fatDrive::getFatSectBuffer(Bit32u fatsectnum) {
+	fatSectCacheEntry &entry = fatSectCache[fatsectnum % fatSectCacheSlots];
+	if(entry.sectnum != fatsectnum) {
+		/* Load two sectors at once for FAT12 */
+		readSector(fatsectnum, &entry.data[0]);
+		if (fattype==FAT12)
+			readSector(fatsectnum+1, &entry.data[512]);
+		entry.sectnum = fatsectnum;
+	}
+	return entry.data;
+}
+
 Bit32u fatDrive::getClusterValue(Bit32u clustNum) {
 	Bit32u fatoffset=0;
 	Bit32u fatsectnum;
@@ -321,13 +333,7 @@ Bit32u fatDrive::getClusterValue(Bit32u clustNum) {
 	fatsectnum = bootbuffer.reservedsectors + (fatoffset / bootbuffer.bytespersector) + partSectOff;
 	fatentoff = fatoffset % bootbuffer.bytespersector;
 
-	if(curFatSect != fatsectnum) {
-		/* Load two sectors at once for FAT12 */
-		readSector(fatsectnum, &fatSectBuffer[0]);
-		if (fattype==FAT12)
-			readSector(fatsectnum+1, &fatSectBuffer[512]);
-		curFatSect = fatsectnum;
-	}
+	Bit8u* fatSectBuffer = getFatSectBuffer(fatsectnum);
 
 	switch(fattype) {
 		case FAT12:
@@ -368,13 +374,7 @@ void fatDrive::setClusterValue(Bit32u clustNum, Bit32u clustValue) {
 	fatsectnum = bootbuffer.reservedsectors + (fatoffset / bootbuffer.bytespersector) + partSectOff;
 	fatentoff = fatoffset % bootbuffer.bytespersector;
 
-	if(curFatSect != fatsectnum) {
-		/* Load two sectors at once for FAT12 */
-		readSector(fatsectnum, &fatSectBuffer[0]);
-		if (fattype==FAT12)
-			readSector(fatsectnum+1, &fatSectBuffer[512]);
-		curFatSect = fatsectnum;
-	}
+	Bit8u* fatSectBuffer = getFatSectBuffer(fatsectnum);
 
 	switch(fattype) {
 		case FAT12: {
@@ -407,6 +407,14 @@ void fatDrive::setClusterValue(Bit32u clustNum, Bit32u clustValue) {
 				writeSector(fatsectnum+1+(fc * bootbuffer.sectorsperfat), &fatSectBuffer[512]);
 		}
 	}
+	if (fattype==FAT12) {
+		// neighbouring slots may hold their own copy of the sectors
+		// just modified (each slot spans two); drop them
+		fatSectCache[(fatsectnum+1) % fatSectCacheSlots].sectnum = 0xffffffff;
+		fatSectCache[(fatsectnum-1) % fatSectCacheSlots].sectnum = 0xffffffff;
+	}
+	// rewriting a FAT entry can relink any chain, drop the cached runs
+	chainCache.clear();
 }
 
 bool fatDrive::getEntryName(char *fullname, char *entname) {
@@ -560,15 +568,17 @@ Bit32u fatDrive::getAbsoluteSectFromBytePos(Bit32u startClustNum, Bit32u bytePos
 }
 
 Bit32u fatDrive::getAbsoluteSectFromChain(Bit32u startClustNum, Bit32u logicalSector) {
-	Bit32s skipClust = logicalSector / bootbuffer.sectorspercluster;
+	Bit32u skipClust = logicalSector / bootbuffer.sectorspercluster;
 	Bit32u sectClust = logicalSector % bootbuffer.sectorspercluster;
 
-	Bit32u currentClust = startClustNum;
-	Bit32u testvalue;
+	/* Clusters resolved on earlier walks of this chain are reused, so a
+	 * seek only walks the part of the chain it hasn't seen before. */
+	std::vector<Bit32u>& chain = chainCache[startClustNum];
+	if (chain.empty()) chain.push_back(startClustNum);
 
-	while(skipClust!=0) {
+	while(skipClust >= chain.size()) {
 		bool isEOF = false;
-		testvalue = getClusterValue(currentClust);
+		Bit32u testvalue = getClusterValue(chain.back());
 		switch(fattype) {
 			case FAT12:
 				if(testvalue >= 0xff8) isEOF = true;
@@ -580,19 +590,18 @@ Bit32u fatDrive::getAbsoluteSectFromChain(Bit32u startClustNum, Bit32u logicalSe
 				if(testvalue >= 0xfffffff8) isEOF = true;
 				break;
 		}
-		if((isEOF) && (skipClust>=1)) {
+		if(isEOF) {
 			//LOG_MSG("End of cluster chain reached before end of logical sector seek!");
-			if (skipClust == 1 && fattype == FAT12) {
+			if (skipClust == chain.size() && fattype == FAT12) {
 				//break;
 				LOG(LOG_DOSMISC,LOG_ERROR)("End of cluster chain reached, but maybe good afterall ?");
 			}
 			return 0;
 		}
-		currentClust = testvalue;
-		--skipClust;
+		chain.push_back(testvalue);
 	}
 
-	return (getClustFirstSect(currentClust) + sectClust);
+	return (getClustFirstSect(chain[skipClust]) + sectClust);
 }
 
 void fatDrive::deleteClustChain(Bit32u startCluster, Bit32u bytePos) {
@@ -720,8 +729,7 @@ fatDrive::fatDrive(const char *sysFilename,
 	  firstDataSector(0),
 	  firstRootDirSect(0),
 	  cwdDirCluster(0),
-	  fatSectBuffer{0},
-	  curFatSect(0)
+	  fatSectCache{}
 {
 	FILE *diskfile;
 	Bit32u filesize;
@@ -901,8 +909,11 @@ fatDrive::fatDrive(const char *sysFilename,
 	/* There is no cluster 0, this means we are in the root directory */
 	cwdDirCluster = 0;
 
-	memset(fatSectBuffer,0,1024);
-	curFatSect = 0xffffffff;
+	for (Bit32u i=0; i<fatSectCacheSlots; i++) {
+		memset(fatSectCache[i].data,0,sizeof(fatSectCache[i].data));
+		fatSectCache[i].sectnum = 0xffffffff;
+	}
+	chainCache.clear();
 
 	safe_strcpy(info, "fatDrive ");
 	safe_strcat(info, sysFilename);
@@ -136,6 +136,7 @@ isoDrive::isoDrive(char driveLetter, const char *fileName, Bit8u mediaid, int &e
          :iso(false),
           dataCD(false),
           mediaid(0),
+          keptImage(NULL),
           subUnit(0),
           driveLetter('\0')
  {
@@ -171,13 +172,29 @@ isoDrive::isoDrive(char driveLetter, const char *fileName, Bit8u mediaid, int &e
 	}
 }
 
-isoDrive::~isoDrive() { }
+isoDrive::~isoDrive() {
+	// MSCDEX deletes the installed image itself when the drive is
+	// removed; a disc of ours still waiting in the swap list is only
+	// known to us
+	if (keptImage && CDROM_Interface_Image::images[subUnit] != keptImage)
+		delete keptImage;
+}
 
 int isoDrive::UpdateMscdex(char driveLetter, const char* path, Bit8u& subUnit) {
 	if (MSCDEX_HasDrive(driveLetter)) {
 		subUnit = MSCDEX_GetSubUnit(driveLetter);
+		if (keptImage) {
+			// disc swap: this image was parsed when it was mounted and
+			// kept since, so switching is just a re-register; the image
+			// swapped out stays parsed for the next time it goes in
+			if (CDROM_Interface_Image::images[subUnit] != keptImage) {
+				keptImage->Reactivate(subUnit);
+				MSCDEX_ReplaceDrive(keptImage, subUnit, false);
+			}
+			return 0;
+		}
 		CDROM_Interface_Image* oldCdrom = CDROM_Interface_Image::images[subUnit];
-		CDROM_Interface* cdrom = new CDROM_Interface_Image(subUnit);
+		CDROM_Interface_Image* cdrom = new CDROM_Interface_Image(subUnit);
 		char pathCopy[CROSS_LEN];
 		safe_strncpy(pathCopy, path, CROSS_LEN);
 		if (!cdrom->SetDevice(pathCopy)) {
@@ -185,14 +202,23 @@ int isoDrive::UpdateMscdex(char driveLetter, const char* path, Bit8u& subUnit) {
 			delete cdrom;
 			return 3;
 		}
-		MSCDEX_ReplaceDrive(cdrom, subUnit);
+		keptImage = cdrom;
+		// the outgoing image belongs to the drive being swapped out
+		MSCDEX_ReplaceDrive(cdrom, subUnit, false);
 		return 0;
 	} else {
-		return MSCDEX_AddDrive(driveLetter, path, subUnit);
+		int result = MSCDEX_AddDrive(driveLetter, path, subUnit);
+		if (result == 0) keptImage = CDROM_Interface_Image::images[subUnit];
+		return result;
 	}
 }
 
 void isoDrive::Activate(void) {
+	// our disc went back in; the kept image is unchanged so the parsed
+	// directories and cached sectors are still good, only the find
+	// iterators handed out before we were swapped out must go
+	memset(dirIterators, 0, sizeof(dirIterators));
+	nextFreeDirIterator = 0;
 	UpdateMscdex(driveLetter, fileName, subUnit);
 }
 
@@ -379,14 +405,23 @@ Bits isoDrive::UnMount(void) {
 
 int isoDrive::GetDirIterator(const isoDirEntry* de) {
 	int dirIterator = nextFreeDirIterator;
-	
-	// get start and end sector of the directory entry (pad end sector if necessary)
-	dirIterators[dirIterator].currentSector = EXTENT_LOCATION(*de);
-	dirIterators[dirIterator].endSector =
-		EXTENT_LOCATION(*de) + DATA_LENGTH(*de) / ISO_FRAMESIZE - 1;
-	if (DATA_LENGTH(*de) % ISO_FRAMESIZE != 0)
-		dirIterators[dirIterator].endSector++;
-	
+
+	// serve from the parsed directory cache if this extent is already in it
+	std::map<Bit32u, CachedDir>::iterator cached = dirCache.find(EXTENT_LOCATION(*de));
+	if (cached != dirCache.end() && cached->second.loaded) {
+		dirIterators[dirIterator].cache = &cached->second;
+		dirIterators[dirIterator].cachePos = 0;
+	} else {
+		dirIterators[dirIterator].cache = NULL;
+
+		// get start and end sector of the directory entry (pad end sector if necessary)
+		dirIterators[dirIterator].currentSector = EXTENT_LOCATION(*de);
+		dirIterators[dirIterator].endSector =
+			EXTENT_LOCATION(*de) + DATA_LENGTH(*de) / ISO_FRAMESIZE - 1;
+		if (DATA_LENGTH(*de) % ISO_FRAMESIZE != 0)
+			dirIterators[dirIterator].endSector++;
+	}
+
 	// reset position and mark as valid
 	dirIterators[dirIterator].pos = 0;
 	dirIterators[dirIterator].valid = true;
@@ -401,7 +436,14 @@ bool isoDrive::GetNextDirEntry(const int dirIteratorHandle, isoDirEntry* de) {
 	bool result = false;
 	Bit8u* buffer = NULL;
 	DirIterator& dirIterator = dirIterators[dirIteratorHandle];
-	
+
+	// iterators over an already parsed directory never touch the sectors again
+	if (dirIterator.valid && dirIterator.cache) {
+		if (dirIterator.cachePos >= dirIterator.cache->entries.size()) return false;
+		*de = dirIterator.cache->entries[dirIterator.cachePos++];
+		return true;
+	}
+
 	// check if the directory entry is valid
 	if (dirIterator.valid && ReadCachedSector(&buffer, dirIterator.currentSector)) {
 		// check if the next sector has to be read
@@ -520,6 +562,37 @@ bool isoDrive :: loadImage() {
 	return false;
 }
 
+// build the hash key the way the old linear search compared idents:
+// case-insensitive and limited to the first ISO_MAX_FILENAME_LENGTH characters
+static void makeDirIndexKey(char* key, const char* name) {
+	Bitu i = 0;
+	for (; i < ISO_MAX_FILENAME_LENGTH && name[i]; i++) key[i] = toupper(name[i]);
+	key[i] = 0;
+}
+
+isoDrive::CachedDir* isoDrive :: GetCachedDir(const isoDirEntry* de) {
+	CachedDir& dir = dirCache[EXTENT_LOCATION(*de)];
+	if (!dir.loaded) {
+		// parse the whole directory once through the sector walker; while
+		// loaded is still false GetDirIterator keeps reading the sectors
+		int dirIterator = GetDirIterator(de);
+		isoDirEntry entry;
+		while (GetNextDirEntry(dirIterator, &entry)) dir.entries.push_back(entry);
+		FreeDirIterator(dirIterator);
+
+		char key[ISO_MAX_FILENAME_LENGTH + 1];
+		for (size_t i = 0; i < dir.entries.size(); i++) {
+			Bit8u flags = iso ? dir.entries[i].fileFlags : dir.entries[i].timeZone;
+			if (IS_ASSOC(flags)) continue;
+			makeDirIndexKey(key, (char*)dir.entries[i].ident);
+			// first match wins, as in the linear search
+			if (dir.index.find(key) == dir.index.end()) dir.index[key] = i;
+		}
+		dir.loaded = true;
+	}
+	return &dir;
+}
+
 bool isoDrive :: lookup(isoDirEntry *de, const char *path) {
 	if (!dataCD) return false;
 	*de = this->rootEntry;
@@ -542,14 +615,15 @@ bool isoDrive :: lookup(isoDirEntry *de, const char *path) {
 				if (name[nameLength - 1] == '.') name[nameLength - 1] = 0;
 			}
 			
-			// look for the current path element
-			int dirIterator = GetDirIterator(de);
-			while (!found && GetNextDirEntry(dirIterator, de)) {
-				if (!IS_ASSOC(FLAGS2) && (0 == strncasecmp((char*) de->ident, name, ISO_MAX_FILENAME_LENGTH))) {
-					found = true;
-				}
+			// look for the current path element in the directory index
+			CachedDir* dir = GetCachedDir(de);
+			char key[ISO_MAX_FILENAME_LENGTH + 1];
+			makeDirIndexKey(key, name);
+			std::unordered_map<std::string, size_t>::iterator entry = dir->index.find(key);
+			if (entry != dir->index.end()) {
+				*de = dir->entries[entry->second];
+				found = true;
 			}
-			FreeDirIterator(dirIterator);
 		}
 		if (!found) return false;
 	}
@@ -27,14 +27,29 @@
 #include <time.h>
 #include <errno.h>
 
+#include <SDL.h>
+#include <SDL_thread.h>
+
 #include "dos_inc.h"
 #include "dos_mscdex.h"
 #include "support.h"
 #include "cross.h"
 #include "inout.h"
+#include "profiler.h"
+
+// stdio buffer for host files; a generous size doubles as read-ahead
+// for the sequential access patterns DOS programs mostly use
+#define HOST_FILE_BUFSIZE            65536
+// bound on the number of deferred host writes kept in flight; a full
+// queue stalls the producer, which caps both memory use and data loss
+#define WRITE_BEHIND_QUEUE_SIZE         64
 
 bool localDrive::FileCreate(DOS_File * * file,char * name,Bit16u /*attributes*/) {
 //TODO Maybe care for attributes but not likely
+	if (read_only) {
+		DOS_SetError(DOSERR_ACCESS_DENIED);
+		return false;
+	}
 	char newname[CROSS_LEN];
 	safe_strcpy(newname, basedir);
 	safe_strcat(newname, name);
@@ -55,7 +70,8 @@ bool localDrive::FileCreate(DOS_File * * file,char * name,Bit16u /*attributes*/)
 		LOG_MSG("Warning: file creation failed: %s",newname);
 		return false;
 	}
-   
+	setvbuf(hand,NULL,_IOFBF,HOST_FILE_BUFSIZE);
+
 	if (!existing_file) dirCache.AddEntry(newname, true);
 	/* Make the 16 bit device information */
 	*file=new localFile(name,hand);
@@ -71,6 +87,14 @@ bool localDrive::IsFirstEncounter(const std::string& filename) {
 }
 
 bool localDrive::FileOpen(DOS_File** file, char * name, Bit32u flags) {
+	if (read_only) {
+		if ((flags&0xf)==OPEN_READWRITE) {
+			flags &= ~OPEN_READWRITE;
+		} else if ((flags&0xf)==OPEN_WRITE) {
+			DOS_SetError(DOSERR_ACCESS_DENIED);
+			return false;
+		}
+	}
 	const char* type = nullptr;
 	switch (flags&0xf) {
 	case OPEN_READ:        type = "rb" ; break;
@@ -160,8 +184,10 @@ bool localDrive::FileOpen(DOS_File** file, char * name, Bit32u flags) {
 #endif
 
 	if (fhandle) {
+		setvbuf(fhandle,NULL,_IOFBF,HOST_FILE_BUFSIZE);
 		*file = new localFile(name, fhandle);
 		(*file)->flags = flags;  // for the inheritance flag and maybe check for others.
+		if (read_only) (*file)->SetFlagReadOnlyMedium();
 	} else {
 		// Otherwise we really can't open the file.
 		DOS_SetError(DOSERR_INVALID_HANDLE);
@@ -190,6 +216,10 @@ bool localDrive::GetSystemFilename(char *sysName, char const * const dosName) {
 }
 
 bool localDrive::FileUnlink(char * name) {
+	if (read_only) {
+		DOS_SetError(DOSERR_ACCESS_DENIED);
+		return false;
+	}
 	char newname[CROSS_LEN];
 	safe_strcpy(newname, basedir);
 	safe_strcat(newname, name);
@@ -251,6 +281,10 @@ bool localDrive::FindFirst(char * _dir,DOS_DTA & dta,bool fcb_findfirst) {
 	}
 	safe_strcpy(srchInfo[id].srch_dir, tempDir);
 	dta.SetDirID(id);
+	// a recycled search id must not serve entries prefetched for its
+	// previous owner
+	srchBatch[id].next = srchBatch[id].count = 0;
+	srchBatch[id].done = false;
 	
 	Bit8u sAttr;
 	dta.GetSearchParams(sAttr,tempDir);
@@ -284,59 +318,87 @@ bool localDrive::FindFirst(char * _dir,DOS_DTA & dta,bool fcb_findfirst) {
 	return FindNext(dta);
 }
 
-bool localDrive::FindNext(DOS_DTA & dta) {
+// Gather up to SRCH_BATCH_SIZE matching entries from the cached listing
+// in one pass; FindNext then serves them with a single DTA write per call.
+bool localDrive::FillSearchBatch(Bit16u id,Bit8u srch_attr,const char* srch_pattern) {
 
 	char * dir_ent;
 	struct stat stat_block;
 	char full_name[CROSS_LEN];
 	char dir_entcopy[CROSS_LEN];
 
-	Bit8u srch_attr;char srch_pattern[DOS_NAMELENGTH_ASCII];
 	Bit8u find_attr;
 
-	dta.GetSearchParams(srch_attr,srch_pattern);
-	Bit16u id = dta.GetDirID();
+	auto& batch = srchBatch[id];
+	batch.next = batch.count = 0;
+	batch.done = false;
 
-again:
-	if (!dirCache.FindNext(id,dir_ent)) {
-		DOS_SetError(DOSERR_NO_MORE_FILES);
-		return false;
-	}
-	if (!WildFileCmp(dir_ent,srch_pattern)) goto again;
+	while (batch.count < SRCH_BATCH_SIZE) {
+		if (!dirCache.FindNext(id,dir_ent)) {
+			batch.done = true;
+			break;
+		}
+		if (!WildFileCmp(dir_ent,srch_pattern)) continue;
 
-	safe_strcpy(full_name, srchInfo[id].srch_dir);
-	safe_strcat(full_name, dir_ent);
+		safe_strcpy(full_name, srchInfo[id].srch_dir);
+		safe_strcat(full_name, dir_ent);
 
-	//GetExpandName might indirectly destroy dir_ent (by caching in a new directory 
-	//and due to its design dir_ent might be lost.)
-	//Copying dir_ent first
-	safe_strcpy(dir_entcopy, dir_ent);
-	if (stat(dirCache.GetExpandName(full_name),&stat_block)!=0) { 
-		goto again;//No symlinks and such
-	}	
+		//GetExpandName might indirectly destroy dir_ent (by caching in a new directory
+		//and due to its design dir_ent might be lost.)
+		//Copying dir_ent first
+		safe_strcpy(dir_entcopy, dir_ent);
+		if (stat(dirCache.GetExpandName(full_name),&stat_block)!=0) {
+			continue;//No symlinks and such
+		}
 
-	if (stat_block.st_mode & S_IFDIR) find_attr=DOS_ATTR_DIRECTORY;
-	else find_attr=DOS_ATTR_ARCHIVE;
- 	if (~srch_attr & find_attr & (DOS_ATTR_DIRECTORY | DOS_ATTR_HIDDEN | DOS_ATTR_SYSTEM)) goto again;
-	
-	/*file is okay, setup everything to be copied in DTA Block */
-	char find_name[DOS_NAMELENGTH_ASCII];Bit16u find_date,find_time;Bit32u find_size;
+		if (stat_block.st_mode & S_IFDIR) find_attr=DOS_ATTR_DIRECTORY;
+		else find_attr=DOS_ATTR_ARCHIVE;
+		if (~srch_attr & find_attr & (DOS_ATTR_DIRECTORY | DOS_ATTR_HIDDEN | DOS_ATTR_SYSTEM)) continue;
 
-	if (strlen(dir_entcopy)<DOS_NAMELENGTH_ASCII) {
-		safe_strcpy(find_name, dir_entcopy);
-		upcase(find_name);
-	} 
+		/*file is okay, setup everything to be copied in DTA Block */
+		auto& res = batch.entries[batch.count++];
 
-	find_size=(Bit32u) stat_block.st_size;
-	struct tm *time;
-	if ((time=localtime(&stat_block.st_mtime))!=0) {
-		find_date=DOS_PackDate((Bit16u)(time->tm_year+1900),(Bit16u)(time->tm_mon+1),(Bit16u)time->tm_mday);
-		find_time=DOS_PackTime((Bit16u)time->tm_hour,(Bit16u)time->tm_min,(Bit16u)time->tm_sec);
-	} else {
-		find_time=6; 
-		find_date=4;
+		res.name[0]=0;
+		if (strlen(dir_entcopy)<DOS_NAMELENGTH_ASCII) {
+			safe_strcpy(res.name, dir_entcopy);
+			upcase(res.name);
+		}
+
+		res.size=(Bit32u) stat_block.st_size;
+		struct tm *time;
+		if ((time=localtime(&stat_block.st_mtime))!=0) {
+			res.date=DOS_PackDate((Bit16u)(time->tm_year+1900),(Bit16u)(time->tm_mon+1),(Bit16u)time->tm_mday);
+			res.time=DOS_PackTime((Bit16u)time->tm_hour,(Bit16u)time->tm_min,(Bit16u)time->tm_sec);
+		} else {
+			res.time=6;
+			res.date=4;
+		}
+		res.attr=find_attr;
 	}
-	dta.SetResult(find_name,find_size,find_date,find_time,find_attr);
+	return batch.count>0;
+}
+
+bool localDrive::FindNext(DOS_DTA & dta) {
+	Bit16u id = dta.GetDirID();
+	auto& batch = srchBatch[id];
+
+	if (batch.next >= batch.count) {
+		bool refilled = false;
+		// once the listing ran dry for this id there is nothing left
+		// to gather, don't poke the freed dircache slot again
+		if (!batch.done) {
+			Bit8u srch_attr;char srch_pattern[DOS_NAMELENGTH_ASCII];
+			dta.GetSearchParams(srch_attr,srch_pattern);
+			refilled = FillSearchBatch(id,srch_attr,srch_pattern);
+		}
+		if (!refilled) {
+			DOS_SetError(DOSERR_NO_MORE_FILES);
+			return false;
+		}
+	}
+
+	const auto& res = batch.entries[batch.next++];
+	dta.SetResult(res.name,res.size,res.date,res.time,res.attr);
 	return true;
 }
 
@@ -351,6 +413,7 @@ bool localDrive::GetFileAttr(char * name,Bit16u * attr) {
 	if (stat(newname,&status)==0) {
 		*attr=DOS_ATTR_ARCHIVE;
 		if (status.st_mode & S_IFDIR) *attr|=DOS_ATTR_DIRECTORY;
+		if (read_only) *attr|=DOS_ATTR_READ_ONLY;
 		return true;
 	}
 	*attr=0;
@@ -358,6 +421,10 @@ bool localDrive::GetFileAttr(char * name,Bit16u * attr) {
 }
 
 bool localDrive::MakeDir(char * dir) {
+	if (read_only) {
+		DOS_SetError(DOSERR_ACCESS_DENIED);
+		return false;
+	}
 	char newdir[CROSS_LEN];
 	safe_strcpy(newdir, basedir);
 	safe_strcat(newdir, dir);
@@ -373,6 +440,10 @@ bool localDrive::MakeDir(char * dir) {
 }
 
 bool localDrive::RemoveDir(char * dir) {
+	if (read_only) {
+		DOS_SetError(DOSERR_ACCESS_DENIED);
+		return false;
+	}
 	char newdir[CROSS_LEN];
 	safe_strcpy(newdir, basedir);
 	safe_strcat(newdir, dir);
@@ -401,6 +472,10 @@ bool localDrive::TestDir(char * dir) {
 }
 
 bool localDrive::Rename(char * oldname,char * newname) {
+	if (read_only) {
+		DOS_SetError(DOSERR_ACCESS_DENIED);
+		return false;
+	}
 	char newold[CROSS_LEN];
 	safe_strcpy(newold, basedir);
 	safe_strcat(newold, oldname);
@@ -481,7 +556,8 @@ localDrive::localDrive(const char * startdir,
                        Bit16u _total_clusters,
                        Bit16u _free_clusters,
                        Bit8u _mediaid)
-	: write_protected_files{},
+	: read_only(false),
+	  write_protected_files{},
 	  allocation{_bytes_sector,
 	             _sectors_cluster,
 	             _total_clusters,
@@ -494,15 +570,123 @@ localDrive::localDrive(const char * startdir,
 }
 
 
+// ********************************************
+// Write-behind host I/O
+// ********************************************
+// Host writes are handed to a background thread so a slow filesystem
+// (network shares in particular) no longer stalls the emulation loop.
+// Jobs for one file stay in order, and every operation that observes
+// the stream position or contents drains that file's jobs first, which
+// keeps DOS semantics on Seek/Flush/Close intact.
+
+struct WriteBehindJob {
+	FILE *fhandle;
+	SDL_sem *done;
+	volatile bool *failed;
+	Bit8u *data;
+	Bit16u size;
+};
+
+static struct {
+	SDL_Thread *thread;
+	SDL_sem *todo;
+	SDL_sem *space;
+	WriteBehindJob jobs[WRITE_BEHIND_QUEUE_SIZE];
+	Bitu in;
+	Bitu out;
+} write_behind = {};
+
+static int WriteBehindThread(void *unused) {
+	(void) unused; // unused
+	PERF_TuneWorkerThread();
+	while (true) {
+		SDL_SemWait(write_behind.todo);
+		// an empty ring means the shutdown post; jobs queued before
+		// it have already been consumed in order
+		if (write_behind.in == write_behind.out)
+			break;
+		WriteBehindJob &job = write_behind.jobs[write_behind.out];
+		if (fwrite(job.data, 1, job.size, job.fhandle) != job.size)
+			*job.failed = true;
+		delete [] job.data;
+		SDL_SemPost(job.done);
+		write_behind.out = (write_behind.out + 1) % WRITE_BEHIND_QUEUE_SIZE;
+		SDL_SemPost(write_behind.space);
+	}
+	return 0;
+}
+
+static void WB_Stop(void) {
+	if (!write_behind.thread) return;
+	SDL_SemPost(write_behind.todo); // wakes the thread with an empty ring
+	SDL_WaitThread(write_behind.thread, NULL);
+	write_behind.thread = nullptr;
+	SDL_DestroySemaphore(write_behind.todo);
+	SDL_DestroySemaphore(write_behind.space);
+	write_behind.todo = write_behind.space = nullptr;
+}
+
+static void WB_Start(void) {
+	static bool tried = false;
+	if (tried) return;
+	tried = true;
+	write_behind.todo = SDL_CreateSemaphore(0);
+	write_behind.space = SDL_CreateSemaphore(WRITE_BEHIND_QUEUE_SIZE);
+	if (write_behind.todo && write_behind.space)
+		write_behind.thread = SDL_CreateThread(WriteBehindThread, "HostIO", nullptr);
+	if (!write_behind.thread) {
+		LOG_MSG("FILESYSTEM: could not start write-behind thread, writes remain synchronous");
+		if (write_behind.todo) SDL_DestroySemaphore(write_behind.todo);
+		if (write_behind.space) SDL_DestroySemaphore(write_behind.space);
+		write_behind.todo = write_behind.space = nullptr;
+		return;
+	}
+	atexit(WB_Stop);
+}
+
+bool localFile::QueueWrite(Bit8u * data,Bit16u size) {
+	WB_Start();
+	if (!write_behind.thread)
+		return false; // stay synchronous
+	if (!wb_done) {
+		wb_done = SDL_CreateSemaphore(0);
+		if (!wb_done) return false;
+	}
+	SDL_SemWait(write_behind.space); // bounded queue: stall when full
+	WriteBehindJob &job = write_behind.jobs[write_behind.in];
+	job.fhandle = fhandle;
+	job.done = wb_done;
+	job.failed = &wb_failed;
+	job.data = new Bit8u[size];
+	memcpy(job.data, data, size);
+	job.size = size;
+	write_behind.in = (write_behind.in + 1) % WRITE_BEHIND_QUEUE_SIZE;
+	wb_queued++;
+	SDL_SemPost(write_behind.todo);
+	return true;
+}
+
+void localFile::DrainWrites(void) {
+	while (wb_queued) {
+		SDL_SemWait(wb_done);
+		wb_queued--;
+	}
+}
+
 //TODO Maybe use fflush, but that seemed to fuck up in visual c
 bool localFile::Read(Bit8u * data,Bit16u * size) {
 	if ((this->flags & 0xf) == OPEN_WRITE) {	// check if file opened in write-only mode
 		DOS_SetError(DOSERR_ACCESS_DENIED);
 		return false;
 	}
-	if (last_action==WRITE) fseek(fhandle,ftell(fhandle),SEEK_SET);
+	PROF_START(disk_start);
+	if (last_action==WRITE) {
+		DrainWrites();
+		fseek(fhandle,ftell(fhandle),SEEK_SET);
+	}
 	last_action=READ;
 	*size=(Bit16u)fread(data,1,*size,fhandle);
+	PROF_STOP(PROF_DISK,disk_start);
 	/* Fake harddrive motion. Inspector Gadget with soundblaster compatible */
 	/* Same for Igor */
 	/* hardrive motion => unmask irq 2. Only do it when it's masked as unmasking is realitively heavy to emulate */
@@ -517,17 +701,31 @@ bool localFile::Write(Bit8u * data,Bit16u * size) {
 		DOS_SetError(DOSERR_ACCESS_DENIED);
 		return false;
 	}
+	if (wb_failed) {
+		// report a deferred short write on the next call, the way a
+		// synchronous disk-full write would have failed
+		wb_failed = false;
+		DOS_SetError(DOSERR_ACCESS_DENIED);
+		return false;
+	}
+	PROF_START(disk_start);
 	if (last_action==READ) fseek(fhandle,ftell(fhandle),SEEK_SET);
 	last_action=WRITE;
 	if (*size == 0) {
-		return !ftruncate(cross_fileno(fhandle), ftell(fhandle));
+		DrainWrites();
+		const bool ok = !ftruncate(cross_fileno(fhandle), ftell(fhandle));
+		PROF_STOP(PROF_DISK,disk_start);
+		return ok;
 	} else {
-		*size = (Bit16u)fwrite(data, 1, *size, fhandle);
+		if (!QueueWrite(data, *size))
+			*size = (Bit16u)fwrite(data, 1, *size, fhandle);
+		PROF_STOP(PROF_DISK,disk_start);
 		return true;
 	}
 }
 
 bool localFile::Seek(Bit32u * pos,Bit32u type) {
+	DrainWrites();
 	int seektype;
 	switch (type) {
 	case DOS_SEEK_SET:seektype=SEEK_SET;break;
@@ -557,6 +755,7 @@ bool localFile::Seek(Bit32u * pos,Bit32u type) {
 bool localFile::Close() {
 	// only close if one reference left
 	if (refCtr==1) {
+		DrainWrites();
 		if (fhandle) fclose(fhandle);
 		fhandle = 0;
 		open = false;
@@ -571,6 +770,9 @@ Bit16u localFile::GetInformation(void) {
 
 localFile::localFile(const char* _name, FILE * handle)
 	: fhandle(handle),
+	  wb_done(nullptr),
+	  wb_queued(0),
+	  wb_failed(false),
 	  read_only_medium(false),
 	  last_action(NONE)
 {
@@ -582,8 +784,14 @@ localFile::localFile(const char* _name, FILE * handle)
 	SetName(_name);
 }
 
+localFile::~localFile() {
+	DrainWrites();
+	if (wb_done) SDL_DestroySemaphore(wb_done);
+}
+
 bool localFile::UpdateDateTimeFromHost(void) {
 	if (!open) return false;
+	DrainWrites();
 	struct stat temp_stat;
 	fstat(cross_fileno(fhandle), &temp_stat);
 	struct tm * ltime;
@@ -598,6 +806,7 @@ bool localFile::UpdateDateTimeFromHost(void) {
 
 void localFile::Flush(void) {
 	if (last_action==WRITE) {
+		DrainWrites();
 		fseek(fhandle,ftell(fhandle),SEEK_SET);
 		last_action=NONE;
 	}
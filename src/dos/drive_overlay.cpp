@@ -198,12 +198,29 @@ bool Overlay_Drive::TestDir(char * dir) {
 }
 
 
+//Block size used by the lazy copy-on-write of base files (see cow_start).
+#define COW_BLOCK_SIZE 16384
+
 class OverlayFile: public localFile {
 public:
 	OverlayFile(const char* name, FILE * handle):localFile(name,handle){
 		overlay_active = false;
+		cow_base = NULL;
+		cow_size = 0;
+		cow_left = 0;
+		cow_pending = false;
 		if (logoverlay) LOG_MSG("constructing OverlayFile: %s",name);
 	}
+	~OverlayFile() {
+		if (cow_pending) {
+			DrainWrites();
+			cow_finish();
+		}
+	}
+	bool Read(Bit8u * data,Bit16u * size) {
+		cow_touch(*size);
+		return localFile::Read(data,size);
+	}
 	bool Write(Bit8u * data,Bit16u * size) {
 		Bit32u f = flags&0xf;
 		if (!overlay_active && (f == OPEN_READWRITE || f == OPEN_WRITE)) {
@@ -212,19 +229,61 @@ public:
 				if (logoverlay) LOG_MSG("OPTIMISE: truncate on switch!!!!");
 			}
 			Bit32u a = GetTicks();
-			bool r = create_copy();
+			bool r = cow_start();
 			if (GetTicks() - a > 2) {
 				if (logoverlay) LOG_MSG("OPTIMISE: switching took %d",GetTicks() - a);
 			}
 			if (!r) return false;
 			overlay_active = true;
-			
+
+		}
+		if (cow_pending) {
+			DrainWrites();
+			if (*size == 0) {
+				//Truncation: base blocks past the new end must never be copied in again.
+				const Bit32u pos = (Bit32u)ftell(fhandle);
+				if (pos < cow_size) {
+					//Materialize the partially kept block, then drop the rest.
+					if (pos % COW_BLOCK_SIZE) cow_copy_range(pos-1,pos);
+					for (Bitu i = (pos + COW_BLOCK_SIZE - 1)/COW_BLOCK_SIZE; i < cow_copied.size(); i++) {
+						if (!cow_copied[i]) { cow_copied[i] = true; cow_left--; }
+					}
+					cow_size = pos;
+				}
+				if (!cow_left) cow_finish();
+			} else {
+				cow_copy_range((Bit32u)ftell(fhandle),(Bit32u)ftell(fhandle) + *size);
+				if (!cow_left) cow_finish();
+			}
 		}
 		return localFile::Write(data,size);
 	}
-	bool create_copy();
+	bool Close(void) {
+		if (refCtr == 1 && cow_pending) {
+			if (logoverlay) LOG_MSG("materializing %s on close",GetName());
+			DrainWrites();
+			cow_finish();
+		}
+		return localFile::Close();
+	}
+	//Copy in any blocks still coming from the base file, then drop it.
+	void materialize(void) {
+		if (!cow_pending) return;
+		DrainWrites();
+		cow_finish();
+	}
+	bool cow_start();
 //private:
 	bool overlay_active;
+private:
+	void cow_touch(Bit16u len);
+	void cow_copy_range(Bit32u start,Bit32u end);
+	void cow_finish();
+	FILE* cow_base;               //read handle on the base file while blocks are pending
+	Bit32u cow_size;              //length of the region still backed by the base file
+	Bitu cow_left;                //blocks not yet copied into the overlay
+	std::vector<bool> cow_copied; //per-block copied flags
+	bool cow_pending;             //true while cow_left blocks remain
 };
 
 //Create leading directories of a file being overlayed if they exist in the original (localDrive).
@@ -259,16 +318,22 @@ FILE *Overlay_Drive::create_file_in_overlay(const char *dos_filename, char const
 #define BUFSIZ 2048
 #endif
 
-bool OverlayFile::create_copy() {
+/* Switch the file over to a copy in the overlay, lazily: only an empty file
+ * is created here and blocks of the base file are copied in as they are
+ * touched (cow_touch/cow_copy_range). The untouched remainder is materialized
+ * when the last reference closes, so opening a large base file for writing no
+ * longer stalls on a full copy up front. */
+bool OverlayFile::cow_start() {
 	//test if open/valid/etc
 	//ensure file position
-	if (logoverlay) LOG_MSG("create_copy called %s",GetName());
+	if (logoverlay) LOG_MSG("cow_start called %s",GetName());
 
 	FILE* lhandle = this->fhandle;
 	fseek(lhandle,ftell(lhandle),SEEK_SET);
 	int location_in_old_file = ftell(lhandle);
-	fseek(lhandle,0L,SEEK_SET);
-	
+	fseek(lhandle,0L,SEEK_END);
+	const Bit32u base_size = (Bit32u)ftell(lhandle);
+
 	FILE* newhandle = NULL;
 	Bit8u drive_set = GetDrive();
 	if (drive_set != 0xff && drive_set < DOS_DRIVES && Drives[drive_set]){
@@ -277,20 +342,70 @@ bool OverlayFile::create_copy() {
 			newhandle = od->create_file_in_overlay(GetName(),"wb+"); //todo check wb+
 		}
 	}
- 
-	if (!newhandle) return false;
-	char buffer[BUFSIZ];
-	size_t s;
-	while ( (s = fread(buffer,1,BUFSIZ,lhandle)) != 0 ) fwrite(buffer, 1, s, newhandle);
-	fclose(lhandle);
-	//Set copied file handle to position of the old one 
-	fseek(newhandle,location_in_old_file,SEEK_SET);
+
+	if (!newhandle) {
+		fseek(lhandle,location_in_old_file,SEEK_SET);
+		return false;
+	}
+	cow_base = lhandle;
+	cow_size = base_size;
+	cow_copied.assign((base_size + COW_BLOCK_SIZE - 1)/COW_BLOCK_SIZE,false);
+	cow_left = cow_copied.size();
+	cow_pending = (cow_left != 0);
 	this->fhandle = newhandle;
+	//Copy the tail block up front, so the overlay file gets the base file's
+	//length and SEEK_END keeps working on it.
+	if (cow_pending) cow_copy_range(cow_size-1,cow_size);
+	if (!cow_left) cow_finish();
+	//Set copied file handle to position of the old one
+	fseek(newhandle,location_in_old_file,SEEK_SET);
 	//Flags ?
 	if (logoverlay) LOG_MSG("success");
 	return true;
 }
 
+//Materialize the blocks around the current file position ahead of a read.
+void OverlayFile::cow_touch(Bit16u len) {
+	if (!cow_pending || len == 0) return;
+	DrainWrites();
+	const Bit32u start = (Bit32u)ftell(fhandle);
+	if (start >= cow_size) return;
+	cow_copy_range(start,start + len);
+	if (!cow_left) cow_finish();
+}
+
+//Copy the not-yet-copied blocks overlapping [start,end) from the base file.
+//The caller must have drained deferred writes; the file position is kept.
+void OverlayFile::cow_copy_range(Bit32u start,Bit32u end) {
+	if (!cow_left || start >= cow_size) return;
+	if (end > cow_size) end = cow_size;
+	const long oldpos = ftell(fhandle);
+	char buffer[COW_BLOCK_SIZE];
+	for (Bitu i = start/COW_BLOCK_SIZE; i <= (Bitu)((end-1)/COW_BLOCK_SIZE); i++) {
+		if (cow_copied[i]) continue;
+		const Bit32u offset = (Bit32u)i*COW_BLOCK_SIZE;
+		Bit32u remain = cow_size - offset;
+		if (remain > COW_BLOCK_SIZE) remain = COW_BLOCK_SIZE;
+		fseek(cow_base,offset,SEEK_SET);
+		const size_t got = fread(buffer,1,remain,cow_base);
+		fseek(fhandle,offset,SEEK_SET);
+		fwrite(buffer,1,got,fhandle);
+		cow_copied[i] = true;
+		cow_left--;
+	}
+	fseek(fhandle,oldpos,SEEK_SET);
+}
+
+//Copy whatever is still pending and close the base file handle.
+void OverlayFile::cow_finish() {
+	if (!cow_base) return;
+	if (cow_left) cow_copy_range(0,cow_size);
+	fclose(cow_base);
+	cow_base = NULL;
+	cow_pending = false;
+	cow_copied.clear();
+}
+
 
 
 static OverlayFile* ccc(DOS_File* file) {
@@ -414,6 +529,10 @@ bool Overlay_Drive::FileOpen(DOS_File * * file,char * name,Bit32u flags) {
 		if (Files[i] && Files[i]->IsOpen() && Files[i]->GetDrive()==drive && Files[i]->IsName(name)) {
 			lfp=dynamic_cast<localFile*>(Files[i]);
 			if (lfp) lfp->Flush();
+			//A second handle reads the overlay file from disk, so any
+			//pending copy-on-write blocks have to be in place first.
+			OverlayFile* ofp=dynamic_cast<OverlayFile*>(Files[i]);
+			if (ofp) ofp->materialize();
 		}
 	}
 
@@ -0,0 +1,149 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ *
+ * Copyright (C) 2020-2020  The dosbox-staging team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include <cstring>
+#include <vector>
+
+#include "dosbox.h"
+#include "mem.h"
+#include "dos_inc.h"
+#include "profiler.h"
+#include "programs.h"
+#include "program_benchmark.h"
+#include "../hardware/dbopl.h"
+
+// Table setup for a private DBOPL chip; defined in dbopl.cpp but not
+// part of its public header, as it's normally driven via Adlib::Handler.
+namespace DBOPL {
+void InitTables(void);
+}
+
+void BENCHMARK::Report(const char *kernel, double amount,
+                       const char *unit, Bit64s elapsed_us)
+{
+	if (elapsed_us <= 0)
+		elapsed_us = 1;
+	const double rate = amount / (static_cast<double>(elapsed_us) / 1e6);
+	WriteOut("%-14s %8.1f %s in %8.3f ms  (%10.1f %s/s)\n", kernel,
+	         amount, unit, static_cast<double>(elapsed_us) / 1000.0,
+	         rate, unit);
+	LOG_MSG("BENCHMARK: {\"kernel\": \"%s\", \"%s\": %.1f, "
+	        "\"elapsed_us\": %d, \"%s_per_s\": %.1f}",
+	        kernel, unit, amount, static_cast<int>(elapsed_us), unit, rate);
+}
+
+void BENCHMARK::BenchMemory()
+{
+	constexpr Bitu block_bytes = 32 * 1024;
+	constexpr Bitu iterations = 2048; // 64 MB moved per kernel
+	const double megabytes = static_cast<double>(block_bytes * iterations) /
+	                         (1024.0 * 1024.0);
+
+	// Scratch space comes from the DOS allocator so live guest memory
+	// is never touched.
+	Bit16u seg_a = 0;
+	Bit16u seg_b = 0;
+	Bit16u paragraphs = block_bytes / 16;
+	if (!DOS_AllocateMemory(&seg_a, &paragraphs)) {
+		WriteOut("BENCHMARK: Not enough free DOS memory\n");
+		return;
+	}
+	paragraphs = block_bytes / 16;
+	if (!DOS_AllocateMemory(&seg_b, &paragraphs)) {
+		DOS_FreeMemory(seg_a);
+		WriteOut("BENCHMARK: Not enough free DOS memory\n");
+		return;
+	}
+	const PhysPt guest_a = static_cast<PhysPt>(seg_a) * 16;
+	const PhysPt guest_b = static_cast<PhysPt>(seg_b) * 16;
+
+	std::vector<Bit8u> host_a(block_bytes);
+	std::vector<Bit8u> host_b(block_bytes);
+	for (Bitu i = 0; i < block_bytes; i++)
+		host_a[i] = static_cast<Bit8u>(i * 7);
+
+	Bit64s start = PROF_Now();
+	for (Bitu i = 0; i < iterations; i++)
+		memcpy(host_b.data(), host_a.data(), block_bytes);
+	Report("host_memcpy", megabytes, "MB", PROF_Now() - start);
+
+	start = PROF_Now();
+	for (Bitu i = 0; i < iterations; i++)
+		MEM_BlockWrite(guest_a, host_a.data(), block_bytes);
+	Report("mem_blockwrite", megabytes, "MB", PROF_Now() - start);
+
+	start = PROF_Now();
+	for (Bitu i = 0; i < iterations; i++)
+		MEM_BlockRead(guest_a, host_b.data(), block_bytes);
+	Report("mem_blockread", megabytes, "MB", PROF_Now() - start);
+
+	start = PROF_Now();
+	for (Bitu i = 0; i < iterations; i++)
+		mem_memcpy(guest_b, guest_a, block_bytes);
+	Report("mem_memcpy", megabytes, "MB", PROF_Now() - start);
+
+	start = PROF_Now();
+	for (Bitu i = 0; i < iterations; i++)
+		MEM_BlockCopy(guest_b, guest_a, block_bytes);
+	Report("mem_blockcopy", megabytes, "MB", PROF_Now() - start);
+
+	DOS_FreeMemory(seg_b);
+	DOS_FreeMemory(seg_a);
+}
+
+void BENCHMARK::BenchOpl()
+{
+	// A private chip keeps the benchmark off the emulated OPL's state.
+	DBOPL::InitTables();
+	DBOPL::Chip chip;
+	chip.Setup(49716);
+
+	// Key on a single two-operator voice so the generator does real work.
+	static const Bit8u voice[][2] = {
+	        {0x20, 0x01}, {0x40, 0x10}, {0x60, 0xf0}, {0x80, 0x77},
+	        {0x23, 0x01}, {0x43, 0x00}, {0x63, 0xf0}, {0x83, 0x77},
+	        {0xa0, 0x98}, {0xb0, 0x31},
+	};
+	for (Bitu i = 0; i < sizeof(voice) / sizeof(voice[0]); i++)
+		chip.WriteReg(voice[i][0], voice[i][1]);
+
+	constexpr Bitu chunk = 256;
+	constexpr Bitu chunks = 4096; // ~21 seconds of audio
+	Bit32s output[chunk * 2];
+
+	const Bit64s start = PROF_Now();
+	for (Bitu i = 0; i < chunks; i++)
+		chip.GenerateBlock2(chunk, output);
+	Report("dbopl_generate", static_cast<double>(chunk * chunks) / 1000.0,
+	       "ksamples", PROF_Now() - start);
+}
+
+void BENCHMARK::Run()
+{
+	WriteOut("Benchmarking emulation kernels; results are also logged "
+	         "as machine-readable lines.\n\n");
+	BenchMemory();
+	BenchOpl();
+}
+
+void BENCHMARK_ProgramStart(Program **make)
+{
+	*make = new BENCHMARK;
+}
@@ -42,6 +42,10 @@
 #include "ints/int10.h"
 #include "render.h"
 #include "pci_bus.h"
+#include "profiler.h"
+#include "tracer.h"
+#include "savestate.h"
+#include "taskpool.h"
 
 Config * control;
 MachineType machine;
@@ -132,11 +136,30 @@ void increaseticks();
 
 bool mono_cga=false;
 
+// batch runs bail out once the emulated clock reaches this, 0 = run forever
+Bitu exit_after_ticks=0;
+
+// deadline for DOSBOX_RunTicks, 0 = none; only honoured in the outermost
+// machine loop so callbacks that run nested loops complete normally
+static Bitu run_until=0;
+static Bitu loop_depth=0;
+
+// decouple emulation speed and time sources from the host clock
+bool DOSBOX_Deterministic=false;
+
+// fast-forward toggle, see DOSBOX_TurboToggle
+bool DOSBOX_Turbo=false;
+
 static Bitu Normal_Loop(void) {
 	Bits ret;
 	while (1) {
-		if (PIC_RunQueue()) {
+		PROF_START(pic_start);
+		const bool queue_ran = PIC_RunQueue();
+		PROF_STOP(PROF_PIC,pic_start);
+		if (queue_ran) {
+			PROF_START(cpu_start);
 			ret = (*cpudecoder)();
+			PROF_STOP(PROF_CPU,cpu_start);
 			if (GCC_UNLIKELY(ret<0)) return 1;
 			if (ret>0) {
 				if (GCC_UNLIKELY(ret >= CB_MAX)) return 0;
@@ -148,9 +171,15 @@ static Bitu Normal_Loop(void) {
 #endif
 		} else {
 			GFX_Events();
+			if (prof_enabled) PROF_Update();
 			if (ticksRemain>0) {
 				TIMER_AddTick();
 				ticksRemain--;
+				if (GCC_UNLIKELY(exit_after_ticks && PIC_Ticks>=exit_after_ticks)) {
+					LOG_MSG("DOSBOX: Exiting after %u emulated ms",(unsigned)PIC_Ticks);
+					throw 0;
+				}
+				if (GCC_UNLIKELY(run_until && loop_depth==1 && PIC_Ticks>=run_until)) return 1;
 			} else {increaseticks();return 0;}
 		}
 	}
@@ -160,7 +189,9 @@ static Bitu Normal_Loop(void) {
 #define wrap_delay(a) SDL_Delay(a)
 
 void increaseticks() { //Make it return ticksRemain and set it in the function above to remove the global variable.
-	if (GCC_UNLIKELY(ticksLocked)) { // For Fast Forward Mode
+	// Fast Forward Mode; deterministic mode uses the same path so the
+	// tick budget never depends on how fast the host happens to be
+	if (GCC_UNLIKELY(ticksLocked || DOSBOX_Turbo || DOSBOX_Deterministic)) {
 		ticksRemain=5;
 		/* Reset any auto cycle guessing for this frame */
 		ticksLast = GetTicks();
@@ -218,6 +249,9 @@ void increaseticks() { //Make it return ticksRemain and set it in the function a
 	ticksDone += ticksRemain;
 	if ( ticksRemain > 20 ) {
 //		LOG(LOG_MISC,LOG_ERROR)("large remain %d",ticksRemain);
+		/* the host fell noticeably behind; with the profiler on, report
+		   which subsystem ate the budget before the evidence ages out */
+		PROF_Stall(ticksRemain);
 		ticksRemain = 20;
 	}
 	ticksAdded = ticksRemain;
@@ -318,9 +352,22 @@ void DOSBOX_SetNormalLoop() {
 
 void DOSBOX_RunMachine(void){
 	Bitu ret;
+	loop_depth++;
 	do {
 		ret=(*loop)();
 	} while (!ret);
+	loop_depth--;
+}
+
+/* Run the machine until the emulated clock advances by 'ticks' ms, then
+ * return to the caller. An orchestrator hosting many instances can pair
+ * this with PIC_NextEventTime() to sleep an idle instance until its next
+ * scheduled event instead of letting it poll; best combined with the
+ * deterministic setting so the tick budget does not chase the host clock. */
+void DOSBOX_RunTicks(Bitu ticks){
+	run_until=PIC_Ticks+ticks;
+	DOSBOX_RunMachine();
+	run_until=0;
 }
 
 static void DOSBOX_UnlockSpeed( bool pressed ) {
@@ -344,17 +391,62 @@ static void DOSBOX_UnlockSpeed( bool pressed ) {
 	}
 }
 
+/* Proper turbo as opposed to the hold-down speedlock above: a toggle that
+ * mutes the mixer instead of letting it crackle and drops most rendered
+ * frames, so long boot/install sequences replay as fast as the host can
+ * emulate them. The tick budget uses the same unpaced path as speedlock. */
+static void DOSBOX_TurboToggle(bool pressed) {
+	static bool autoadjust = false;
+	if (!pressed) return;
+	DOSBOX_Turbo = !DOSBOX_Turbo;
+	if (DOSBOX_Turbo) {
+		LOG_MSG("DOSBOX: Turbo ON");
+		if (CPU_CycleAutoAdjust) {
+			/* same trick as speedlock: auto adjusting can't work
+			   without real time feedback, run a sane fixed count */
+			autoadjust = true;
+			CPU_CycleAutoAdjust = false;
+			CPU_CycleMax /= 3;
+			if (CPU_CycleMax<1000) CPU_CycleMax=1000;
+		}
+	} else {
+		LOG_MSG("DOSBOX: Turbo OFF");
+		if (autoadjust) {
+			autoadjust = false;
+			CPU_CycleAutoAdjust = true;
+		}
+	}
+	MIXER_SetTurbo(DOSBOX_Turbo);
+}
+
+static void DOSBOX_Destroy(Section * /*sec*/) {
+	TASKPOOL_Shutdown();
+}
+
 static void DOSBOX_RealInit(Section * sec) {
 	Section_prop * section=static_cast<Section_prop *>(sec);
 	/* Initialize some dosbox internals */
+	sec->AddDestroyFunction(&DOSBOX_Destroy);
+	TASKPOOL_Init();
 
 	ticksRemain=0;
 	ticksLast=GetTicks();
 	ticksLocked = false;
+	DOSBOX_Deterministic = section->Get_bool("deterministic");
+	if (DOSBOX_Deterministic)
+		LOG_MSG("DOSBOX: Deterministic mode, emulated time decoupled from the host clock");
 	DOSBOX_SetLoop(&Normal_Loop);
 	MSG_Init(section);
 
 	MAPPER_AddHandler(DOSBOX_UnlockSpeed, MK_f12, MMOD2,"speedlock","Speedlock");
+	MAPPER_AddHandler(DOSBOX_TurboToggle, MK_f8, MMOD2,"turbo","Turbo");
+	MAPPER_AddHandler(PROF_Toggle, MK_f10, MMOD2,"profiler","Profiler");
+	MAPPER_AddHandler(TRACE_Toggle, MK_f7, MMOD2,"tracer","Trace");
+	MAPPER_AddHandler(SAVESTATE_Save, MK_f5, MMOD2,"savestate","Save State");
+	MAPPER_AddHandler(SAVESTATE_Load, MK_f9, MMOD2,"loadstate","Load State");
+	MAPPER_AddHandler(REWIND_Toggle, MK_f6, MMOD2,"rewindrec","Rewind Rec");
+	MAPPER_AddHandler(REWIND_Step, MK_f4, MMOD2,"rewind","Rewind");
+	REWIND_Init();
 	std::string cmd_machine;
 	if (control->cmdline->FindString("-machine",cmd_machine,true)){
 		//update value in config (else no matching against suggested values
@@ -422,6 +514,13 @@ void DOSBOX_Init(void) {
 	Pstring = secprop->Add_path("captures",Property::Changeable::Always,"capture");
 	Pstring->Set_help("Directory where things like wave, midi, screenshot get captured.");
 
+	Pint = secprop->Add_int("zmbvcompression",Property::Changeable::OnlyAtStart,4);
+	Pint->SetMinMax(1,9);
+	Pint->Set_help(
+	        "Deflate level for ZMBV video capture (1-9). Lower is faster,\n"
+	        "higher compresses better; 1 roughly halves the compression cost\n"
+	        "of high-framerate captures for moderately larger files.");
+
 #if C_DEBUG
 	LOG_StartUp();
 #endif
@@ -437,6 +536,16 @@ void DOSBOX_Init(void) {
 		"This value is best left at its default to avoid problems with some games,\n"
 		"though few games might require a higher value.\n"
 		"There is generally no speed advantage when raising this value.");
+	Pbool = secprop->Add_bool("bigpages", Property::Changeable::OnlyAtStart, true);
+	Pbool->Set_help(
+		"Back the emulated memory with huge host pages when the host supports it,\n"
+		"reducing host TLB pressure. Falls back to normal pages automatically.");
+	Pbool = secprop->Add_bool("deterministic", Property::Changeable::OnlyAtStart, false);
+	Pbool->Set_help(
+		"Run emulation decoupled from the host clock: the tick budget is fixed\n"
+		"and the RTC and BIOS clock advance with emulated time from a fixed base\n"
+		"date, so identical workloads execute identical instruction counts.\n"
+		"Use together with a fixed cycles setting. Runs as fast as possible.");
 	secprop->AddInitFunction(&CALLBACK_Init);
 	secprop->AddInitFunction(&PIC_Init);//done
 	secprop->AddInitFunction(&PROGRAMS_Init);
@@ -445,8 +554,9 @@ void DOSBOX_Init(void) {
 
 	secprop=control->AddSection_prop("render",&RENDER_Init,true);
 	Pint = secprop->Add_int("frameskip",Property::Changeable::Always,0);
-	Pint->SetMinMax(0,10);
-	Pint->Set_help("How many frames DOSBox skips before drawing one.");
+	Pint->SetMinMax(-1,10);
+	Pint->Set_help("How many frames DOSBox skips before drawing one.\n"
+	               "  -1: Skip automatically when the host is too slow to keep up.");
 
 	Pbool = secprop->Add_bool("aspect", Property::Changeable::Always, true);
 	Pbool->Set_help("Scales the vertical resolution to produce a 4:3 display aspect\n"
@@ -488,10 +598,16 @@ void DOSBOX_Init(void) {
 	Pstring->Set_help("Path to GLSL shader source to use with OpenGL output (\"none\" to disable).\n"
 	                  "Can be either an absolute path, a file in the \"glshaders\" subdirectory\n"
 	                  "of the DOSBox configuration directory, or one of the built-in shaders:\n"
-	                  "advinterp2x, advinterp3x, advmame2x, advmame3x, rgb2x, rgb3x, scan2x,\n"
-	                  "scan3x, tv2x, tv3x, sharp.");
+	                  "advinterp2x, advinterp3x, advmame2x, advmame3x, hq2x, hq3x, rgb2x,\n"
+	                  "rgb3x, scan2x, scan3x, tv2x, tv3x, sharp.");
 #endif
 
+	Pstring = secprop->Add_path("framedigest",Property::Changeable::Always,"");
+	Pstring->Set_help("File kept current with a sequence number and 64-bit hash of the\n"
+	                  "presented frame, rewritten when the picture changes. External\n"
+	                  "watchdogs can detect a stuck display by comparing hashes instead\n"
+	                  "of taking screenshots. Empty disables the digest service.");
+
 	secprop=control->AddSection_prop("cpu",&CPU_Init,true);//done
 	const char* cores[] = { "auto",
 #if (C_DYNAMIC_X86) || (C_DYNREC)
@@ -528,6 +644,17 @@ void DOSBOX_Init(void) {
 
 	Pstring = Pmulti_remain->GetSection()->Add_string("parameters",Property::Changeable::Always,"");
 
+	Pint = secprop->Add_int("dyncachesize",Property::Changeable::OnlyAtStart,8);
+	Pint->SetMinMax(1,256);
+	Pint->Set_help("Size in megabytes of the dynamic core's code cache. Big protected\n"
+	               "mode applications can thrash the default and retranslate constantly;\n"
+	               "the log reports when the cache keeps filling up.");
+
+	Pbool = secprop->Add_bool("cycleprofiles",Property::Changeable::OnlyAtStart,false);
+	Pbool->Set_help("Remember the cycle count the auto adjuster (cycles=auto/max) settles on\n"
+	                "per started executable and restore it the next time that program runs,\n"
+	                "skipping the ramp-up (and audio stutter) after launch.");
+
 	Pint = secprop->Add_int("cycleup",Property::Changeable::Always,10);
 	Pint->SetMinMax(1,1000000);
 	Pint->Set_help("Amount of cycles to decrease/increase with keycombos.(CTRL-F11/CTRL-F12)");
@@ -543,6 +670,18 @@ void DOSBOX_Init(void) {
 	secprop->AddInitFunction(&VGA_Init);
 	secprop->AddInitFunction(&KEYBOARD_Init);
 
+	secprop=control->AddSection_prop("performance",&PERF_Init);
+	Pstring = secprop->Add_string("cpuaffinity",Property::Changeable::OnlyAtStart,"");
+	Pstring->Set_help("Host cores the emulation thread may run on, e.g. 2 or 0-3,6.\n"
+	                  "Empty leaves placement to the OS. Keeping all listed cores on one\n"
+	                  "NUMA node also keeps guest memory local.");
+	Pstring = secprop->Add_string("workeraffinity",Property::Changeable::OnlyAtStart,"");
+	Pstring->Set_help("Host cores for helper threads (mixer callback, capture workers),\n"
+	                  "so they cannot preempt the emulation thread.");
+	Pbool = secprop->Add_bool("realtime",Property::Changeable::OnlyAtStart,false);
+	Pbool->Set_help("Request realtime scheduling (SCHED_FIFO) for the emulation thread\n"
+	                "where the OS permits it.");
+
 
 #if defined(PCI_FUNCTIONALITY_ENABLED)
 	secprop=control->AddSection_prop("pci",&PCI_Init,false); //PCI bus
@@ -558,7 +697,7 @@ void DOSBOX_Init(void) {
 	Pint->Set_help("Mixer sample rate, setting any device's rate higher than this will probably lower their sound quality.");
 
 	const char *blocksizes[] = {
-		 "1024", "2048", "4096", "8192", "512", "256", 0};
+		 "1024", "2048", "4096", "8192", "512", "256", "128", 0};
 	Pint = secprop->Add_int("blocksize",Property::Changeable::OnlyAtStart,1024);
 	Pint->Set_values(blocksizes);
 	Pint->Set_help("Mixer block size, larger blocks might help sound stuttering but sound will also be more lagged.");
@@ -567,6 +706,9 @@ void DOSBOX_Init(void) {
 	Pint->SetMinMax(0,100);
 	Pint->Set_help("How many milliseconds of data to keep on top of the blocksize.");
 
+	Pbool = secprop->Add_bool("lowlatency",Property::Changeable::OnlyAtStart,false);
+	Pbool->Set_help("Generate mixer output in sub-millisecond slices. Combine with a small blocksize and prebuffer to get below 10 ms of latency.");
+
 	secprop=control->AddSection_prop("midi",&MIDI_Init,true);//done
 	secprop->AddInitFunction(&MPU401_Init,true);//done
 
@@ -793,6 +935,13 @@ void DOSBOX_Init(void) {
 	Pbool = secprop->Add_bool("umb",Property::Changeable::WhenIdle,true);
 	Pbool->Set_help("Enable UMB support.");
 
+	Pint = secprop->Add_int("diskcache",Property::Changeable::OnlyAtStart,512);
+	Pint->SetMinMax(0,16384);
+	Pint->Set_help("Host-side sector cache per mounted disk image in kilobytes\n"
+		"(0 disables it). Memory-mapped images don't need it; it covers\n"
+		"the plain file path, so there is no reason to run SMARTDRV in\n"
+		"the guest.");
+
 	secprop->AddInitFunction(&DOS_KeyboardLayout_Init,true);
 	Pstring = secprop->Add_string("keyboardlayout",Property::Changeable::WhenIdle, "auto");
 	Pstring->Set_help("Language code of the keyboard layout (or none).");
@@ -101,11 +101,10 @@ static void FPU_FPOP(void){
 
 static double FROUND(double in){
 	switch(fpu.round){
-	case ROUND_Nearest:	
-		if (in-floor(in)>0.5) return (floor(in)+1);
-		else if (in-floor(in)<0.5) return (floor(in));
-		else return (((static_cast<Bit64s>(floor(in)))&1)!=0)?(floor(in)+1):(floor(in));
-		break;
+	case ROUND_Nearest:
+		/* the host FPU stays in its default round-to-nearest-even mode,
+		   which is exactly this case; saves the repeated floor() calls */
+		return nearbyint(in);
 	case ROUND_Down:
 		return (floor(in));
 		break;
@@ -481,18 +480,20 @@ static void FPU_FXAM(void){
 
 
 static void FPU_F2XM1(void){
-	fpu.regs[TOP].d = pow(2.0,fpu.regs[TOP].d) - 1;
+	// expm1 keeps precision near zero, where pow(2,x)-1 cancels
+	fpu.regs[TOP].d = expm1(fpu.regs[TOP].d * M_LN2);
 	return;
 }
 
 static void FPU_FYL2X(void){
-	fpu.regs[STV(1)].d*=log(fpu.regs[TOP].d)/log(static_cast<Real64>(2.0));
+	fpu.regs[STV(1)].d*=log2(fpu.regs[TOP].d);
 	FPU_FPOP();
 	return;
 }
 
 static void FPU_FYL2XP1(void){
-	fpu.regs[STV(1)].d*=log(fpu.regs[TOP].d+1.0)/log(static_cast<Real64>(2.0));
+	// log1p keeps precision for the small arguments this op exists for
+	fpu.regs[STV(1)].d*=log1p(fpu.regs[TOP].d)/M_LN2;
 	FPU_FPOP();
 	return;
 }
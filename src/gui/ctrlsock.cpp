@@ -0,0 +1,224 @@
+/*
+ *  Copyright (C) 2002-2020  The DOSBox Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "ctrlsock.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "cpu.h"
+#include "mapper.h"
+#include "render.h"
+#include "support.h"
+#include "vga.h"
+
+#if !defined (WIN32)
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#define CTRLSOCK_CLIENTS	4
+#define CTRLSOCK_LINE		256
+
+static struct {
+	int listen_fd;
+	char path[108];		// sun_path size
+	struct {
+		int fd;
+		char line[CTRLSOCK_LINE];
+		Bitu used;
+	} clients[CTRLSOCK_CLIENTS];
+} ctrlsock = { -1, {0}, {{-1,{0},0},{-1,{0},0},{-1,{0},0},{-1,{0},0}} };
+
+static void CTRLSOCK_Reply(int fd,const char * msg) {
+	/* best effort; a gone client is dropped on the next read */
+	if (write(fd,msg,strlen(msg))<0) {};
+}
+
+/* run one command line; replies are one line each so batched commands
+   keep their answers in order */
+static void CTRLSOCK_Execute(int fd,char * line) {
+	char reply[CTRLSOCK_LINE];
+	char * cmd=strtok(line," \t");
+	if (!cmd) return;
+	if (!strcasecmp(cmd,"key") || !strcasecmp(cmd,"event")) {
+		const bool is_key=!strcasecmp(cmd,"key");
+		char * name=strtok(NULL," \t");
+		char * action=strtok(NULL," \t");
+		if (!name || !action) {
+			CTRLSOCK_Reply(fd,"err usage: key|event <name> <down|up|press>\n");
+			return;
+		}
+		char entry[64];
+		if (is_key) snprintf(entry,sizeof(entry),"key_%s",name);
+		else safe_strncpy(entry,name,sizeof(entry));
+		bool ok;
+		if (!strcasecmp(action,"down")) ok=MAPPER_TriggerEvent(entry,true);
+		else if (!strcasecmp(action,"up")) ok=MAPPER_TriggerEvent(entry,false);
+		else if (!strcasecmp(action,"press")) {
+			ok=MAPPER_TriggerEvent(entry,true);
+			if (ok) MAPPER_TriggerEvent(entry,false);
+		} else {
+			CTRLSOCK_Reply(fd,"err bad action\n");
+			return;
+		}
+		CTRLSOCK_Reply(fd,ok?"ok\n":"err no such event\n");
+		return;
+	}
+	if (!strcasecmp(cmd,"cycles")) {
+		snprintf(reply,sizeof(reply),"ok %d\n",(int)CPU_CycleMax);
+		CTRLSOCK_Reply(fd,reply);
+		return;
+	}
+	if (!strcasecmp(cmd,"text")) {
+		/* rows x cols screen text straight out of video memory; the
+		   sequence lets a poller skip parsing unchanged screens */
+		static char text[100*132];
+		Bitu cols;
+		Bit32u seq;
+		const Bitu rows=VGA_GetTextScreen(text,sizeof(text),&cols,&seq);
+		if (!rows) {
+			CTRLSOCK_Reply(fd,"err not in a text mode\n");
+			return;
+		}
+		snprintf(reply,sizeof(reply),"ok %u %u %u\n",
+			(unsigned)rows,(unsigned)cols,(unsigned)seq);
+		CTRLSOCK_Reply(fd,reply);
+		for (Bitu r=0;r<rows;r++) {
+			if (write(fd,text+r*cols,cols)<0) {};
+			CTRLSOCK_Reply(fd,"\n");
+		}
+		return;
+	}
+	if (!strcasecmp(cmd,"digest")) {
+		Bit32u sequence;
+		const Bit64u digest=RENDER_FrameDigest(&sequence);
+		snprintf(reply,sizeof(reply),"ok %u %016llx\n",
+			(unsigned)sequence,(unsigned long long)digest);
+		CTRLSOCK_Reply(fd,reply);
+		return;
+	}
+	CTRLSOCK_Reply(fd,"err unknown command\n");
+}
+
+void CTRLSOCK_Init(const char * path) {
+	if (!path || !*path) return;
+	if (strlen(path)>=sizeof(ctrlsock.path)) {
+		LOG_MSG("CTRLSOCK: Socket path too long, service disabled.");
+		return;
+	}
+	int fd=socket(AF_UNIX,SOCK_STREAM,0);
+	if (fd<0) {
+		LOG_MSG("CTRLSOCK: Can't create socket: %s",strerror(errno));
+		return;
+	}
+	struct sockaddr_un addr;
+	memset(&addr,0,sizeof(addr));
+	addr.sun_family=AF_UNIX;
+	safe_strncpy(addr.sun_path,path,sizeof(addr.sun_path));
+	unlink(path);		// stale socket from a previous run
+	if (bind(fd,(struct sockaddr*)&addr,sizeof(addr))<0 || listen(fd,CTRLSOCK_CLIENTS)<0) {
+		LOG_MSG("CTRLSOCK: Can't listen on %s: %s",path,strerror(errno));
+		close(fd);
+		return;
+	}
+	fcntl(fd,F_SETFL,fcntl(fd,F_GETFL)|O_NONBLOCK);
+	ctrlsock.listen_fd=fd;
+	safe_strncpy(ctrlsock.path,path,sizeof(ctrlsock.path));
+	LOG_MSG("CTRLSOCK: Listening on %s",path);
+}
+
+void CTRLSOCK_Shutdown(void) {
+	for (Bitu i=0;i<CTRLSOCK_CLIENTS;i++) {
+		if (ctrlsock.clients[i].fd>=0) close(ctrlsock.clients[i].fd);
+		ctrlsock.clients[i].fd=-1;
+	}
+	if (ctrlsock.listen_fd>=0) {
+		close(ctrlsock.listen_fd);
+		unlink(ctrlsock.path);
+		ctrlsock.listen_fd=-1;
+	}
+}
+
+void CTRLSOCK_Events(void) {
+	if (ctrlsock.listen_fd<0) return;
+	/* take new clients */
+	for (;;) {
+		int fd=accept(ctrlsock.listen_fd,NULL,NULL);
+		if (fd<0) break;
+		Bitu i;
+		for (i=0;i<CTRLSOCK_CLIENTS;i++) {
+			if (ctrlsock.clients[i].fd<0) {
+				fcntl(fd,F_SETFL,fcntl(fd,F_GETFL)|O_NONBLOCK);
+				ctrlsock.clients[i].fd=fd;
+				ctrlsock.clients[i].used=0;
+				break;
+			}
+		}
+		if (i>=CTRLSOCK_CLIENTS) close(fd);
+	}
+	/* drain every client and run all complete lines in this batch */
+	for (Bitu i=0;i<CTRLSOCK_CLIENTS;i++) {
+		const int fd=ctrlsock.clients[i].fd;
+		if (fd<0) continue;
+		for (;;) {
+			char * buf=ctrlsock.clients[i].line;
+			Bitu used=ctrlsock.clients[i].used;
+			const ssize_t got=read(fd,buf+used,CTRLSOCK_LINE-1-used);
+			if (got<0) {
+				if (errno==EAGAIN || errno==EWOULDBLOCK) break;
+				close(fd);
+				ctrlsock.clients[i].fd=-1;
+				break;
+			}
+			if (got==0) {		// client hung up
+				close(fd);
+				ctrlsock.clients[i].fd=-1;
+				break;
+			}
+			used+=(Bitu)got;
+			buf[used]=0;
+			char * eol;
+			while ((eol=strchr(buf,'\n'))!=NULL) {
+				*eol=0;
+				CTRLSOCK_Execute(fd,buf);
+				const Bitu consumed=(Bitu)(eol+1-buf);
+				memmove(buf,eol+1,used-consumed+1);
+				used-=consumed;
+			}
+			if (used>=CTRLSOCK_LINE-1) used=0;	// oversized line, drop it
+			ctrlsock.clients[i].used=used;
+			if (ctrlsock.clients[i].fd<0) break;
+		}
+	}
+}
+
+#else
+
+/* no local socket transport on windows yet; the service is posix-only */
+void CTRLSOCK_Init(const char * path) {
+	if (path && *path)
+		LOG_MSG("CTRLSOCK: Control socket not supported on this platform.");
+}
+void CTRLSOCK_Shutdown(void) {}
+void CTRLSOCK_Events(void) {}
+
+#endif
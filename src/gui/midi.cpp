@@ -23,6 +23,7 @@
 #include <algorithm>
 
 #include <SDL.h>
+#include <SDL_thread.h>
 
 #include "dosbox.h"
 #include "midi.h"
@@ -99,8 +100,114 @@ MidiHandler Midi_none;
 
 DB_Midi midi;
 
+/**
+ *  The platform handlers can block (device latency, and the SysEx
+ *  pacing delays for the MT-32), so finished messages are handed to
+ *  an output thread through a bounded queue instead of being played
+ *  from the emulation thread. The queue orders messages and SysEx
+ *  transfers relative to each other, and the pacing sleep happens on
+ *  the output thread between events.
+ */
+#define MIDI_QUEUE_SIZE 256
+
+struct MidiOutEvent {
+	Bit8u msg[8];
+	Bit8u *sysex;		//heap copy of a sysex transfer, else NULL
+	Bitu sysex_len;
+	Bitu delay;		//pacing delay in ms after a sysex upload
+};
+
+static struct {
+	SDL_Thread *thread;
+	SDL_sem *todo, *space;
+	MidiOutEvent events[MIDI_QUEUE_SIZE];
+	Bitu in, out;
+	bool quit;
+} midi_out;
+
+static int MIDI_OutThread(void * /*unused*/) {
+	while (true) {
+		SDL_SemWait(midi_out.todo);
+		if (midi_out.quit) return 0;
+		MidiOutEvent &event = midi_out.events[midi_out.out];
+		midi_out.out = (midi_out.out + 1) % MIDI_QUEUE_SIZE;
+		if (event.sysex) {
+			midi.handler->PlaySysex(event.sysex, event.sysex_len);
+			delete [] event.sysex;
+			event.sysex = NULL;
+			if (event.delay) SDL_Delay(event.delay);
+		} else {
+			midi.handler->PlayMsg(event.msg);
+		}
+		SDL_SemPost(midi_out.space);
+	}
+}
+
+static void MIDI_QueueMsg(const Bit8u *msg) {
+	if (!midi_out.thread) {
+		midi.handler->PlayMsg(const_cast<Bit8u *>(msg));
+		return;
+	}
+	SDL_SemWait(midi_out.space);
+	MidiOutEvent &event = midi_out.events[midi_out.in];
+	midi_out.in = (midi_out.in + 1) % MIDI_QUEUE_SIZE;
+	memcpy(event.msg, msg, sizeof(event.msg));
+	event.sysex = NULL;
+	event.delay = 0;
+	SDL_SemPost(midi_out.todo);
+}
+
+static void MIDI_QueueSysex(const Bit8u *sysex, Bitu len, Bitu delay) {
+	if (!midi_out.thread) {
+		midi.handler->PlaySysex(const_cast<Bit8u *>(sysex), len);
+		return;
+	}
+	SDL_SemWait(midi_out.space);
+	MidiOutEvent &event = midi_out.events[midi_out.in];
+	midi_out.in = (midi_out.in + 1) % MIDI_QUEUE_SIZE;
+	event.sysex = new Bit8u[len];
+	memcpy(event.sysex, sysex, len);
+	event.sysex_len = len;
+	event.delay = delay;
+	SDL_SemPost(midi_out.todo);
+}
+
+static void MIDI_StartOutThread(void) {
+	midi_out.todo = SDL_CreateSemaphore(0);
+	midi_out.space = SDL_CreateSemaphore(MIDI_QUEUE_SIZE);
+	midi_out.quit = false;
+	if (midi_out.todo && midi_out.space)
+		midi_out.thread = SDL_CreateThread(MIDI_OutThread, "MIDI", NULL);
+	/* without the thread every message is played synchronously */
+	if (!midi_out.thread)
+		LOG_MSG("MIDI: Couldn't start the output thread, so playing synchronously");
+}
+
+static void MIDI_StopOutThread(void) {
+	if (midi_out.thread) {
+		midi_out.quit = true;
+		SDL_SemPost(midi_out.todo);
+		SDL_WaitThread(midi_out.thread, NULL);
+		midi_out.thread = NULL;
+		/* drop whatever was still queued */
+		for (Bitu i = 0; i < MIDI_QUEUE_SIZE; i++) {
+			delete [] midi_out.events[i].sysex;
+			midi_out.events[i].sysex = NULL;
+		}
+	}
+	if (midi_out.todo) {
+		SDL_DestroySemaphore(midi_out.todo);
+		midi_out.todo = NULL;
+	}
+	if (midi_out.space) {
+		SDL_DestroySemaphore(midi_out.space);
+		midi_out.space = NULL;
+	}
+}
+
 void MIDI_RawOutByte(Bit8u data) {
-	if (midi.sysex.start) {
+	/* Without the output thread the sysex pacing has to stall us here */
+	if (midi.sysex.start && !midi_out.thread) {
 		Bit32u passed_ticks = GetTicks() - midi.sysex.start;
 		if (passed_ticks < midi.sysex.delay) SDL_Delay(midi.sysex.delay - passed_ticks);
 	}
@@ -108,7 +215,7 @@ void MIDI_RawOutByte(Bit8u data) {
 	/* Test for a realtime MIDI message */
 	if (data>=0xf8) {
 		midi.rt_buf[0]=data;
-		midi.handler->PlayMsg(midi.rt_buf);
+		MIDI_QueueMsg(midi.rt_buf);
 		return;
 	}
 	/* Test for a active sysex tranfer */
@@ -123,7 +230,6 @@ void MIDI_RawOutByte(Bit8u data) {
 				LOG(LOG_ALL,LOG_ERROR)("MIDI:Skipping invalid MT-32 SysEx midi message (too short to contain a checksum)");
 			} else {
 //				LOG(LOG_ALL,LOG_NORMAL)("Play sysex; address:%02X %02X %02X, length:%4d, delay:%3d", midi.sysex.buf[5], midi.sysex.buf[6], midi.sysex.buf[7], midi.sysex.used, midi.sysex.delay);
-				midi.handler->PlaySysex(midi.sysex.buf, midi.sysex.used);
 				if (midi.sysex.start) {
 					if (midi.sysex.buf[5] == 0x7F) {
 						midi.sysex.delay = 290; // All Parameters reset
@@ -132,8 +238,10 @@ void MIDI_RawOutByte(Bit8u data) {
 					} else if (midi.sysex.buf[5] == 0x10 && midi.sysex.buf[6] == 0x00 && midi.sysex.buf[7] == 0x01) {
 						midi.sysex.delay = 30; // Dark Sun 1
 					} else midi.sysex.delay = (Bitu)(((float)(midi.sysex.used) * 1.25f) * 1000.0f / 3125.0f) + 2;
-					midi.sysex.start = GetTicks();
 				}
+				MIDI_QueueSysex(midi.sysex.buf, midi.sysex.used,
+				                midi.sysex.start ? midi.sysex.delay : 0);
+				if (midi.sysex.start) midi.sysex.start = GetTicks();
 			}
 
 			LOG(LOG_ALL,LOG_NORMAL)("Sysex message size %d", static_cast<int>(midi.sysex.used));
@@ -157,7 +265,7 @@ void MIDI_RawOutByte(Bit8u data) {
 			if (CaptureState & CAPTURE_MIDI) {
 				CAPTURE_AddMidi(false, midi.cmd_len, midi.cmd_buf);
 			}
-			midi.handler->PlayMsg(midi.cmd_buf);
+			MIDI_QueueMsg(midi.cmd_buf);
 			midi.cmd_pos=1;		//Use Running status
 		}
 	}
@@ -199,6 +307,7 @@ public:
 				midi.handler=handler;
 				midi.available=true;
 				LOG_MSG("MIDI: Opened device:%s",handler->GetName());
+				MIDI_StartOutThread();
 				return;
 			}
 			handler=handler->next;
@@ -211,6 +320,7 @@ getdefault:
 				midi.available=true;
 				midi.handler=handler;
 				LOG_MSG("MIDI: Opened device:%s",handler->GetName());
+				MIDI_StartOutThread();
 				return;
 			}
 			handler=handler->next;
@@ -218,6 +328,7 @@ getdefault:
 		/* This shouldn't be possible */
 	}
 	~MIDI(){
+		MIDI_StopOutThread();
 		if(midi.available) midi.handler->Close();
 		midi.available = false;
 		midi.handler = 0;
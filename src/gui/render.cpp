@@ -23,24 +23,94 @@
 #include <fstream>
 #include <sstream>
 #include <stdlib.h>
+#include <string.h>
 
 #include "dosbox.h"
 #include "video.h"
 #include "render.h"
+#include "profiler.h"
 #include "setup.h"
 #include "control.h"
 #include "mapper.h"
 #include "cross.h"
 #include "hardware.h"
 #include "support.h"
+#include "timer.h"
 #include "shell.h"
 
 #include "render_scalers.h"
 #include "render_glsl.h"
 
+#define XXH_INLINE_ALL
+#include "../libs/decoders/xxhash.h"
+
 Render_t render;
 ScalerLineHandler_t RENDER_DrawLine;
 
+/* Frame digest service: a per-line hash of the scaler source cache is kept
+   current whenever a frame is actually presented, folded into one frame
+   digest with a sequence number that only moves when the picture does.
+   External watchdogs read the digest file instead of screenshotting the
+   instance; a screen that stopped changing is a file that stopped
+   changing. */
+static struct {
+	Bit64u line[SCALER_MAXHEIGHT];
+	Bit64u pal;		// palette hash; fades change no source bytes
+	Bit64u frame;
+	Bit32u sequence;
+	Bit32u written;		// sequence the digest file last got
+	Bit32u write_tick;
+	char path[CROSS_LEN];
+} render_digest;
+
+#define RENDER_DIGEST_INTERVAL 500	// ms between digest file rewrites
+
+static void RENDER_UpdateDigest(void) {
+	const Bit8u * src=(Bit8u*)&scalerSourceCache;
+	const Bitu pitch=render.scale.cachePitch;
+	bool dirty=false;
+	for (Bitu i=0;i<render.src.height;i++) {
+		const Bit64u h=XXH64(src,pitch,0);
+		if (h!=render_digest.line[i]) {
+			render_digest.line[i]=h;
+			dirty=true;
+		}
+		src+=pitch;
+	}
+	if (render.pal.changed) {
+		const Bit64u p=XXH64(&render.pal.rgb,sizeof(render.pal.rgb),0);
+		if (p!=render_digest.pal) {
+			render_digest.pal=p;
+			dirty=true;
+		}
+	}
+	if (!dirty) return;
+	const Bit64u frame=XXH64(render_digest.line,
+		render.src.height*sizeof(Bit64u),render_digest.pal);
+	if (frame!=render_digest.frame) {
+		render_digest.frame=frame;
+		render_digest.sequence++;
+	}
+}
+
+static void RENDER_WriteDigest(void) {
+	if (render_digest.written==render_digest.sequence) return;
+	const Bit32u now=GetTicks();
+	if (now-render_digest.write_tick<RENDER_DIGEST_INTERVAL) return;
+	FILE * f=fopen(render_digest.path,"w");
+	if (!f) return;
+	fprintf(f,"%u %016llx\n",(unsigned)render_digest.sequence,
+		(unsigned long long)render_digest.frame);
+	fclose(f);
+	render_digest.written=render_digest.sequence;
+	render_digest.write_tick=now;
+}
+
+Bit64u RENDER_FrameDigest(Bit32u * sequence) {
+	if (sequence) *sequence=render_digest.sequence;
+	return render_digest.frame;
+}
+
 static void RENDER_CallBack( GFX_CallBackFunctions_t function );
 
 static void Check_Palette(void) {
@@ -49,9 +119,10 @@ static void Check_Palette(void) {
 		memset(render.pal.modified, 0, sizeof(render.pal.modified));
 		render.pal.changed = false;
 	}
-	if (render.pal.first>render.pal.last) 
+	if (render.pal.first>render.pal.last)
 		return;
 	Bitu i;
+	Bitu modified=0;
 	switch (render.scale.outMode) {
 	case scalerMode8:
 		break;
@@ -66,6 +137,7 @@ static void Check_Palette(void) {
 				render.pal.changed = true;
 				render.pal.modified[i] = 1;
 				render.pal.lut.b16[i] = newPal;
+				modified++;
 			}
 		}
 		break;
@@ -80,10 +152,16 @@ static void Check_Palette(void) {
 				render.pal.changed = true;
 				render.pal.modified[i] = 1;
 				render.pal.lut.b32[i] = newPal;
+				modified++;
 			}
 		}
 		break;
 	}
+	/* A change this size (fades mostly) redraws the whole frame anyway,
+	   and the plain cache-clear redraw is cheaper than having the pal
+	   line handlers test every pixel against the modified table */
+	if (modified > 64)
+		render.scale.clearCache = true;
 	/* Setup pal index to startup values */
 	render.pal.first=256;
 	render.pal.last=0;
@@ -104,7 +182,15 @@ static void RENDER_StartLineHandler(const void * s) {
 	if (s) {
 		const Bitu *src = (Bitu*)s;
 		Bitu *cache = (Bitu*)(render.scale.cacheRead);
-		for (Bits x=render.src.start;x>0;) {
+		Bits x = render.src.start;
+		/* compare clean stretches a cache line at a time; memcmp turns
+		   into vector compares and most frames are entirely clean */
+		while (x >= (Bits)(64 / sizeof(Bitu)) && !memcmp(src, cache, 64)) {
+			x -= 64 / sizeof(Bitu);
+			src += 64 / sizeof(Bitu);
+			cache += 64 / sizeof(Bitu);
+		}
+		for (;x>0;) {
 			if (GCC_UNLIKELY(src[0] != cache[0])) {
 				if (!GFX_StartUpdate( render.scale.outWrite, render.scale.outPitch )) {
 					RENDER_DrawLine = RENDER_EmptyLineHandler;
@@ -137,6 +223,29 @@ static void RENDER_FinishLineHandler(const void * s) {
 }
 
 
+/* Unity-scale output with matching in/out formats doesn't need the
+   scaler at all: copy the line to the output buffer and refresh the
+   cache in the same pass */
+static void RENDER_DirectLineHandler(const void * s) {
+	if (s) {
+		const Bitu *src = (Bitu*)s;
+		Bitu *cache = (Bitu*)(render.scale.cacheRead);
+		Bitu *out = (Bitu*)(render.scale.outWrite);
+		for (Bits x=render.src.start;x>0;) {
+			const Bitu val = src[0];
+			cache[0] = val;
+			out[0] = val;
+			x--; src++; cache++; out++;
+		}
+		render.scale.outWrite += render.scale.outPitch;
+		if (Scaler_ChangedLineIndex & 1)
+			Scaler_ChangedLines[Scaler_ChangedLineIndex]++;
+		else
+			Scaler_ChangedLines[++Scaler_ChangedLineIndex] = 1;
+	}
+	render.scale.cacheRead += render.scale.cachePitch;
+}
+
 static void RENDER_ClearCacheHandler(const void * src) {
 	Bitu x, width;
 	Bit32u *srcLine, *cacheLine;
@@ -153,7 +262,13 @@ bool RENDER_StartUpdate(void) {
 		return false;
 	if (GCC_UNLIKELY(!render.active))
 		return false;
-	if (GCC_UNLIKELY(render.frameskip.count<render.frameskip.max)) {
+	int frameskip_max = render.frameskip.max;
+	if (frameskip_max<0) frameskip_max = render.frameskip.auto_max;
+	//Fast forward: nobody watches at turbo speed, keep one frame in ten
+	//alive so there is still feedback on what the machine is doing
+	if (GCC_UNLIKELY(DOSBOX_Turbo) && frameskip_max<9)
+		frameskip_max = 9;
+	if (GCC_UNLIKELY(render.frameskip.count<frameskip_max)) {
 		render.frameskip.count++;
 		return false;
 	}
@@ -203,10 +318,32 @@ static void RENDER_Halt( void ) {
 	render.active=false;
 }
 
+static void RENDER_AdaptSkip( Bitu presentTime ) {
+	// raise the skip when presenting eats a sizable share of the frame
+	// period for a while, relax it again once the host keeps up; the
+	// counters make single hiccups (window moves etc.) not flip the skip
+	static Bitu slow = 0, fast = 0;
+	Bitu period = (render.src.fps > 1.0f) ? (Bitu)(1000.0f / render.src.fps) : 14;
+	if (presentTime * 2 > period) {
+		fast = 0;
+		if (++slow >= 4) {
+			slow = 0;
+			if (render.frameskip.auto_max < 10) render.frameskip.auto_max++;
+		}
+	} else {
+		slow = 0;
+		if (++fast >= 70) {
+			fast = 0;
+			if (render.frameskip.auto_max > 0) render.frameskip.auto_max--;
+		}
+	}
+}
+
 extern Bitu PIC_Ticks;
 void RENDER_EndUpdate( bool abort ) {
 	if (GCC_UNLIKELY(!render.updating))
 		return;
+	PROF_START(render_start);
 	RENDER_DrawLine = RENDER_EmptyLineHandler;
 	if (GCC_UNLIKELY(CaptureState & (CAPTURE_IMAGE|CAPTURE_VIDEO))) {
 		Bitu pitch, flags;
@@ -217,13 +354,20 @@ void RENDER_EndUpdate( bool abort ) {
 		}
 		float fps = render.src.fps;
 		pitch = render.scale.cachePitch;
-		if (render.frameskip.max)
+		if (render.frameskip.max>0)
 			fps /= 1+render.frameskip.max;
 		CAPTURE_AddImage( render.src.width, render.src.height, render.src.bpp, pitch,
 			flags, fps, (Bit8u *)&scalerSourceCache, (Bit8u*)&render.pal.rgb );
 	}
 	if ( render.scale.outWrite ) {
+		/* something was drawn, refresh the digest from the source
+		   cache; untouched frames never get here and cost nothing */
+		if (render_digest.path[0] && !abort)
+			RENDER_UpdateDigest();
+		Bit32u presentStart = GetTicks();
 		GFX_EndUpdate( abort? NULL : Scaler_ChangedLines );
+		if (render.frameskip.max<0)
+			RENDER_AdaptSkip( GetTicks() - presentStart );
 		render.frameskip.hadSkip[render.frameskip.index] = 0;
 	} else {
 #if 0
@@ -237,6 +381,9 @@ void RENDER_EndUpdate( bool abort ) {
 	}
 	render.frameskip.index = (render.frameskip.index + 1) & (RENDER_SKIP_CACHE - 1);
 	render.updating=false;
+	if (render_digest.path[0])
+		RENDER_WriteDigest();
+	PROF_STOP(PROF_RENDER,render_start);
 }
 
 static Bitu MakeAspectTable(Bitu skip,Bitu height,double scaley,Bitu miny) {
@@ -516,6 +663,14 @@ forcenormal:
 	default:
 		E_Exit("RENDER:Wrong source bpp %d", render.src.bpp );
 	}
+	/* pixel-perfect bypass: with scaler=none, no aspect line doubling
+	   and the output surface in the source format, the generated 1x
+	   "scaler" only shuffles bytes around - go direct instead */
+	if (simpleBlock == &ScaleNormal1x && !render.scale.complexHandler &&
+		render.scale.inMode == render.scale.outMode &&
+		render.scale.inMode != scalerMode8 &&
+		height == render.src.height)
+		render.scale.lineHandler = RENDER_DirectLineHandler;
 	render.scale.blocks = render.src.width / SCALER_BLOCKSIZE;
 	render.scale.lastBlock = render.src.width % SCALER_BLOCKSIZE;
 	render.scale.inHeight = render.src.height;
@@ -621,6 +776,8 @@ static bool RENDER_GetShader(std::string& shader_path) {
 	else if (shader_path == "advinterp3x") buf << advinterp3x_glsl;
 	else if (shader_path == "advmame2x")   buf << advmame2x_glsl;
 	else if (shader_path == "advmame3x")   buf << advmame3x_glsl;
+	else if (shader_path == "hq2x")        buf << hq2x_glsl;
+	else if (shader_path == "hq3x")        buf << hq3x_glsl;
 	else if (shader_path == "rgb2x")       buf << rgb2x_glsl;
 	else if (shader_path == "rgb3x")       buf << rgb3x_glsl;
 	else if (shader_path == "scan2x")      buf << scan2x_glsl;
@@ -671,36 +828,13 @@ static bool RENDER_GetShader(std::string& shader_path) {
 }
 #endif
 
-void RENDER_Init(Section * sec) {
-	Section_prop * section=static_cast<Section_prop *>(sec);
-
-	//For restarting the renderer.
-	static bool running = false;
-	bool aspect = render.aspect;
-	Bitu scalersize = render.scale.size;
-	bool scalerforced = render.scale.forced;
-	scalerOperation_t scaleOp = render.scale.op;
-
-	render.pal.first=256;
-	render.pal.last=0;
-	render.aspect=section->Get_bool("aspect");
-	render.frameskip.max=section->Get_int("frameskip");
-	render.frameskip.count=0;
-	std::string cline;
-	std::string scaler;
-	//Check for commandline paramters and parse them through the configclass so they get checked against allowed values
-	if (control->cmdline->FindString("-scaler",cline,true)) {
-		section->HandleInputline(std::string("scaler=") + cline);
-	} else if (control->cmdline->FindString("-forcescaler",cline,true)) {
-		section->HandleInputline(std::string("scaler=") + cline + " forced");
-	}
-	   
+static void RENDER_ParseScaler(Section_prop * section) {
 	Prop_multival* prop = section->Get_multival("scaler");
-	scaler = prop->GetSection()->Get_string("type");
+	std::string scaler = prop->GetSection()->Get_string("type");
 	std::string f = prop->GetSection()->Get_string("force");
 	render.scale.forced = false;
 	if(f == "forced") render.scale.forced = true;
-   
+
 	if (scaler == "none") { render.scale.op = scalerOpNormal;render.scale.size = 1; }
 	else if (scaler == "normal2x") { render.scale.op = scalerOpNormal;render.scale.size = 2; }
 	else if (scaler == "normal3x") { render.scale.op = scalerOpNormal;render.scale.size = 3; }
@@ -723,11 +857,60 @@ void RENDER_Init(Section * sec) {
 	else if (scaler == "scan2x"){ render.scale.op = scalerOpScan;render.scale.size = 2; }
 	else if (scaler == "scan3x"){ render.scale.op = scalerOpScan;render.scale.size = 3; }
 #endif
+}
+
+/* Runtime change of a hot-reloadable render property: re-read it and kick
+   the usual reset if the active scaler setup changed. */
+static void RENDER_Update(Section * sec) {
+	Section_prop * section=static_cast<Section_prop *>(sec);
+	bool aspect = render.aspect;
+	Bitu scalersize = render.scale.size;
+	bool scalerforced = render.scale.forced;
+	scalerOperation_t scaleOp = render.scale.op;
+
+	render.aspect=section->Get_bool("aspect");
+	render.frameskip.max=section->Get_int("frameskip");
+	RENDER_ParseScaler(section);
+
+	if (render.src.bpp && ((render.aspect != aspect) || (render.scale.op != scaleOp) ||
+				  (render.scale.size != scalersize) || (render.scale.forced != scalerforced) ||
+				   render.scale.forced))
+		RENDER_CallBack( GFX_CallBackReset );
+	GFX_SetTitle(-1,render.frameskip.max,false);
+}
+
+void RENDER_Init(Section * sec) {
+	Section_prop * section=static_cast<Section_prop *>(sec);
+
+	//For restarting the renderer.
+	static bool running = false;
+	bool aspect = render.aspect;
+	Bitu scalersize = render.scale.size;
+	bool scalerforced = render.scale.forced;
+	scalerOperation_t scaleOp = render.scale.op;
+
+	render.pal.first=256;
+	render.pal.last=0;
+	render.aspect=section->Get_bool("aspect");
+	render.frameskip.max=section->Get_int("frameskip");
+	render.frameskip.auto_max=0;
+	render.frameskip.count=0;
+	std::string cline;
+	//Check for commandline paramters and parse them through the configclass so they get checked against allowed values
+	if (control->cmdline->FindString("-scaler",cline,true)) {
+		section->HandleInputline(std::string("scaler=") + cline);
+	} else if (control->cmdline->FindString("-forcescaler",cline,true)) {
+		section->HandleInputline(std::string("scaler=") + cline + " forced");
+	}
+
+	RENDER_ParseScaler(section);
+
+	safe_strncpy(render_digest.path,section->Get_string("framedigest"),CROSS_LEN);
 
 #if C_OPENGL
 	char* shader_src = render.shader_src;
 	Prop_path *sh = section->Get_path("glshader");
-	f = (std::string)sh->GetValue();
+	std::string f = (std::string)sh->GetValue();
 	if (f.empty() || f=="none") {
 		free(render.shader_src);
 		render.shader_src = NULL;
@@ -758,5 +941,9 @@ void RENDER_Init(Section * sec) {
 	MAPPER_AddHandler(DecreaseFrameSkip,MK_f7,MMOD1,"decfskip","Dec Fskip");
 	MAPPER_AddHandler(IncreaseFrameSkip,MK_f8,MMOD1,"incfskip","Inc Fskip");
 	GFX_SetTitle(-1,render.frameskip.max,false);
+
+	sec->AddUpdateFunction("scaler",&RENDER_Update);
+	sec->AddUpdateFunction("aspect",&RENDER_Update);
+	sec->AddUpdateFunction("frameskip",&RENDER_Update);
 }
 
@@ -163,6 +163,172 @@ void main()
 #endif
 )GLSL";
 
+static const char hq2x_glsl[] = R"GLSL(
+varying vec2 v_texCoord;
+uniform sampler2D rubyTexture;
+uniform vec2 rubyInputSize;
+uniform vec2 rubyOutputSize;
+uniform vec2 rubyTextureSize;
+
+#if defined(VERTEX)
+attribute vec4 a_position;
+
+void main() {
+	gl_Position = a_position;
+	v_texCoord = vec2(a_position.x+1.0,1.0-a_position.y)*rubyInputSize;
+}
+
+#elif defined(FRAGMENT)
+
+/* same tolerances the cpu hq scalers use (trY/trU/trV in render_templates_hq.h) */
+bool diffYUV(vec3 a, vec3 b) {
+	vec3 d = a-b;
+	vec3 yuv = vec3(dot(d, vec3(0.299,0.587,0.114)),
+	                dot(d, vec3(-0.169,-0.331,0.5)),
+	                dot(d, vec3(0.5,-0.419,-0.081)));
+	return any(greaterThan(abs(yuv), vec3(48.0,7.0,6.0)/255.0));
+}
+
+/* cv/ch: vertical/horizontal neighbours of this corner */
+vec3 hqcorner(vec3 c4, vec3 cv, vec3 ch) {
+	if (!diffYUV(cv,ch))
+		return 0.5*c4 + 0.25*cv + 0.25*ch;
+	return c4;
+}
+
+vec3 gethq2xtexel(vec2 coord) {
+	vec2 base = floor(coord/vec2(2.0))+vec2(0.5);
+	vec3 c1 = texture2D(rubyTexture, (base-vec2(0.0,1.0))/rubyTextureSize).xyz;
+	vec3 c3 = texture2D(rubyTexture, (base-vec2(1.0,0.0))/rubyTextureSize).xyz;
+	vec3 c4 = texture2D(rubyTexture, base/rubyTextureSize).xyz;
+	vec3 c5 = texture2D(rubyTexture, (base+vec2(1.0,0.0))/rubyTextureSize).xyz;
+	vec3 c7 = texture2D(rubyTexture, (base+vec2(0.0,1.0))/rubyTextureSize).xyz;
+
+	vec3 l00 = hqcorner(c4,c1,c3);
+	vec3 l01 = hqcorner(c4,c1,c5);
+	vec3 l10 = hqcorner(c4,c7,c3);
+	vec3 l11 = hqcorner(c4,c7,c5);
+
+	coord = max(floor(mod(coord, 2.0)), 0.0);
+	return mix(mix(l00,l01,coord.x), mix(l10,l11,coord.x), coord.y);
+}
+
+void main()
+{
+	vec2 coord = v_texCoord;
+#if defined(OPENGLNB)
+	gl_FragColor = gethq2xtexel(coord);
+#else
+	coord -= 0.5;
+	vec3 c0 = gethq2xtexel(coord);
+	vec3 c1 = gethq2xtexel(coord+vec2(1.0,0.0));
+	vec3 c2 = gethq2xtexel(coord+vec2(0.0,1.0));
+	vec3 c3 = gethq2xtexel(coord+vec2(1.0));
+
+	coord = fract(max(coord,0.0));
+	gl_FragColor = vec4(mix(mix(c0,c1,coord.x), mix(c2,c3,coord.x), coord.y), 1.0);
+#endif
+}
+#endif
+)GLSL";
+
+static const char hq3x_glsl[] = R"GLSL(
+varying vec2 v_texCoord;
+uniform sampler2D rubyTexture;
+uniform vec2 rubyInputSize;
+uniform vec2 rubyOutputSize;
+uniform vec2 rubyTextureSize;
+
+#if defined(VERTEX)
+attribute vec4 a_position;
+
+void main() {
+	gl_Position = a_position;
+	v_texCoord = vec2(a_position.x+1.0,1.0-a_position.y)/2.0*rubyInputSize*3.0;
+}
+
+#elif defined(FRAGMENT)
+
+/* same tolerances the cpu hq scalers use (trY/trU/trV in render_templates_hq.h) */
+bool diffYUV(vec3 a, vec3 b) {
+	vec3 d = a-b;
+	vec3 yuv = vec3(dot(d, vec3(0.299,0.587,0.114)),
+	                dot(d, vec3(-0.169,-0.331,0.5)),
+	                dot(d, vec3(0.5,-0.419,-0.081)));
+	return any(greaterThan(abs(yuv), vec3(48.0,7.0,6.0)/255.0));
+}
+
+/* cv/ch: vertical/horizontal neighbours of this corner */
+vec3 hqcorner(vec3 c4, vec3 cv, vec3 ch) {
+	if (!diffYUV(cv,ch))
+		return 0.5*c4 + 0.25*cv + 0.25*ch;
+	return c4;
+}
+
+/* ca/cb: the two neighbours flanking cm along this edge */
+vec3 hqedge(vec3 c4, vec3 cm, vec3 ca, vec3 cb) {
+	if ((!diffYUV(ca,cm) || !diffYUV(cm,cb)) && diffYUV(c4,cm))
+		return 0.75*c4 + 0.25*cm;
+	return c4;
+}
+
+vec3 gethq3xtexel(vec2 coord) {
+	vec2 base = floor(coord/vec2(3.0))+vec2(0.5);
+	vec3 c1 = texture2D(rubyTexture, (base-vec2(0.0,1.0))/rubyTextureSize).xyz;
+	vec3 c3 = texture2D(rubyTexture, (base-vec2(1.0,0.0))/rubyTextureSize).xyz;
+	vec3 c4 = texture2D(rubyTexture, base/rubyTextureSize).xyz;
+	vec3 c5 = texture2D(rubyTexture, (base+vec2(1.0,0.0))/rubyTextureSize).xyz;
+	vec3 c7 = texture2D(rubyTexture, (base+vec2(0.0,1.0))/rubyTextureSize).xyz;
+
+	vec3 l00 = hqcorner(c4,c1,c3);
+	vec3 l01 = hqedge(c4,c1,c3,c5);
+	vec3 l02 = hqcorner(c4,c1,c5);
+	vec3 l10 = hqedge(c4,c3,c1,c7);
+	vec3 l11 = c4;
+	vec3 l12 = hqedge(c4,c5,c1,c7);
+	vec3 l20 = hqcorner(c4,c7,c3);
+	vec3 l21 = hqedge(c4,c7,c3,c5);
+	vec3 l22 = hqcorner(c4,c7,c5);
+
+	coord = mod(coord, 3.0);
+	bvec2 l = lessThan(coord, vec2(1.0));
+	bvec2 h = greaterThanEqual(coord, vec2(2.0));
+
+	if (h.x) {
+		l01 = l02;
+		l11 = l12;
+		l21 = l22;
+	}
+	if (h.y) {
+		l10 = l20;
+		l11 = l21;
+	}
+	if (l.x) {
+		l01 = l00;
+		l11 = l10;
+	}
+	return l.y ? l01 : l11;
+}
+
+void main()
+{
+	vec2 coord = v_texCoord;
+#if defined(OPENGLNB)
+	gl_FragColor = gethq3xtexel(coord);
+#else
+	coord -= 0.5;
+	vec3 c0 = gethq3xtexel(coord);
+	vec3 c1 = gethq3xtexel(coord+vec2(1.0,0.0));
+	vec3 c2 = gethq3xtexel(coord+vec2(0.0,1.0));
+	vec3 c3 = gethq3xtexel(coord+vec2(1.0));
+
+	coord = fract(max(coord,0.0));
+	gl_FragColor = vec4(mix(mix(c0,c1,coord.x), mix(c2,c3,coord.x), coord.y), 1.0);
+#endif
+}
+#endif
+)GLSL";
+
 static const char advmame2x_glsl[] = R"GLSL(
 varying vec2 v_texCoord;
 uniform sampler2D rubyTexture;
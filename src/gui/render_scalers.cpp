@@ -80,17 +80,6 @@ static INLINE void ScalerAddLines( Bitu changed, Bitu count ) {
 	while (bsize--) *bdst++=*bsrc++;		\
 }
 
-#define interp_w2(P0,P1,W0,W1)															\
-	((((P0&redblueMask)*W0+(P1&redblueMask)*W1)/(W0+W1)) & redblueMask) |	\
-	((((P0&  greenMask)*W0+(P1&  greenMask)*W1)/(W0+W1)) & greenMask)
-#define interp_w3(P0,P1,P2,W0,W1,W2)														\
-	((((P0&redblueMask)*W0+(P1&redblueMask)*W1+(P2&redblueMask)*W2)/(W0+W1+W2)) & redblueMask) |	\
-	((((P0&  greenMask)*W0+(P1&  greenMask)*W1+(P2&  greenMask)*W2)/(W0+W1+W2)) & greenMask)
-#define interp_w4(P0,P1,P2,P3,W0,W1,W2,W3)														\
-	((((P0&redblueMask)*W0+(P1&redblueMask)*W1+(P2&redblueMask)*W2+(P3&redblueMask)*W3)/(W0+W1+W2+W3)) & redblueMask) |	\
-	((((P0&  greenMask)*W0+(P1&  greenMask)*W1+(P2&  greenMask)*W2+(P3&  greenMask)*W3)/(W0+W1+W2+W3)) & greenMask)
-
-
 #define CC scalerChangeCache
 
 /* Include the different rendering routines */
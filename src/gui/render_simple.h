@@ -58,9 +58,16 @@ static void conc4d(SCALERNAME,SBPP,DBPP,R)(const void *s) {
 			src+=4;
 			cache+=4;
 			line0+=4*SCALERWIDTH;
-#else 
+#else
 	for (Bits x=render.src.width;x>0;) {
-		if (*(Bitu const*)src == *(Bitu*)cache) {
+		/* skip clean stretches a cache line at a time; memcmp turns into
+		   vector compares and most lines don't change between frames */
+		if (x >= (Bits)(64/sizeof(SRCTYPE)) && !memcmp(src, cache, 64)) {
+			x-=(Bits)(64/sizeof(SRCTYPE));
+			src+=64/sizeof(SRCTYPE);
+			cache+=64/sizeof(SRCTYPE);
+			line0+=(64/sizeof(SRCTYPE))*SCALERWIDTH;
+		} else if (*(Bitu const*)src == *(Bitu*)cache) {
 			x-=(sizeof(Bitu)/sizeof(SRCTYPE));
 			src+=(sizeof(Bitu)/sizeof(SRCTYPE));
 			cache+=(sizeof(Bitu)/sizeof(SRCTYPE));
@@ -77,6 +77,33 @@
 
 #define redblueMask (redMask | blueMask)
 
+#if DBPP == 32
+/* 32 bpp blending spreads the pixel over a 64 bit word with blue, red
+   and green in separate 16 bit lanes, so a weighted blend costs one
+   multiply per source pixel instead of one per channel mask, and the
+   resulting straight-line code vectorizes.  Every caller uses a power
+   of two weight sum, which shifting out the fraction bits relies on. */
+#define interp_spread(P)	(((Bit64u)(P) & redblueMask) | (((Bit64u)(P) & greenMask) << 24))
+#define interp_fold(T)		((Bit32u)((T) & redblueMask) | ((Bit32u)((T) >> 24) & greenMask))
+#define interp_w2(P0,P1,W0,W1)															\
+	interp_fold((interp_spread(P0)*W0+interp_spread(P1)*W1)/(W0+W1))
+#define interp_w3(P0,P1,P2,W0,W1,W2)														\
+	interp_fold((interp_spread(P0)*W0+interp_spread(P1)*W1+interp_spread(P2)*W2)/(W0+W1+W2))
+#define interp_w4(P0,P1,P2,P3,W0,W1,W2,W3)														\
+	interp_fold((interp_spread(P0)*W0+interp_spread(P1)*W1+interp_spread(P2)*W2+interp_spread(P3)*W3)/(W0+W1+W2+W3))
+#else
+/* 15/16 bpp lacks the lane room for the spread trick, blend the packed
+   red/blue pair and green separately */
+#define interp_w2(P0,P1,W0,W1)															\
+	((((P0&redblueMask)*W0+(P1&redblueMask)*W1)/(W0+W1)) & redblueMask) |	\
+	((((P0&  greenMask)*W0+(P1&  greenMask)*W1)/(W0+W1)) & greenMask)
+#define interp_w3(P0,P1,P2,W0,W1,W2)														\
+	((((P0&redblueMask)*W0+(P1&redblueMask)*W1+(P2&redblueMask)*W2)/(W0+W1+W2)) & redblueMask) |	\
+	((((P0&  greenMask)*W0+(P1&  greenMask)*W1+(P2&  greenMask)*W2)/(W0+W1+W2)) & greenMask)
+#define interp_w4(P0,P1,P2,P3,W0,W1,W2,W3)														\
+	((((P0&redblueMask)*W0+(P1&redblueMask)*W1+(P2&redblueMask)*W2+(P3&redblueMask)*W3)/(W0+W1+W2+W3)) & redblueMask) |	\
+	((((P0&  greenMask)*W0+(P1&  greenMask)*W1+(P2&  greenMask)*W2+(P3&  greenMask)*W3)/(W0+W1+W2+W3)) & greenMask)
+#endif
 
 #if SBPP == 8 || SBPP == 9
 #define SC scalerSourceCache.b8
@@ -205,7 +232,10 @@ static void conc3d(Cache,SBPP,DBPP) (const void * s) {
 		for (Bitu x=0;x<SCALER_BLOCKSIZE;x++) {
 			PTYPE pixel = PMAKE(src[x]);
 			if (pixel != fc[x]) {
-#else 
+#else
+		/* precheck the whole block with a vector compare; the word loop
+		   only runs for blocks that really changed */
+		if (memcmp(src, sc, SCALER_BLOCKSIZE * sizeof(SRCTYPE)))
 		for (Bitu x=0;x<SCALER_BLOCKSIZE;x+=sizeof(Bitu)/sizeof(SRCTYPE)) {
 			if (*(Bitu const*)&src[x] != *(Bitu*)&sc[x]) {
 #endif
@@ -610,6 +640,13 @@ static void conc3d(Cache,SBPP,DBPP) (const void * s) {
 #undef greenMask
 #undef blueMask
 #undef redblueMask
+#ifdef interp_spread
+#undef interp_spread
+#undef interp_fold
+#endif
+#undef interp_w2
+#undef interp_w3
+#undef interp_w4
 #undef redBits
 #undef greenBits
 #undef blueBits
@@ -2394,8 +2394,32 @@ static bool MAPPER_CreateBindsFromFile() {
 }
 
 void MAPPER_CheckEvent(SDL_Event * event) {
-	for (CBindGroup_it it = bindgroups.begin(); it != bindgroups.end(); ++it) {
-		if ((*it)->CheckEvent(event)) return;
+	/* Dispatch on the event type instead of offering every event to
+	 * every bind group: key events only concern the key group (which
+	 * indexes its bind lists by scancode), joystick events only the
+	 * stick groups, and anything else has no takers at all. */
+	switch (event->type) {
+	case SDL_KEYDOWN:
+	case SDL_KEYUP:
+		for (auto it = keybindgroups.begin(); it != keybindgroups.end(); ++it) {
+			if ((*it)->CheckEvent(event)) return;
+		}
+		break;
+	case SDL_JOYAXISMOTION:
+	case SDL_JOYHATMOTION:
+	case SDL_JOYBUTTONDOWN:
+	case SDL_JOYBUTTONUP:
+		for (unsigned int i = 0; i < mapper.sticks.num_groups; i++) {
+			if (mapper.sticks.stick[i] &&
+			    mapper.sticks.stick[i]->CheckEvent(event))
+				return;
+		}
+		for (auto it = stickbindgroups.begin(); it != stickbindgroups.end(); ++it) {
+			if ((*it)->CheckEvent(event)) return;
+		}
+		break;
+	default:
+		break;
 	}
 }
 
@@ -2618,6 +2642,18 @@ void MAPPER_LosingFocus() {
 	}
 }
 
+/* Control-socket entry: trigger a mapper event by entry name (key_esc,
+   hand_scrshot, ...) without going through an SDL input event, so remaps
+   and handler events work the same as from a real keyboard. */
+bool MAPPER_TriggerEvent(const char * entry,bool pressed) {
+	for (CEvent *event : events) {
+		if (strcmp(event->GetName(),entry)) continue;
+		event->Active(pressed);
+		return true;
+	}
+	return false;
+}
+
 void MAPPER_RunEvent(Bitu /*val*/) {
 	KEYBOARD_ClrBuffer();	//Clear buffer
 	GFX_LosingFocus();		//Release any keys pressed (buffer gets filled again).
@@ -59,6 +59,8 @@
 #include "cpu.h"
 #include "control.h"
 #include "render.h"
+#include "tracer.h"
+#include "ctrlsock.h"
 
 #include "../libs/ppscale/ppscale.h"
 
@@ -86,6 +88,22 @@
 #define GL_PIXEL_UNPACK_BUFFER_BINDING_ARB 0x88EF
 #endif
 
+#ifndef GL_ARB_sync
+#define GL_ARB_sync 1
+typedef struct __GLsync *GLsync;
+#define GL_SYNC_GPU_COMMANDS_COMPLETE      0x9117
+#define GL_SYNC_FLUSH_COMMANDS_BIT         0x00000001
+#endif
+
+#ifndef GL_ARB_buffer_storage
+#define GL_ARB_buffer_storage 1
+#define GL_MAP_PERSISTENT_BIT              0x0040
+#define GL_MAP_COHERENT_BIT                0x0080
+#endif
+#ifndef GL_MAP_WRITE_BIT
+#define GL_MAP_WRITE_BIT                   0x0002
+#endif
+
 #ifndef GL_ARB_vertex_buffer_object
 #define GL_ARB_vertex_buffer_object 1
 typedef void (APIENTRYP PFNGLGENBUFFERSARBPROC) (GLsizei n, GLuint *buffers);
@@ -103,6 +121,16 @@ PFNGLBUFFERDATAARBPROC glBufferDataARB = NULL;
 PFNGLMAPBUFFERARBPROC glMapBufferARB = NULL;
 PFNGLUNMAPBUFFERARBPROC glUnmapBufferARB = NULL;
 
+/* Persistent-mapped pixel buffers (GL_ARB_buffer_storage + GL_ARB_sync).
+ * The _NP suffix sidesteps mismatching typedefs in old Khronos headers,
+ * same reason as PFNGLSHADERSOURCEPROC_NP below.
+ */
+typedef void (APIENTRYP PFNGLBUFFERSTORAGEPROC_NP) (GLenum target, GLsizeiptr size, const GLvoid *data, GLbitfield flags);
+typedef GLvoid* (APIENTRYP PFNGLMAPBUFFERRANGEPROC_NP) (GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access);
+typedef GLsync (APIENTRYP PFNGLFENCESYNCPROC_NP) (GLenum condition, GLbitfield flags);
+typedef GLenum (APIENTRYP PFNGLCLIENTWAITSYNCPROC_NP) (GLsync sync, GLbitfield flags, Bit64u timeout);
+typedef void (APIENTRYP PFNGLDELETESYNCPROC_NP) (GLsync sync);
+
 /* Don't guard these with GL_VERSION_2_0 - Apple defines it but not these typedefs.
  * If they're already defined they should match these definitions, so no conflicts.
  */
@@ -152,6 +180,11 @@ PFNGLUNIFORM2FPROC glUniform2f = NULL;
 PFNGLUNIFORM1IPROC glUniform1i = NULL;
 PFNGLUSEPROGRAMPROC glUseProgram = NULL;
 PFNGLVERTEXATTRIBPOINTERPROC glVertexAttribPointer = NULL;
+PFNGLBUFFERSTORAGEPROC_NP glBufferStorage = NULL;
+PFNGLMAPBUFFERRANGEPROC_NP glMapBufferRange = NULL;
+PFNGLFENCESYNCPROC_NP glFenceSync = NULL;
+PFNGLCLIENTWAITSYNCPROC_NP glClientWaitSync = NULL;
+PFNGLDELETESYNCPROC_NP glDeleteSync = NULL;
 }
 
 /* "using" is meant to hide identical names declared in outer scope
@@ -176,6 +209,11 @@ PFNGLVERTEXATTRIBPOINTERPROC glVertexAttribPointer = NULL;
 #define glUniform1i               gl2::glUniform1i
 #define glUseProgram              gl2::glUseProgram
 #define glVertexAttribPointer     gl2::glVertexAttribPointer
+#define glBufferStorage           gl2::glBufferStorage
+#define glMapBufferRange          gl2::glMapBufferRange
+#define glFenceSync               gl2::glFenceSync
+#define glClientWaitSync          gl2::glClientWaitSync
+#define glDeleteSync              gl2::glDeleteSync
 
 #endif // C_OPENGL
 
@@ -305,6 +343,16 @@ struct SDL_Block {
 		bool packed_pixel;
 		bool paletted_texture;
 		bool pixel_buffer_object = false;
+		// triple-buffered persistent mapping (GL_ARB_buffer_storage)
+		bool persistent_buffer = false;
+		int buffer_index = 0;
+		Bit8u *buffer_base = nullptr;
+		GLsync buffer_fence[3] = {};
+		// present_low_latency: cap the driver queue at one frame in
+		// flight, like a waitable swapchain
+		bool low_latency = false;
+		bool can_fence = false;
+		GLsync present_fence = {};
 		bool use_shader;
 		GLuint program_object;
 		const char *shader_src;
@@ -357,6 +405,7 @@ static SDL_Block sdl;
 
 static SDL_Rect CalculateViewport(int win_width, int win_height);
 static void CleanupSDLResources();
+static void DestroyTextureRenderer();
 static void HandleVideoResize(int width, int height);
 
 static constexpr char version_msg[] = R"(dosbox (dosbox-staging), version %s
@@ -419,6 +468,10 @@ extern bool CPU_CycleAutoAdjust;
 bool startup_state_numlock=false;
 bool startup_state_capslock=false;
 
+static char profiler_info[96] = {0};
+static bool headless = false;
+extern Bitu exit_after_ticks;
+
 void GFX_SetTitle(Bit32s cycles, int /*frameskip*/, bool paused)
 {
 	char title[200] = {0};
@@ -431,9 +484,19 @@ void GFX_SetTitle(Bit32s cycles, int /*frameskip*/, bool paused)
 	                          : "%8s - %d cycles/ms - dosbox-staging%s";
 	snprintf(title, sizeof(title), msg, RunningProgram, internal_cycles,
 	         paused ? " (PAUSED)" : "");
+	if (profiler_info[0]) {
+		const size_t len = strlen(title);
+		snprintf(title + len, sizeof(title) - len, " [%s]", profiler_info);
+	}
 	SDL_SetWindowTitle(sdl.window, title);
 }
 
+void GFX_SetProfilerInfo(const char *info)
+{
+	safe_strcpy(profiler_info, info ? info : "");
+	GFX_SetTitle(-1, -1, false);
+}
+
 #if SDL_VERSION_ATLEAST(2, 0, 5)
 /* This function is SDL_EventFilter which is being called when event is
  * pushed into the SDL event queue.
@@ -635,6 +698,7 @@ static SDL_Window *SetWindowMode(SCREEN_TYPES screen_type,
 		last_type = screen_type;
 
 		if (sdl.window) {
+			DestroyTextureRenderer();
 			SDL_DestroyWindow(sdl.window);
 		}
 
@@ -668,6 +732,7 @@ static SDL_Window *SetWindowMode(SCREEN_TYPES screen_type,
 		sdl.desktop.window.resizable = resizable;
 #endif
 		GFX_SetTitle(-1, -1, false); // refresh title.
+		SetIcon(); // fast boot defers window creation to this point
 
 		if (!fullscreen) {
 			goto finish;
@@ -1067,43 +1132,60 @@ dosurface:
 		}
 		if (sdl.render_driver != "auto")
 			SDL_SetHint(SDL_HINT_RENDER_DRIVER, sdl.render_driver.c_str());
-		sdl.renderer = SDL_CreateRenderer(sdl.window, -1,
-		                                  SDL_RENDERER_ACCELERATED |
-		                                  (sdl.desktop.vsync ? SDL_RENDERER_PRESENTVSYNC : 0));
+		if (!sdl.renderer)
+			sdl.renderer = SDL_CreateRenderer(sdl.window, -1,
+			                                  SDL_RENDERER_ACCELERATED |
+			                                  (sdl.desktop.vsync ? SDL_RENDERER_PRESENTVSYNC : 0));
 		if (!sdl.renderer) {
 			LOG_MSG("%s\n", SDL_GetError());
 			LOG_MSG("SDL:Can't create renderer, falling back to surface");
 			goto dosurface;
 		}
-		/* SDL_PIXELFORMAT_ARGB8888 is possible with most
-		rendering drivers, "opengles" being a notable exception */
-		sdl.texture.texture = SDL_CreateTexture(sdl.renderer, SDL_PIXELFORMAT_ARGB8888,
-		                                        SDL_TEXTUREACCESS_STREAMING, width, height);
-
-		/* SDL_PIXELFORMAT_ABGR8888 (not RGB) is the
-		only supported format for the "opengles" driver */
-		if (!sdl.texture.texture) {
-			if (flags & GFX_RGBONLY) goto dosurface;
-			sdl.texture.texture = SDL_CreateTexture(sdl.renderer, SDL_PIXELFORMAT_ABGR8888,
-			                                        SDL_TEXTUREACCESS_STREAMING, width, height);
+		// a parked set with the right dimensions makes the change free
+		for (int i = 0; i < TEXTURE_CACHE_SIZE; i++) {
+			parked_texture_set &set = texture_cache[i];
+			if (set.texture && set.input_surface->w == (int)width &&
+			    set.input_surface->h == (int)height) {
+				sdl.texture.texture = set.texture;
+				sdl.texture.input_surface = set.input_surface;
+				sdl.texture.pixelFormat = set.pixelFormat;
+				set.texture = nullptr;
+				set.input_surface = nullptr;
+				set.pixelFormat = nullptr;
+				break;
+			}
 		}
 		if (!sdl.texture.texture) {
-			SDL_DestroyRenderer(sdl.renderer);
-			sdl.renderer = NULL;
-			LOG_MSG("SDL:Can't create texture, falling back to surface");
-			goto dosurface;
-		}
+			/* SDL_PIXELFORMAT_ARGB8888 is possible with most
+			rendering drivers, "opengles" being a notable exception */
+			sdl.texture.texture = SDL_CreateTexture(sdl.renderer, SDL_PIXELFORMAT_ARGB8888,
+			                                        SDL_TEXTUREACCESS_STREAMING, width, height);
 
-		sdl.texture.input_surface = SDL_CreateRGBSurface(0, width, height, 32, 0, 0, 0, 0);
-		if (!sdl.texture.input_surface) {
-			LOG_MSG("SDL: Error while preparing texture input");
-			goto dosurface;
+			/* SDL_PIXELFORMAT_ABGR8888 (not RGB) is the
+			only supported format for the "opengles" driver */
+			if (!sdl.texture.texture) {
+				if (flags & GFX_RGBONLY) goto dosurface;
+				sdl.texture.texture = SDL_CreateTexture(sdl.renderer, SDL_PIXELFORMAT_ABGR8888,
+				                                        SDL_TEXTUREACCESS_STREAMING, width, height);
+			}
+			if (!sdl.texture.texture) {
+				DestroyTextureRenderer();
+				LOG_MSG("SDL:Can't create texture, falling back to surface");
+				goto dosurface;
+			}
+
+			sdl.texture.input_surface = SDL_CreateRGBSurface(0, width, height, 32, 0, 0, 0, 0);
+			if (!sdl.texture.input_surface) {
+				LOG_MSG("SDL: Error while preparing texture input");
+				goto dosurface;
+			}
 		}
 
 		SDL_SetRenderDrawColor(sdl.renderer, 0, 0, 0, SDL_ALPHA_OPAQUE);
 		Uint32 pixelFormat;
 		SDL_QueryTexture(sdl.texture.texture, &pixelFormat, NULL, NULL, NULL);
-		sdl.texture.pixelFormat = SDL_AllocFormat(pixelFormat);
+		if (!sdl.texture.pixelFormat)
+			sdl.texture.pixelFormat = SDL_AllocFormat(pixelFormat);
 		switch (SDL_BITSPERPIXEL(pixelFormat)) {
 			case 8:  retFlags = GFX_CAN_8;  break;
 			case 15: retFlags = GFX_CAN_15; break;
@@ -1124,11 +1206,26 @@ dosurface:
 #if C_OPENGL
 	case SCREEN_OPENGL: {
 		if (sdl.opengl.pixel_buffer_object) {
+			if (sdl.opengl.buffer_base) {
+				glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_EXT, sdl.opengl.buffer);
+				glUnmapBufferARB(GL_PIXEL_UNPACK_BUFFER_EXT);
+				sdl.opengl.buffer_base = nullptr;
+			}
+			for (int i = 0; i < 3; i++) {
+				if (sdl.opengl.buffer_fence[i]) {
+					glDeleteSync(sdl.opengl.buffer_fence[i]);
+					sdl.opengl.buffer_fence[i] = nullptr;
+				}
+			}
 			glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_EXT, 0);
 			if (sdl.opengl.buffer) glDeleteBuffersARB(1, &sdl.opengl.buffer);
 		} else {
 			free(sdl.opengl.framebuf);
 		}
+		if (sdl.opengl.present_fence) {
+			glDeleteSync(sdl.opengl.present_fence);
+			sdl.opengl.present_fence = nullptr;
+		}
 		sdl.opengl.framebuf=0;
 		if (!(flags & GFX_CAN_32))
 			goto dosurface;
@@ -1146,7 +1243,10 @@ dosurface:
 			LOG_MSG("SDL:OPENGL:Can't open drawing window, are you running in 16bpp(or higher) mode?");
 			goto dosurface;
 		}
-		sdl.opengl.context = SDL_GL_CreateContext(sdl.window);
+		/* reuse the context across mode changes; the shader block
+		   below already revalidates its program either way */
+		if (sdl.opengl.context == NULL)
+			sdl.opengl.context = SDL_GL_CreateContext(sdl.window);
 		if (sdl.opengl.context == NULL) {
 			LOG_MSG("SDL:OPENGL:Can't create OpenGL context, falling back to surface");
 			goto dosurface;
@@ -1249,7 +1349,29 @@ dosurface:
 		if (sdl.opengl.pixel_buffer_object) {
 			glGenBuffersARB(1, &sdl.opengl.buffer);
 			glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_EXT, sdl.opengl.buffer);
-			glBufferDataARB(GL_PIXEL_UNPACK_BUFFER_EXT, width*height*4, NULL, GL_STREAM_DRAW_ARB);
+			if (sdl.opengl.persistent_buffer) {
+				// three frames in one persistently mapped store; the
+				// scaler writes the next frame while earlier uploads
+				// are still in flight
+				const GLbitfield flags = GL_MAP_WRITE_BIT |
+				                         GL_MAP_PERSISTENT_BIT |
+				                         GL_MAP_COHERENT_BIT;
+				glBufferStorage(GL_PIXEL_UNPACK_BUFFER_EXT, width*height*4*3, NULL, flags);
+				sdl.opengl.buffer_base = static_cast<Bit8u *>(
+					glMapBufferRange(GL_PIXEL_UNPACK_BUFFER_EXT, 0, width*height*4*3, flags));
+				sdl.opengl.buffer_index = 0;
+				if (!sdl.opengl.buffer_base) {
+					// the store is immutable, start over with a plain pbo
+					LOG_MSG("SDL:OPENGL: Persistent mapping failed, using plain pixel buffer");
+					sdl.opengl.persistent_buffer = false;
+					glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_EXT, 0);
+					glDeleteBuffersARB(1, &sdl.opengl.buffer);
+					glGenBuffersARB(1, &sdl.opengl.buffer);
+					glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_EXT, sdl.opengl.buffer);
+				}
+			}
+			if (!sdl.opengl.persistent_buffer)
+				glBufferDataARB(GL_PIXEL_UNPACK_BUFFER_EXT, width*height*4, NULL, GL_STREAM_DRAW_ARB);
 			glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_EXT, 0);
 		} else {
 			sdl.opengl.framebuf = malloc(width * height * 4); // 32 bit color
@@ -1530,7 +1652,18 @@ bool GFX_StartUpdate(uint8_t * &pixels, int &pitch)
 		return true;
 #if C_OPENGL
 	case SCREEN_OPENGL:
-		if (sdl.opengl.pixel_buffer_object) {
+		if (sdl.opengl.persistent_buffer) {
+			// wait until the upload that used this third of the store
+			// has finished before handing it back to the scaler
+			GLsync &fence = sdl.opengl.buffer_fence[sdl.opengl.buffer_index];
+			if (fence) {
+				glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, (Bit64u)1000*1000*1000);
+				glDeleteSync(fence);
+				fence = nullptr;
+			}
+			pixels = sdl.opengl.buffer_base +
+			         sdl.opengl.buffer_index * sdl.opengl.pitch * sdl.draw.height;
+		} else if (sdl.opengl.pixel_buffer_object) {
 			glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_EXT, sdl.opengl.buffer);
 			pixels = static_cast<uint8_t *>(glMapBufferARB(GL_PIXEL_UNPACK_BUFFER_EXT, GL_WRITE_ONLY));
 		} else {
@@ -1559,6 +1692,65 @@ bool GFX_StartUpdate(uint8_t * &pixels, int &pitch)
 	return false;
 }
 
+// Frame pacing governor. When presents are vsync-locked (renderer
+// created with PRESENTVSYNC, swap interval 1, or the driver forcing it)
+// the present call returns on the host vblank, so present-to-present
+// deltas measure the host refresh period. A small correction fed back
+// into the emulated vertical timer keeps the present at a stable phase
+// inside the vblank window instead of beating against the host refresh,
+// which otherwise shows up as alternating 16/33ms frame deliveries.
+// Without vsync the present deltas simply mirror the emulated timing,
+// the measured error stays near zero and the correction is a no-op.
+static struct {
+	Bit64u last = 0;     // performance counter at the previous present
+	double period = 0;   // filtered present-to-present period (ms)
+	double error = 0;    // filtered deviation from that period (ms)
+	bool valid = false;
+} frame_pace;
+
+static void FramePaceSample(void) {
+	const Bit64u now = SDL_GetPerformanceCounter();
+	if (frame_pace.last) {
+		const double delta = (now - frame_pace.last) * 1000.0 /
+		                     SDL_GetPerformanceFrequency();
+		if (delta >= 2.0 && delta <= 100.0) {
+			if (frame_pace.period > 0)
+				frame_pace.period = frame_pace.period * 0.95 + delta * 0.05;
+			else
+				frame_pace.period = delta;
+			frame_pace.error = frame_pace.error * 0.8 +
+			                   (delta - frame_pace.period) * 0.2;
+			frame_pace.valid = true;
+		} else {
+			// mode change or long stall; restart the filter
+			frame_pace.period = 0;
+			frame_pace.error = 0;
+			frame_pace.valid = false;
+		}
+	}
+	frame_pace.last = now;
+}
+
+double GFX_GetFramePacingAdjust(double frame_ms) {
+	if (!frame_pace.valid || frame_pace.period <= 0)
+		return 0;
+	// only engage when the emulated rate is close enough to the host
+	// rate (~2%) for phase alignment to make sense; 70Hz VGA modes on
+	// a 60Hz display are left alone
+	const double ratio = frame_ms / frame_pace.period;
+	if (ratio < 0.98 || ratio > 1.02)
+		return 0;
+	// a late present (positive error) means the next frame should
+	// start a touch earlier; take a fraction of the error and clamp
+	// so guest timing never shifts more than 0.5ms per frame
+	double adjust = frame_pace.error * 0.25;
+	if (adjust > 0.5)
+		adjust = 0.5;
+	else if (adjust < -0.5)
+		adjust = -0.5;
+	return -adjust;
+}
+
 void GFX_EndUpdate( const Bit16u *changedLines ) {
 	if (!sdl.update_display_contents)
 		return;
@@ -1574,13 +1766,41 @@ void GFX_EndUpdate( const Bit16u *changedLines ) {
 	switch (sdl.desktop.type) {
 	case SCREEN_TEXTURE:
 		assert(sdl.texture.input_surface);
-		SDL_UpdateTexture(sdl.texture.texture,
-		                  nullptr, // update entire texture
-		                  sdl.texture.input_surface->pixels,
-		                  sdl.texture.input_surface->pitch);
+		if (changedLines) {
+			// upload only the changed bands; small updates like a
+			// moving mouse cursor otherwise cost a full-frame upload
+			int y = 0;
+			size_t index = 0;
+			SDL_Rect rect;
+			rect.x = 0;
+			rect.w = sdl.draw.width;
+			while (y < sdl.draw.height) {
+				if (!(index & 1)) {
+					y += changedLines[index];
+				} else {
+					rect.y = y;
+					rect.h = changedLines[index];
+					const Bit8u *pixels =
+					        (const Bit8u *)sdl.texture.input_surface->pixels +
+					        y * sdl.texture.input_surface->pitch;
+					SDL_UpdateTexture(sdl.texture.texture, &rect,
+					                  pixels,
+					                  sdl.texture.input_surface->pitch);
+					y += rect.h;
+				}
+				index++;
+			}
+		} else {
+			SDL_UpdateTexture(sdl.texture.texture,
+			                  nullptr, // update entire texture
+			                  sdl.texture.input_surface->pixels,
+			                  sdl.texture.input_surface->pitch);
+		}
 		SDL_RenderClear(sdl.renderer);
 		SDL_RenderCopy(sdl.renderer, sdl.texture.texture, NULL, &sdl.clip);
 		SDL_RenderPresent(sdl.renderer);
+		FramePaceSample();
+		if (GCC_UNLIKELY(trace_enabled)) TRACE_Instant("gfx","present",0);
 		break;
 #if C_OPENGL
 	case SCREEN_OPENGL:
@@ -1595,9 +1815,33 @@ void GFX_EndUpdate( const Bit16u *changedLines ) {
 			sdl.opengl.actual_frame_count++;
 			return;
 		}
+		// Before queueing more work, wait for the previous present to
+		// reach the GPU; keeps at most one frame in flight so input is
+		// never rendered against a frame the driver queued long ago.
+		if (sdl.opengl.low_latency && sdl.opengl.present_fence) {
+			glClientWaitSync(sdl.opengl.present_fence,
+			                 GL_SYNC_FLUSH_COMMANDS_BIT,
+			                 (Bit64u)100*1000*1000);
+			glDeleteSync(sdl.opengl.present_fence);
+			sdl.opengl.present_fence = nullptr;
+		}
 		glClearColor (0.0f, 0.0f, 0.0f, 1.0f);
 		glClear(GL_COLOR_BUFFER_BIT);
-		if (sdl.opengl.pixel_buffer_object) {
+		if (sdl.opengl.persistent_buffer) {
+			glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_EXT, sdl.opengl.buffer);
+			glBindTexture(GL_TEXTURE_2D, sdl.opengl.texture);
+			glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, sdl.draw.width,
+			                sdl.draw.height, GL_BGRA_EXT,
+			                GL_UNSIGNED_INT_8_8_8_8_REV,
+			                (const GLvoid *)(size_t)(sdl.opengl.buffer_index *
+			                                         sdl.opengl.pitch * sdl.draw.height));
+			glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_EXT, 0);
+			// fence the upload so GFX_StartUpdate knows when this
+			// third of the store can be written again
+			sdl.opengl.buffer_fence[sdl.opengl.buffer_index] =
+			        glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+			sdl.opengl.buffer_index = (sdl.opengl.buffer_index + 1) % 3;
+		} else if (sdl.opengl.pixel_buffer_object) {
 			glUnmapBufferARB(GL_PIXEL_UNPACK_BUFFER_EXT);
 			glBindTexture(GL_TEXTURE_2D, sdl.opengl.texture);
 			glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, sdl.draw.width,
@@ -1634,6 +1878,11 @@ void GFX_EndUpdate( const Bit16u *changedLines ) {
 			glCallList(sdl.opengl.displaylist);
 		}
 		SDL_GL_SwapWindow(sdl.window);
+		if (sdl.opengl.low_latency && sdl.opengl.can_fence)
+			sdl.opengl.present_fence =
+			        glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		FramePaceSample();
+		if (GCC_UNLIKELY(trace_enabled)) TRACE_Instant("gfx","present",0);
 		break;
 #endif
 	case SCREEN_SURFACE:
@@ -1711,20 +1960,40 @@ void GFX_UpdateDisplayDimensions(int width, int height)
 	}
 }
 
-static void CleanupSDLResources()
+/* Titles that flip between text and graphics modes rebuild the output
+   chain every frame; park the texture set on a mode change and keep the
+   renderer and GL context alive with the window, so flipping back to a
+   recent mode is a lookup instead of a full GL teardown and re-init. */
+#define TEXTURE_CACHE_SIZE 4
+struct parked_texture_set {
+	SDL_Texture *texture = nullptr;
+	SDL_Surface *input_surface = nullptr;
+	SDL_PixelFormat *pixelFormat = nullptr;
+};
+static parked_texture_set texture_cache[TEXTURE_CACHE_SIZE];
+static int texture_cache_next = 0;
+
+static void FreeParkedTextureSet(parked_texture_set &set)
 {
-	if (sdl.texture.pixelFormat) {
-		SDL_FreeFormat(sdl.texture.pixelFormat);
-		sdl.texture.pixelFormat = nullptr;
+	if (set.pixelFormat) {
+		SDL_FreeFormat(set.pixelFormat);
+		set.pixelFormat = nullptr;
 	}
-	if (sdl.texture.texture) {
-		SDL_DestroyTexture(sdl.texture.texture);
-		sdl.texture.texture = nullptr;
+	if (set.texture) {
+		SDL_DestroyTexture(set.texture);
+		set.texture = nullptr;
 	}
-	if (sdl.texture.input_surface) {
-		SDL_FreeSurface(sdl.texture.input_surface);
-		sdl.texture.input_surface = nullptr;
+	if (set.input_surface) {
+		SDL_FreeSurface(set.input_surface);
+		set.input_surface = nullptr;
 	}
+}
+
+static void DestroyTextureRenderer()
+{
+	// the parked textures belong to the renderer; free them first
+	for (int i = 0; i < TEXTURE_CACHE_SIZE; i++)
+		FreeParkedTextureSet(texture_cache[i]);
 	if (sdl.renderer) {
 		SDL_DestroyRenderer(sdl.renderer);
 		sdl.renderer = nullptr;
@@ -1737,8 +2006,38 @@ static void CleanupSDLResources()
 #endif
 }
 
+static void CleanupSDLResources()
+{
+	if (sdl.texture.texture && sdl.texture.input_surface) {
+		parked_texture_set &set = texture_cache[texture_cache_next];
+		texture_cache_next = (texture_cache_next + 1) % TEXTURE_CACHE_SIZE;
+		FreeParkedTextureSet(set);
+		set.texture = sdl.texture.texture;
+		set.input_surface = sdl.texture.input_surface;
+		set.pixelFormat = sdl.texture.pixelFormat;
+		sdl.texture.texture = nullptr;
+		sdl.texture.input_surface = nullptr;
+		sdl.texture.pixelFormat = nullptr;
+	}
+	/* anything half-built still goes the old way; the renderer and GL
+	   context stay alive for as long as the window does */
+	if (sdl.texture.pixelFormat) {
+		SDL_FreeFormat(sdl.texture.pixelFormat);
+		sdl.texture.pixelFormat = nullptr;
+	}
+	if (sdl.texture.texture) {
+		SDL_DestroyTexture(sdl.texture.texture);
+		sdl.texture.texture = nullptr;
+	}
+	if (sdl.texture.input_surface) {
+		SDL_FreeSurface(sdl.texture.input_surface);
+		sdl.texture.input_surface = nullptr;
+	}
+}
+
 static void GUI_ShutDown(Section *)
 {
+	CTRLSOCK_Shutdown();
 	GFX_Stop();
 	if (sdl.draw.callback)
 		(sdl.draw.callback)( GFX_CallBackStop );
@@ -1747,6 +2046,7 @@ static void GUI_ShutDown(Section *)
 	if (mouse_is_captured)
 		GFX_ToggleMouseCapture();
 	CleanupSDLResources();
+	DestroyTextureRenderer();
 }
 
 static void SetPriority(PRIORITY_LEVELS level) {
@@ -2137,10 +2437,19 @@ static void GUI_StartUp(Section * sec) {
 		sdl.desktop.want_type=SCREEN_SURFACE;//SHOULDN'T BE POSSIBLE anymore
 	}
 
+	if (headless && sdl.desktop.want_type != SCREEN_SURFACE) {
+		// the dummy video driver offers no renderer or GL context
+		LOG_MSG("SDL: Headless mode supports only surface output, overriding");
+		sdl.desktop.want_type = SCREEN_SURFACE;
+	}
+
 	sdl.texture.texture = 0;
 	sdl.texture.pixelFormat = 0;
 	sdl.render_driver = section->Get_string("texture_renderer");
 	lowcase(sdl.render_driver);
+#if C_OPENGL
+	sdl.opengl.low_latency = section->Get_bool("present_low_latency");
+#endif
 
 	SetupWindowResolution(section->Get_string("windowresolution"));
 
@@ -2193,6 +2502,11 @@ static void GUI_StartUp(Section * sec) {
 			glBufferDataARB = (PFNGLBUFFERDATAARBPROC)SDL_GL_GetProcAddress("glBufferDataARB");
 			glMapBufferARB = (PFNGLMAPBUFFERARBPROC)SDL_GL_GetProcAddress("glMapBufferARB");
 			glUnmapBufferARB = (PFNGLUNMAPBUFFERARBPROC)SDL_GL_GetProcAddress("glUnmapBufferARB");
+			glBufferStorage = (PFNGLBUFFERSTORAGEPROC_NP)SDL_GL_GetProcAddress("glBufferStorage");
+			glMapBufferRange = (PFNGLMAPBUFFERRANGEPROC_NP)SDL_GL_GetProcAddress("glMapBufferRange");
+			glFenceSync = (PFNGLFENCESYNCPROC_NP)SDL_GL_GetProcAddress("glFenceSync");
+			glClientWaitSync = (PFNGLCLIENTWAITSYNCPROC_NP)SDL_GL_GetProcAddress("glClientWaitSync");
+			glDeleteSync = (PFNGLDELETESYNCPROC_NP)SDL_GL_GetProcAddress("glDeleteSync");
 
 			// FIXME: according to Khronos documentation, the correct way to
 			//        query GL_EXTENSIONS is using glGetStringi from OpenGL 3.0
@@ -2203,36 +2517,57 @@ static void GUI_StartUp(Section * sec) {
 				sdl.opengl.pixel_buffer_object=(strstr(gl_ext,"GL_ARB_pixel_buffer_object") != NULL ) &&
 				    glGenBuffersARB && glBindBufferARB && glDeleteBuffersARB && glBufferDataARB &&
 				    glMapBufferARB && glUnmapBufferARB;
+				sdl.opengl.persistent_buffer = sdl.opengl.pixel_buffer_object &&
+				    (strstr(gl_ext,"GL_ARB_buffer_storage") != NULL) &&
+				    (strstr(gl_ext,"GL_ARB_sync") != NULL) &&
+				    glBufferStorage && glMapBufferRange &&
+				    glFenceSync && glClientWaitSync && glDeleteSync;
+				sdl.opengl.can_fence = (strstr(gl_ext,"GL_ARB_sync") != NULL) &&
+				    glFenceSync && glClientWaitSync && glDeleteSync;
 			} else {
 				sdl.opengl.packed_pixel = false;
 				sdl.opengl.paletted_texture = false;
 				sdl.opengl.pixel_buffer_object = false;
+				sdl.opengl.persistent_buffer = false;
+				sdl.opengl.can_fence = false;
 			}
 #ifdef DB_DISABLE_DBO
 			sdl.opengl.pixel_buffer_object = false;
+			sdl.opengl.persistent_buffer = false;
 #endif
 			LOG_MSG("OPENGL: Pixel buffer object extension: %s",
 			        sdl.opengl.pixel_buffer_object ? "available"
 			                                       : "missing");
+			LOG_MSG("OPENGL: Persistent buffer mapping: %s",
+			        sdl.opengl.persistent_buffer ? "available"
+			                                     : "missing");
 		}
 	} /* OPENGL is requested end */
 #endif	//OPENGL
 
-	if (!SetDefaultWindowMode())
-		E_Exit("Could not initialize video: %s", SDL_GetError());
-
 	// FIXME the code updated sdl.desktop.bpp in here (has effect in setting up scalers)
 
-	SDL_SetWindowTitle(sdl.window, "dosbox-staging");
-	SetIcon();
-
 	const bool tiny_fullresolution = splash_image.width > sdl.desktop.full.width ||
 	                                 splash_image.height > sdl.desktop.full.height;
-	if (!(sdl.desktop.fullscreen && tiny_fullresolution)) {
-		GFX_Start();
-		DisplaySplash(1000);
-		GFX_Stop();
+	// the splash and its delay dominate cold start, so batch and
+	// headless runs skip it
+	const bool want_splash = section->Get_bool("splashscreen") && !headless;
+	if (want_splash) {
+		if (!SetDefaultWindowMode())
+			E_Exit("Could not initialize video: %s", SDL_GetError());
+		SDL_SetWindowTitle(sdl.window, "dosbox-staging");
+		SetIcon();
+		if (!(sdl.desktop.fullscreen && tiny_fullresolution)) {
+			GFX_Start();
+			DisplaySplash(1000);
+			GFX_Stop();
+		}
 	}
+	// fast boot: without a splash nothing is shown before the first
+	// real frame, so the window is left for the first GFX_SetSize to
+	// create at its final size (SetWindowMode builds it on demand and
+	// refreshes title and icon); the shell starts without waiting on a
+	// throwaway splash-sized mode-set
 
 	// Apply the user's mouse settings
 	Section_prop* s = section->Get_multival("capture_mouse")->GetSection();
@@ -2287,6 +2622,8 @@ static void GUI_StartUp(Section * sec) {
 	SDL_Keymod keystate = SDL_GetModState();
 	if(keystate&KMOD_NUM) startup_state_numlock = true;
 	if(keystate&KMOD_CAPS) startup_state_capslock = true;
+
+	CTRLSOCK_Init(section->Get_string("controlsocket"));
 }
 
 static void HandleMouseMotion(SDL_MouseMotionEvent * motion) {
@@ -2453,6 +2790,9 @@ void GFX_Events() {
 	last_check = current_check;
 #endif
 
+	// run everything queued on the control socket as one batch per poll
+	CTRLSOCK_Events();
+
 	SDL_Event event;
 #if defined (REDUCE_JOYSTICK_POLLING)
 	if (MAPPER_IsUsingJoysticks()) {
@@ -2641,9 +2981,27 @@ void GFX_Events() {
 			}
 			break; // end of SDL_WINDOWEVENT
 
-		case SDL_MOUSEMOTION:
+		case SDL_MOUSEMOTION: {
+			/* High-rate mice queue several motion events per tick;
+			 * coalesce consecutive ones so the mouse emulation runs
+			 * once per burst. Relative motion accumulates and the
+			 * last absolute position wins. Only directly adjacent
+			 * events are merged, which keeps motion ordered against
+			 * button presses in between. */
+			SDL_Event next;
+			while (SDL_PeepEvents(&next, 1, SDL_PEEKEVENT, SDL_FIRSTEVENT,
+			                      SDL_LASTEVENT) == 1 &&
+			       next.type == SDL_MOUSEMOTION) {
+				SDL_PeepEvents(&next, 1, SDL_GETEVENT, SDL_MOUSEMOTION,
+				               SDL_MOUSEMOTION);
+				event.motion.xrel += next.motion.xrel;
+				event.motion.yrel += next.motion.yrel;
+				event.motion.x = next.motion.x;
+				event.motion.y = next.motion.y;
+			}
 			HandleMouseMotion(&event.motion);
 			break;
+		}
 		case SDL_MOUSEBUTTONDOWN:
 		case SDL_MOUSEBUTTONUP:
 			if (sdl.mouse.control_choice != NoMouse)
@@ -2751,6 +3109,10 @@ void Config_Add_SDL() {
 	Pbool->Set_help("Start DOSBox directly in fullscreen.\n"
 	                "Press Alt-Enter to switch back to window.");
 
+	Pbool = sdl_sec->Add_bool("splashscreen", on_start, true);
+	Pbool->Set_help("Show the splash screen on startup. Disabling it saves\n"
+	                "a second of startup time, useful for scripted runs.");
+
 	pint = sdl_sec->Add_int("display", on_start, 0);
 	pint->Set_help("Number of display to use; values depend on OS and user "
 	               "settings.");
@@ -2803,6 +3165,11 @@ void Config_Add_SDL() {
 	                  "Use output=auto for an automatic choice.");
 	Pstring->Set_values(Get_SDL_TextureRenderers());
 
+	Pbool = sdl_sec->Add_bool("present_low_latency", on_start, false);
+	Pbool->Set_help("Keep at most one presented frame queued in the video\n"
+	                "driver (output=opengl only). Lowers input latency by\n"
+	                "about a frame at some cost in throughput headroom.");
+
 	// Define mouse control settings
 	Pmulti = sdl_sec->Add_multi("capture_mouse", always, " ");
 	const char *mouse_controls[] = {
@@ -2878,6 +3245,11 @@ void Config_Add_SDL() {
 	pstring = sdl_sec->Add_path("mapperfile", always, MAPPERFILE);
 	pstring->Set_help("File used to load/save the key/event mappings from.\n"
 	                  "Resetmapper only works with the default value.");
+
+	pstring = sdl_sec->Add_path("controlsocket", on_start, "");
+	pstring->Set_help("Local socket accepting automation commands (key injection,\n"
+	                  "cycle queries, frame digest reads); one text command per line,\n"
+	                  "batched per event poll. Empty disables the service.");
 }
 
 static void show_warning(char const * const message) {
@@ -3180,6 +3552,23 @@ int main(int argc, char* argv[]) {
 	LOG_MSG("dosbox-staging version %s", VERSION);
 	LOG_MSG("---");
 
+	if (control->cmdline->FindExist("-headless", true)) {
+		// the dummy drivers need neither a display nor an audio
+		// device; emulation, the mixer and the capture paths all
+		// still run, so batch sweeps can verify frames and audio
+		headless = true;
+		SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+		SDL_setenv("SDL_AUDIODRIVER", "dummy", 1);
+		LOG_MSG("SDL: Running headless using the dummy video and audio drivers");
+	}
+	std::string exit_after;
+	if (control->cmdline->FindString("-exit-after", exit_after, true)) {
+		exit_after_ticks = 1000 * static_cast<Bitu>(atoi(exit_after.c_str()));
+		if (exit_after_ticks)
+			LOG_MSG("SDL: Will exit after %s emulated second(s)",
+			        exit_after.c_str());
+	}
+
 	if (SDL_Init(SDL_INIT_AUDIO | SDL_INIT_VIDEO) < 0)
 		E_Exit("Can't init SDL %s", SDL_GetError());
 	sdl.initialized = true;
@@ -3292,6 +3681,10 @@ int main(int argc, char* argv[]) {
 #endif
 		}
 	}
+	catch (int code) {
+		// thrown by the killswitch and the -exit-after deadline
+		rcode = code;
+	}
 	catch (...) {
 		// just exit
 		rcode = 1;
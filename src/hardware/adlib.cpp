@@ -304,7 +304,7 @@ class Capture {
 	}
 
 	void ClearBuf( void ) {
-		fwrite( buf, 1, bufUsed, handle );
+		CAPTURE_WriteBlock( handle, buf, bufUsed );
 		header.commands += bufUsed / 2;
 		bufUsed = 0;
 	}
@@ -366,6 +366,7 @@ class Capture {
 	void CloseFile( void ) {
 		if ( handle ) {
 			ClearBuf();
+			CAPTURE_WriterFlush();
 			/* Endianize the header and write it to beginning of the file */
 			header.versionHigh  = host_to_le(header.versionHigh);
 			header.versionLow   = host_to_le(header.versionLow);
@@ -527,6 +528,50 @@ Bit8u Chip::Read( ) {
 
 }
 
+void Module::QueueWrite( Bit32u reg, Bit8u val ) {
+	if ( fifoHead - fifoTail >= WRITE_FIFO_SIZE ) {
+		//Queue full; apply the backlog directly. Those writes are late
+		//anyway and keeping the order is what matters
+		DrainQueue();
+	}
+	QueuedWrite & qw = writeFifo[ fifoHead++ & (WRITE_FIFO_SIZE-1) ];
+	qw.time = PIC_FullIndex();
+	qw.reg = reg;
+	qw.val = val;
+}
+
+void Module::DrainQueue( void ) {
+	while ( fifoTail != fifoHead ) {
+		QueuedWrite & qw = writeFifo[ fifoTail++ & (WRITE_FIFO_SIZE-1) ];
+		handler->WriteReg( qw.reg, qw.val );
+	}
+}
+
+void Module::Generate( Bitu samples ) {
+	const double now = PIC_FullIndex();
+	const double span = now - lastFlush;
+	Bitu done = 0;
+	while ( fifoTail != fifoHead ) {
+		QueuedWrite & qw = writeFifo[ fifoTail & (WRITE_FIFO_SIZE-1) ];
+		//Map the write time into the block being rendered, so the write
+		//lands on the right sample like on a real chip
+		double frac = span > 0 ? ( qw.time - lastFlush ) / span : 1.0;
+		if ( frac < 0 ) frac = 0;
+		else if ( frac > 1 ) frac = 1;
+		Bitu at = (Bitu)( frac * samples );
+		if ( at > done ) {
+			handler->Generate( mixerChan, at - done );
+			done = at;
+		}
+		handler->WriteReg( qw.reg, qw.val );
+		fifoTail++;
+	}
+	if ( samples > done ) {
+		handler->Generate( mixerChan, samples - done );
+	}
+	lastFlush = now;
+}
+
 void Module::CacheWrite( Bit32u reg, Bit8u val ) {
 	//capturing?
 	if ( capture ) {
@@ -555,7 +600,7 @@ void Module::DualWrite( Bit8u index, Bit8u reg, Bit8u val ) {
 		val |= index ? 0xA0 : 0x50;
 	}
 	Bit32u fullReg = reg + (index ? 0x100 : 0);
-	handler->WriteReg( fullReg, val );
+	QueueWrite( fullReg, val );
 	CacheWrite( fullReg, val );
 }
 
@@ -610,7 +655,7 @@ void Module::PortWrite( Bitu port, Bitu val, Bitu iolen ) {
 		case MODE_OPL2:
 		case MODE_OPL3:
 			if ( !chip[0].Write( reg.normal, val ) ) {
-				handler->WriteReg( reg.normal, val );
+				QueueWrite( reg.normal, val );
 				CacheWrite( reg.normal, val );
 			}
 			break;
@@ -726,7 +771,7 @@ void Module::Init( Mode m ) {
 static Adlib::Module* module = 0;
 
 static void OPL_CallBack(Bitu len) {
-	module->handler->Generate( module->mixerChan, len );
+	module->Generate( len );
 	//Disable the sound generation after 30 seconds of silence
 	if ((PIC_Ticks - module->lastUsed) > 30000) {
 		Bitu i;
@@ -835,6 +880,9 @@ Module::Module(Section *configuration)
 	  reg{0}, // union
 	  ctrl{false, 0, 0xff, 0xff},
 	  mixerChan(nullptr),
+	  fifoHead(0),
+	  fifoTail(0),
+	  lastFlush(0.0),
 	  lastUsed(0),
 	  handler(nullptr),
 	  capture(nullptr)
@@ -849,7 +897,10 @@ Module::Module(Section *configuration)
 
 	mixerChan = mixerObject.Install(OPL_CallBack,rate,"FM");
 	//Used to be 2.0, which was measured to be too high. Exact value depends on card/clone.
-	mixerChan->SetScale( 1.5f );  
+	mixerChan->SetScale( 1.5f );
+	//FM output is bright enough for linear interpolation aliasing to be
+	//audible when oplrate and the mixer rate differ (49716 vs 48000)
+	mixerChan->SetResampleQuality( true );
 
 	handler = make_opl_handler(section->Get_string("oplemu"), oplmode);
 	handler->Init(rate);
@@ -131,11 +131,27 @@ class Module: public Module_base {
 		Bit8u rvol;
 		bool mixer;
 	} ctrl;
+	//Timestamped register write fifo, drained by the mixer callback; port
+	//writes queue instead of rendering and locking the mixer per write
+	struct QueuedWrite {
+		double time;
+		Bit32u reg;
+		Bit8u val;
+	};
+	static const Bitu WRITE_FIFO_SIZE = 4096;	//power of two
+	QueuedWrite writeFifo[WRITE_FIFO_SIZE];
+	Bitu fifoHead, fifoTail;
+	double lastFlush;
+	void QueueWrite( Bit32u reg, Bit8u val );
+	void DrainQueue( void );
 	void CacheWrite( Bit32u reg, Bit8u val );
 	void DualWrite( Bit8u index, Bit8u reg, Bit8u val );
 	void CtrlWrite( Bit8u val );
 	Bitu CtrlRead( void );
 public:
+	//Render a block of samples, applying queued register writes at their
+	//place within the block
+	void Generate( Bitu samples );
 	static OPL_Mode oplmode;
 	MixerChannel* mixerChan;
 	Bit32u lastUsed;				//Ticks when adlib was last used to turn of mixing after a few second
@@ -123,6 +123,34 @@ static void cmos_writereg(Bitu port,Bitu val,Bitu iolen) {
 
 #define MAKE_RETURN(_VAL) (cmos.bcd ? ((((_VAL) / 10) << 4) | ((_VAL) % 10)) : (_VAL));
 
+static struct tm cmos_time_snapshot;
+static Bitu cmos_time_for=(Bitu)-1;		/* emulated second of the snapshot */
+
+/* At most one time()/localtime() pair per emulated second; clock-polling
+   games read the time registers every frame and the old code also paid
+   the syscall for non-time registers like the status and disk info ones */
+static struct tm * cmos_localtime(void) {
+	Bitu now=PIC_Ticks/1000;
+	if (GCC_UNLIKELY(cmos_time_for!=now)) {
+		time_t curtime;
+		struct tm *loctime;
+		if (DOSBOX_Deterministic) {
+			/* Virtual clock: fixed base date advanced by emulated time */
+			curtime = DOSBOX_DETERMINISTIC_TIME_BASE + (time_t)now;
+			loctime = gmtime (&curtime);
+		} else {
+			/* Get the current time. */
+			curtime = time (NULL);
+
+			/* Convert it to local time representation. */
+			loctime = localtime (&curtime);
+		}
+		cmos_time_snapshot=*loctime;
+		cmos_time_for=now;
+	}
+	return &cmos_time_snapshot;
+}
+
 static Bitu cmos_readreg(Bitu port,Bitu iolen) {
 	if (cmos.reg>0x3f) {
 		LOG(LOG_BIOS,LOG_ERROR)("CMOS:Read from illegal register %x",cmos.reg);
@@ -130,31 +158,24 @@ static Bitu cmos_readreg(Bitu port,Bitu iolen) {
 	}
 	Bitu drive_a, drive_b;
 	Bit8u hdparm;
-	time_t curtime;
-	struct tm *loctime;
-	/* Get the current time. */
-	curtime = time (NULL);
-
-	/* Convert it to local time representation. */
-	loctime = localtime (&curtime);
 
 	switch (cmos.reg) {
 	case 0x00:		/* Seconds */
-		return 	MAKE_RETURN(loctime->tm_sec);
+		return 	MAKE_RETURN(cmos_localtime()->tm_sec);
 	case 0x02:		/* Minutes */
-		return 	MAKE_RETURN(loctime->tm_min);
+		return 	MAKE_RETURN(cmos_localtime()->tm_min);
 	case 0x04:		/* Hours */
-		return 	MAKE_RETURN(loctime->tm_hour);
+		return 	MAKE_RETURN(cmos_localtime()->tm_hour);
 	case 0x06:		/* Day of week */
-		return 	MAKE_RETURN(loctime->tm_wday + 1);
+		return 	MAKE_RETURN(cmos_localtime()->tm_wday + 1);
 	case 0x07:		/* Date of month */
-		return 	MAKE_RETURN(loctime->tm_mday);
+		return 	MAKE_RETURN(cmos_localtime()->tm_mday);
 	case 0x08:		/* Month */
-		return 	MAKE_RETURN(loctime->tm_mon + 1);
+		return 	MAKE_RETURN(cmos_localtime()->tm_mon + 1);
 	case 0x09:		/* Year */
-		return 	MAKE_RETURN(loctime->tm_year % 100);
+		return 	MAKE_RETURN(cmos_localtime()->tm_year % 100);
 	case 0x32:		/* Century */
-		return 	MAKE_RETURN(loctime->tm_year / 100 + 19);
+		return 	MAKE_RETURN(cmos_localtime()->tm_year / 100 + 19);
 	case 0x01:		/* Seconds Alarm */
 	case 0x03:		/* Minutes Alarm */
 	case 0x05:		/* Hours Alarm */
@@ -33,53 +33,114 @@ Bit32u ems_board_mapping[LINK_START];
 
 static Bit32u dma_wrapping = 0xffff;
 
+static void DMA_InvalidateSpans(void);
+
 static void UpdateEMSMapping(void) {
 	/* if EMS is not present, this will result in a 1:1 mapping */
 	Bitu i;
 	for (i=0;i<0x10;i++) {
 		ems_board_mapping[EMM_PAGEFRAME4K+i]=paging.firstmb[EMM_PAGEFRAME4K+i];
 	}
+	DMA_InvalidateSpans();
+}
+
+/* resolve a 4k page through the EMS pageframe etc. */
+static INLINE Bitu DMA_MapPage(Bitu page) {
+	if (page < EMM_PAGEFRAME4K) page = paging.firstmb[page];
+	else if (page < EMM_PAGEFRAME4K+0x10) page = ems_board_mapping[page];
+	else if (page < LINK_START) page = paging.firstmb[page];
+	return page;
 }
 
-/* read a block from physical memory */
-static void DMA_BlockRead(PhysPt spage,PhysPt offset,void * data,Bitu size,Bit8u dma16) {
-	Bit8u * write=(Bit8u *) data;
+/* per-unit fallback for when segment wrapping is disabled (emm386 sets
+   dma_wrapping to 0xffffffff): the window is the whole address space,
+   far too large to enumerate into spans */
+static void DMA_BlockMove(PhysPt spage,PhysPt offset,Bit8u * buffer,Bitu size,Bit8u dma16,bool to_guest) {
 	Bitu highpart_addr_page = spage>>12;
 	size <<= dma16;
 	offset <<= dma16;
 	Bit32u dma_wrap = ((0xffff<<dma16)+dma16) | dma_wrapping;
 	for ( ; size ; size--, offset++) {
 		if (offset>(dma_wrapping<<dma16)) {
-			LOG_MSG("DMA segbound wrapping (read): %x:%x size %" sBitfs(x) " [%x] wrap %x",spage,offset,size,dma16,dma_wrapping);
+			LOG_MSG("DMA segbound wrapping: %x:%x size %" sBitfs(x) " [%x] wrap %x",spage,offset,size,dma16,dma_wrapping);
 		}
 		offset &= dma_wrap;
-		Bitu page = highpart_addr_page+(offset >> 12);
-		/* care for EMS pageframe etc. */
-		if (page < EMM_PAGEFRAME4K) page = paging.firstmb[page];
-		else if (page < EMM_PAGEFRAME4K+0x10) page = ems_board_mapping[page];
-		else if (page < LINK_START) page = paging.firstmb[page];
-		*write++=phys_readb(page*4096 + (offset & 4095));
+		Bitu page = DMA_MapPage(highpart_addr_page+(offset >> 12));
+		if (to_guest) phys_writeb(page*4096 + (offset & 4095), *buffer++);
+		else *buffer++=phys_readb(page*4096 + (offset & 4095));
 	}
 }
 
-/* write a block into physical memory */
-static void DMA_BlockWrite(PhysPt spage,PhysPt offset,void * data,Bitu size,Bit8u dma16) {
-	Bit8u * read=(Bit8u *) data;
-	Bitu highpart_addr_page = spage>>12;
-	size <<= dma16;
-	offset <<= dma16;
-	Bit32u dma_wrap = ((0xffff<<dma16)+dma16) | dma_wrapping;
-	for ( ; size ; size--, offset++) {
-		if (offset>(dma_wrapping<<dma16)) {
-			LOG_MSG("DMA segbound wrapping (write): %x:%x size %" sBitfs(x) " [%x] wrap %x",spage,offset,size,dma16,dma_wrapping);
+/**
+ * The page mapping and the segment wrap point only change when a channel
+ * is reprogrammed (all those port writes run UpdateEMSMapping), so each
+ * channel resolves its whole wrap window into a short list of contiguous
+ * host spans once and transfers walk that list with plain copies. Only
+ * the normal 64K/128K wrap window is cached this way; DMA_SPAN_MAX is
+ * sized for its worst-case page count.
+ */
+
+void DmaChannel::BuildSpans(void) {
+	const Bit32u dma_wrap = ((0xffff << DMA16) + DMA16) | dma_wrapping;
+	const Bitu base_page = pagebase >> 12;
+	span_wrap = dma_wrap;
+	span_count = 0;
+	Bit32u offset = 0;
+	Bit8u * prev_end = NULL;
+	while (offset <= dma_wrap) {
+		Bitu page = DMA_MapPage(base_page + (offset >> 12));
+		Bit8u * host = MemBase + page*4096;
+		Bit32u len = 4096;
+		if (offset + len > dma_wrap + 1) len = dma_wrap + 1 - offset;
+		if (span_count && host == prev_end) {
+			/* adjacent in host memory, extend the previous span */
+			spans[span_count-1].len += len;
+		} else {
+			spans[span_count].host = host;
+			spans[span_count].start = offset;
+			spans[span_count].len = len;
+			span_count++;
 		}
-		offset &= dma_wrap;
-		Bitu page = highpart_addr_page+(offset >> 12);
-		/* care for EMS pageframe etc. */
-		if (page < EMM_PAGEFRAME4K) page = paging.firstmb[page];
-		else if (page < EMM_PAGEFRAME4K+0x10) page = ems_board_mapping[page];
-		else if (page < LINK_START) page = paging.firstmb[page];
-		phys_writeb(page*4096 + (offset & 4095), *read++);
+		prev_end = host + len;
+		offset += len;
+	}
+	spans_ok = true;
+}
+
+/* move a block between the channel's wrap window and a host buffer;
+   addr and size are in transfer units, to_guest selects the direction */
+void DmaChannel::TransferBlock(Bitu addr,Bit8u * buffer,Bitu size,bool to_guest) {
+	if (GCC_UNLIKELY(dma_wrapping != 0xffff)) {
+		DMA_BlockMove(pagebase,addr,buffer,size,DMA16,to_guest);
+		return;
+	}
+	if (GCC_UNLIKELY(!spans_ok)) BuildSpans();
+	Bit32u offset = ((Bit32u)addr << DMA16) & span_wrap;
+	size <<= DMA16;
+	Bitu s = 0;
+	while (offset >= spans[s].start + spans[s].len) s++;
+	while (size) {
+		const Bit32u into = offset - spans[s].start;
+		Bitu todo = spans[s].len - into;
+		if (todo > size) todo = size;
+		if (to_guest) memcpy(spans[s].host + into, buffer, todo);
+		else memcpy(buffer, spans[s].host + into, todo);
+		buffer += todo;
+		offset += todo;
+		size -= todo;
+		if (offset > span_wrap) {
+			LOG_MSG("DMA segbound wrapping: chan %x offset %x wrap %x",channum,offset,span_wrap);
+			offset = 0;
+			s = 0;
+		} else s++;
+	}
+}
+
+/* any reprogramming or ems remap drops every cached span list */
+static void DMA_InvalidateSpans(void) {
+	for (Bit8u ct=0;ct<8;ct++) {
+		DmaChannel * chan=GetDMAChannel(ct);
+		if (chan) chan->spans_ok=false;
 	}
 }
 
@@ -280,6 +341,9 @@ DmaChannel::DmaChannel(Bit8u num, bool dma16) {
 	autoinit = false;
 	tcount = false;
 	request = false;
+	span_count = 0;
+	span_wrap = 0;
+	spans_ok = false;
 }
 
 Bitu DmaChannel::Read(Bitu want, Bit8u * buffer) {
@@ -288,12 +352,12 @@ Bitu DmaChannel::Read(Bitu want, Bit8u * buffer) {
 again:
 	Bitu left=(currcnt+1);
 	if (want<left) {
-		DMA_BlockRead(pagebase,curraddr,buffer,want,DMA16);
+		TransferBlock(curraddr,buffer,want,false);
 		done+=want;
 		curraddr+=want;
 		currcnt-=want;
 	} else {
-		DMA_BlockRead(pagebase,curraddr,buffer,want,DMA16);
+		TransferBlock(curraddr,buffer,want,false);
 		buffer+=left << DMA16;
 		want-=left;
 		done+=left;
@@ -320,12 +384,12 @@ Bitu DmaChannel::Write(Bitu want, Bit8u * buffer) {
 again:
 	Bitu left=(currcnt+1);
 	if (want<left) {
-		DMA_BlockWrite(pagebase,curraddr,buffer,want,DMA16);
+		TransferBlock(curraddr,buffer,want,true);
 		done+=want;
 		curraddr+=want;
 		currcnt-=want;
 	} else {
-		DMA_BlockWrite(pagebase,curraddr,buffer,left,DMA16);
+		TransferBlock(curraddr,buffer,left,true);
 		buffer+=left << DMA16;
 		want-=left;
 		done+=left;
@@ -392,6 +456,7 @@ public:
 
 void DMA_SetWrapping(Bitu wrap) {
 	dma_wrapping = wrap;
+	DMA_InvalidateSpans();
 }
 
 static DMA* test;
@@ -320,31 +320,67 @@ public:
 		UpdateVolumes();
 	}
 
+	// How many samples the channel can advance before the per-sample
+	// updates could change any state (wave boundary, ramp step, IRQ)
+	INLINE Bit32u SteadySamples(void) const {
+		if (!(RampCtrl & 0x3)) return 0;	//the volume ramp is running
+		if (WaveCtrl & (WCTRL_STOP | WCTRL_STOPPED)) return 0xffffffff;
+		if (!WaveAdd) return 0xffffffff;
+		if (WaveCtrl & WCTRL_DECREASING) {
+			if (WaveAddr <= WaveStart) return 0;
+			return (WaveAddr - WaveStart - 1) / WaveAdd;
+		}
+		if (WaveAddr >= WaveEnd) return 0;
+		return (WaveEnd - WaveAddr - 1) / WaveAdd;
+	}
+
 	void generateSamples(Bit32s * stream,Bit32u len) {
 		//Disabled channel
 		if (RampCtrl & WaveCtrl & 3) return;
 
-		if (WaveCtrl & WCTRL_16BIT) {
-			for (int i = 0; i < (int)len; i++) {
-				// Get sample
-				Bit32s tmpsamp = GetSample16();
-				// Output stereo sample
-				stream[i << 1] += tmpsamp * VolLeft;
-				stream[(i << 1) + 1] += tmpsamp * VolRight;
-				WaveUpdate();
-				RampUpdate();
-			}
-		}
-		else {
-			for (int i = 0; i < (int)len; i++) {
-				// Get sample
-				Bit32s tmpsamp = GetSample8();
-				// Output stereo sample
-				stream[i << 1] += tmpsamp * VolLeft;
-				stream[(i << 1) + 1] += tmpsamp * VolRight;
-				WaveUpdate();
-				RampUpdate();
+		Bit32u i = 0;
+		while (i < len) {
+			Bit32u run = SteadySamples();
+			if (run > len - i) run = len - i;
+			if (run) {
+				/* Neither a wave boundary nor a ramp step can fire
+				   in this span, so the updates reduce to a linear
+				   address step: interpolate and accumulate with
+				   constant volumes in a tight loop */
+				const bool moving = !(WaveCtrl & (WCTRL_STOP | WCTRL_STOPPED));
+				const bool decreasing = (WaveCtrl & WCTRL_DECREASING) != 0;
+				if (WaveCtrl & WCTRL_16BIT) {
+					for (Bit32u j = 0; j < run; j++, i++) {
+						const Bit32s tmpsamp = GetSample16();
+						stream[i << 1] += tmpsamp * VolLeft;
+						stream[(i << 1) + 1] += tmpsamp * VolRight;
+						if (moving) {
+							if (decreasing) WaveAddr -= WaveAdd;
+							else WaveAddr += WaveAdd;
+						}
+					}
+				} else {
+					for (Bit32u j = 0; j < run; j++, i++) {
+						const Bit32s tmpsamp = GetSample8();
+						stream[i << 1] += tmpsamp * VolLeft;
+						stream[(i << 1) + 1] += tmpsamp * VolRight;
+						if (moving) {
+							if (decreasing) WaveAddr -= WaveAdd;
+							else WaveAddr += WaveAdd;
+						}
+					}
+				}
+				continue;
 			}
+			/* A boundary or ramp step may land on this sample, so take
+			   the full per-sample update path */
+			const Bit32s tmpsamp = (WaveCtrl & WCTRL_16BIT) ? GetSample16()
+			                                                : GetSample8();
+			stream[i << 1] += tmpsamp * VolLeft;
+			stream[(i << 1) + 1] += tmpsamp * VolRight;
+			WaveUpdate();
+			RampUpdate();
+			i++;
 		}
 	}
 };
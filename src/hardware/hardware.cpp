@@ -29,6 +29,9 @@
 #include "pic.h"
 #include "render.h"
 #include "cross.h"
+#include "taskpool.h"
+
+#include <SDL_thread.h>
 
 #if (C_SSHOT)
 #include <png.h>
@@ -36,6 +39,7 @@
 #endif
 
 static std::string capturedir;
+static int zmbv_compression = 4;
 extern const char* RunningProgram;
 Bitu CaptureState;
 
@@ -76,10 +80,102 @@ static struct {
 		void		*buf;
 		Bit8u		*index;
 		Bitu		indexsize, indexused;
+		SDL_Thread	*thread;
+		SDL_sem		*todo, *done;
+		bool		pending, quit;
+		int			pendingFlags, pendingWritten;
+		Bit16s		pendingAudio[WAVE_BUF][2];
+		Bitu		pendingAudioBytes;
 	} video;
 #endif
 } capture;
 
+/* Shared capture writer: full capture blocks are handed to a background
+   thread so the flushes on the audio path (wave, midi, raw opl) never
+   block on host file I/O. The ring is bounded; a caller that finds it
+   full waits for a slot, which is no worse than doing the write itself. */
+#define CAPWRITE_BLOCKS		8
+#define CAPWRITE_BLOCKSIZE	(4*WAVE_BUF)
+static struct {
+	struct {
+		FILE	*handle;
+		Bit32u	used;
+		Bit8u	data[CAPWRITE_BLOCKSIZE];
+	} block[CAPWRITE_BLOCKS];
+	Bitu		readpos, writepos;
+	SDL_Thread	*thread;
+	SDL_sem		*todo, *room;
+	SDL_mutex	*lock;
+	bool		quit;
+} capwriter;
+
+static int CAPTURE_WriterThread(void *) {
+	PERF_TuneWorkerThread();
+	while (true) {
+		SDL_SemWait(capwriter.todo);
+		if (capwriter.quit)
+			return 0;
+		fwrite(capwriter.block[capwriter.readpos].data, 1,
+		       capwriter.block[capwriter.readpos].used,
+		       capwriter.block[capwriter.readpos].handle);
+		capwriter.readpos = (capwriter.readpos+1) % CAPWRITE_BLOCKS;
+		SDL_SemPost(capwriter.room);
+	}
+}
+
+void CAPTURE_WriteBlock(FILE * handle,const void * data,Bitu len) {
+	if (!capwriter.thread || len > CAPWRITE_BLOCKSIZE) {
+		fwrite(data,1,len,handle);
+		return;
+	}
+	SDL_SemWait(capwriter.room);
+	/* wave comes in from the mixer callback while midi and opl arrive
+	   from the emulation thread, so slot assignment needs the lock */
+	SDL_LockMutex(capwriter.lock);
+	capwriter.block[capwriter.writepos].handle = handle;
+	capwriter.block[capwriter.writepos].used = (Bit32u)len;
+	memcpy(capwriter.block[capwriter.writepos].data, data, len);
+	capwriter.writepos = (capwriter.writepos+1) % CAPWRITE_BLOCKS;
+	SDL_UnlockMutex(capwriter.lock);
+	SDL_SemPost(capwriter.todo);
+}
+
+void CAPTURE_WriterFlush(void) {
+	if (!capwriter.thread)
+		return;
+	/* holding every slot means the queue is drained and the writer is
+	   idle; needed before seeking back to fix up a header or closing */
+	for (Bitu i=0;i<CAPWRITE_BLOCKS;i++)
+		SDL_SemWait(capwriter.room);
+	for (Bitu i=0;i<CAPWRITE_BLOCKS;i++)
+		SDL_SemPost(capwriter.room);
+}
+
+static void CAPTURE_WriterStartUp(void) {
+	capwriter.readpos = capwriter.writepos = 0;
+	capwriter.quit = false;
+	capwriter.todo = SDL_CreateSemaphore(0);
+	capwriter.room = SDL_CreateSemaphore(CAPWRITE_BLOCKS);
+	capwriter.lock = SDL_CreateMutex();
+	if (capwriter.todo && capwriter.room && capwriter.lock)
+		capwriter.thread = SDL_CreateThread(CAPTURE_WriterThread, "CapWrite", NULL);
+	if (!capwriter.thread)
+		LOG_MSG("No writer thread for capturing, writing synchronously");
+}
+
+static void CAPTURE_WriterShutDown(void) {
+	if (!capwriter.thread)
+		return;
+	CAPTURE_WriterFlush();
+	capwriter.quit = true;
+	SDL_SemPost(capwriter.todo);
+	SDL_WaitThread(capwriter.thread, NULL);
+	capwriter.thread = NULL;
+	SDL_DestroySemaphore(capwriter.todo);
+	SDL_DestroySemaphore(capwriter.room);
+	SDL_DestroyMutex(capwriter.lock);
+}
+
 FILE * OpenCaptureFile(const char * type,const char * ext) {
 	if(capturedir.empty()) {
 		LOG_MSG("Please specify a capture directory");
@@ -144,10 +240,12 @@ static void CAPTURE_AddAviChunk(const char * tag, Bit32u size, void * data, Bit3
 	pos = capture.video.written + 4;
 	capture.video.written += writesize + 8;
 	if (capture.video.indexused + 16 >= capture.video.indexsize ) {
-		capture.video.index = (Bit8u*)realloc( capture.video.index, capture.video.indexsize + 16 * 4096);
+		/* double the arena; growing it linearly makes realloc copy the
+		   whole index ever more often as the session gets longer */
+		capture.video.index = (Bit8u*)realloc( capture.video.index, capture.video.indexsize * 2);
 		if (!capture.video.index)
 			E_Exit("Ran out of memory during AVI capturing");
-		capture.video.indexsize += 16*4096;
+		capture.video.indexsize *= 2;
 	}
 	index = capture.video.index+capture.video.indexused;
 	capture.video.indexused += 16;
@@ -162,13 +260,53 @@ static void CAPTURE_AddAviChunk(const char * tag, Bit32u size, void * data, Bit3
 #endif
 
 #if (C_SSHOT)
+/* The zlib stage and the chunk fwrites run on a worker thread,
+   overlapped with the emulation of the next frame; the main thread only
+   waits for the previous frame before reusing the codec state */
+static int CAPTURE_VideoThread(void *) {
+	PERF_TuneWorkerThread();
+	while (true) {
+		SDL_SemWait(capture.video.todo);
+		if (capture.video.quit)
+			return 0;
+		capture.video.pendingWritten = capture.video.codec->DeflateFrame();
+		if (capture.video.pendingWritten >= 0) {
+			CAPTURE_AddAviChunk( "00dc", capture.video.pendingWritten, capture.video.buf, capture.video.pendingFlags & 1 ? 0x10 : 0x0);
+			capture.video.frames++;
+		}
+		if (capture.video.pendingAudioBytes) {
+			CAPTURE_AddAviChunk( "01wb", capture.video.pendingAudioBytes, capture.video.pendingAudio, 0);
+			capture.video.audiowritten = capture.video.pendingAudioBytes;
+			capture.video.pendingAudioBytes = 0;
+		}
+		SDL_SemPost(capture.video.done);
+	}
+}
+
+static void CAPTURE_VideoFlushFrame(void) {
+	if (!capture.video.pending)
+		return;
+	SDL_SemWait(capture.video.done);
+	capture.video.pending = false;
+}
+
 static void CAPTURE_VideoEvent(bool pressed) {
 	if (!pressed)
 		return;
 	if (CaptureState & CAPTURE_VIDEO) {
 		/* Close the video */
 		CaptureState &= ~CAPTURE_VIDEO;
-		LOG_MSG("Stopped capturing video.");	
+		LOG_MSG("Stopped capturing video.");
+
+		CAPTURE_VideoFlushFrame();
+		if (capture.video.thread) {
+			capture.video.quit = true;
+			SDL_SemPost(capture.video.todo);
+			SDL_WaitThread(capture.video.thread, NULL);
+			capture.video.thread = NULL;
+			SDL_DestroySemaphore(capture.video.todo);
+			SDL_DestroySemaphore(capture.video.done);
+		}
 
 		Bit8u avi_header[AVI_HEADER_SIZE];
 		Bitu main_list;
@@ -300,6 +438,187 @@ static void CAPTURE_VideoEvent(bool pressed) {
 }
 #endif
 
+#if (C_SSHOT)
+/* all the state a screenshot needs, copied off so the png can be
+   compressed and written without stalling the emulation */
+struct ScreenShot {
+	FILE *fp;
+	Bitu width, height, bpp, pitch, flags;
+	Bit8u pal[256*4];
+	Bit8u *data;
+};
+
+/* rows handed to libpng per call; fewer library entry points and the
+   converted rows stay warm in cache for the filter pass */
+#define SHOT_ROW_BATCH 16
+
+static int CAPTURE_ShotThread(void * arg) {
+	ScreenShot *shot = (ScreenShot *)arg;
+	Bitu i;
+	Bitu countWidth = (shot->flags & CAPTURE_FLAG_DBLW) ? (shot->width / 2) : shot->width;
+	png_structp png_ptr;
+	png_infop info_ptr;
+	png_color palette[256];
+
+	/* First try to allocate the png structures */
+	png_ptr = png_create_write_struct(PNG_LIBPNG_VER_STRING, NULL,NULL, NULL);
+	if (!png_ptr) {
+		fclose(shot->fp);
+		delete [] shot->data;
+		delete shot;
+		return 0;
+	}
+	info_ptr = png_create_info_struct(png_ptr);
+	if (!info_ptr) {
+		png_destroy_write_struct(&png_ptr, (png_infopp)NULL);
+		fclose(shot->fp);
+		delete [] shot->data;
+		delete shot;
+		return 0;
+	}
+
+	/* Finalize the initing of png library */
+	png_init_io(png_ptr, shot->fp);
+	/* default level instead of best; screenshots in quick succession
+	   should not pile up encoder threads for a few percent of size */
+	png_set_compression_level(png_ptr,Z_DEFAULT_COMPRESSION);
+	/* skip libpng's try-all-filters heuristic; palette data filters
+	   badly anyway and SUB is nearly always the pick for truecolour */
+	png_set_filter(png_ptr, 0, (shot->bpp==8) ? PNG_FILTER_NONE : PNG_FILTER_SUB);
+
+	/* set other zlib parameters */
+	png_set_compression_mem_level(png_ptr, 8);
+	png_set_compression_strategy(png_ptr,Z_DEFAULT_STRATEGY);
+	png_set_compression_window_bits(png_ptr, 15);
+	png_set_compression_method(png_ptr, 8);
+	png_set_compression_buffer_size(png_ptr, 8192);
+
+	if (shot->bpp==8) {
+		png_set_IHDR(png_ptr, info_ptr, shot->width, shot->height,
+			8, PNG_COLOR_TYPE_PALETTE, PNG_INTERLACE_NONE,
+			PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+		for (i=0;i<256;i++) {
+			palette[i].red=shot->pal[i*4+0];
+			palette[i].green=shot->pal[i*4+1];
+			palette[i].blue=shot->pal[i*4+2];
+		}
+		png_set_PLTE(png_ptr, info_ptr, palette,256);
+	} else {
+		png_set_bgr( png_ptr );
+		png_set_IHDR(png_ptr, info_ptr, shot->width, shot->height,
+			8, PNG_COLOR_TYPE_RGB, PNG_INTERLACE_NONE,
+			PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+	}
+#ifdef PNG_TEXT_SUPPORTED
+	constexpr char keyword[] = "Software";
+	constexpr char value[] = "dosbox-staging " VERSION;
+	constexpr int num_text = 1;
+	static_assert(sizeof(keyword) < 80, "libpng limit");
+	png_text texts[num_text] = {};
+	texts[0].compression = PNG_TEXT_COMPRESSION_NONE;
+	texts[0].key = const_cast<png_charp>(keyword);
+	texts[0].text = const_cast<png_charp>(value);
+	texts[0].text_length = sizeof(value);
+	png_set_text(png_ptr, info_ptr, texts, num_text);
+#endif
+	png_write_info(png_ptr, info_ptr);
+	Bit8u *rowBuf = new Bit8u[SHOT_ROW_BATCH * SCALER_MAXWIDTH * 4];
+	png_bytep rowPointers[SHOT_ROW_BATCH];
+	Bitu batched = 0;
+	for (i=0;i<shot->height;i++) {
+		Bit8u *doubleRow = rowBuf + batched * SCALER_MAXWIDTH * 4;
+		void *rowPointer;
+		uint8_t *srcLine;
+		if (shot->flags & CAPTURE_FLAG_DBLH)
+			srcLine=(shot->data+(i >> 1)*shot->pitch);
+		else
+			srcLine=(shot->data+(i >> 0)*shot->pitch);
+		rowPointer=srcLine;
+		switch (shot->bpp) {
+		case 8:
+			if (shot->flags & CAPTURE_FLAG_DBLW) {
+				for (Bitu x=0;x<countWidth;x++)
+					doubleRow[x*2+0] =
+					doubleRow[x*2+1] = srcLine[x];
+				rowPointer = doubleRow;
+			}
+			break;
+		case 15:
+			if (shot->flags & CAPTURE_FLAG_DBLW) {
+				for (Bitu x = 0; x < countWidth; x++) {
+					const Bitu pixel = host_readw_at(srcLine, x);
+					doubleRow[x*6+0] = doubleRow[x*6+3] = ((pixel& 0x001f) * 0x21) >>  2;
+					doubleRow[x*6+1] = doubleRow[x*6+4] = ((pixel& 0x03e0) * 0x21) >>  7;
+					doubleRow[x*6+2] = doubleRow[x*6+5] = ((pixel& 0x7c00) * 0x21) >>  12;
+				}
+			} else {
+				for (Bitu x = 0; x < countWidth; x++) {
+					const Bitu pixel = host_readw_at(srcLine, x);
+					doubleRow[x*3+0] = ((pixel& 0x001f) * 0x21) >>  2;
+					doubleRow[x*3+1] = ((pixel& 0x03e0) * 0x21) >>  7;
+					doubleRow[x*3+2] = ((pixel& 0x7c00) * 0x21) >>  12;
+				}
+			}
+			rowPointer = doubleRow;
+			break;
+		case 16:
+			if (shot->flags & CAPTURE_FLAG_DBLW) {
+				for (Bitu x = 0; x < countWidth; x++) {
+					const Bitu pixel = host_readw_at(srcLine, x);
+					doubleRow[x*6+0] = doubleRow[x*6+3] = ((pixel& 0x001f) * 0x21) >> 2;
+					doubleRow[x*6+1] = doubleRow[x*6+4] = ((pixel& 0x07e0) * 0x41) >> 9;
+					doubleRow[x*6+2] = doubleRow[x*6+5] = ((pixel& 0xf800) * 0x21) >> 13;
+				}
+			} else {
+				for (Bitu x = 0; x < countWidth; x++) {
+					const Bitu pixel = host_readw_at(srcLine, x);
+					doubleRow[x*3+0] = ((pixel& 0x001f) * 0x21) >>  2;
+					doubleRow[x*3+1] = ((pixel& 0x07e0) * 0x41) >>  9;
+					doubleRow[x*3+2] = ((pixel& 0xf800) * 0x21) >>  13;
+				}
+			}
+			rowPointer = doubleRow;
+			break;
+		case 32:
+			if (shot->flags & CAPTURE_FLAG_DBLW) {
+				for (Bitu x=0;x<countWidth;x++) {
+					doubleRow[x*6+0] = doubleRow[x*6+3] = srcLine[x*4+0];
+					doubleRow[x*6+1] = doubleRow[x*6+4] = srcLine[x*4+1];
+					doubleRow[x*6+2] = doubleRow[x*6+5] = srcLine[x*4+2];
+				}
+			} else {
+				for (Bitu x=0;x<countWidth;x++) {
+					doubleRow[x*3+0] = srcLine[x*4+0];
+					doubleRow[x*3+1] = srcLine[x*4+1];
+					doubleRow[x*3+2] = srcLine[x*4+2];
+				}
+			}
+			rowPointer = doubleRow;
+			break;
+		}
+		rowPointers[batched++] = (png_bytep)rowPointer;
+		if (batched == SHOT_ROW_BATCH || i + 1 == shot->height) {
+			png_write_rows(png_ptr, rowPointers, batched);
+			batched = 0;
+		}
+	}
+	delete [] rowBuf;
+	/* Finish writing */
+	png_write_end(png_ptr, 0);
+	/*Destroy PNG structs*/
+	png_destroy_write_struct(&png_ptr, &info_ptr);
+	/*close file*/
+	fclose(shot->fp);
+	delete [] shot->data;
+	delete shot;
+	return 0;
+}
+
+static void CAPTURE_ShotTask(void * arg) {
+	CAPTURE_ShotThread(arg);
+}
+#endif
+
 void CAPTURE_AddImage(Bitu width, Bitu height, Bitu bpp, Bitu pitch, Bitu flags, float fps, Bit8u * data, Bit8u * pal) {
 #if (C_SSHOT)
 	Bitu i;
@@ -317,148 +636,32 @@ void CAPTURE_AddImage(Bitu width, Bitu height, Bitu bpp, Bitu pitch, Bitu flags,
 		return;
 	
 	if (CaptureState & CAPTURE_IMAGE) {
-		png_structp png_ptr;
-		png_infop info_ptr;
-		png_color palette[256];
-
 		CaptureState &= ~CAPTURE_IMAGE;
 		/* Open the actual file */
 		FILE *fp = OpenCaptureFile("Screenshot", ".png");
-		if (!fp)
-			goto skip_shot;
-		/* First try to allocate the png structures */
-		png_ptr = png_create_write_struct(PNG_LIBPNG_VER_STRING, NULL,NULL, NULL);
-		if (!png_ptr) {
-			fclose(fp);
-			goto skip_shot;
-		}
-		info_ptr = png_create_info_struct(png_ptr);
-		if (!info_ptr) {
-			png_destroy_write_struct(&png_ptr, (png_infopp)NULL);
-			fclose(fp);
-			goto skip_shot;
-		}
-	
-		/* Finalize the initing of png library */
-		png_init_io(png_ptr, fp);
-		png_set_compression_level(png_ptr,Z_BEST_COMPRESSION);
-		
-		/* set other zlib parameters */
-		png_set_compression_mem_level(png_ptr, 8);
-		png_set_compression_strategy(png_ptr,Z_DEFAULT_STRATEGY);
-		png_set_compression_window_bits(png_ptr, 15);
-		png_set_compression_method(png_ptr, 8);
-		png_set_compression_buffer_size(png_ptr, 8192);
-	
-		if (bpp==8) {
-			png_set_IHDR(png_ptr, info_ptr, width, height,
-				8, PNG_COLOR_TYPE_PALETTE, PNG_INTERLACE_NONE,
-				PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
-			for (i=0;i<256;i++) {
-				palette[i].red=pal[i*4+0];
-				palette[i].green=pal[i*4+1];
-				palette[i].blue=pal[i*4+2];
-			}
-			png_set_PLTE(png_ptr, info_ptr, palette,256);
-		} else {
-			png_set_bgr( png_ptr );
-			png_set_IHDR(png_ptr, info_ptr, width, height,
-				8, PNG_COLOR_TYPE_RGB, PNG_INTERLACE_NONE,
-				PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
-		}
-#ifdef PNG_TEXT_SUPPORTED
-		constexpr char keyword[] = "Software";
-		constexpr char value[] = "dosbox-staging " VERSION;
-		constexpr int num_text = 1;
-		static_assert(sizeof(keyword) < 80, "libpng limit");
-		png_text texts[num_text] = {};
-		texts[0].compression = PNG_TEXT_COMPRESSION_NONE;
-		texts[0].key = const_cast<png_charp>(keyword);
-		texts[0].text = const_cast<png_charp>(value);
-		texts[0].text_length = sizeof(value);
-		png_set_text(png_ptr, info_ptr, texts, num_text);
-#endif
-		png_write_info(png_ptr, info_ptr);
-		for (i=0;i<height;i++) {
-			void *rowPointer;
-			uint8_t *srcLine;
-			if (flags & CAPTURE_FLAG_DBLH)
-				srcLine=(data+(i >> 1)*pitch);
+		if (fp) {
+			/* hand the frame off to a writer thread; the png
+			   compression is way too slow for the emulation thread */
+			Bitu lines = (flags & CAPTURE_FLAG_DBLH) ? (height / 2) : height;
+			ScreenShot *shot = new ScreenShot;
+			shot->fp = fp;
+			shot->width = width;
+			shot->height = height;
+			shot->bpp = bpp;
+			shot->pitch = pitch;
+			shot->flags = flags;
+			if (bpp == 8 && pal)
+				memcpy(shot->pal, pal, sizeof(shot->pal));
 			else
-				srcLine=(data+(i >> 0)*pitch);
-			rowPointer=srcLine;
-			switch (bpp) {
-			case 8:
-				if (flags & CAPTURE_FLAG_DBLW) {
-   					for (Bitu x=0;x<countWidth;x++)
-						doubleRow[x*2+0] =
-						doubleRow[x*2+1] = srcLine[x];
-					rowPointer = doubleRow;
-				}
-				break;
-			case 15:
-				if (flags & CAPTURE_FLAG_DBLW) {
-					for (Bitu x = 0; x < countWidth; x++) {
-						const Bitu pixel = host_readw_at(srcLine, x);
-						doubleRow[x*6+0] = doubleRow[x*6+3] = ((pixel& 0x001f) * 0x21) >>  2;
-						doubleRow[x*6+1] = doubleRow[x*6+4] = ((pixel& 0x03e0) * 0x21) >>  7;
-						doubleRow[x*6+2] = doubleRow[x*6+5] = ((pixel& 0x7c00) * 0x21) >>  12;
-					}
-				} else {
-					for (Bitu x = 0; x < countWidth; x++) {
-						const Bitu pixel = host_readw_at(srcLine, x);
-						doubleRow[x*3+0] = ((pixel& 0x001f) * 0x21) >>  2;
-						doubleRow[x*3+1] = ((pixel& 0x03e0) * 0x21) >>  7;
-						doubleRow[x*3+2] = ((pixel& 0x7c00) * 0x21) >>  12;
-					}
-				}
-				rowPointer = doubleRow;
-				break;
-			case 16:
-				if (flags & CAPTURE_FLAG_DBLW) {
-					for (Bitu x = 0; x < countWidth; x++) {
-						const Bitu pixel = host_readw_at(srcLine, x);
-						doubleRow[x*6+0] = doubleRow[x*6+3] = ((pixel& 0x001f) * 0x21) >> 2;
-						doubleRow[x*6+1] = doubleRow[x*6+4] = ((pixel& 0x07e0) * 0x41) >> 9;
-						doubleRow[x*6+2] = doubleRow[x*6+5] = ((pixel& 0xf800) * 0x21) >> 13;
-					}
-				} else {
-					for (Bitu x = 0; x < countWidth; x++) {
-						const Bitu pixel = host_readw_at(srcLine, x);
-						doubleRow[x*3+0] = ((pixel& 0x001f) * 0x21) >>  2;
-						doubleRow[x*3+1] = ((pixel& 0x07e0) * 0x41) >>  9;
-						doubleRow[x*3+2] = ((pixel& 0xf800) * 0x21) >>  13;
-					}
-				}
-				rowPointer = doubleRow;
-				break;
-			case 32:
-				if (flags & CAPTURE_FLAG_DBLW) {
-					for (Bitu x=0;x<countWidth;x++) {
-						doubleRow[x*6+0] = doubleRow[x*6+3] = srcLine[x*4+0];
-						doubleRow[x*6+1] = doubleRow[x*6+4] = srcLine[x*4+1];
-						doubleRow[x*6+2] = doubleRow[x*6+5] = srcLine[x*4+2];
-					}
-				} else {
-					for (Bitu x=0;x<countWidth;x++) {
-						doubleRow[x*3+0] = srcLine[x*4+0];
-						doubleRow[x*3+1] = srcLine[x*4+1];
-						doubleRow[x*3+2] = srcLine[x*4+2];
-					}
-				}
-				rowPointer = doubleRow;
-				break;
-			}
-			png_write_row(png_ptr, (png_bytep)rowPointer);
+				memset(shot->pal, 0, sizeof(shot->pal));
+			shot->data = new Bit8u[lines * pitch];
+			memcpy(shot->data, data, lines * pitch);
+			/* the shared pool absorbs the encode; no thread spawn
+			   per shot, inline as the last resort */
+			if (!TASKPOOL_RunAsync(CAPTURE_ShotTask, shot))
+				CAPTURE_ShotThread(shot);
 		}
-		/* Finish writing */
-		png_write_end(png_ptr, 0);
-		/*Destroy PNG structs*/
-		png_destroy_write_struct(&png_ptr, &info_ptr);
-		/*close file*/
-		fclose(fp);
 	}
-skip_shot:
 	if (CaptureState & CAPTURE_VIDEO) {
 		zmbv_format_t format;
 		/* Disable capturing if any of the test fails */
@@ -483,10 +686,13 @@ skip_shot:
 			capture.video.handle = OpenCaptureFile("Video",".avi");
 			if (!capture.video.handle)
 				goto skip_video;
+			/* large stdio buffer so the chunk writes reach the host in
+			   big sequential blocks */
+			setvbuf(capture.video.handle, NULL, _IOFBF, 256*1024);
 			capture.video.codec = new VideoCodec();
 			if (!capture.video.codec)
 				goto skip_video;
-			if (!capture.video.codec->SetupCompress( width, height)) 
+			if (!capture.video.codec->SetupCompress( width, height, zmbv_compression)) 
 				goto skip_video;
 			capture.video.bufSize = capture.video.codec->NeededSize(width, height, format);
 			capture.video.buf = malloc( capture.video.bufSize );
@@ -498,6 +704,18 @@ skip_shot:
 			capture.video.indexsize = 16*4096;
 			capture.video.indexused = 8;
 
+			capture.video.pending = false;
+			capture.video.pendingAudioBytes = 0;
+			capture.video.quit = false;
+			capture.video.todo = SDL_CreateSemaphore(0);
+			capture.video.done = SDL_CreateSemaphore(0);
+			if (capture.video.todo && capture.video.done)
+				capture.video.thread = SDL_CreateThread(CAPTURE_VideoThread, "Capture", NULL);
+			else
+				capture.video.thread = NULL;
+			if (!capture.video.thread)
+				LOG_MSG("No worker thread for video capturing, compressing synchronously");
+
 			capture.video.width = width;
 			capture.video.height = height;
 			capture.video.bpp = bpp;
@@ -509,6 +727,9 @@ skip_shot:
 			capture.video.audioused = 0;
 			capture.video.audiowritten = 0;
 		}
+		/* Finish the frame the worker still holds before the codec state
+		   and the write buffer get reused for this one */
+		CAPTURE_VideoFlushFrame();
 		int codecFlags;
 		if (capture.video.frames % 300 == 0)
 			codecFlags = 1;
@@ -557,12 +778,27 @@ skip_shot:
 			}
 			capture.video.codec->CompressLines( 1, &rowPointer );
 		}
-		int written = capture.video.codec->FinishCompressFrame();
-		if (written < 0)
-			goto skip_video;
-		CAPTURE_AddAviChunk( "00dc", written, capture.video.buf, codecFlags & 1 ? 0x10 : 0x0);
-		capture.video.frames++;
-//		LOG_MSG("Frame %d video %d audio %d",capture.video.frames, written, capture.video.audioused *4 );
+		capture.video.codec->CompressFrameData();
+		capture.video.pendingFlags = codecFlags;
+		if (capture.video.thread) {
+			/* hand the audio gathered over this frame to the worker
+			   along with the video job, so both chunks are written
+			   off-thread; the audio block below then sees nothing */
+			if (capture.video.audioused) {
+				memcpy(capture.video.pendingAudio, capture.video.audiobuf, capture.video.audioused*4);
+				capture.video.pendingAudioBytes = capture.video.audioused*4;
+				capture.video.audioused = 0;
+			}
+			capture.video.pending = true;
+			SDL_SemPost(capture.video.todo);
+		} else {
+			capture.video.pendingWritten = capture.video.codec->DeflateFrame();
+			if (capture.video.pendingWritten < 0)
+				goto skip_video;
+			CAPTURE_AddAviChunk( "00dc", capture.video.pendingWritten, capture.video.buf, codecFlags & 1 ? 0x10 : 0x0);
+			capture.video.frames++;
+		}
+//		LOG_MSG("Frame %d video %d audio %d",capture.video.frames, capture.video.pendingWritten, capture.video.audioused *4 );
 		if ( capture.video.audioused ) {
 			CAPTURE_AddAviChunk( "01wb", capture.video.audioused * 4, capture.video.audiobuf, 0);
 			capture.video.audiowritten = capture.video.audioused*4;
@@ -624,7 +860,7 @@ void CAPTURE_AddWave(Bit32u freq, Bit32u len, Bit16s * data) {
 		while (len > 0 ) {
 			Bitu left = WAVE_BUF - capture.wave.used;
 			if (!left) {
-				fwrite(capture.wave.buf,1,4*WAVE_BUF,capture.wave.handle);
+				CAPTURE_WriteBlock(capture.wave.handle,capture.wave.buf,4*WAVE_BUF);
 				capture.wave.length += 4*WAVE_BUF;
 				capture.wave.used = 0;
 				left = WAVE_BUF;
@@ -638,6 +874,49 @@ void CAPTURE_AddWave(Bit32u freq, Bit32u len, Bit16s * data) {
 		}
 	}
 }
+/* Per-channel wave taps. Unlike the master wave capture these keep their
+   own copy of the header and their own running length, so several taps
+   with different rates can record at the same time. */
+struct WaveTap {
+	FILE *	handle;
+	Bit32u	length;
+	Bit32u	freq;
+};
+
+void * CAPTURE_OpenWaveTap(const char * label,Bit32u freq) {
+	char type[64];
+	snprintf(type,sizeof(type),"Wave Tap %s",label);
+	FILE * handle=OpenCaptureFile(type,".wav");
+	if (!handle) return NULL;
+	WaveTap * tap=new WaveTap;
+	tap->handle=handle;
+	tap->length=0;
+	tap->freq=freq;
+	fwrite(wavheader,1,sizeof(wavheader),handle);
+	return tap;
+}
+
+void CAPTURE_AddWaveTap(void * opaque,Bitu len,const Bit16s * data) {
+	WaveTap * tap=(WaveTap *)opaque;
+	CAPTURE_WriteBlock(tap->handle,data,len*4);
+	tap->length+=(Bit32u)len*4;
+}
+
+void CAPTURE_CloseWaveTap(void * opaque) {
+	WaveTap * tap=(WaveTap *)opaque;
+	CAPTURE_WriterFlush();
+	Bit8u header[sizeof(wavheader)];
+	memcpy(header,wavheader,sizeof(wavheader));
+	host_writed(&header[0x04],tap->length+sizeof(wavheader)-8);
+	host_writed(&header[0x18],tap->freq);
+	host_writed(&header[0x1C],tap->freq*4);
+	host_writed(&header[0x28],tap->length);
+	fseek(tap->handle,0,0);
+	fwrite(header,1,sizeof(header),tap->handle);
+	fclose(tap->handle);
+	delete tap;
+}
+
 static void CAPTURE_WaveEvent(bool pressed) {
 	if (!pressed)
 		return;
@@ -645,8 +924,9 @@ static void CAPTURE_WaveEvent(bool pressed) {
 	if (capture.wave.handle) {
 		LOG_MSG("Stopped capturing wave output.");
 		/* Write last piece of audio in buffer */
-		fwrite(capture.wave.buf,1,capture.wave.used*4,capture.wave.handle);
+		CAPTURE_WriteBlock(capture.wave.handle,capture.wave.buf,capture.wave.used*4);
 		capture.wave.length+=capture.wave.used*4;
+		CAPTURE_WriterFlush();
 		/* Fill in the header with useful information */
 		host_writed(&wavheader[0x04],capture.wave.length+sizeof(wavheader)-8);
 		host_writed(&wavheader[0x18],capture.wave.freq);
@@ -680,7 +960,7 @@ static void RawMidiAdd(Bit8u data) {
 	capture.midi.buffer[capture.midi.used++]=data;
 	if (capture.midi.used >= MIDI_BUF ) {
 		capture.midi.done += capture.midi.used;
-		fwrite(capture.midi.buffer,1,MIDI_BUF,capture.midi.handle);
+		CAPTURE_WriteBlock(capture.midi.handle,capture.midi.buffer,MIDI_BUF);
 		capture.midi.used = 0;
 	}
 }
@@ -725,8 +1005,9 @@ static void CAPTURE_MidiEvent(bool pressed) {
 		RawMidiAdd(0x2F);
 		RawMidiAdd(0x00);
 		/* clear out the final data in the buffer if any */
-		fwrite(capture.midi.buffer,1,capture.midi.used,capture.midi.handle);
+		CAPTURE_WriteBlock(capture.midi.handle,capture.midi.buffer,capture.midi.used);
 		capture.midi.done+=capture.midi.used;
+		CAPTURE_WriterFlush();
 		fseek(capture.midi.handle,18, SEEK_SET);
 		Bit8u size[4];
 		size[0]=(Bit8u)(capture.midi.done >> 24);
@@ -756,7 +1037,9 @@ public:
 		Section_prop * section = static_cast<Section_prop *>(configuration);
 		Prop_path* proppath= section->Get_path("captures");
 		capturedir = proppath->realpath;
+		zmbv_compression = section->Get_int("zmbvcompression");
 		CaptureState = 0;
+		CAPTURE_WriterStartUp();
 		MAPPER_AddHandler(CAPTURE_WaveEvent,MK_f6,MMOD1,"recwave","Rec Wave");
 		MAPPER_AddHandler(CAPTURE_MidiEvent,MK_f8,MMOD1|MMOD2,"caprawmidi","Cap MIDI");
 #if (C_SSHOT)
@@ -770,6 +1053,7 @@ public:
 #endif
 		if (capture.wave.handle) CAPTURE_WaveEvent(true);
 		if (capture.midi.handle) CAPTURE_MidiEvent(true);
+		CAPTURE_WriterShutDown();
 	}
 };
 
@@ -27,8 +27,15 @@
 
 //#define ENABLE_PORTLOG
 
-IO_WriteHandler * io_writehandlers[3][IO_MAX];
-IO_ReadHandler * io_readhandlers[3][IO_MAX];
+// one descriptor per port: both directions and all three widths sit in
+// the same cache line or two, instead of being spread over six separate
+// 512K table rows as with the old io_readhandlers/io_writehandlers
+// [3][IO_MAX] layout
+struct IO_PortDescriptor {
+	IO_ReadHandler * read[3];
+	IO_WriteHandler * write[3];
+};
+static IO_PortDescriptor io_ports[IO_MAX];
 
 static Bitu IO_ReadBlocked(Bitu /*port*/,Bitu /*iolen*/) {
 	return ~0;
@@ -41,16 +48,16 @@ static Bitu IO_ReadDefault(Bitu port,Bitu iolen) {
 	switch (iolen) {
 	case 1:
 		LOG(LOG_IO,LOG_WARN)("Read from port %04X",port);
-		io_readhandlers[0][port]=IO_ReadBlocked;
+		io_ports[port].read[0]=IO_ReadBlocked;
 		return 0xff;
 	case 2:
 		return
-			(io_readhandlers[0][port+0](port+0,1) << 0) |
-			(io_readhandlers[0][port+1](port+1,1) << 8);
+			(io_ports[port+0].read[0](port+0,1) << 0) |
+			(io_ports[port+1].read[0](port+1,1) << 8);
 	case 4:
 		return
-			(io_readhandlers[1][port+0](port+0,2) << 0) |
-			(io_readhandlers[1][port+2](port+2,2) << 16);
+			(io_ports[port+0].read[1](port+0,2) << 0) |
+			(io_ports[port+2].read[1](port+2,2) << 16);
 	}
 	return 0;
 }
@@ -59,51 +66,65 @@ void IO_WriteDefault(Bitu port,Bitu val,Bitu iolen) {
 	switch (iolen) {
 	case 1:
 		LOG(LOG_IO,LOG_WARN)("Writing %02X to port %04X",val,port);
-		io_writehandlers[0][port]=IO_WriteBlocked;
+		io_ports[port].write[0]=IO_WriteBlocked;
 		break;
 	case 2:
-		io_writehandlers[0][port+0](port+0,(val >> 0) & 0xff,1);
-		io_writehandlers[0][port+1](port+1,(val >> 8) & 0xff,1);
+		io_ports[port+0].write[0](port+0,(val >> 0) & 0xff,1);
+		io_ports[port+1].write[0](port+1,(val >> 8) & 0xff,1);
 		break;
 	case 4:
-		io_writehandlers[1][port+0](port+0,(val >> 0 ) & 0xffff,2);
-		io_writehandlers[1][port+2](port+2,(val >> 16) & 0xffff,2);
+		io_ports[port+0].write[1](port+0,(val >> 0 ) & 0xffff,2);
+		io_ports[port+2].write[1](port+2,(val >> 16) & 0xffff,2);
 		break;
 	}
 }
 
 void IO_RegisterReadHandler(Bitu port,IO_ReadHandler * handler,Bitu mask,Bitu range) {
 	while (range--) {
-		if (mask&IO_MB) io_readhandlers[0][port]=handler;
-		if (mask&IO_MW) io_readhandlers[1][port]=handler;
-		if (mask&IO_MD) io_readhandlers[2][port]=handler;
+		if (mask&IO_MB) io_ports[port].read[0]=handler;
+		if (mask&IO_MW) io_ports[port].read[1]=handler;
+		if (mask&IO_MD) io_ports[port].read[2]=handler;
 		port++;
 	}
 }
 
 void IO_RegisterWriteHandler(Bitu port,IO_WriteHandler * handler,Bitu mask,Bitu range) {
 	while (range--) {
-		if (mask&IO_MB) io_writehandlers[0][port]=handler;
-		if (mask&IO_MW) io_writehandlers[1][port]=handler;
-		if (mask&IO_MD) io_writehandlers[2][port]=handler;
+		if (mask&IO_MB) io_ports[port].write[0]=handler;
+		if (mask&IO_MW) io_ports[port].write[1]=handler;
+		if (mask&IO_MD) io_ports[port].write[2]=handler;
 		port++;
 	}
 }
 
+void IO_RegisterPortMap(const IO_PortMapEntry * map,Bitu count) {
+	for (Bitu i=0;i<count;i++) {
+		if (map[i].read) IO_RegisterReadHandler(map[i].port,map[i].read,map[i].mask,map[i].range);
+		if (map[i].write) IO_RegisterWriteHandler(map[i].port,map[i].write,map[i].mask,map[i].range);
+	}
+}
+
+void IO_FreePortMap(const IO_PortMapEntry * map,Bitu count) {
+	for (Bitu i=0;i<count;i++) {
+		if (map[i].read) IO_FreeReadHandler(map[i].port,map[i].mask,map[i].range);
+		if (map[i].write) IO_FreeWriteHandler(map[i].port,map[i].mask,map[i].range);
+	}
+}
+
 void IO_FreeReadHandler(Bitu port,Bitu mask,Bitu range) {
 	while (range--) {
-		if (mask&IO_MB) io_readhandlers[0][port]=IO_ReadDefault;
-		if (mask&IO_MW) io_readhandlers[1][port]=IO_ReadDefault;
-		if (mask&IO_MD) io_readhandlers[2][port]=IO_ReadDefault;
+		if (mask&IO_MB) io_ports[port].read[0]=IO_ReadDefault;
+		if (mask&IO_MW) io_ports[port].read[1]=IO_ReadDefault;
+		if (mask&IO_MD) io_ports[port].read[2]=IO_ReadDefault;
 		port++;
 	}
 }
 
 void IO_FreeWriteHandler(Bitu port,Bitu mask,Bitu range) {
 	while (range--) {
-		if (mask&IO_MB) io_writehandlers[0][port]=IO_WriteDefault;
-		if (mask&IO_MW) io_writehandlers[1][port]=IO_WriteDefault;
-		if (mask&IO_MD) io_writehandlers[2][port]=IO_WriteDefault;
+		if (mask&IO_MB) io_ports[port].write[0]=IO_WriteDefault;
+		if (mask&IO_MW) io_ports[port].write[1]=IO_WriteDefault;
+		if (mask&IO_MD) io_ports[port].write[2]=IO_WriteDefault;
 		port++;
 	}
 }
@@ -318,7 +339,7 @@ void IO_WriteB(Bitu port,Bitu val) {
 	}
 	else {
 		IO_USEC_write_delay();
-		io_writehandlers[0][port](port,val,1);
+		io_ports[port].write[0](port,val,1);
 	}
 }
 
@@ -354,7 +375,7 @@ void IO_WriteW(Bitu port,Bitu val) {
 	}
 	else {
 		IO_USEC_write_delay();
-		io_writehandlers[1][port](port,val,2);
+		io_ports[port].write[1](port,val,2);
 	}
 }
 
@@ -388,7 +409,7 @@ void IO_WriteD(Bitu port,Bitu val) {
 		memcpy(&lflags,&old_lflags,sizeof(LazyFlags));
 		cpudecoder=old_cpudecoder;
 	}
-	else io_writehandlers[2][port](port,val,4);
+	else io_ports[port].write[2](port,val,4);
 }
 
 Bitu IO_ReadB(Bitu port) {
@@ -424,7 +445,7 @@ Bitu IO_ReadB(Bitu port) {
 	}
 	else {
 		IO_USEC_read_delay();
-		retval = io_readhandlers[0][port](port,1);
+		retval = io_ports[port].read[0](port,1);
 	}
 	log_io(0, false, port, retval);
 	return retval;
@@ -462,7 +483,7 @@ Bitu IO_ReadW(Bitu port) {
 	}
 	else {
 		IO_USEC_read_delay();
-		retval = io_readhandlers[1][port](port,2);
+		retval = io_ports[port].read[1](port,2);
 	}
 	log_io(1, false, port, retval);
 	return retval;
@@ -498,7 +519,7 @@ Bitu IO_ReadD(Bitu port) {
 		memcpy(&lflags,&old_lflags,sizeof(LazyFlags));
 		cpudecoder=old_cpudecoder;
 	} else {
-		retval = io_readhandlers[2][port](port,4);
+		retval = io_ports[port].read[2](port,4);
 	}
 	log_io(2, false, port, retval);
 	return retval;
@@ -91,7 +91,8 @@ Bitu ECBAmount = 0;
 ECBClass::ECBClass(Bit16u segment, Bit16u offset) {
 	ECBAddr = RealMake(segment, offset);
 	databuffer = 0;
-	
+	bufcap = 0;
+
 #ifdef IPX_DEBUGMSG
 	SerialNumber = ECBSerialNumber;
 	ECBSerialNumber++;
@@ -125,8 +126,16 @@ ECBClass::ECBClass(Bit16u segment, Bit16u offset) {
 	mysocket = getSocket();
 }
 void ECBClass::writeDataBuffer(Bit8u* buffer, Bit16u length) {
-	if(databuffer!=0) delete [] databuffer;
-	databuffer = new Bit8u[length];
+	// runs once per received packet; reuse the old allocation
+	// when it is big enough
+	if(databuffer!=0 && bufcap<length) {
+		delete [] databuffer;
+		databuffer = 0;
+	}
+	if(databuffer==0) {
+		databuffer = new Bit8u[length];
+		bufcap = length;
+	}
 	memcpy(databuffer,buffer,length);
 	buflen=length;
 
@@ -140,14 +149,17 @@ bool ECBClass::writeData() {
 	Bitu bufoffset = 0;
 	for(Bitu i = 0;i < fragCount;i++) {
 		getFragDesc(i,&tmpFrag);
-		for(Bitu t = 0;t < tmpFrag.size;t++) {
-			real_writeb(tmpFrag.segment, tmpFrag.offset + t, buffer[bufoffset]);
-			bufoffset++;
-			if(bufoffset >= length) {
-				setCompletionFlag(COMP_SUCCESS);
-				setImmAddress(&buffer[22]);  // Write in source node
-				return true;
-			}
+		// copy whole fragments through the paging layer at once;
+		// the old byte-at-a-time loop dominated receive cost
+		Bitu tocopy = tmpFrag.size;
+		if(tocopy > length - bufoffset) tocopy = length - bufoffset;
+		MEM_BlockWrite(PhysMake(tmpFrag.segment, tmpFrag.offset),
+			&buffer[bufoffset], tocopy);
+		bufoffset += tocopy;
+		if(bufoffset >= length) {
+			setCompletionFlag(COMP_SUCCESS);
+			setImmAddress(&buffer[22]);  // Write in source node
+			return true;
 		}
 	}
 	if(bufoffset < length) {
@@ -605,8 +617,18 @@ static void IPX_ClientLoop(void) {
 	inPacket.channel = UDPChannel;
 
 	// Its amazing how much simpler UDP is than TCP
-	numrecv = SDLNet_UDP_Recv(ipxClientSocket, &inPacket);
-	if(numrecv) receivePacket(inPacket.data, inPacket.len);
+	// Drain everything that arrived since the last tick; busy games
+	// easily exceed one packet per emulated millisecond
+	while((numrecv = SDLNet_UDP_Recv(ipxClientSocket, &inPacket)) != 0) {
+		receivePacket(inPacket.data, inPacket.len);
+		// only keep draining while another ECB is listening;
+		// otherwise leave the rest queued for the next tick so
+		// the guest gets a chance to repost
+		ECBClass *useECB = ECBList;
+		while(useECB != NULL && useECB->iuflag != USEFLAG_LISTENING)
+			useECB = useECB->nextECB;
+		if(useECB == NULL) break;
+	}
 }
 
 
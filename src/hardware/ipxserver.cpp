@@ -34,11 +34,20 @@ UDPsocket ipxServerSocket;  // Listening server socket
 packetBuffer connBuffer[SOCKETTABLESIZE];
 
 Bit8u inBuffer[IPXBUFFERSIZE];
-IPaddress ipconn[SOCKETTABLESIZE];  // Active TCP/IP connection 
+IPaddress ipconn[SOCKETTABLESIZE];  // Active TCP/IP connection
 UDPsocket tcpconn[SOCKETTABLESIZE];  // Active TCP/IP connections
 SDLNet_SocketSet serverSocketSet;
 TIMER_TickHandler* serverTimer;
 
+/* The server runs on its own thread so that routing a busy session does
+   not eat into the hosting instance's emulation time; the connection
+   table is the only state shared with the emulation thread and is
+   guarded by connMutex. Falls back to the old once-per-tick polling
+   when the thread cannot be created. */
+static SDL_Thread *serverThread = NULL;
+static SDL_mutex *connMutex = NULL;
+static volatile bool serverRunning = false;
+
 Bit8u packetCRC(Bit8u *buffer, Bit16u bufSize) {
 	Bit8u tmpCRC = 0;
 	Bit16u i;
@@ -83,19 +92,26 @@ static void sendIPXPacket(Bit8u *buffer, Bit16s bufSize) {
 	destport = tmpHeader->dest.addr.byIP.port;
 	
 
+	if (connMutex) SDL_LockMutex(connMutex);
 	if(desthost == 0xffffffff) {
-		// Broadcast
+		// Broadcast; fan out with a single vectored send so the
+		// whole table costs one call instead of one per client
+		UDPpacket fanout[SOCKETTABLESIZE];
+		UDPpacket *fanoutptrs[SOCKETTABLESIZE];
+		Bitu fanoutcount = 0;
 		for(i=0;i<SOCKETTABLESIZE;i++) {
 			if(connBuffer[i].connected && ((ipconn[i].host != srchost)||(ipconn[i].port!=srcport))) {
-				outPacket.address = ipconn[i];
-				result = SDLNet_UDP_Send(ipxServerSocket,-1,&outPacket);
-				if(result == 0) {
-					LOG_MSG("IPXSERVER: %s", SDLNet_GetError());
-					continue;
-				}
+				fanout[fanoutcount] = outPacket;
+				fanout[fanoutcount].address = ipconn[i];
+				fanoutptrs[fanoutcount] = &fanout[fanoutcount];
+				fanoutcount++;
 				//LOG_MSG("IPXSERVER: Packet of %d bytes sent from %d.%d.%d.%d to %d.%d.%d.%d (BROADCAST) (%x CRC)", bufSize, CONVIP(srchost), CONVIP(ipconn[i].host), packetCRC(&buffer[30], bufSize-30));
 			}
 		}
+		if(fanoutcount) {
+			result = SDLNet_UDP_SendV(ipxServerSocket, fanoutptrs, (int)fanoutcount);
+			if(result == 0) LOG_MSG("IPXSERVER: %s", SDLNet_GetError());
+		}
 	} else {
 		// Specific address
 		for(i=0;i<SOCKETTABLESIZE;i++) {
@@ -110,16 +126,16 @@ static void sendIPXPacket(Bit8u *buffer, Bit16s bufSize) {
 			}
 		}
 	}
-
-
-
-
+	if (connMutex) SDL_UnlockMutex(connMutex);
 }
 
 bool IPX_isConnectedToServer(Bits tableNum, IPaddress ** ptrAddr) {
 	if(tableNum >= SOCKETTABLESIZE) return false;
+	if (connMutex) SDL_LockMutex(connMutex);
 	*ptrAddr = &ipconn[tableNum];
-	return connBuffer[tableNum].connected;
+	bool connected = connBuffer[tableNum].connected;
+	if (connMutex) SDL_UnlockMutex(connMutex);
+	return connected;
 }
 
 static void ackClient(IPaddress clientAddr) {
@@ -148,81 +164,132 @@ static void ackClient(IPaddress clientAddr) {
 
 }
 
-static void IPX_ServerLoop() {
-	UDPpacket inPacket;
+static void serverProcessPacket(UDPpacket *inPacket) {
 	IPaddress tmpAddr;
 
 	//char regString[] = "IPX Register\0";
 
 	Bit16u i;
 	Bit32u host;
+
+	// Check to see if incoming packet is a registration packet
+	// For this, I just spoofed the echo protocol packet designation 0x02
+	IPXHeader *tmpHeader;
+	tmpHeader = (IPXHeader *)inPacket->data;
+
+	// Check to see if echo packet
+	if(SDLNet_Read16(tmpHeader->dest.socket) == 0x2) {
+		// Null destination node means its a server registration packet
+		if(tmpHeader->dest.addr.byIP.host == 0x0) {
+			UnpackIP(tmpHeader->src.addr.byIP, &tmpAddr);
+			if (connMutex) SDL_LockMutex(connMutex);
+			for(i=0;i<SOCKETTABLESIZE;i++) {
+				if(!connBuffer[i].connected) {
+					// Use prefered host IP rather than the reported source IP
+					// It may be better to use the reported source
+					ipconn[i] = inPacket->address;
+
+					connBuffer[i].connected = true;
+					host = ipconn[i].host;
+					LOG_MSG("IPXSERVER: Connect from %d.%d.%d.%d", CONVIP(host));
+					ackClient(inPacket->address);
+					if (connMutex) SDL_UnlockMutex(connMutex);
+					return;
+				} else {
+					if((ipconn[i].host == tmpAddr.host) && (ipconn[i].port == tmpAddr.port)) {
+
+						LOG_MSG("IPXSERVER: Reconnect from %d.%d.%d.%d", CONVIP(tmpAddr.host));
+						// Update anonymous port number if changed
+						ipconn[i].port = inPacket->address.port;
+						ackClient(inPacket->address);
+						if (connMutex) SDL_UnlockMutex(connMutex);
+						return;
+					}
+				}
+
+			}
+			if (connMutex) SDL_UnlockMutex(connMutex);
+		}
+	}
+
+	// IPX packet is complete.  Now interpret IPX header and send to respective IP address
+	sendIPXPacket((Bit8u *)inPacket->data, inPacket->len);
+}
+
+static void IPX_ServerLoop() {
+	// tick-handler fallback: poll one packet per emulated millisecond
+	UDPpacket inPacket;
 	Bits result;
 
 	inPacket.channel = -1;
 	inPacket.data = &inBuffer[0];
 	inPacket.maxlen = IPXBUFFERSIZE;
 
-
 	result = SDLNet_UDP_Recv(ipxServerSocket, &inPacket);
-	if (result != 0) {
-		// Check to see if incoming packet is a registration packet
-		// For this, I just spoofed the echo protocol packet designation 0x02
-		IPXHeader *tmpHeader;
-		tmpHeader = (IPXHeader *)&inBuffer[0];
-	
-		// Check to see if echo packet
-		if(SDLNet_Read16(tmpHeader->dest.socket) == 0x2) {
-			// Null destination node means its a server registration packet
-			if(tmpHeader->dest.addr.byIP.host == 0x0) {
-				UnpackIP(tmpHeader->src.addr.byIP, &tmpAddr);
-				for(i=0;i<SOCKETTABLESIZE;i++) {
-					if(!connBuffer[i].connected) {
-						// Use prefered host IP rather than the reported source IP
-						// It may be better to use the reported source
-						ipconn[i] = inPacket.address;
-
-						connBuffer[i].connected = true;
-						host = ipconn[i].host;
-						LOG_MSG("IPXSERVER: Connect from %d.%d.%d.%d", CONVIP(host));
-						ackClient(inPacket.address);
-						return;
-					} else {
-						if((ipconn[i].host == tmpAddr.host) && (ipconn[i].port == tmpAddr.port)) {
-
-							LOG_MSG("IPXSERVER: Reconnect from %d.%d.%d.%d", CONVIP(tmpAddr.host));
-							// Update anonymous port number if changed
-							ipconn[i].port = inPacket.address.port;
-							ackClient(inPacket.address);
-							return;
-						}
-					}
-					
-				}
-			}
-		}
+	if (result != 0) serverProcessPacket(&inPacket);
+}
 
-		// IPX packet is complete.  Now interpret IPX header and send to respective IP address
-		sendIPXPacket((Bit8u *)inPacket.data, inPacket.len);
+static int IPX_ServerThread(void * /*unused*/) {
+	UDPpacket inPacket;
+
+	inPacket.channel = -1;
+	inPacket.data = &inBuffer[0];
+	inPacket.maxlen = IPXBUFFERSIZE;
+
+	while (serverRunning) {
+		// sleep until traffic arrives; the timeout bounds shutdown
+		if (SDLNet_CheckSockets(serverSocketSet, 100) <= 0) continue;
+		while (SDLNet_UDP_Recv(ipxServerSocket, &inPacket) != 0)
+			serverProcessPacket(&inPacket);
 	}
+	return 0;
 }
 
 void IPX_StopServer() {
-	TIMER_DelTickHandler(&IPX_ServerLoop);
+	if (serverThread) {
+		serverRunning = false;
+		SDL_WaitThread(serverThread, NULL);
+		serverThread = NULL;
+	} else {
+		TIMER_DelTickHandler(&IPX_ServerLoop);
+	}
+	if (serverSocketSet) {
+		SDLNet_FreeSocketSet(serverSocketSet);
+		serverSocketSet = NULL;
+	}
 	SDLNet_UDP_Close(ipxServerSocket);
+	if (connMutex) {
+		SDL_DestroyMutex(connMutex);
+		connMutex = NULL;
+	}
 }
 
 bool IPX_StartServer(Bit16u portnum) {
 	Bit16u i;
 
 	if(!SDLNet_ResolveHost(&ipxServerIp, NULL, portnum)) {
-	
-		//serverSocketSet = SDLNet_AllocSocketSet(SOCKETTABLESIZE);
+
 		ipxServerSocket = SDLNet_UDP_Open(portnum);
 		if(!ipxServerSocket) return false;
 
 		for(i=0;i<SOCKETTABLESIZE;i++) connBuffer[i].connected = false;
 
-		TIMER_AddTickHandler(&IPX_ServerLoop);
+		connMutex = SDL_CreateMutex();
+		serverSocketSet = SDLNet_AllocSocketSet(1);
+		if (connMutex && serverSocketSet &&
+		    SDLNet_UDP_AddSocket(serverSocketSet, ipxServerSocket) != -1) {
+			serverRunning = true;
+			serverThread = SDL_CreateThread(IPX_ServerThread, "IPXServer", NULL);
+		}
+		if (!serverThread) {
+			serverRunning = false;
+			if (serverSocketSet) {
+				SDLNet_FreeSocketSet(serverSocketSet);
+				serverSocketSet = NULL;
+			}
+			LOG_MSG("IPXSERVER: Couldn't start the server thread, polling from the emulation loop");
+			TIMER_AddTickHandler(&IPX_ServerLoop);
+		}
 		return true;
 	}
 	return false;
@@ -144,6 +144,29 @@ bool button_wrapping_enabled = true;
 
 extern bool autofire; //sdl_mapper.cpp
 
+/* the button/enable bits of port 0x201 only change on host events, so
+   keep them precomputed instead of rebuilding the branch chain on every
+   read; games busy-poll this port thousands of times per frame */
+static Bit8u button_mask = 0xf0;
+
+static void UpdateButtonMask(void) {
+	Bit8u mask = 0xf0;
+	if (stick[0].enabled) {
+		if (stick[0].button[0]) mask&=~16;
+		if (stick[0].button[1]) mask&=~32;
+	}
+	if (stick[1].enabled) {
+		if (stick[1].button[0]) mask&=~64;
+		if (stick[1].button[1]) mask&=~128;
+	}
+	button_mask = mask;
+}
+
+/* cached axis nibble for the timed handler, valid until the next axis
+   one-shot expires; reads in between are a compare and an or */
+static Bit8u axis_state = 0x0f;
+static double axis_next_tick = 0;
+
 static Bitu read_p201(Bitu port,Bitu iolen) {
 	/* Reset Joystick to 0 after TIMEOUT ms */
 	if(write_active && ((PIC_Ticks - last_write) > TIMEOUT)) {
@@ -164,43 +187,42 @@ static Bitu read_p201(Bitu port,Bitu iolen) {
 	**  Joystick A, Button 2 -----------+   |   |   +----------- Joystick B, X Axis
 	**  Joystick A, Button 1 ---------------+   +--------------- Joystick B, Y Axis
 	**/
-	Bit8u ret=0xff;
+	Bit8u ret=0x0f;
 	if (stick[0].enabled) {
 		if (stick[0].xcount) stick[0].xcount--; else ret&=~1;
 		if (stick[0].ycount) stick[0].ycount--; else ret&=~2;
-		if (stick[0].button[0]) ret&=~16;
-		if (stick[0].button[1]) ret&=~32;
 	}
 	if (stick[1].enabled) {
 		if (stick[1].xcount) stick[1].xcount--; else ret&=~4;
 		if (stick[1].ycount) stick[1].ycount--; else ret&=~8;
-		if (stick[1].button[0]) ret&=~64;
-		if (stick[1].button[1]) ret&=~128;
 	}
-	return ret;
+	return ret | button_mask;
 }
 
 static Bitu read_p201_timed(Bitu port,Bitu iolen) {
-	Bit8u ret=0xff;
 	double currentTick = PIC_FullIndex();
+	/* nothing expires before axis_next_tick, so the cached nibble is
+	   still what the comparisons below would produce */
+	if (GCC_LIKELY(currentTick < axis_next_tick))
+		return axis_state | button_mask;
+
+	Bit8u ret=0x0f;
+	double next = 1e30; /* nothing pending */
 	if( stick[0].enabled ){
 		if( stick[0].xtick < currentTick ) ret &=~1;
+		else if( stick[0].xtick < next ) next = stick[0].xtick;
 		if( stick[0].ytick < currentTick ) ret &=~2;
+		else if( stick[0].ytick < next ) next = stick[0].ytick;
 	}
 	if( stick[1].enabled ){
 		if( stick[1].xtick < currentTick ) ret &=~4;
+		else if( stick[1].xtick < next ) next = stick[1].xtick;
 		if( stick[1].ytick < currentTick ) ret &=~8;
+		else if( stick[1].ytick < next ) next = stick[1].ytick;
 	}
-
-	if (stick[0].enabled) {
-		if (stick[0].button[0]) ret&=~16;
-		if (stick[0].button[1]) ret&=~32;
-	}
-	if (stick[1].enabled) {
-		if (stick[1].button[0]) ret&=~64;
-		if (stick[1].button[1]) ret&=~128;
-	}
-	return ret;
+	axis_state = ret;
+	axis_next_tick = next;
+	return ret | button_mask;
 }
 
 static void write_p201(Bitu port,Bitu val,Bitu iolen) {
@@ -236,27 +258,40 @@ static void write_p201_timed(Bitu port,Bitu val,Bitu iolen) {
 		stick[1].ytick = currentTick + 1000.0*( JOY_S_CONSTANT + S_PER_OHM *
 		                 (double)((swap34? stick[1].xpos : stick[1].ypos)+1.0) * OHMS);
 	}
+	axis_next_tick = 0; /* recompute the cached nibble on the next read */
 }
 
 void JOYSTICK_Enable(Bitu which,bool enabled) {
 	if (which<2) stick[which].enabled = enabled;
+	UpdateButtonMask();
+	axis_next_tick = 0;
 }
 
 void JOYSTICK_Button(Bitu which,Bitu num,bool pressed) {
 	if ((which<2) && (num<2)) stick[which].button[num] = pressed;
+	UpdateButtonMask();
+}
+
+/* decimate incoming positions to the resolution the guest can observe
+   (the counters quantize to 1/RANGE); analog jitter below that would
+   otherwise force a retransform (sqrt and friends) per SDL event */
+static INLINE float quantize_axis(float pos) {
+	return floorf(pos * (RANGE * 4) + 0.5f) / (RANGE * 4);
 }
 
 void JOYSTICK_Move_X(Bitu which,float x) {
 	if (which > 1) return;
+	x = quantize_axis(x);
 	if (stick[which].xpos == x) return;
 	stick[which].xpos = x;
 	stick[which].transformed = false;
-//	if( which == 0 || joytype != JOY_FCS)  
-//		stick[which].applied_conversion; //todo 
+//	if( which == 0 || joytype != JOY_FCS)
+//		stick[which].applied_conversion; //todo
 }
 
 void JOYSTICK_Move_Y(Bitu which,float y) {
 	if (which > 1) return;
+	y = quantize_axis(y);
 	if (stick[which].ypos == y) return;
 	stick[which].ypos = y;
 	stick[which].transformed = false;
@@ -323,6 +358,8 @@ public:
 		bool circ = section->Get_bool("circularinput");
 		if (circ) stick[0].mapstate = JoyStick::JOYMAP_CIRCLE;
 		stick[0].deadzone = section->Get_int("deadzone");
+		UpdateButtonMask();
+		axis_next_tick = 0;
 	}
 };
 static JOYSTICK* test;
@@ -240,20 +240,57 @@ void saa1099_device::sound_stream_update(sound_stream &stream, stream_sample_t *
 		}
 	}
 
-	/* fill all data needed */
-	for( j = 0; j < samples; j++ )
+	/* fill all data needed; the mix only changes when an oscillator
+	 * flips, so generate run lengths up to the nearest flip instead of
+	 * re-evaluating every generator for every sample */
+	j = 0;
+	while (j < samples)
 	{
-		int output_l = 0, output_r = 0;
+		int output_l, output_r;
+		int run = samples - j;
 
-		/* for each channel */
+		/* make sure every tone generator has a valid frequency */
 		for (ch = 0; ch < 6; ch++)
 		{
 			if (m_channels[ch].freq == 0.0)
 				m_channels[ch].freq = (double)((2 * m_master_clock / 512) << m_channels[ch].octave) /
 					(511.0 - (double)m_channels[ch].frequency);
+		}
+
+		/* samples until the nearest level flip; the counters are
+		 * non-negative here, so the first decrement that goes below
+		 * zero is floor(counter/freq)+1 steps away */
+		for (ch = 0; ch < 6; ch++)
+		{
+			const int steps = (int)(m_channels[ch].counter / m_channels[ch].freq) + 1;
+			if (steps < run) run = steps;
+		}
+		for (ch = 0; ch < 2; ch++)
+		{
+			if (m_noise[ch].freq > 0.0)
+			{
+				const int steps = (int)(m_noise[ch].counter / m_noise[ch].freq) + 1;
+				if (steps < run) run = steps;
+			}
+		}
+		if (run < 1) run = 1;
 
-			/* check the actual position in the square wave */
-			m_channels[ch].counter -= m_channels[ch].freq;
+		/* all but the last sample of the run keep the current mix */
+		if (run > 1)
+		{
+			mix_channels(output_l, output_r);
+			for (int k = 0; k < run - 1; k++)
+			{
+				outputs[LEFT][j + k] = output_l;
+				outputs[RIGHT][j + k] = output_r;
+			}
+		}
+
+		/* advance the oscillators across the run; a flip (and the
+		 * envelope clock it may carry) lands on the last sample */
+		for (ch = 0; ch < 6; ch++)
+		{
+			m_channels[ch].counter -= m_channels[ch].freq * run;
 			while (m_channels[ch].counter < 0)
 			{
 				/* calculate new frequency now after the half wave is updated */
@@ -269,36 +306,13 @@ void saa1099_device::sound_stream_update(sound_stream &stream, stream_sample_t *
 				if (ch == 4 && m_env_clock[1] == 0)
 					envelope_w(1);
 			}
-
-			// if the noise is enabled
-			if (m_channels[ch].noise_enable)
-			{
-				// if the noise level is high (noise 0: chan 0-2, noise 1: chan 3-5)
-				if (m_noise[ch/3].level & 1)
-				{
-					// subtract to avoid overflows, also use only half amplitude
-					output_l -= m_channels[ch].amplitude[ LEFT] * m_channels[ch].envelope[ LEFT] / 16 / 2;
-					output_r -= m_channels[ch].amplitude[RIGHT] * m_channels[ch].envelope[RIGHT] / 16 / 2;
-				}
-			}
-			// if the square wave is enabled
-			if (m_channels[ch].freq_enable)
-			{
-				// if the channel level is high
-				if (m_channels[ch].level & 1)
-				{
-					output_l += m_channels[ch].amplitude[ LEFT] * m_channels[ch].envelope[ LEFT] / 16;
-					output_r += m_channels[ch].amplitude[RIGHT] * m_channels[ch].envelope[RIGHT] / 16;
-				}
-			}
 		}
-
 		for (ch = 0; ch < 2; ch++)
 		{
 			/* update the state of the noise generator
 			 * polynomial is x^18 + x^11 + x (i.e. 0x20400) and is a plain XOR, initial state is probably all 1s
 			 * see http://www.vogons.org/viewtopic.php?f=9&t=51695 */
-			m_noise[ch].counter -= m_noise[ch].freq;
+			m_noise[ch].counter -= m_noise[ch].freq * run;
 			while (m_noise[ch].counter < 0)
 			{
 				m_noise[ch].counter += m_sample_rate;
@@ -308,10 +322,46 @@ void saa1099_device::sound_stream_update(sound_stream &stream, stream_sample_t *
 					m_noise[ch].level <<= 1;
 			}
 		}
-		/* write sound data to the buffer */
-		outputs[LEFT][j] = output_l / 6;
-		outputs[RIGHT][j] = output_r / 6;
+
+		/* the last sample of the run reflects the post-flip state */
+		mix_channels(output_l, output_r);
+		outputs[LEFT][j + run - 1] = output_l;
+		outputs[RIGHT][j + run - 1] = output_r;
+		j += run;
+	}
+}
+
+/* mix the six channels for the current generator state */
+void saa1099_device::mix_channels(int &output_l, int &output_r)
+{
+	output_l = 0;
+	output_r = 0;
+	for (int ch = 0; ch < 6; ch++)
+	{
+		// if the noise is enabled
+		if (m_channels[ch].noise_enable)
+		{
+			// if the noise level is high (noise 0: chan 0-2, noise 1: chan 3-5)
+			if (m_noise[ch/3].level & 1)
+			{
+				// subtract to avoid overflows, also use only half amplitude
+				output_l -= m_channels[ch].amplitude[ LEFT] * m_channels[ch].envelope[ LEFT] / 16 / 2;
+				output_r -= m_channels[ch].amplitude[RIGHT] * m_channels[ch].envelope[RIGHT] / 16 / 2;
+			}
+		}
+		// if the square wave is enabled
+		if (m_channels[ch].freq_enable)
+		{
+			// if the channel level is high
+			if (m_channels[ch].level & 1)
+			{
+				output_l += m_channels[ch].amplitude[ LEFT] * m_channels[ch].envelope[ LEFT] / 16;
+				output_r += m_channels[ch].amplitude[RIGHT] * m_channels[ch].envelope[RIGHT] / 16;
+			}
+		}
 	}
+	output_l /= 6;
+	output_r /= 6;
 }
 
 
@@ -97,6 +97,7 @@ private:
 	};
 
 	void envelope_w(int ch);
+	void mix_channels(int &output_l, int &output_r);
 
 	sound_stream *m_stream;          /* our stream */
 	int m_noise_params[2];            /* noise generators parameters */
@@ -387,6 +387,33 @@ void sn76496_base_device::countdown_cycles()
 	}
 }
 
+// mix the four channels for the current output state
+void sn76496_base_device::mix_output(int16_t &out, int16_t &out2)
+{
+	if (m_stereo)
+	{
+		out = ((((m_stereo_mask & 0x10)!=0) && (m_output[0]!=0))? m_volume[0] : 0)
+			+ ((((m_stereo_mask & 0x20)!=0) && (m_output[1]!=0))? m_volume[1] : 0)
+			+ ((((m_stereo_mask & 0x40)!=0) && (m_output[2]!=0))? m_volume[2] : 0)
+			+ ((((m_stereo_mask & 0x80)!=0) && (m_output[3]!=0))? m_volume[3] : 0);
+
+		out2= ((((m_stereo_mask & 0x1)!=0) && (m_output[0]!=0))? m_volume[0] : 0)
+			+ ((((m_stereo_mask & 0x2)!=0) && (m_output[1]!=0))? m_volume[1] : 0)
+			+ ((((m_stereo_mask & 0x4)!=0) && (m_output[2]!=0))? m_volume[2] : 0)
+			+ ((((m_stereo_mask & 0x8)!=0) && (m_output[3]!=0))? m_volume[3] : 0);
+	}
+	else
+	{
+		out = ((m_output[0]!=0)? m_volume[0]:0)
+			+((m_output[1]!=0)? m_volume[1]:0)
+			+((m_output[2]!=0)? m_volume[2]:0)
+			+((m_output[3]!=0)? m_volume[3]:0);
+		out2 = 0;
+	}
+
+	if (m_negate) { out = -out; out2 = -out2; }
+}
+
 void sn76496_base_device::sound_stream_update(sound_stream &stream, stream_sample_t **inputs, stream_sample_t **outputs, int samples)
 {
 	int i;
@@ -396,50 +423,108 @@ void sn76496_base_device::sound_stream_update(sound_stream &stream, stream_sampl
 	int16_t out;
 	int16_t out2 = 0;
 
+	// Rather than clocking the chip one input cycle at a time, find how many
+	// divided clocks go by before any channel flips, emit the (constant) mix
+	// for every output sample that falls in that span, then process the flip
+	// clock with the original per-cycle logic.
 	while (samples > 0)
 	{
-		// clock chip once
-		if (m_current_clock > 0) // not ready for new divided clock
+		// divided clocks until the earliest counter expires
+		int32_t clocks = m_count[0];
+		for (i = 1; i < 4; i++)
+			if (m_count[i] < clocks) clocks = m_count[i];
+		if (clocks < 1) clocks = 1;
+
+		// input cycles before the expiring clock comes due
+		int32_t idle = m_current_clock + (clocks-1)*m_clock_divider;
+		int32_t used = 0;
+
+		mix_output(out, out2);
+		while (idle > 0)
 		{
-			m_current_clock--;
+			// cycles until the next output sample is due
+			int32_t to_sample = (RATE_MAX - rate_counter + rate_add - 1)/rate_add;
+			if (to_sample > idle)
+			{
+				rate_counter += rate_add*idle;
+				used += idle;
+				break;
+			}
+			rate_counter += rate_add*to_sample - RATE_MAX;
+			*(lbuffer++) = out;
+			if (m_stereo) *(rbuffer++) = out2;
+			used += to_sample;
+			idle -= to_sample;
+			if (--samples == 0) break;
 		}
-		else // ready for new divided clock, make a new sample
+
+		// account for the cycles consumed; the divided clocks among them
+		// only lower the counters, no channel flips yet
+		int32_t clocked;
+		if (used <= m_current_clock)
 		{
-			m_current_clock = m_clock_divider-1;
-			// decrement Cycles to READY by one
-			countdown_cycles();
+			m_current_clock -= used;
+			clocked = 0;
+		}
+		else
+		{
+			clocked = 1 + (used - m_current_clock - 1)/m_clock_divider;
+			m_current_clock = m_clock_divider - 1 - ((used - m_current_clock - 1) % m_clock_divider);
+		}
+		if (clocked > 0)
+		{
+			for (i = 0; i < 4; i++) m_count[i] -= clocked;
+			// decrement Cycles to READY in bulk
+			if (m_cycles_to_ready >= clocked)
+			{
+				m_cycles_to_ready -= clocked;
+				m_ready_state = false;
+			}
+			else
+			{
+				m_cycles_to_ready = 0;
+				m_ready_state = true;
+			}
+		}
+
+		// the span ended early because the buffer is full
+		if (samples == 0) break;
 
-			// handle channels 0,1,2
-			for (i = 0; i < 3; i++)
+		// the expiring divided clock, handled exactly like before
+		m_current_clock = m_clock_divider-1;
+		// decrement Cycles to READY by one
+		countdown_cycles();
+
+		// handle channels 0,1,2
+		for (i = 0; i < 3; i++)
+		{
+			m_count[i]--;
+			if (m_count[i] <= 0)
 			{
-				m_count[i]--;
-				if (m_count[i] <= 0)
-				{
-					m_output[i] ^= 1;
-					m_count[i] = m_period[i];
-				}
+				m_output[i] ^= 1;
+				m_count[i] = m_period[i];
 			}
+		}
 
-			// handle channel 3
-			m_count[3]--;
-			if (m_count[3] <= 0)
+		// handle channel 3
+		m_count[3]--;
+		if (m_count[3] <= 0)
+		{
+			// if noisemode is 1, both taps are enabled
+			// if noisemode is 0, the lower tap, whitenoisetap2, is held at 0
+			// The != was a bit-XOR (^) before
+			if (((m_RNG & m_whitenoise_tap1)!=0) != (((m_RNG & m_whitenoise_tap2)!=(m_ncr_style_psg?m_whitenoise_tap2:0)) && in_noise_mode()))
 			{
-				// if noisemode is 1, both taps are enabled
-				// if noisemode is 0, the lower tap, whitenoisetap2, is held at 0
-				// The != was a bit-XOR (^) before
-				if (((m_RNG & m_whitenoise_tap1)!=0) != (((m_RNG & m_whitenoise_tap2)!=(m_ncr_style_psg?m_whitenoise_tap2:0)) && in_noise_mode()))
-				{
-					m_RNG >>= 1;
-					m_RNG |= m_feedback_mask;
-				}
-				else
-				{
-					m_RNG >>= 1;
-				}
-				m_output[3] = m_RNG & 1;
-
-				m_count[3] = m_period[3];
+				m_RNG >>= 1;
+				m_RNG |= m_feedback_mask;
 			}
+			else
+			{
+				m_RNG >>= 1;
+			}
+			m_output[3] = m_RNG & 1;
+
+			m_count[3] = m_period[3];
 		}
 
 		//Skip final generation if you don't need an actual sample
@@ -448,27 +533,8 @@ void sn76496_base_device::sound_stream_update(sound_stream &stream, stream_sampl
 			continue;
 		rate_counter -= RATE_MAX;
 
-		if (m_stereo)
-		{
-			out = ((((m_stereo_mask & 0x10)!=0) && (m_output[0]!=0))? m_volume[0] : 0)
-				+ ((((m_stereo_mask & 0x20)!=0) && (m_output[1]!=0))? m_volume[1] : 0)
-				+ ((((m_stereo_mask & 0x40)!=0) && (m_output[2]!=0))? m_volume[2] : 0)
-				+ ((((m_stereo_mask & 0x80)!=0) && (m_output[3]!=0))? m_volume[3] : 0);
-
-			out2= ((((m_stereo_mask & 0x1)!=0) && (m_output[0]!=0))? m_volume[0] : 0)
-				+ ((((m_stereo_mask & 0x2)!=0) && (m_output[1]!=0))? m_volume[1] : 0)
-				+ ((((m_stereo_mask & 0x4)!=0) && (m_output[2]!=0))? m_volume[2] : 0)
-				+ ((((m_stereo_mask & 0x8)!=0) && (m_output[3]!=0))? m_volume[3] : 0);
-		}
-		else
-		{
-			out= ((m_output[0]!=0)? m_volume[0]:0)
-				+((m_output[1]!=0)? m_volume[1]:0)
-				+((m_output[2]!=0)? m_volume[2]:0)
-				+((m_output[3]!=0)? m_volume[3]:0);
-		}
-
-		if (m_negate) { out = -out; out2 = -out2; }
+		// this sample reflects the state after the flip
+		mix_output(out, out2);
 		*(lbuffer++) = out;
 		if (m_stereo) *(rbuffer++) = out2;
 		samples--;
@@ -63,6 +63,7 @@ private:
 	inline bool     in_noise_mode();
 	void            register_for_save_states();
 	void            countdown_cycles();
+	void            mix_output(int16_t &out, int16_t &out2);
 
 
 
@@ -23,9 +23,19 @@
 #include "setup.h"
 #include "paging.h"
 #include "regs.h"
+#include "memarena.h"
 
 #include <string.h>
 
+#if defined (WIN32)
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#ifndef MAP_ANONYMOUS
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+#endif
+
 #define PAGES_IN_BLOCK	((1024*1024)/MEM_PAGE_SIZE)
 #define SAFE_MEMORY	32
 #define MAX_MEMORY	64
@@ -173,22 +183,103 @@ void mem_strcpy(PhysPt dest,PhysPt src) {
 	mem_writeb_inline(dest,0);
 }
 
+/* The bulk helpers below walk the range a page at a time: pages with a
+ * direct tlb pointer (ordinary RAM) are copied with one memcpy and only
+ * handler-backed pages (MMIO, ROM, paged-out) drop to the byte loop. */
 void mem_memcpy(PhysPt dest,PhysPt src,Bitu size) {
-	while (size--) mem_writeb_inline(dest++,mem_readb_inline(src++));
+	while (size) {
+		Bitu chunk=0x1000-(dest&0xfff);
+		Bitu src_left=0x1000-(src&0xfff);
+		if (chunk>src_left) chunk=src_left;
+		if (chunk>size) chunk=size;
+		HostPt src_addr=get_tlb_read(src);
+		HostPt dest_addr=get_tlb_write(dest);
+		if (src_addr && dest_addr) {
+			//Merge following pages that share the same tlb bases, so the
+			//whole RAM span moves in one (vectorized) library copy
+			while (chunk<size) {
+				if (get_tlb_read(src+chunk)!=src_addr) break;
+				if (get_tlb_write(dest+chunk)!=dest_addr) break;
+				Bitu add=0x1000-((src+chunk)&0xfff);
+				Bitu dest_add=0x1000-((dest+chunk)&0xfff);
+				if (dest_add<add) add=dest_add;
+				if (chunk+add>size) add=size-chunk;
+				chunk+=add;
+			}
+			memmove(dest_addr+dest,src_addr+src,chunk);
+			dest+=chunk;src+=chunk;
+		} else {
+			for (Bitu i=0;i<chunk;i++) mem_writeb_inline(dest++,mem_readb_inline(src++));
+		}
+		size-=chunk;
+	}
 }
 
 void MEM_BlockRead(PhysPt pt,void * data,Bitu size) {
 	Bit8u * write=reinterpret_cast<Bit8u *>(data);
-	while (size--) {
-		*write++=mem_readb_inline(pt++);
+	while (size) {
+		Bitu chunk=0x1000-(pt&0xfff);
+		if (chunk>size) chunk=size;
+		HostPt tlb_addr=get_tlb_read(pt);
+		if (tlb_addr) {
+			while (chunk<size && get_tlb_read(pt+chunk)==tlb_addr) {
+				Bitu add=0x1000;
+				if (chunk+add>size) add=size-chunk;
+				chunk+=add;
+			}
+			memcpy(write,tlb_addr+pt,chunk);
+			write+=chunk;pt+=chunk;
+		} else {
+			for (Bitu i=0;i<chunk;i++) *write++=mem_readb_inline(pt++);
+		}
+		size-=chunk;
 	}
 }
 
 void MEM_BlockWrite(PhysPt pt,void const * const data,Bitu size) {
 	Bit8u const * read = reinterpret_cast<Bit8u const * const>(data);
-	while (size--) {
-		mem_writeb_inline(pt++,*read++);
+	while (size) {
+		Bitu chunk=0x1000-(pt&0xfff);
+		if (chunk>size) chunk=size;
+		HostPt tlb_addr=get_tlb_write(pt);
+		if (tlb_addr) {
+			while (chunk<size && get_tlb_write(pt+chunk)==tlb_addr) {
+				Bitu add=0x1000;
+				if (chunk+add>size) add=size-chunk;
+				chunk+=add;
+			}
+			memcpy(tlb_addr+pt,read,chunk);
+			read+=chunk;pt+=chunk;
+		} else {
+			for (Bitu i=0;i<chunk;i++) mem_writeb_inline(pt++,*read++);
+		}
+		size-=chunk;
+	}
+}
+
+/* Resolve a guest range to a direct host pointer so bulk transfers can skip
+ * the byte-wise copy above. Every page of the range must be plain RAM (a
+ * non-null tlb pointer) and share the same tlb base, which makes the range
+ * contiguous in host memory; otherwise null is returned and the caller has
+ * to fall back to MEM_BlockRead/MEM_BlockWrite. */
+HostPt MEM_GetHostReadPt(PhysPt pt,Bitu size) {
+	if (!size) return 0;
+	HostPt base=get_tlb_read(pt);
+	if (!base) return 0;
+	for (PhysPt page=(pt&~0xfffu)+0x1000;page<pt+size;page+=0x1000) {
+		if (get_tlb_read(page)!=base) return 0;
 	}
+	return base+pt;
+}
+
+HostPt MEM_GetHostWritePt(PhysPt pt,Bitu size) {
+	if (!size) return 0;
+	HostPt base=get_tlb_write(pt);
+	if (!base) return 0;
+	for (PhysPt page=(pt&~0xfffu)+0x1000;page<pt+size;page+=0x1000) {
+		if (get_tlb_write(page)!=base) return 0;
+	}
+	return base+pt;
 }
 
 void MEM_BlockCopy(PhysPt dest,PhysPt src,Bitu size) {
@@ -541,6 +632,58 @@ void PreparePCJRCartRom(void) {
 
 HostPt GetMemBase(void) { return MemBase; }
 
+/* Guest RAM backing: with bigpages=true the base is allocated through the
+ * host VM system and flagged for huge pages where available, which cuts host
+ * TLB misses for large guests. Every path falls back to a plain allocation,
+ * so MEM_FreeBase has to remember how the block was obtained. */
+static bool membase_mapped = false;
+
+static HostPt MEM_AllocateBase(Bitu bytes,bool bigpages) {
+	membase_mapped = false;
+	if (bigpages) {
+#if defined (WIN32)
+		/* Large pages need the SeLockMemoryPrivilege and a size that is
+		 * a multiple of the large-page granularity; just try and see. */
+		SIZE_T large = GetLargePageMinimum();
+		if (large) {
+			SIZE_T rounded = (bytes + large - 1) & ~(large - 1);
+			void* p = VirtualAlloc(NULL,rounded,MEM_RESERVE|MEM_COMMIT|MEM_LARGE_PAGES,PAGE_READWRITE);
+			if (p) {
+				membase_mapped = true;
+				return static_cast<HostPt>(p);
+			}
+		}
+#else
+		void* p = mmap(NULL,bytes,PROT_READ|PROT_WRITE,MAP_PRIVATE|MAP_ANONYMOUS,-1,0);
+		if (p != MAP_FAILED) {
+			membase_mapped = true;
+#ifdef MADV_HUGEPAGE
+			/* best effort; transparent huge pages pick the range up */
+			madvise(p,bytes,MADV_HUGEPAGE);
+#endif
+			return static_cast<HostPt>(p);
+		}
+#endif
+		LOG_MSG("MEM: Couldn't get huge-page backed memory, using a normal allocation");
+	}
+	return new (std::nothrow) Bit8u[bytes];
+}
+
+static void MEM_FreeBase(HostPt base,Bitu bytes) {
+	if (!base) return;
+	if (membase_mapped) {
+#if defined (WIN32)
+		(void)bytes; // VirtualFree releases the whole reservation
+		VirtualFree(base,0,MEM_RELEASE);
+#else
+		munmap(base,bytes);
+#endif
+		membase_mapped = false;
+		return;
+	}
+	delete [] base;
+}
+
 class MEMORY:public Module_base{
 private:
 	IO_ReadHandleObject ReadHandler;
@@ -563,12 +706,19 @@ public:
 			LOG_MSG("Memory sizes above %d MB are NOT recommended.",SAFE_MEMORY - 1);
 			LOG_MSG("Stick with the default values unless you are absolutely certain.");
 		}
-		MemBase = new (std::nothrow) Bit8u[memsize * 1024 * 1024];
+		MemBase = MEM_AllocateBase(memsize * 1024 * 1024,
+		                           section->Get_bool("bigpages"));
 		if (!MemBase) {
 			E_Exit("Can't allocate main memory of %u MB", memsize);
 		}
-		memset((void*)MemBase, 0, memsize * 1024 * 1024);
+		/* mapped bases come back zero-filled and stay unresident until
+		   the guest actually touches a page; only the heap fallback
+		   needs the clear */
+		if (!membase_mapped)
+			memset((void*)MemBase, 0, memsize * 1024 * 1024);
 		memory.pages = (memsize * 1024 * 1024) / 4096;
+		ARENA_Account("guest ram",(Bits)memsize * 1024 * 1024);
+		ARENA_Account("page tables",(Bits)(memory.pages*(sizeof(PageHandler*)+sizeof(MemHandle))));
 
 		/* Allocate the data for the different page information blocks */
 		memory.phandlers = new (std::nothrow) PageHandler * [memory.pages];
@@ -609,9 +759,12 @@ public:
 		MEM_A20_Enable(false);
 	}
 	~MEMORY(){
-		delete [] MemBase;
+		MEM_FreeBase(MemBase,memory.pages*4096);
+		MemBase = NULL;
 		delete [] memory.phandlers;
 		delete [] memory.mhandles;
+		ARENA_Account("guest ram",-(Bits)(memory.pages*4096));
+		ARENA_Account("page tables",-(Bits)(memory.pages*(sizeof(PageHandler*)+sizeof(MemHandle))));
 	}
 };	
 
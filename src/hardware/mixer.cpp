@@ -29,6 +29,15 @@
 #include <math.h>
 #include <algorithm>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+#if defined(__SSE4_1__)
+#include <smmintrin.h>
+#endif
+
 #if defined (WIN32)
 //Midi listing
 #ifndef WIN32_LEAN_AND_MEAN
@@ -50,6 +59,8 @@
 #include "support.h"
 #include "mapper.h"
 #include "hardware.h"
+#include "profiler.h"
+#include "tracer.h"
 #include "programs.h"
 #include "midi.h"
 
@@ -64,6 +75,44 @@
 #define FREQ_NEXT ( 1 << FREQ_SHIFT)
 #define FREQ_MASK ( FREQ_NEXT -1 )
 
+/* Windowed-sinc resampler: a polyphase bank of Blackman-windowed sinc
+   filters, one per fractional position. Each phase is normalized to
+   unity DC gain in 4.12 fixed point, so the 8-tap dot product stays
+   well inside 32 bits and vectorizes cleanly. Costs a constant group
+   delay of (taps/2 - 1) input samples over linear interpolation. */
+#define SINC_PHASE_BITS 6
+#define SINC_PHASES ( 1 << SINC_PHASE_BITS)
+#define SINC_COEF_SHIFT 12
+
+static Bit16s sinc_table[SINC_PHASES][MIXER_SINC_TAPS];
+
+static void MIXER_BuildSincTable(void) {
+	static bool built = false;
+	if (built) return;
+	built = true;
+	//Cut off slightly below Nyquist; device rates sit near the mixer
+	//rate, so this keeps the transition band out of the passband for
+	//mild downsampling (49716 -> 48000) as well
+	const double cutoff = 0.9;
+	for (Bitu p = 0; p < SINC_PHASES; p++) {
+		const double frac = (double)p / SINC_PHASES;
+		double coef[MIXER_SINC_TAPS];
+		double sum = 0.0;
+		for (Bitu t = 0; t < MIXER_SINC_TAPS; t++) {
+			const double x = (double)t - (MIXER_SINC_TAPS / 2 - 1) - frac;
+			double s;
+			if (x == 0.0) s = cutoff;
+			else s = sin(M_PI * cutoff * x) / (M_PI * x);
+			const double u = x / (MIXER_SINC_TAPS / 2);
+			const double w = 0.42 + 0.5 * cos(M_PI * u) + 0.08 * cos(2.0 * M_PI * u);
+			coef[t] = s * w;
+			sum += coef[t];
+		}
+		for (Bitu t = 0; t < MIXER_SINC_TAPS; t++)
+			sinc_table[p][t] = (Bit16s)floor(coef[t] / sum * (1 << SINC_COEF_SHIFT) + 0.5);
+	}
+}
+
 #define TICK_SHIFT 14
 #define TICK_NEXT ( 1 << TICK_SHIFT)
 #define TICK_MASK (TICK_NEXT -1)
@@ -88,6 +137,11 @@ static struct {
 	float mastervol[2];
 	MixerChannel * channels;
 	bool nosound;
+	bool lowlatency;
+	bool turbo;		//Fast forward: mix silently, device paused
+	//Device failover state, see MIXER_DeviceCheck
+	bool device_lost;
+	Bitu device_retry;
 	Bit32u freq;
 	Bit32u blocksize;
 	//Note: As stated earlier, all sdl code shall rather be in sdlmain
@@ -106,6 +160,7 @@ MixerChannel::MixerChannel(MIXER_Handler _handler, Bitu _freq, const char * _nam
 
 		// Private member initialization
 		handler      (_handler),
+		src_freq     (0),
 		freq_add     (0),
 		freq_counter (0),
 		needed       (0),
@@ -114,7 +169,12 @@ MixerChannel::MixerChannel(MIXER_Handler _handler, Bitu _freq, const char * _nam
 		volmul       {0, 0},
 		scale        {0, 0},
 		channel_map  {0, 0},
-		interpolate  (false) {
+		interpolate  (false),
+		sinc         (false),
+		sinc_pos     (0),
+		tap          (nullptr),
+		tap_used     (0) {
+	memset(sinc_hist, 0, sizeof(sinc_hist));
 }
 
 MixerChannel * MIXER_AddChannel(MIXER_Handler handler, Bitu freq, const char * name) {
@@ -144,6 +204,7 @@ void MIXER_DelChannel(MixerChannel* delchan) {
 	while (chan) {
 		if (chan==delchan) {
 			*where=chan->next;
+			delchan->SetTap(false);	//finish an open tap file
 			delete delchan;
 			return;
 		}
@@ -153,10 +214,12 @@ void MIXER_DelChannel(MixerChannel* delchan) {
 }
 
 static void MIXER_LockAudioDevice(void) {
+	if (!mixer.sdldevice) return;
 	SDL_LockAudioDevice(mixer.sdldevice);
 }
 
 static void MIXER_UnlockAudioDevice(void) {
+	if (!mixer.sdldevice) return;
 	SDL_UnlockAudioDevice(mixer.sdldevice);
 }
 
@@ -223,7 +286,12 @@ void MixerChannel::Enable(bool _yesno) {
 }
 
 void MixerChannel::SetFreq(Bitu freq) {
+	//A rate switch invalidates the wav header of an open tap, start a new file
+	const bool retap = (tap!=NULL) && (freq!=src_freq);
+	if (retap) SetTap(false);
+	src_freq=freq;
 	freq_add=(freq<<FREQ_SHIFT)/mixer.freq;
+	if (retap) SetTap(true);
 
 	if (freq != mixer.freq) {
 		interpolate = true;
@@ -233,6 +301,49 @@ void MixerChannel::SetFreq(Bitu freq) {
 	}
 }
 
+void MixerChannel::UpdateFreq(void) {
+	SetFreq(src_freq);
+}
+
+void MixerChannel::SetResampleQuality(bool use_sinc) {
+	sinc = use_sinc;
+	if (sinc) {
+		MIXER_BuildSincTable();
+		memset(sinc_hist, 0, sizeof(sinc_hist));
+		sinc_pos = 0;
+	}
+}
+
+/* Wave tap: clone this channel's samples into an own wav sink at the rate
+   the device generates them, taken straight off the incoming data before
+   resampling and volume.  Costs one compare per frame when off. */
+void MixerChannel::SetTap(bool enable) {
+	if (enable) {
+		if (tap) return;
+		tap=CAPTURE_OpenWaveTap(name,(Bit32u)src_freq);
+		tap_used=0;
+	} else {
+		if (!tap) return;
+		if (tap_used) CAPTURE_AddWaveTap(tap,tap_used,tap_buf);
+		tap_used=0;
+		CAPTURE_CloseWaveTap(tap);
+		tap=NULL;
+	}
+}
+
+bool MixerChannel::Tapped(void) const {
+	return tap!=NULL;
+}
+
+INLINE void MixerChannel::TapFrame(Bits left,Bits right) {
+	tap_buf[tap_used*2+0]=MIXER_CLIP(left);
+	tap_buf[tap_used*2+1]=MIXER_CLIP(right);
+	if (++tap_used>=MIXER_TAP_BUF) {
+		CAPTURE_AddWaveTap(tap,tap_used,tap_buf);
+		tap_used=0;
+	}
+}
+
 void MixerChannel::Mix(Bitu _needed) {
 	needed=_needed;
 	while (enabled && needed>done) {
@@ -245,6 +356,11 @@ void MixerChannel::Mix(Bitu _needed) {
 
 void MixerChannel::AddSilence(void) {
 	if (done<needed) {
+		if (GCC_UNLIKELY(tap!=NULL)) {
+			//Keep the tap's timeline intact over the silent stretch
+			Bitu frames=((needed-done)*freq_add) >> FREQ_SHIFT;
+			while (frames--) TapFrame(0,0);
+		}
 		done=needed;
 		//Make sure the next samples are zero when they get switched to prev
 		next_sample[0] = 0;
@@ -254,12 +370,213 @@ void MixerChannel::AddSilence(void) {
 	}
 }
 
+//Read a single frame at pos into next_sample
+template<class Type,bool stereo,bool signeddata,bool nativeorder>
+inline void MixerChannel::LoadSample(const Type* data, Bitu pos) {
+	if ( sizeof( Type) == 1) {
+		if (!signeddata) {
+			if (stereo) {
+				next_sample[0]=(((Bit8s)(data[pos*2+0] ^ 0x80)) << 8);
+				next_sample[1]=(((Bit8s)(data[pos*2+1] ^ 0x80)) << 8);
+			} else {
+				next_sample[0]=(((Bit8s)(data[pos] ^ 0x80)) << 8);
+			}
+		} else {
+			if (stereo) {
+				next_sample[0]=(data[pos*2+0] << 8);
+				next_sample[1]=(data[pos*2+1] << 8);
+			} else {
+				next_sample[0]=(data[pos] << 8);
+			}
+		}
+	//16bit and 32bit both contain 16bit data internally
+	} else  {
+		if (signeddata) {
+			if (stereo) {
+				if (nativeorder) {
+					next_sample[0]=data[pos*2+0];
+					next_sample[1]=data[pos*2+1];
+				} else {
+					if ( sizeof( Type) == 2) {
+						next_sample[0]=(Bit16s)host_readw((HostPt)&data[pos*2+0]);
+						next_sample[1]=(Bit16s)host_readw((HostPt)&data[pos*2+1]);
+					} else {
+						next_sample[0]=(Bit32s)host_readd((HostPt)&data[pos*2+0]);
+						next_sample[1]=(Bit32s)host_readd((HostPt)&data[pos*2+1]);
+					}
+				}
+			} else {
+				if (nativeorder) {
+					next_sample[0] = data[pos];
+				} else {
+					if ( sizeof( Type) == 2) {
+						next_sample[0]=(Bit16s)host_readw((HostPt)&data[pos]);
+					} else {
+						next_sample[0]=(Bit32s)host_readd((HostPt)&data[pos]);
+					}
+				}
+			}
+		} else {
+			if (stereo) {
+				if (nativeorder) {
+					next_sample[0]=(Bits)data[pos*2+0]-32768;
+					next_sample[1]=(Bits)data[pos*2+1]-32768;
+				} else {
+					if ( sizeof( Type) == 2) {
+						next_sample[0]=(Bits)host_readw((HostPt)&data[pos*2+0])-32768;
+						next_sample[1]=(Bits)host_readw((HostPt)&data[pos*2+1])-32768;
+					} else {
+						next_sample[0]=(Bits)host_readd((HostPt)&data[pos*2+0])-32768;
+						next_sample[1]=(Bits)host_readd((HostPt)&data[pos*2+1])-32768;
+					}
+				}
+			} else {
+				if (nativeorder) {
+					next_sample[0]=(Bits)data[pos]-32768;
+				} else {
+					if ( sizeof( Type) == 2) {
+						next_sample[0]=(Bits)host_readw((HostPt)&data[pos])-32768;
+					} else {
+						next_sample[0]=(Bits)host_readd((HostPt)&data[pos])-32768;
+					}
+				}
+			}
+		}
+	}
+	//Every incoming frame passes through here exactly once, so this is
+	//the single point where a tap sees the device's own sample stream
+	if (GCC_UNLIKELY(tap!=NULL)) TapFrame(next_sample[0],stereo ? next_sample[1] : next_sample[0]);
+}
+
+/* Expand the run of output frames fed by one native-rate input pair:
+   linear interpolation with a stepping fraction, volume applied and
+   accumulated into the interleaved work frames. The fraction stays below
+   FREQ_NEXT (1<<14) and the sample diff below 17 bits, so diff*frac fits
+   a 32 bit lane; the volume products wrap at 32 bits exactly like the
+   scalar accumulate does when it stores its Bits product into the
+   work buffer. Four frames per vector iteration. */
+static INLINE void MIXER_Upsample(Bit32s (*write)[2],Bitu frames,
+		Bits prev,Bits diff,Bit32u frac,Bit32u step,const Bit32s * volmul) {
+	Bitu n = 0;
+#if defined(__SSE4_1__)
+	__m128i vfrac = _mm_add_epi32(_mm_set1_epi32((int)frac),
+		_mm_mullo_epi32(_mm_set1_epi32((int)step),_mm_set_epi32(3,2,1,0)));
+	const __m128i vstep = _mm_set1_epi32((int)(step*4));
+	const __m128i vdiff = _mm_set1_epi32((int)diff);
+	const __m128i vprev = _mm_set1_epi32((int)prev);
+	const __m128i vvol0 = _mm_set1_epi32(volmul[0]);
+	const __m128i vvol1 = _mm_set1_epi32(volmul[1]);
+	for (; n + 4 <= frames; n += 4) {
+		__m128i s = _mm_add_epi32(vprev,
+			_mm_srai_epi32(_mm_mullo_epi32(vdiff,vfrac),FREQ_SHIFT));
+		__m128i l = _mm_mullo_epi32(s,vvol0);
+		__m128i r = _mm_mullo_epi32(s,vvol1);
+		__m128i lo = _mm_unpacklo_epi32(l,r);
+		__m128i hi = _mm_unpackhi_epi32(l,r);
+		_mm_storeu_si128((__m128i*)&write[n][0],
+			_mm_add_epi32(_mm_loadu_si128((const __m128i*)&write[n][0]),lo));
+		_mm_storeu_si128((__m128i*)&write[n+2][0],
+			_mm_add_epi32(_mm_loadu_si128((const __m128i*)&write[n+2][0]),hi));
+		vfrac = _mm_add_epi32(vfrac,vstep);
+	}
+	frac += (Bit32u)n*step;
+#elif defined(__ARM_NEON) || defined(__aarch64__)
+	const int32x4_t lane = {0,1,2,3};
+	int32x4_t vfrac = vaddq_s32(vdupq_n_s32((Bit32s)frac),
+		vmulq_s32(vdupq_n_s32((Bit32s)step),lane));
+	const int32x4_t vstep = vdupq_n_s32((Bit32s)(step*4));
+	const int32x4_t vdiff = vdupq_n_s32((Bit32s)diff);
+	const int32x4_t vprev = vdupq_n_s32((Bit32s)prev);
+	const int32x4_t vvol0 = vdupq_n_s32(volmul[0]);
+	const int32x4_t vvol1 = vdupq_n_s32(volmul[1]);
+	for (; n + 4 <= frames; n += 4) {
+		int32x4_t s = vaddq_s32(vprev,
+			vshrq_n_s32(vmulq_s32(vdiff,vfrac),FREQ_SHIFT));
+		int32x4x2_t zip = vzipq_s32(vmulq_s32(s,vvol0),vmulq_s32(s,vvol1));
+		vst1q_s32(&write[n][0],vaddq_s32(vld1q_s32(&write[n][0]),zip.val[0]));
+		vst1q_s32(&write[n+2][0],vaddq_s32(vld1q_s32(&write[n+2][0]),zip.val[1]));
+		vfrac = vaddq_s32(vfrac,vstep);
+	}
+	frac += (Bit32u)n*step;
+#endif
+	for (; n < frames; n++) {
+		Bits sample = prev + ((diff * (Bits)frac) >> FREQ_SHIFT);
+		write[n][0] += sample * volmul[0];
+		write[n][1] += sample * volmul[1];
+		frac += step;
+	}
+}
+
 template<class Type,bool stereo,bool signeddata,bool nativeorder>
 inline void MixerChannel::AddSamples(Bitu len, const Type* data) {
 	//Position where to write the data
 	Bitu mixpos = mixer.pos + done;
 	//Position in the incoming data
 	Bitu pos = 0;
+
+	//Apply the left and right channel mappers only on write[..]
+	//assignments.  This ensures the channels are mapped only once
+	//(avoiding double-swapping) and also minimizes the places where
+	//we use our mapping variables as array indexes.
+	//Note that volumes are independent of the channels mapping.
+	const Bit8u left_map(channel_map[0]);
+	const Bit8u right_map(channel_map[1]);
+
+	//Fast path for channels running at the mixer rate: one frame in is
+	//one frame out, so the freq counter bookkeeping drops out of the
+	//loop entirely (the counter sits at FREQ_NEXT in steady state; the
+	//first call after Enable still goes through the generic loop once)
+	if (!interpolate && freq_counter == FREQ_NEXT) {
+		while (pos < len) {
+			prev_sample[0] = next_sample[0];
+			if (stereo) {
+				prev_sample[1] = next_sample[1];
+			}
+			LoadSample<Type,stereo,signeddata,nativeorder>(data,pos);
+			pos++;
+			mixpos &= MIXER_BUFMASK;
+			Bit32s* write = mixer.work[mixpos];
+			write[0] += prev_sample[left_map] * volmul[0];
+			write[1] += (stereo ? prev_sample[right_map] : prev_sample[left_map]) * volmul[1];
+			mixpos++;
+			done++;
+		}
+		return;
+	}
+
+	//Batch upsampler for low-rate mono channels (disney at ~7khz and
+	//friends): every input frame feeds several output frames, so expand
+	//each whole run in one vector pass instead of taking one trip through
+	//the generic loop below per output frame
+	if (!stereo && interpolate && !sinc && left_map == 0 &&
+	    freq_add && freq_add <= FREQ_NEXT) {
+		while (1) {
+			while (freq_counter >= FREQ_NEXT) {
+				if (pos >= len)
+					return;
+				freq_counter -= FREQ_NEXT;
+				prev_sample[0] = next_sample[0];
+				LoadSample<Type,stereo,signeddata,nativeorder>(data,pos);
+				pos++;
+			}
+			const Bits prev = prev_sample[0];
+			const Bits diff = next_sample[0] - prev;
+			//Output frames this prev/next pair is good for
+			Bitu run = (FREQ_NEXT - freq_counter + freq_add - 1) / freq_add;
+			while (run) {
+				mixpos &= MIXER_BUFMASK;
+				Bitu span = MIXER_BUFSIZE - mixpos;
+				if (span > run) span = run;
+				MIXER_Upsample(&mixer.work[mixpos],span,prev,diff,
+					(Bit32u)freq_counter,(Bit32u)freq_add,volmul);
+				freq_counter += span * freq_add;
+				mixpos += span;
+				done += span;
+				run -= span;
+			}
+		}
+	}
+
 	//Mix and data for the full length
 	while (1) {
 		//Does new data need to get read?
@@ -273,89 +590,18 @@ inline void MixerChannel::AddSamples(Bitu len, const Type* data) {
 			if (stereo) {
 				prev_sample[1] = next_sample[1];
 			}
-
-			if ( sizeof( Type) == 1) {
-				if (!signeddata) {
-					if (stereo) {
-						next_sample[0]=(((Bit8s)(data[pos*2+0] ^ 0x80)) << 8);
-						next_sample[1]=(((Bit8s)(data[pos*2+1] ^ 0x80)) << 8);
-					} else {
-						next_sample[0]=(((Bit8s)(data[pos] ^ 0x80)) << 8);
-					}
-				} else {
-					if (stereo) {
-						next_sample[0]=(data[pos*2+0] << 8);
-						next_sample[1]=(data[pos*2+1] << 8);
-					} else {
-						next_sample[0]=(data[pos] << 8);
-					}
-				}
-			//16bit and 32bit both contain 16bit data internally
-			} else  {
-				if (signeddata) {
-					if (stereo) {
-						if (nativeorder) {
-							next_sample[0]=data[pos*2+0];
-							next_sample[1]=data[pos*2+1];
-						} else {
-							if ( sizeof( Type) == 2) {
-								next_sample[0]=(Bit16s)host_readw((HostPt)&data[pos*2+0]);
-								next_sample[1]=(Bit16s)host_readw((HostPt)&data[pos*2+1]);
-							} else {
-								next_sample[0]=(Bit32s)host_readd((HostPt)&data[pos*2+0]);
-								next_sample[1]=(Bit32s)host_readd((HostPt)&data[pos*2+1]);
-							}
-						}
-					} else {
-						if (nativeorder) {
-							next_sample[0] = data[pos];
-						} else {
-							if ( sizeof( Type) == 2) {
-								next_sample[0]=(Bit16s)host_readw((HostPt)&data[pos]);
-							} else {
-								next_sample[0]=(Bit32s)host_readd((HostPt)&data[pos]);
-							}
-						}
-					}
-				} else {
-					if (stereo) {
-						if (nativeorder) {
-							next_sample[0]=(Bits)data[pos*2+0]-32768;
-							next_sample[1]=(Bits)data[pos*2+1]-32768;
-						} else {
-							if ( sizeof( Type) == 2) {
-								next_sample[0]=(Bits)host_readw((HostPt)&data[pos*2+0])-32768;
-								next_sample[1]=(Bits)host_readw((HostPt)&data[pos*2+1])-32768;
-							} else {
-								next_sample[0]=(Bits)host_readd((HostPt)&data[pos*2+0])-32768;
-								next_sample[1]=(Bits)host_readd((HostPt)&data[pos*2+1])-32768;
-							}
-						}
-					} else {
-						if (nativeorder) {
-							next_sample[0]=(Bits)data[pos]-32768;
-						} else {
-							if ( sizeof( Type) == 2) {
-								next_sample[0]=(Bits)host_readw((HostPt)&data[pos])-32768;
-							} else {
-								next_sample[0]=(Bits)host_readd((HostPt)&data[pos])-32768;
-							}
-						}
-					}
-				}
+			LoadSample<Type,stereo,signeddata,nativeorder>(data,pos);
+			//Keep the filter history fed; both copies so the
+			//convolution below can read the taps linearly
+			if (sinc) {
+				sinc_pos = (sinc_pos + 1) & (MIXER_SINC_TAPS - 1);
+				sinc_hist[0][sinc_pos] = sinc_hist[0][sinc_pos + MIXER_SINC_TAPS] = (Bit32s)next_sample[0];
+				sinc_hist[1][sinc_pos] = sinc_hist[1][sinc_pos + MIXER_SINC_TAPS] = (Bit32s)(stereo ? next_sample[1] : next_sample[0]);
 			}
 			//This sample has been handled now, increase position
 			pos++;
 		}
 
-		//Apply the left and right channel mappers only on write[..]
-		//assignments.  This ensures the channels are mapped only once
-		//(avoiding double-swapping) and also minimizes the places where
-		//we use our mapping variables as array indexes.
-		//Note that volumes are independent of the channels mapping.
-		const Bit8u left_map(channel_map[0]);
-		const Bit8u right_map(channel_map[1]);
-
 		//Where to write
 		mixpos &= MIXER_BUFMASK;
 		Bit32s* write = mixer.work[mixpos];
@@ -363,6 +609,21 @@ inline void MixerChannel::AddSamples(Bitu len, const Type* data) {
 			write[0] += prev_sample[left_map] * volmul[0];
 			write[1] += (stereo ? prev_sample[right_map] : prev_sample[left_map]) * volmul[1];
 		}
+		else if (sinc) {
+			const Bit16s * coef = sinc_table[(freq_counter & FREQ_MASK) >> (FREQ_SHIFT - SINC_PHASE_BITS)];
+			const Bit32s * hist = &sinc_hist[left_map][(Bitu)sinc_pos + 1];
+			Bit32s sample = 0;
+			for (Bitu t = 0; t < MIXER_SINC_TAPS; t++)
+				sample += coef[t] * hist[t];
+			write[0] += (sample >> SINC_COEF_SHIFT) * volmul[0];
+			if (stereo) {
+				hist = &sinc_hist[right_map][(Bitu)sinc_pos + 1];
+				sample = 0;
+				for (Bitu t = 0; t < MIXER_SINC_TAPS; t++)
+					sample += coef[t] * hist[t];
+			}
+			write[1] += (sample >> SINC_COEF_SHIFT) * volmul[1];
+		}
 		else {
 			Bits diff_mul = freq_counter & FREQ_MASK;
 			Bits sample = prev_sample[left_map] + (((next_sample[left_map] - prev_sample[left_map]) * diff_mul) >> FREQ_SHIFT);
@@ -384,6 +645,10 @@ void MixerChannel::AddStretched(Bitu len,Bit16s * data) {
 		LOG_MSG("Can't add, buffer full");
 		return;
 	}
+	if (GCC_UNLIKELY(tap!=NULL)) {
+		//The stretched path has no fixed device rate; tap the input as is
+		for (Bitu i=0;i<len;i++) TapFrame(data[i],data[i]);
+	}
 	//Target samples this inputs gets stretched into
 	Bitu outlen = needed - done;
 	Bitu index = 0;
@@ -461,8 +726,12 @@ void MixerChannel::AddSamples_s32_nonnative(Bitu len,const Bit32s * data) {
 }
 
 void MixerChannel::FillUp(void) {
+	/* don't fight the callback over the lock for channels that have
+	   nothing to add; this runs on every port write of some devices */
+	if (!enabled)
+		return;
 	MIXER_LockAudioDevice();
-	if (!enabled || done<mixer.done) {
+	if (done<mixer.done) {
 		MIXER_UnlockAudioDevice();
 		return;
 	}
@@ -489,45 +758,93 @@ static Bit32u calc_tickadd(Bit32u freq) {
 #endif
 }
 
-/* Mix a certain amount of new samples */
+/* Mix a certain amount of new samples, caller holds the device lock */
 static void MIXER_MixData(Bitu needed) {
+	PROF_START(mix_start);
 	MixerChannel * chan=mixer.channels;
 	while (chan) {
 		chan->Mix(needed);
 		chan=chan->next;
 	}
-	if (CaptureState & (CAPTURE_WAVE|CAPTURE_VIDEO)) {
-		int16_t convert[1024][2];
-		const size_t added = std::min<size_t>(needed - mixer.done, 1024);
-		size_t readpos = (mixer.pos + mixer.done) & MIXER_BUFMASK;
-		for (size_t i = 0; i < added; i++) {
-			const int32_t sample_1 = mixer.work[readpos][0] >> MIXER_VOLSHIFT;
-			const int32_t sample_2 = mixer.work[readpos][1] >> MIXER_VOLSHIFT;
-			const int16_t s1 = MIXER_CLIP(sample_1);
-			const int16_t s2 = MIXER_CLIP(sample_2);
-			convert[i][0] = host_to_le16(s1);
-			convert[i][1] = host_to_le16(s2);
-			readpos = (readpos + 1) & MIXER_BUFMASK;
-		}
-		CAPTURE_AddWave(mixer.freq, added, reinterpret_cast<int16_t*>(convert));
-	}
 	//Reset the the tick_add for constant speed
 	if( Mixer_irq_important() )
 		mixer.tick_add = calc_tickadd(mixer.freq);
-	mixer.done = needed;
+	PROF_STOP(PROF_MIXER,mix_start);
 }
 
-static void MIXER_Mix(void) {
+/* Convert the samples between done and needed for the capture. The
+   callback neither consumes nor clears beyond done, and pos+done stays
+   invariant under its updates, so this can run without the lock */
+static void MIXER_CaptureData(Bitu done, Bitu needed, Bitu pos) {
+	int16_t convert[1024][2];
+	const size_t added = std::min<size_t>(needed - done, 1024);
+	size_t readpos = (pos + done) & MIXER_BUFMASK;
+	for (size_t i = 0; i < added; i++) {
+		const int32_t sample_1 = mixer.work[readpos][0] >> MIXER_VOLSHIFT;
+		const int32_t sample_2 = mixer.work[readpos][1] >> MIXER_VOLSHIFT;
+		const int16_t s1 = MIXER_CLIP(sample_1);
+		const int16_t s2 = MIXER_CLIP(sample_2);
+		convert[i][0] = host_to_le16(s1);
+		convert[i][1] = host_to_le16(s2);
+		readpos = (readpos + 1) & MIXER_BUFMASK;
+	}
+	CAPTURE_AddWave(mixer.freq, added, reinterpret_cast<int16_t*>(convert));
+}
+
+static void MIXER_MixPortion(Bit32u tick_portion) {
 	MIXER_LockAudioDevice();
 	MIXER_MixData(mixer.needed);
-	mixer.tick_counter += mixer.tick_add;
+	const bool capturing = (CaptureState & (CAPTURE_WAVE|CAPTURE_VIDEO)) != 0;
+	const Bitu done = mixer.done;
+	const Bitu needed = mixer.needed;
+	const Bitu pos = mixer.pos;
+	if (!capturing)
+		mixer.done = needed;
+	mixer.tick_counter += tick_portion;
 	mixer.needed+=(mixer.tick_counter >> TICK_SHIFT);
 	mixer.tick_counter &= TICK_MASK;
 	MIXER_UnlockAudioDevice();
+	if (capturing) {
+		/* the conversion and a possible file write happen outside the
+		   lock so they can't stall the audio callback */
+		MIXER_CaptureData(done, needed, pos);
+		MIXER_LockAudioDevice();
+		/* the callback may have consumed old samples meanwhile, so
+		   publishing the new ones has to be an increment */
+		mixer.done += needed - done;
+		MIXER_UnlockAudioDevice();
+	}
+}
+
+static void MIXER_Mix(void) {
+	MIXER_MixPortion(mixer.tick_add);
+}
+
+/* Low-latency mode: generate in quarter-tick slices instead of once per
+ * millisecond, so the audio thread never waits on up to a whole tick of
+ * ungenerated data. The sub-tick steps ride the PIC queue, which runs
+ * them at their exact emulated time ahead of later device events; the
+ * last slice takes the division remainder so a full tick stays exact. */
+#define MIXER_SLICES 4
+
+static void MIXER_SliceEvent(Bitu val) {
+	const Bit32u quarter = mixer.tick_add / MIXER_SLICES;
+	if (val == MIXER_SLICES - 1)
+		MIXER_MixPortion(mixer.tick_add - (MIXER_SLICES - 1) * quarter);
+	else
+		MIXER_MixPortion(quarter);
+}
+
+static void MIXER_MixLowLatency(void) {
+	MIXER_MixPortion(mixer.tick_add / MIXER_SLICES);
+	for (Bitu s = 1; s < MIXER_SLICES; s++)
+		PIC_AddEvent(MIXER_SliceEvent, (float)s / MIXER_SLICES, s);
 }
 
 static void MIXER_Mix_NoSound(void) {
 	MIXER_MixData(mixer.needed);
+	if (CaptureState & (CAPTURE_WAVE|CAPTURE_VIDEO))
+		MIXER_CaptureData(mixer.done, mixer.needed, mixer.pos);
 	/* Clear piece we've just generated */
 	for (Bitu i=0;i<mixer.needed;i++) {
 		mixer.work[mixer.pos][0]=0;
@@ -546,7 +863,45 @@ static void MIXER_Mix_NoSound(void) {
 	mixer.done=0;
 }
 
+/* Drain a contiguous span of work frames into an interleaved s16 stream:
+   shift out the volume headroom, saturate and clear the drained frames.
+   packs/vqmovn give the saturating narrow directly; four stereo frames go
+   out per vector iteration. Channel and master volume are already fused
+   into the accumulate stage via volmul, so this is the only other pass
+   the samples make. */
+static void MIXER_DrainSpan(Bitu pos, Bitu frames, Bit16s * &output) {
+	Bit32s (*work)[2] = &mixer.work[pos];
+	Bitu n = 0;
+#if defined(__SSE2__)
+	for (; n + 4 <= frames; n += 4) {
+		__m128i a = _mm_loadu_si128((const __m128i*)&work[n][0]);
+		__m128i b = _mm_loadu_si128((const __m128i*)&work[n+2][0]);
+		a = _mm_srai_epi32(a, MIXER_VOLSHIFT);
+		b = _mm_srai_epi32(b, MIXER_VOLSHIFT);
+		_mm_storeu_si128((__m128i*)output, _mm_packs_epi32(a, b));
+		output += 8;
+	}
+#elif defined(__ARM_NEON) || defined(__aarch64__)
+	for (; n + 4 <= frames; n += 4) {
+		int16x4_t a = vqmovn_s32(vshrq_n_s32(vld1q_s32(&work[n][0]), MIXER_VOLSHIFT));
+		int16x4_t b = vqmovn_s32(vshrq_n_s32(vld1q_s32(&work[n+2][0]), MIXER_VOLSHIFT));
+		vst1q_s16(output, vcombine_s16(a, b));
+		output += 8;
+	}
+#endif
+	for (; n < frames; n++) {
+		*output++ = MIXER_CLIP(work[n][0] >> MIXER_VOLSHIFT);
+		*output++ = MIXER_CLIP(work[n][1] >> MIXER_VOLSHIFT);
+	}
+	/* Clean the used buffer */
+	memset(work, 0, frames * sizeof(work[0]));
+}
+
 static void SDLCALL MIXER_CallBack(void * userdata, Uint8 *stream, int len) {
+	// SDL owns this thread, so placement is applied from the first call
+	static bool placed = false;
+	if (GCC_UNLIKELY(!placed)) { PERF_TuneWorkerThread(); placed = true; }
+	const Bit64s trace_start = GCC_UNLIKELY(trace_enabled) ? PROF_Now() : 0;
 	memset(stream, 0, len);
 	Bitu need=(Bitu)len/MIXER_SSIZE;
 	Bit16s * output=(Bit16s *)stream;
@@ -558,8 +913,13 @@ static void SDLCALL MIXER_CallBack(void * userdata, Uint8 *stream, int len) {
 	/* Enough room in the buffer ? */
 	if (mixer.done < need) {
 //		LOG_MSG("Full underrun need %d, have %d, min %d", need, mixer.done, mixer.min_needed);
-		if((need - mixer.done) > (need >>7) ) //Max 1 procent stretch.
+		if((need - mixer.done) > (need >>7) ) { //Max 1 procent stretch.
+			if (GCC_UNLIKELY(trace_enabled)) {
+				TRACE_Instant("mixer","underrun",0);
+				TRACE_Complete("mixer","callback",0,trace_start);
+			}
 			return;
+		}
 		reduce = mixer.done;
 		index_add = (reduce << TICK_SHIFT) / need;
 		mixer.tick_add = calc_tickadd(mixer.freq+mixer.min_needed);
@@ -641,22 +1001,136 @@ static void SDLCALL MIXER_CallBack(void * userdata, Uint8 *stream, int len) {
 			pos++;
 		}
 	} else {
-		while (reduce--) {
+		while (reduce) {
 			pos &= MIXER_BUFMASK;
-			sample=mixer.work[pos][0]>>MIXER_VOLSHIFT;
-			*output++=MIXER_CLIP(sample);
-			sample=mixer.work[pos][1]>>MIXER_VOLSHIFT;
-			*output++=MIXER_CLIP(sample);
-			mixer.work[pos][0]=0;
-			mixer.work[pos][1]=0;
-			pos++;
+			Bitu span = MIXER_BUFSIZE - pos;
+			if (span > reduce) span = reduce;
+			MIXER_DrainSpan(pos, span, output);
+			pos += span;
+			reduce -= span;
 		}
 	}
+	if (GCC_UNLIKELY(trace_enabled)) TRACE_Complete("mixer","callback",0,trace_start);
+}
+
+/* Single registered ticker that routes to the active sink; swapping the
+   sink is just a mode change, so no ticker list surgery is needed while
+   the list is being walked */
+static void MIXER_MixTick(void) {
+	if (mixer.device_lost || mixer.turbo)
+		MIXER_Mix_NoSound();
+	else if (mixer.lowlatency)
+		MIXER_MixLowLatency();
+	else
+		MIXER_Mix();
+}
+
+/* Fast forward: drop the real-time constraint instead of letting the
+   output crackle. The silent sink keeps consuming the channels at the
+   (now much faster) emulated tick rate and the paused device plays
+   nothing; normal output resumes where the device left off. */
+void MIXER_SetTurbo(bool enabled) {
+	if (mixer.turbo == enabled) return;
+	mixer.turbo = enabled;
+	if (mixer.sdldevice)
+		SDL_PauseAudioDevice(mixer.sdldevice, mixer.turbo ? 1 : 0);
+}
+
+/* Device failover: when the opened device stalls or disappears (usb and
+   hdmi audio on kiosk hardware), drop to the silent drain so the
+   emulation thread never blocks on a dead device, and retry the default
+   device at intervals. Runs at 10 Hz off the rate-classed ticker. */
+#define MIXER_DEVICE_RETRY_MS 2000
+
+static void MIXER_DeviceCheck(void) {
+	if (mixer.device_lost) {
+		if (++mixer.device_retry < MIXER_DEVICE_RETRY_MS / 100)
+			return;
+		mixer.device_retry = 0;
+		SDL_AudioSpec spec;
+		memset(&spec, 0, sizeof(spec));
+		spec.freq = (int)mixer.freq;
+		spec.format = AUDIO_S16SYS;
+		spec.channels = 2;
+		spec.callback = MIXER_CallBack;
+		spec.userdata = NULL;
+		spec.samples = (Uint16)mixer.blocksize;
+		/* no ALLOW flags: the channels keep resampling to the rate
+		   the mixer was set up with, sdl converts if it has to */
+		SDL_AudioDeviceID dev = SDL_OpenAudioDevice(NULL, 0, &spec, NULL, 0);
+		if (!dev)
+			return;
+		mixer.sdldevice = dev;
+		mixer.device_lost = false;
+		SDL_PauseAudioDevice(mixer.sdldevice, mixer.turbo ? 1 : 0);
+		LOG_MSG("MIXER: Audio device restored.");
+		return;
+	}
+	if (!mixer.sdldevice)
+		return;
+	if (SDL_GetAudioDeviceStatus(mixer.sdldevice) != SDL_AUDIO_STOPPED)
+		return;
+	LOG_MSG("MIXER: Audio device lost, failing over to silent output.");
+	SDL_CloseAudioDevice(mixer.sdldevice);
+	mixer.sdldevice = 0;
+	mixer.device_lost = true;
+	mixer.device_retry = 0;
 }
 
 static void MIXER_Stop(Section* sec) {
 }
 
+/* Apply a runtime rate/blocksize/prebuffer change to the running mixer:
+   reopen the output device with the new spec and retune every channel. A
+   failed reopen drops to the silent sink and lets the failover poll retry,
+   same as losing the device. */
+static void MIXER_UpdateConfig(Section* sec) {
+	Section_prop * section=static_cast<Section_prop *>(sec);
+	Bit32u rate=(Bit32u)section->Get_int("rate");
+	Bit32u blocksize=(Bit32u)section->Get_int("blocksize");
+	if (rate != mixer.freq || blocksize != mixer.blocksize) {
+		if (mixer.nosound) {
+			mixer.freq=rate;
+			mixer.blocksize=blocksize;
+		} else {
+			if (mixer.sdldevice) {
+				SDL_CloseAudioDevice(mixer.sdldevice);
+				mixer.sdldevice = 0;
+			}
+			mixer.freq=rate;
+			mixer.blocksize=blocksize;
+			SDL_AudioSpec spec;
+			SDL_AudioSpec obtained;
+			memset(&spec,0,sizeof(spec));
+			spec.freq=(int)mixer.freq;
+			spec.format=AUDIO_S16SYS;
+			spec.channels=2;
+			spec.callback=MIXER_CallBack;
+			spec.userdata=NULL;
+			spec.samples=(Uint16)mixer.blocksize;
+			mixer.sdldevice = SDL_OpenAudioDevice(NULL, 0, &spec, &obtained, SDL_AUDIO_ALLOW_FREQUENCY_CHANGE);
+			if (mixer.sdldevice) {
+				mixer.freq=obtained.freq;
+				mixer.blocksize=obtained.samples;
+				mixer.device_lost = false;
+				SDL_PauseAudioDevice(mixer.sdldevice, mixer.turbo ? 1 : 0);
+			} else {
+				LOG_MSG("MIXER: Can't reopen audio: %s , running silent until a device appears.",SDL_GetError());
+				mixer.device_lost = true;
+				mixer.device_retry = 0;
+			}
+		}
+		mixer.tick_add=calc_tickadd(mixer.freq);
+		for (MixerChannel * chan=mixer.channels;chan;chan=chan->next)
+			chan->UpdateFreq();
+	}
+	mixer.min_needed=section->Get_int("prebuffer");
+	if (mixer.min_needed>100) mixer.min_needed=100;
+	mixer.min_needed=(mixer.freq*mixer.min_needed)/1000;
+	mixer.max_needed=mixer.blocksize * 2 + 2*mixer.min_needed;
+	mixer.needed=mixer.min_needed+1;
+}
+
 class MIXER : public Program {
 public:
 	void MakeVolume(char * scan,float & vol0,float & vol1) {
@@ -689,6 +1163,17 @@ public:
 			ListMidi();
 			return;
 		}
+		if (cmd->FindString("/TAP",temp_line,false)) {
+			MixerChannel * chan=MIXER_FindChannel(temp_line.c_str());
+			if (!chan) {
+				WriteOut("No such channel: %s\n",temp_line.c_str());
+				return;
+			}
+			chan->SetTap(!chan->Tapped());
+			WriteOut("%s wave tap on channel %s\n",
+				chan->Tapped()?"Started":"Stopped",chan->name);
+			return;
+		}
 		if (cmd->FindString("MASTER",temp_line,false)) {
 			MakeVolume((char *)temp_line.c_str(),mixer.mastervol[0],mixer.mastervol[1]);
 		}
@@ -776,17 +1261,26 @@ void MIXER_Init(Section* sec) {
 		mixer.tick_add=calc_tickadd(mixer.freq);
 		TIMER_AddTickHandler(MIXER_Mix_NoSound);
 	} else if ((mixer.sdldevice = SDL_OpenAudioDevice(NULL, 0, &spec, &obtained, SDL_AUDIO_ALLOW_FREQUENCY_CHANGE)) ==0 ) {
-		mixer.nosound = true;
-		LOG_MSG("MIXER: Can't open audio: %s , running in nosound mode.",SDL_GetError());
+		/* keep running on the silent sink and let the failover poll
+		   pick the device up once it appears */
+		mixer.device_lost = true;
+		LOG_MSG("MIXER: Can't open audio: %s , running silent until a device appears.",SDL_GetError());
 		mixer.tick_add=calc_tickadd(mixer.freq);
-		TIMER_AddTickHandler(MIXER_Mix_NoSound);
+		mixer.lowlatency=section->Get_bool("lowlatency");
+		TIMER_AddTickHandler(MIXER_MixTick);
+		TIMER_AddTickHandlerRate(MIXER_DeviceCheck, 10);
 	} else {
 		if((static_cast<Bit16s>(mixer.freq) != obtained.freq) || (mixer.blocksize != obtained.samples))
 			LOG_MSG("MIXER: Got different values from SDL: freq %d, blocksize %d",obtained.freq,obtained.samples);
 		mixer.freq=obtained.freq;
 		mixer.blocksize=obtained.samples;
 		mixer.tick_add=calc_tickadd(mixer.freq);
-		TIMER_AddTickHandler(MIXER_Mix);
+		mixer.lowlatency=section->Get_bool("lowlatency");
+		if (mixer.lowlatency)
+			LOG_MSG("MIXER: Low-latency mode, generating in %d slices per tick",
+			        MIXER_SLICES);
+		TIMER_AddTickHandler(MIXER_MixTick);
+		TIMER_AddTickHandlerRate(MIXER_DeviceCheck, 10);
 		SDL_PauseAudioDevice(mixer.sdldevice, 0);
 	}
 	mixer.min_needed=section->Get_int("prebuffer");
@@ -795,6 +1289,10 @@ void MIXER_Init(Section* sec) {
 	mixer.max_needed=mixer.blocksize * 2 + 2*mixer.min_needed;
 	mixer.needed=mixer.min_needed+1;
 	PROGRAMS_MakeFile("MIXER.COM",MIXER_ProgramStart);
+
+	sec->AddUpdateFunction("rate",&MIXER_UpdateConfig);
+	sec->AddUpdateFunction("blocksize",&MIXER_UpdateConfig);
+	sec->AddUpdateFunction("prebuffer",&MIXER_UpdateConfig);
 }
 
 void MIXER_CloseAudioDevice(void) {
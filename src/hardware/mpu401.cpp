@@ -37,7 +37,6 @@ static void MPU401_EOIHandlerDispatch(void);
 #define MPU401_VERSION	0x15
 #define MPU401_REVISION	0x01
 #define MPU401_QUEUE 32
-#define MPU401_TIMECONSTANT (60000000/1000.0f)
 #define MPU401_RESETBUSY 14.0f
 
 enum MpuMode { M_UART,M_INTELLIGENT };
@@ -90,9 +89,19 @@ static struct {
 		Bit8u tempo_grad;
 		Bit8u cth_rate,cth_counter;
 		bool clock_to_host,cth_active;
+		Bit64s period_ns;	// precomputed sequencer clock period
 	} clock;
 } mpu;
 
+/* The sequencer clock rate only changes with the tempo/timebase
+   registers, so compute the event period once there instead of doing
+   the float division again for every single clock event. */
+static void MPU401_UpdatePeriod(void) {
+	Bitu rate=mpu.clock.tempo*mpu.clock.timebase;
+	if (rate) mpu.clock.period_ns=(Bit64s)(60000000000ULL/rate);
+	else mpu.clock.period_ns=0;
+}
+
 
 static void QueueByte(Bit8u data) {
 	if (mpu.state.block_ack) {mpu.state.block_ack=false;return;}
@@ -152,7 +161,8 @@ static void MPU401_WriteCommand(Bitu port,Bitu val,Bitu iolen) {
 				LOG(LOG_MISC,LOG_NORMAL)("MPU-401:Intelligent mode playback started");
 				mpu.state.playing=true;
 				PIC_RemoveEvents(MPU401_Event);
-				PIC_AddEvent(MPU401_Event,MPU401_TIMECONSTANT/(mpu.clock.tempo*mpu.clock.timebase));
+				MPU401_UpdatePeriod();
+				if (mpu.clock.period_ns) PIC_AddEventNS(MPU401_Event,mpu.clock.period_ns);
 				ClrQueue();
 				break;
 		}
@@ -186,26 +196,10 @@ static void MPU401_WriteCommand(Bitu port,Bitu val,Bitu iolen) {
 		case 0x95:
 			mpu.clock.clock_to_host=true;
 			break;
-		case 0xc2: /* Internal timebase */
-			mpu.clock.timebase=48;
-			break;
-		case 0xc3:
-			mpu.clock.timebase=72;
-			break;
-		case 0xc4:
-			mpu.clock.timebase=96;
-			break;
-		case 0xc5:
-			mpu.clock.timebase=120;
-			break;
-		case 0xc6:
-			mpu.clock.timebase=144;
-			break;
-		case 0xc7:
-			mpu.clock.timebase=168;
-			break;
-		case 0xc8:
-			mpu.clock.timebase=192;
+		case 0xc2: case 0xc3: case 0xc4: case 0xc5:
+		case 0xc6: case 0xc7: case 0xc8: /* Internal timebase */
+			mpu.clock.timebase=48+(val-0xc2)*24;
+			MPU401_UpdatePeriod();
 			break;
 		/* Commands with data byte */
 		case 0xe0: case 0xe1: case 0xe2: case 0xe4: case 0xe6:
@@ -311,6 +305,7 @@ static void MPU401_WriteData(Bitu port,Bitu val,Bitu iolen) {
 		case 0xe0:	/* Set tempo */
 			mpu.state.command_byte=0;
 			mpu.clock.tempo=val;
+			MPU401_UpdatePeriod();
 			return;
 		case 0xe1:	/* Set relative tempo */
 			mpu.state.command_byte=0;
@@ -548,16 +543,20 @@ static void MPU401_Event(Bitu val) {
 	}
 	if (!mpu.state.irq_pending && mpu.state.req_mask) MPU401_EOIHandler();
 next_event:
-	Bitu new_time;
-	if ((new_time=mpu.clock.tempo*mpu.clock.timebase)==0) return;
-	PIC_AddEvent(MPU401_Event,MPU401_TIMECONSTANT/new_time);
+	if (!mpu.clock.period_ns) return;
+	PIC_AddEventNS(MPU401_Event,mpu.clock.period_ns);
 }
 
 
 static void MPU401_EOIHandlerDispatch(void) {
 	if (mpu.state.send_now) {
-		mpu.state.eoi_scheduled=true;
-		PIC_AddEvent(MPU401_EOIHandler,0.06f); //Possible a bit longer
+		// one pending EOI event covers any further input that ends
+		// before it fires; MIDI-heavy titles used to pile up one
+		// event per message here
+		if (!mpu.state.eoi_scheduled) {
+			mpu.state.eoi_scheduled=true;
+			PIC_AddEvent(MPU401_EOIHandler,0.06f); //Possible a bit longer
+		}
 	}
 	else if (!mpu.state.eoi_scheduled) MPU401_EOIHandler();
 }
@@ -612,6 +611,7 @@ static void MPU401_Reset(void) {
 	mpu.clock.timebase=mpu.clock.old_timebase=120;
 	mpu.clock.tempo_rel=mpu.clock.old_tempo_rel=40;
 	mpu.clock.tempo_grad=0;
+	MPU401_UpdatePeriod();
 	mpu.clock.clock_to_host=false;
 	mpu.clock.cth_rate=60;
 	mpu.clock.cth_counter=0;
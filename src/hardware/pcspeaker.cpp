@@ -254,7 +254,25 @@ static void PCSPEAKER_CallBack(Bitu len) {
 	Bitu pos=0;
 	float sample_base=0;
 	float sample_add=(1.0001f)/len;
-	while (count--) {
+	while (count) {
+		/* The volume sits on its target level between entries, which is
+		   most of the time between PIT flips; write those runs out as
+		   whole constant samples in one go instead of integrating each
+		   sample against the entry queue */
+		if (spkr.volwant == spkr.volcur) {
+			const float next_index = spkr.used ? spkr.entries[pos].index : 2.0f;
+			const float span = next_index - sample_base;
+			Bitu run = (span > 0) ? (Bitu)(span / sample_add) : 0;
+			if (run > count) run = count;
+			if (run) {
+				const Bit16s val = (Bit16s)spkr.volcur;
+				count -= run;
+				sample_base += run * sample_add;
+				while (run--) *stream++ = val;
+				continue;
+			}
+		}
+		count--;
 		float index=sample_base;
 		sample_base+=sample_add;
 		float end=sample_base;
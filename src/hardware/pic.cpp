@@ -16,6 +16,8 @@
  *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
  */
 
+#include <string.h>
+
 #include "dosbox.h"
 #include "inout.h"
 #include "cpu.h"
@@ -23,8 +25,10 @@
 #include "pic.h"
 #include "timer.h"
 #include "setup.h"
-
-#define PIC_QUEUESIZE 512
+#include "tracer.h"
+#if C_DEBUG
+#include "debug.h"
+#endif
 
 struct PIC_Controller {
 	Bitu icw_words;
@@ -165,18 +169,56 @@ void PIC_Controller::start_irq(Bit8u val){
 
 
 struct PICEntry {
-	float index;
+	/* nanoseconds relative to the start of the current tick; integer so
+	   the per-tick rebasing below never accumulates rounding */
+	Bit64s index_ns;
 	Bitu value;
+	Bit64u seq;			// insertion order, breaks ties between equal indices
 	PIC_EventHandler pic_event;
-	PICEntry * next;
+	PICEntry * next;	// free list linkage
 };
 
 static struct {
 	PICEntry entries[PIC_QUEUESIZE];
+	PICEntry * heap[PIC_QUEUESIZE];		// binary min-heap on (index,seq)
+	Bitu heap_used;
 	PICEntry * free_entry;
-	PICEntry * next_entry;
 } pic_queue;
 
+static Bit64u pic_event_seq=0;
+
+// earliest index first; equal indices keep their insertion (FIFO) order,
+// matching what the old sorted list guaranteed
+static INLINE bool HeapBefore(PICEntry * a,PICEntry * b) {
+	if (a->index_ns != b->index_ns) return a->index_ns < b->index_ns;
+	return a->seq < b->seq;
+}
+
+static void HeapSiftUp(Bitu pos) {
+	PICEntry * entry=pic_queue.heap[pos];
+	while (pos) {
+		Bitu parent=(pos-1)>>1;
+		if (!HeapBefore(entry,pic_queue.heap[parent])) break;
+		pic_queue.heap[pos]=pic_queue.heap[parent];
+		pos=parent;
+	}
+	pic_queue.heap[pos]=entry;
+}
+
+static void HeapSiftDown(Bitu pos) {
+	PICEntry * entry=pic_queue.heap[pos];
+	for (;;) {
+		Bitu child=2*pos+1;
+		if (child>=pic_queue.heap_used) break;
+		if ((child+1<pic_queue.heap_used) &&
+		    HeapBefore(pic_queue.heap[child+1],pic_queue.heap[child])) child++;
+		if (!HeapBefore(pic_queue.heap[child],entry)) break;
+		pic_queue.heap[pos]=pic_queue.heap[child];
+		pos=child;
+	}
+	pic_queue.heap[pos]=entry;
+}
+
 static void write_command(Bitu port,Bitu val,Bitu iolen) {
 	PIC_Controller * pic=&pics[port==0x20 ? 0 : 1];
 
@@ -370,105 +412,196 @@ void PIC_SetIRQMask(Bitu irq, bool masked) {
 }
 
 static void AddEntry(PICEntry * entry) {
-	PICEntry * find_entry=pic_queue.next_entry;
-	if (GCC_UNLIKELY(find_entry ==0)) {
-		entry->next=0;
-		pic_queue.next_entry=entry;
-	} else if (find_entry->index>entry->index) {
-		pic_queue.next_entry=entry;
-		entry->next=find_entry;
-	} else while (find_entry) {
-		if (find_entry->next) {
-			/* See if the next index comes later than this one */
-			if (find_entry->next->index > entry->index) {
-				entry->next=find_entry->next;
-				find_entry->next=entry;
-				break;
-			} else {
-				find_entry=find_entry->next;
-			}
-		} else {
-			entry->next=find_entry->next;
-			find_entry->next=entry;
-			break;
-		}
-	}
-	Bits cycles=PIC_MakeCycles(pic_queue.next_entry->index-PIC_TickIndex());
+	entry->seq=pic_event_seq++;
+	pic_queue.heap[pic_queue.heap_used++]=entry;
+	HeapSiftUp(pic_queue.heap_used-1);
+	Bits cycles=(Bits)(pic_queue.heap[0]->index_ns*CPU_CycleMax/1000000-PIC_TickIndexND());
 	if (cycles<CPU_Cycles) {
 		CPU_CycleLeft+=CPU_Cycles;
 		CPU_Cycles=0;
 	}
 }
 static bool InEventService = false;
-static float srv_lag = 0;
+static Bit64s srv_lag = 0;
 
-void PIC_AddEvent(PIC_EventHandler handler,float delay,Bitu val) {
+void PIC_AddEventNS(PIC_EventHandler handler,Bit64s delay_ns,Bitu val) {
 	if (GCC_UNLIKELY(!pic_queue.free_entry)) {
 		LOG(LOG_PIC,LOG_ERROR)("Event queue full");
 		return;
 	}
 	PICEntry * entry=pic_queue.free_entry;
-	if(InEventService) entry->index = delay + srv_lag;
-	else entry->index = delay + PIC_TickIndex();
+	if(InEventService) entry->index_ns = delay_ns + srv_lag;
+	else entry->index_ns = delay_ns + PIC_TickIndexNS();
 
 	entry->pic_event=handler;
 	entry->value=val;
 	pic_queue.free_entry=pic_queue.free_entry->next;
 	AddEntry(entry);
+	if (GCC_UNLIKELY(trace_enabled)) TRACE_Instant("pic","add",(void*)handler);
+}
+
+void PIC_AddEvent(PIC_EventHandler handler,float delay,Bitu val) {
+	PIC_AddEventNS(handler,(Bit64s)(delay*1000000.0f),val);
+}
+
+/* filter the heap with pred, then restore the heap property bottom-up;
+   one O(n) pass regardless of how many events are dropped */
+#define PIC_FILTER_QUEUE(pred) {									\
+	Bitu used=pic_queue.heap_used;									\
+	Bitu kept=0;													\
+	for (Bitu i=0;i<used;i++) {										\
+		PICEntry * entry=pic_queue.heap[i];							\
+		if (GCC_UNLIKELY(pred)) {									\
+			entry->next=pic_queue.free_entry;						\
+			pic_queue.free_entry=entry;								\
+		} else pic_queue.heap[kept++]=entry;						\
+	}																\
+	if (kept!=used) {												\
+		pic_queue.heap_used=kept;									\
+		for (Bits i=(Bits)(kept>>1)-1;i>=0;i--)						\
+			HeapSiftDown((Bitu)i);									\
+	}																\
 }
 
 void PIC_RemoveSpecificEvents(PIC_EventHandler handler, Bitu val) {
-	PICEntry * entry=pic_queue.next_entry;
-	PICEntry * prev_entry;
-	prev_entry = 0;
-	while (entry) {
-		if (GCC_UNLIKELY((entry->pic_event == handler)) && (entry->value == val)) {
-			if (prev_entry) {
-				prev_entry->next=entry->next;
-				entry->next=pic_queue.free_entry;
-				pic_queue.free_entry=entry;
-				entry=prev_entry->next;
-				continue;
-			} else {
-				pic_queue.next_entry=entry->next;
-				entry->next=pic_queue.free_entry;
-				pic_queue.free_entry=entry;
-				entry=pic_queue.next_entry;
-				continue;
-			}
-		}
-		prev_entry=entry;
-		entry=entry->next;
-	}	
+	PIC_FILTER_QUEUE((entry->pic_event==handler) && (entry->value==val));
 }
 
 void PIC_RemoveEvents(PIC_EventHandler handler) {
-	PICEntry * entry=pic_queue.next_entry;
-	PICEntry * prev_entry;
-	prev_entry=0;
-	while (entry) {
-		if (GCC_UNLIKELY(entry->pic_event==handler)) {
-			if (prev_entry) {
-				prev_entry->next=entry->next;
-				entry->next=pic_queue.free_entry;
-				pic_queue.free_entry=entry;
-				entry=prev_entry->next;
-				continue;
-			} else {
-				pic_queue.next_entry=entry->next;
-				entry->next=pic_queue.free_entry;
-				pic_queue.free_entry=entry;
-				entry=pic_queue.next_entry;
-				continue;
-			}
+	PIC_FILTER_QUEUE(entry->pic_event==handler);
+}
+
+double PIC_NextEventTime(void) {
+	if (!pic_queue.heap_used) return -1.0;
+	/* entry index is in ns relative to the start of the current tick */
+	return (double)PIC_Ticks + (double)pic_queue.heap[0]->index_ns/1000000.0;
+}
+
+Bitu PIC_SaveEvents(PICEventState * buf,Bitu max) {
+	Bitu count=0;
+	for (Bitu i=0;i<pic_queue.heap_used && count<max;i++) {
+		buf[count].handler=pic_queue.heap[i]->pic_event;
+		buf[count].index_ns=pic_queue.heap[i]->index_ns;
+		buf[count].value=pic_queue.heap[i]->value;
+		buf[count].seq=pic_queue.heap[i]->seq;
+		count++;
+	}
+	return count;
+}
+
+void PIC_LoadEvents(const PICEventState * buf,Bitu count) {
+	/* rebuild the free list, then reinsert the saved entries with their
+	   original sequence numbers so FIFO tie-breaking is preserved */
+	for (Bitu i=0;i<PIC_QUEUESIZE-1;i++) {
+		pic_queue.entries[i].next=&pic_queue.entries[i+1];
+	}
+	pic_queue.entries[PIC_QUEUESIZE-1].next=0;
+	pic_queue.free_entry=&pic_queue.entries[0];
+	pic_queue.heap_used=0;
+	for (Bitu i=0;i<count;i++) {
+		PICEntry * entry=pic_queue.free_entry;
+		pic_queue.free_entry=entry->next;
+		entry->index_ns=buf[i].index_ns;
+		entry->value=buf[i].value;
+		entry->pic_event=buf[i].handler;
+		entry->seq=buf[i].seq;
+		if (entry->seq>=pic_event_seq) pic_event_seq=entry->seq+1;
+		pic_queue.heap[pic_queue.heap_used++]=entry;
+		HeapSiftUp(pic_queue.heap_used-1);
+	}
+}
+
+Bitu PIC_ControllerStateSize(void) {
+	return sizeof(pics);
+}
+
+void PIC_SaveControllers(void * buf) {
+	memcpy(buf,pics,sizeof(pics));
+}
+
+void PIC_LoadControllers(const void * buf) {
+	memcpy(pics,buf,sizeof(pics));
+}
+
+/* Cumulative per-handler accounting, active while the profiler is on. The
+   summary names handlers by address; resolve them against a map file or the
+   debugger. Dumped and reset every five seconds */
+#define HANDLER_STAT_SLOTS 64
+static struct HandlerStat {
+	const void * handler;
+	const char * kind;
+	Bit64s total_us;
+	Bit64s worst_us;
+	Bit32u calls;
+} handler_stats[HANDLER_STAT_SLOTS];
+static Bitu handler_stats_used=0;
+static Bit64s handler_stats_dumped=0;
+
+static void HandlerAccount(const char * kind,const void * handler,Bit64s start) {
+	const Bit64s spent=PROF_Now()-start;
+	for (Bitu i=0;i<handler_stats_used;i++) {
+		HandlerStat * stat=&handler_stats[i];
+		if (stat->handler==handler && stat->kind==kind) {
+			stat->total_us+=spent;
+			if (spent>stat->worst_us) stat->worst_us=spent;
+			stat->calls++;
+			return;
+		}
+	}
+	if (handler_stats_used>=HANDLER_STAT_SLOTS) return;
+	HandlerStat * stat=&handler_stats[handler_stats_used++];
+	stat->handler=handler;
+	stat->kind=kind;
+	stat->total_us=spent;
+	stat->worst_us=spent;
+	stat->calls=1;
+}
+
+/* Worst single handler call since the last query; consumed by the
+   profiler's stall report, which clears the window so the next stall is
+   attributed on its own */
+Bit64s PIC_TakeWorstHandler(const void ** handler,const char ** kind) {
+	Bit64s worst=0;
+	Bitu worst_i=0;
+	for (Bitu i=0;i<handler_stats_used;i++) {
+		if (handler_stats[i].worst_us>worst) {
+			worst=handler_stats[i].worst_us;
+			worst_i=i;
 		}
-		prev_entry=entry;
-		entry=entry->next;
-	}	
+	}
+	if (!worst) return 0;
+	*handler=handler_stats[worst_i].handler;
+	*kind=handler_stats[worst_i].kind;
+	for (Bitu i=0;i<handler_stats_used;i++) handler_stats[i].worst_us=0;
+	return worst;
+}
+
+static void HandlerStatsUpdate(void) {
+	const Bit64s now=PROF_Now();
+	if (!handler_stats_dumped) {
+		handler_stats_dumped=now;
+		return;
+	}
+	const Bit64s interval=now-handler_stats_dumped;
+	if (interval<5000000) return;
+	for (Bitu i=0;i<handler_stats_used;i++) {
+		const HandlerStat * stat=&handler_stats[i];
+		LOG_MSG("CYCLES: %s=%p calls=%u total_us=%d worst_us=%d avg_us=%.1f load=%.2f%%",
+			stat->kind,stat->handler,stat->calls,
+			(int)stat->total_us,
+			(int)stat->worst_us,
+			(double)stat->total_us/stat->calls,
+			stat->total_us*100.0/interval);
+	}
+	handler_stats_used=0;
+	handler_stats_dumped=now;
 }
 
 
 bool PIC_RunQueue(void) {
+#if C_DEBUG
+	if (GCC_UNLIKELY(DEBUG_Profiling)) DEBUG_ProfileSample();
+#endif
 	/* Check to see if a new millisecond needs to be started */
 	CPU_CycleLeft+=CPU_Cycles;
 	CPU_Cycles=0;
@@ -478,12 +611,25 @@ bool PIC_RunQueue(void) {
 	/* Check the queue for an entry */
 	Bits index_nd=PIC_TickIndexND();
 	InEventService = true;
-	while (pic_queue.next_entry && (pic_queue.next_entry->index*CPU_CycleMax<=index_nd)) {
-		PICEntry * entry=pic_queue.next_entry;
-		pic_queue.next_entry=entry->next;
+	while (pic_queue.heap_used && (pic_queue.heap[0]->index_ns*CPU_CycleMax<=(Bit64s)index_nd*1000000)) {
+		/* Pop the earliest entry before running it, the handler may
+		   schedule new events */
+		PICEntry * entry=pic_queue.heap[0];
+		pic_queue.heap_used--;
+		if (pic_queue.heap_used) {
+			pic_queue.heap[0]=pic_queue.heap[pic_queue.heap_used];
+			HeapSiftDown(0);
+		}
 
-		srv_lag = entry->index;
-		(entry->pic_event)(entry->value); // call the event handler
+		srv_lag = entry->index_ns;
+		if (GCC_UNLIKELY(trace_enabled || prof_enabled)) {
+			const Bit64s probe_start=PROF_Now();
+			(entry->pic_event)(entry->value); // call the event handler
+			if (trace_enabled) TRACE_Complete("pic","event",(void*)entry->pic_event,probe_start);
+			if (prof_enabled) HandlerAccount("event",(void*)entry->pic_event,probe_start);
+		} else {
+			(entry->pic_event)(entry->value); // call the event handler
+		}
 
 		/* Put the entry in the free list */
 		entry->next=pic_queue.free_entry;
@@ -492,9 +638,9 @@ bool PIC_RunQueue(void) {
 	InEventService = false;
 
 	/* Check when to set the new cycle end */
-	if (pic_queue.next_entry) {
-		Bits cycles=(Bits)(pic_queue.next_entry->index*CPU_CycleMax-index_nd);
-		if (GCC_UNLIKELY(!cycles)) cycles=1;
+	if (pic_queue.heap_used) {
+		Bits cycles=(Bits)(pic_queue.heap[0]->index_ns*CPU_CycleMax/1000000-index_nd);
+		if (GCC_UNLIKELY(cycles<=0)) cycles=1;
 		if (cycles<CPU_CycleLeft) {
 			CPU_Cycles=cycles;
 		} else {
@@ -509,6 +655,8 @@ bool PIC_RunQueue(void) {
 /* The TIMER Part */
 struct TickerBlock {
 	TIMER_TickHandler handler;
+	Bitu interval;				/* in ticks, 1 == 1000Hz */
+	Bitu countdown;
 	TickerBlock * next;
 };
 
@@ -529,38 +677,64 @@ void TIMER_DelTickHandler(TIMER_TickHandler handler) {
 	}
 }
 
-void TIMER_AddTickHandler(TIMER_TickHandler handler) {
+void TIMER_AddTickHandlerRate(TIMER_TickHandler handler,Bitu rate_hz) {
+	static Bitu stagger=0;
 	TickerBlock * newticker=new TickerBlock;
 	newticker->next=firstticker;
 	newticker->handler=handler;
+	if (!rate_hz || rate_hz>1000) rate_hz=1000;
+	newticker->interval=1000/rate_hz;
+	/* spread slow handlers over different ticks */
+	newticker->countdown=(stagger++ % newticker->interval)+1;
 	firstticker=newticker;
 }
 
+void TIMER_AddTickHandler(TIMER_TickHandler handler) {
+	TIMER_AddTickHandlerRate(handler,1000);
+}
+
 void TIMER_AddTick(void) {
 	/* Setup new amount of cycles for PIC */
 	CPU_CycleLeft=CPU_CycleMax;
 	CPU_Cycles=0;
 	PIC_Ticks++;
-	/* Go through the list of scheduled events and lower their index with 1000 */
-	PICEntry * entry=pic_queue.next_entry;
-	while (entry) {
-		entry->index -= 1.0;
-		entry=entry->next;
-	}
+	/* Go through the list of scheduled events and lower their index with
+	   one tick; a uniform shift keeps the heap ordering intact */
+	for (Bitu i=0;i<pic_queue.heap_used;i++) pic_queue.heap[i]->index_ns -= 1000000;
 	/* Call our list of ticker handlers */
 	TickerBlock * ticker=firstticker;
 	while (ticker) {
 		TickerBlock * nextticker=ticker->next;
-		ticker->handler();
+		/* rate-classed handlers only run every interval ticks */
+		if (--ticker->countdown) {
+			ticker=nextticker;
+			continue;
+		}
+		ticker->countdown=ticker->interval;
+		if (GCC_UNLIKELY(trace_enabled || prof_enabled)) {
+			const Bit64s probe_start=PROF_Now();
+			ticker->handler();
+			if (trace_enabled) TRACE_Complete("timer","tick",(void*)ticker->handler,probe_start);
+			if (prof_enabled) HandlerAccount("tick",(void*)ticker->handler,probe_start);
+		} else {
+			ticker->handler();
+		}
 		ticker=nextticker;
 	}
+	if (GCC_UNLIKELY(prof_enabled)) HandlerStatsUpdate();
 }
 
+// both controllers always sit on the same ports, so the whole map is
+// compile-time data
+static const IO_PortMapEntry pic_portmap[] = {
+	{ 0x20,1,IO_MB,read_command,write_command },
+	{ 0x21,1,IO_MB,read_data,write_data },
+	{ 0xa0,1,IO_MB,read_command,write_command },
+	{ 0xa1,1,IO_MB,read_data,write_data },
+};
+
 /* Use full name to avoid name clash with compile option for position-independent code */
 class PIC_8259A: public Module_base {
-private:
-	IO_ReadHandleObject ReadHandler[4];
-	IO_WriteHandleObject WriteHandler[4];
 public:
 	PIC_8259A(Section* configuration):Module_base(configuration){
 		/* Setup pic0 and pic1 with initial values like DOS has normally */
@@ -591,24 +765,18 @@ public:
 			/* Enable IRQ6 (replacement for the NMI for PCJr) */
 			PIC_SetIRQMask(6,false);
 		}
-		ReadHandler[0].Install(0x20,read_command,IO_MB);
-		ReadHandler[1].Install(0x21,read_data,IO_MB);
-		WriteHandler[0].Install(0x20,write_command,IO_MB);
-		WriteHandler[1].Install(0x21,write_data,IO_MB);
-		ReadHandler[2].Install(0xa0,read_command,IO_MB);
-		ReadHandler[3].Install(0xa1,read_data,IO_MB);
-		WriteHandler[2].Install(0xa0,write_command,IO_MB);
-		WriteHandler[3].Install(0xa1,write_data,IO_MB);
+		IO_RegisterPortMap(pic_portmap,sizeof(pic_portmap)/sizeof(pic_portmap[0]));
 		/* Initialize the pic queue */
 		for (i=0;i<PIC_QUEUESIZE-1;i++) {
 			pic_queue.entries[i].next=&pic_queue.entries[i+1];
 		}
 		pic_queue.entries[PIC_QUEUESIZE-1].next=0;
 		pic_queue.free_entry=&pic_queue.entries[0];
-		pic_queue.next_entry=0;
+		pic_queue.heap_used=0;
 	}
 
 	~PIC_8259A(){
+		IO_FreePortMap(pic_portmap,sizeof(pic_portmap)/sizeof(pic_portmap[0]));
 	}
 };
 
@@ -102,6 +102,13 @@ struct SB_INFO {
 		Bitu bits;
 		DmaChannel * chan;
 		Bitu remain_size;
+		//Compiled transfer setup, reused when a command re-issues the
+		//same parameters; see DSP_DoDMATransfer
+		DMA_MODES setup_mode;
+		Bitu setup_freq;
+		bool setup_stereo;
+		bool setup_valid;
+		DmaChannel * setup_chan;
 	} dma;
 	bool speaker;
 	bool midi;
@@ -634,15 +641,24 @@ static void DSP_RaiseIRQEvent(Bitu /*val*/) {
 }
 
 static void DSP_DoDMATransfer(const DMA_MODES mode, Bitu freq, bool autoinit, bool stereo) {
+	/* Re-issuing the same transfer setup (games restart single cycle
+	   blocks hundreds of times a second at 44k) reuses the compiled
+	   rate, format and channel registration; only the block counter and
+	   irq state need reloading then */
+	const bool same_setup = sb.dma.setup_valid &&
+		mode == sb.dma.setup_mode && freq == sb.dma.setup_freq &&
+		stereo == sb.dma.setup_stereo && sb.dma.chan == sb.dma.setup_chan;
+
 	//Fill up before changing state?
-	sb.chan->FillUp();
+	if (!same_setup)
+		sb.chan->FillUp();
 
 	//Starting a new transfer will clear any active irqs?
 	sb.irq.pending_8bit = false;
 	sb.irq.pending_16bit = false;
 	PIC_DeActivateIRQ(sb.hw.irq);
 
-	switch (mode) {
+	if (!same_setup) switch (mode) {
 	case DSP_DMA_2:          sb.dma.mul = (1 << SB_SH) / 4; break;
 	case DSP_DMA_3:          sb.dma.mul = (1 << SB_SH) / 3; break;
 	case DSP_DMA_4:          sb.dma.mul = (1 << SB_SH) / 2; break;
@@ -670,18 +686,27 @@ static void DSP_DoDMATransfer(const DMA_MODES mode, Bitu freq, bool autoinit, bo
 	}
 	sb.dma.autoinit = autoinit;
 	sb.dma.mode = mode;
-	sb.dma.stereo = stereo;
-	//Double the reading speed for stereo mode
-	if (sb.dma.stereo) 
-		sb.dma.mul*=2;
-	sb.dma.rate=(sb.freq*sb.dma.mul) >> SB_SH;
-	sb.dma.min=(sb.dma.rate*3)/1000;
-	sb.chan->SetFreq(freq);
+	if (!same_setup) {
+		sb.dma.stereo = stereo;
+		//Double the reading speed for stereo mode
+		if (sb.dma.stereo)
+			sb.dma.mul*=2;
+		sb.dma.rate=(sb.freq*sb.dma.mul) >> SB_SH;
+		sb.dma.min=(sb.dma.rate*3)/1000;
+		sb.chan->SetFreq(freq);
+	}
 
 	PIC_RemoveEvents(END_DMA_Event);
 	//Set to be masked, the dma call can change this again.
 	sb.mode = MODE_DMA_MASKED;
-	sb.dma.chan->Register_Callback(DSP_DMA_CallBack);
+	if (!same_setup)
+		sb.dma.chan->Register_Callback(DSP_DMA_CallBack);
+
+	sb.dma.setup_mode = mode;
+	sb.dma.setup_freq = freq;
+	sb.dma.setup_stereo = stereo;
+	sb.dma.setup_chan = sb.dma.chan;
+	sb.dma.setup_valid = true;
 
 #if (C_DEBUG)
 	const char *type;
@@ -781,6 +806,7 @@ static void DSP_Reset(void) {
 	sb.dma.autoinit=false;
 	sb.dma.mode=DSP_DMA_NONE;
 	sb.dma.remain_size=0;
+	sb.dma.setup_valid=false;
 	if (sb.dma.chan) sb.dma.chan->Clear_Request();
 
 	sb.freq=22050;
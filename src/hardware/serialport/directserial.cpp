@@ -38,6 +38,8 @@ CDirectSerial::CDirectSerial (Bitu id, CommandLine* cmd)
 
 	rx_retry = 0;
     rx_retry_max = 0;
+	rx_bulk_in = 0;
+	rx_bulk_out = 0;
 
 	std::string tmpstring;
 	if(!cmd->FindStringBegin("realport:",tmpstring,false)) return;
@@ -234,12 +236,23 @@ void CDirectSerial::handleUpperEvent(Bit16u type) {
 }
 
 bool CDirectSerial::doReceive() {
-	int value = SERIAL_getextchar(comport);
-	if(value) {
+	if(rx_bulk_out >= rx_bulk_in) {
+		// buffer empty: fetch whatever the kernel has queued in one go
+		rx_bulk_out = rx_bulk_in = 0;
+		int got = SERIAL_getextchars(comport, rx_bulk, SERIAL_BULK_MAX);
+		if(got <= 0) return false;
+		rx_bulk_in = (Bitu)got;
+	}
+	int value = rx_bulk[rx_bulk_out++];
+	receiveByteEx((Bit8u)(value&0xff),(Bit8u)((value&0xff00)>>8));
+	// a backlog only builds up at high baudrates; drain it into the
+	// FIFO in one go instead of one byte per RX event. The reception
+	// interrupt still fires at the programmed FIFO watermark.
+	while(rx_bulk_out < rx_bulk_in && CanReceiveByte()) {
+		value = rx_bulk[rx_bulk_out++];
 		receiveByteEx((Bit8u)(value&0xff),(Bit8u)((value&0xff00)>>8));
-		return true;
 	}
-	return false;
+	return true;
 }
 
 // updatePortConfig is called when emulated app changes the serial port
@@ -59,6 +59,12 @@ private:
 						// an overrun error.
 	bool doReceive();
 
+	// host-side receive buffer; one bulk kernel read fills it and
+	// doReceive() hands bytes to the guest FIFO from here
+	int rx_bulk[SERIAL_BULK_MAX];
+	Bitu rx_bulk_in;
+	Bitu rx_bulk_out;
+
 #if SERIAL_DEBUG
 	bool dbgmsg_poll_block;
 	bool dbgmsg_rx_block;
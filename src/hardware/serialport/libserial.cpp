@@ -215,9 +215,30 @@ int SERIAL_getextchar(COMPORT port) {
 	return retval;
 }
 
+int SERIAL_getextchars(COMPORT port, int* buf, int count) {
+	DWORD errors = 0;
+	DWORD dwRead = 0;
+	char chunk[SERIAL_BULK_MAX];
+
+	if (count > SERIAL_BULK_MAX) count = SERIAL_BULK_MAX;
+	if (!ReadFile(port->porthandle, chunk, count, &dwRead, NULL)) return 0;
+	if (!dwRead) return 0;
+	ClearCommError(port->porthandle, &errors, NULL);
+	errors &= CE_BREAK|CE_FRAME|CE_RXPARITY|CE_OVERRUN;
+	int stored = 0;
+	for (DWORD i = 0; i < dwRead; i++) {
+		int retval = 0x10000 | (chunk[i] & 0xff);
+		// the API only reports line errors per request, not per byte;
+		// attach them to the first one like the single-char path does
+		if (i == 0) retval |= (errors<<8);
+		buf[stored++] = retval;
+	}
+	return stored;
+}
+
 bool SERIAL_setCommParameters(COMPORT port,
 			int baudrate, char parity, int stopbits, int length) {
-	
+
 	DCB dcb;
 	dcb.DCBlength=sizeof(dcb);
 	GetCommState(port->porthandle,&dcb);
@@ -277,6 +298,9 @@ struct _COMPORT {
 	int porthandle;
 	bool breakstatus;
 	termios backup;
+	/* raw bytes of a PARMRK escape that got split across bulk reads */
+	unsigned char pend[3];
+	int pend_cnt;
 };
 
 bool SERIAL_open(const char* portname, COMPORT* port) {
@@ -286,6 +310,7 @@ bool SERIAL_open(const char* portname, COMPORT* port) {
 	if(cp == NULL) return false;
 
 	cp->breakstatus=false;
+	cp->pend_cnt=0;
 
 	size_t len = strlen(portname);
 	if(len > 240) {
@@ -403,9 +428,51 @@ int SERIAL_getextchar(COMPORT port) {
 	return retval;
 }
 
+int SERIAL_getextchars(COMPORT port, int* buf, int count) {
+	unsigned char chunk[SERIAL_BULK_MAX + 3];
+
+	// unfinished escape from the previous call goes first
+	int avail = port->pend_cnt;
+	memcpy(chunk, port->pend, avail);
+	port->pend_cnt = 0;
+
+	if (count > SERIAL_BULK_MAX) count = SERIAL_BULK_MAX;
+	int dwRead = read(port->porthandle, chunk + avail, count);
+	if (dwRead > 0) avail += dwRead;
+
+	int stored = 0;
+	int i = 0;
+	while (i < avail && stored < count) {
+		unsigned char error = 0;
+		unsigned char ch = chunk[i];
+		if (ch == 0xff) {
+			// PARMRK escapes: ff ff is a literal ff, ff 00 xx flags
+			// a break (xx=0) or a framing error on xx
+			if (i + 1 >= avail) break;
+			if (chunk[i+1] == 0x00) {
+				if (i + 2 >= avail) break;
+				ch = chunk[i+2];
+				error = ch ? SERIAL_FRAMING_ERR : SERIAL_BREAK_ERR;
+				i += 3;
+			} else {
+				ch = chunk[i+1];
+				i += 2;
+			}
+		} else i++;
+		buf[stored++] = 0x10000 | (error<<8) | ch;
+	}
+	// keep an unfinished escape for the next call (at most 2 bytes,
+	// 3 when the entry limit cut the loop short)
+	if (i < avail) {
+		port->pend_cnt = avail - i;
+		memcpy(port->pend, chunk + i, port->pend_cnt);
+	}
+	return stored;
+}
+
 bool SERIAL_setCommParameters(COMPORT port,
 			int baudrate, char parity, int stopbits, int length) {
-	
+
 	termios termInfo;
 	int result = tcgetattr(port->porthandle, &termInfo);
 	if (result==-1) return false;
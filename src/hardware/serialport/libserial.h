@@ -54,3 +54,8 @@ bool SERIAL_sendchar(COMPORT port, char data);
 #define SERIAL_OVERRUN_ERR 0x02
 
 int SERIAL_getextchar(COMPORT port);
+
+// bulk receive: one kernel read, up to count entries in the same format
+// as SERIAL_getextchar; returns the number of entries stored in buf
+#define SERIAL_BULK_MAX 1024
+int SERIAL_getextchars(COMPORT port, int* buf, int count);
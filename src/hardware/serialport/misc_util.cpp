@@ -149,6 +149,14 @@ bool TCPClientSocket::GetRemoteAddressString(Bit8u* buffer) {
 }
 
 bool TCPClientSocket::ReceiveArray(Bit8u* data, Bitu* size) {
+	// drain anything GetcharNonBlock already pulled off the wire
+	if (recvbufferindex < recvbuffersize) {
+		Bitu got = 0;
+		while (got < *size && recvbufferindex < recvbuffersize)
+			data[got++] = recvbuffer[recvbufferindex++];
+		*size = got;
+		return true;
+	}
 	if(SDLNet_CheckSockets(listensocketset,0))
 	{
 		Bits retval = SDLNet_TCP_Recv(mysock, data, static_cast<int>(*size));
@@ -172,17 +180,20 @@ Bits TCPClientSocket::GetcharNonBlock() {
 // -1: no data
 // -2: socket closed
 // 0..255: data
-	Bits rvalue = -1;
-	if(SDLNet_CheckSockets(listensocketset,0))
-	{
-		char data = 0;
-		if (SDLNet_TCP_Recv(mysock, &data, 1) != 1) {
-			isopen = false;
-			rvalue = -2;
-		} else
-			rvalue = static_cast<Bits>(data);
+	if (recvbufferindex < recvbuffersize)
+		return static_cast<Bits>(recvbuffer[recvbufferindex++]);
+	// refill with one readiness check and one bulk read; polling a
+	// byte at a time cost a select() plus recv() per character
+	if (!SDLNet_CheckSockets(listensocketset, 0))
+		return -1;
+	Bits retval = SDLNet_TCP_Recv(mysock, recvbuffer, sizeof(recvbuffer));
+	if (retval < 1) {
+		isopen = false;
+		return -2;
 	}
-	return rvalue;
+	recvbuffersize = static_cast<Bitu>(retval);
+	recvbufferindex = 1;
+	return static_cast<Bits>(recvbuffer[0]);
 }
 
 bool TCPClientSocket::Putchar(Bit8u data)
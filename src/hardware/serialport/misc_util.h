@@ -112,6 +112,12 @@ private:
 	Bitu sendbuffersize = 0;
 	Bitu sendbufferindex = 0;
 	Bit8u *sendbuffer = nullptr;
+
+	// Receive buffering: one readiness check and one bulk read fill
+	// this, instead of a select() and recv() round trip per byte
+	Bit8u recvbuffer[1024];
+	Bitu recvbuffersize = 0;
+	Bitu recvbufferindex = 0;
 };
 
 struct TCPServerSocket {
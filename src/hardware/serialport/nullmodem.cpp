@@ -42,6 +42,7 @@ CNullModem::CNullModem(Bitu id, CommandLine* cmd):CSerial (id, cmd) {
 	
 	dtrrespect=false;
 	tx_block=false;
+	tx_wrote=false;
 	receiveblock=false;
 	transparent=false;
 	telnet=false;
@@ -80,10 +81,20 @@ CNullModem::CNullModem(Bitu id, CommandLine* cmd):CSerial (id, cmd) {
 	}
 	// txdelay: How many milliseconds to wait before sending data.
 	// This reduces network overhead quite a lot.
-	if (getBituSubstring("txdelay:", &tx_gather, cmd)) {
-		if (!(tx_gather<=500)) {
-			tx_gather=12;
+	Bitu tx_temp=0;
+	if (getBituSubstring("txdelay:", &tx_temp, cmd)) {
+		if (!(tx_temp<=500)) {
+			tx_temp=12;
 		}
+		tx_gather=(float)tx_temp;
+	}
+	// txdelayus: the same window in microseconds, for interactive
+	// protocols where a whole millisecond of gathering is too coarse.
+	if (getBituSubstring("txdelayus:", &tx_temp, cmd)) {
+		if (!(tx_temp<=500000)) {
+			tx_temp=12000;
+		}
+		tx_gather=(float)tx_temp/1000.0f;
 	}
 	// port is for both server and client
 	if (getBituSubstring("port:", &temptcpport, cmd)) {
@@ -163,9 +174,10 @@ CNullModem::~CNullModem() {
 
 void CNullModem::WriteChar(Bit8u data) {
 	if (clientsocket)clientsocket->SendByteBuffered(data);
+	tx_wrote=true;
 	if (!tx_block) {
 		//LOG_MSG("setevreduct");
-		setEvent(SERIAL_TX_REDUCTION, (float)tx_gather);
+		setEvent(SERIAL_TX_REDUCTION, tx_gather);
 		tx_block=true;
 	}
 }
@@ -379,7 +391,16 @@ void CNullModem::handleUpperEvent(Bit16u type) {
 					setEvent(SERIAL_RX_EVENT, bytetime*0.9f);
 				}
 			}
+			tx_wrote=false;
 			ByteTransmitted();
+			// the guest had nothing further queued: flush now
+			// instead of letting the tail of a burst wait out
+			// the rest of the gather window
+			if (tx_block && !tx_wrote) {
+				if (clientsocket) clientsocket->FlushBuffer();
+				removeEvent(SERIAL_TX_REDUCTION);
+				tx_block=false;
+			}
 			break;
 		}
 		case SERIAL_THR_EVENT: {
@@ -80,13 +80,18 @@ private:
 	bool tx_block;		// true while the SERIAL_TX_REDUCTION event
 						// is pending
 
+	bool tx_wrote;		// a byte entered the send buffer during the
+						// current TX event; cleared to detect when
+						// the guest has nothing more queued
+
 	Bitu rx_retry;		// counter of retries
 
 	Bitu rx_retry_max;	// how many POLL_EVENTS to wait before causing
 						// a overrun error.
 
-	Bitu tx_gather;		// how long to gather tx data before
-						// sending all of them [milliseconds]
+	float tx_gather;	// how long to gather tx data before
+						// sending all of them [milliseconds,
+						// may be fractional]
 
 	
 	bool dtrrespect;	// dtr behavior - only send data to the serial
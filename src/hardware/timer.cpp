@@ -21,6 +21,7 @@
 #include "dosbox.h"
 #include "inout.h"
 #include "pic.h"
+#include "cpu.h"
 #include "mem.h"
 #include "mixer.h"
 #include "timer.h"
@@ -78,23 +79,49 @@ static void PIT0_Event(Bitu /*val*/) {
 	}
 }
 
+/* Elapsed pit clocks since p->start, in 32.32 fixed point. The millisecond
+   part only changes once per emulated tick and is cached per counter, so the
+   calibration loops that hammer port 0x40 pay one integer multiply and shift
+   over the in-tick cycle count instead of the old float division chain */
+struct PIT_ReadCache {
+	double start;				/* p->start the base was computed against */
+	Bitu tick;				/* PIC_Ticks the base was computed for */
+	Bit64s base;				/* pit clocks from start to that tick, 32.32 */
+};
+static PIT_ReadCache pit_cache[3]={{-1.0,0,0},{-1.0,0,0},{-1.0,0,0}};
+static Bit32s pit_cycle_mult_for=-1;
+static Bit64u pit_cycle_mult;		/* pit clocks per cpu cycle, 32.32 */
+
+static INLINE Bit64u counter_elapsed(Bitu counter,PIT_Block * p) {
+	PIT_ReadCache & cache=pit_cache[counter];
+	if (GCC_UNLIKELY(cache.tick!=PIC_Ticks || cache.start!=p->start)) {
+		cache.base=(Bit64s)(((double)PIC_Ticks-p->start)*(PIT_TICK_RATE/1000.0)*4294967296.0);
+		cache.tick=PIC_Ticks;
+		cache.start=p->start;
+	}
+	if (GCC_UNLIKELY(CPU_CycleMax!=pit_cycle_mult_for)) {
+		pit_cycle_mult_for=CPU_CycleMax;
+		pit_cycle_mult=(Bit64u)((PIT_TICK_RATE*4294967296.0)/(1000.0*(double)pit_cycle_mult_for));
+	}
+	Bit64s cycles_done=(Bit64s)CPU_CycleMax-CPU_CycleLeft-CPU_Cycles;
+	if (cycles_done<0) cycles_done=0;
+	Bit64s elapsed=cache.base+(Bit64s)((Bit64u)cycles_done*pit_cycle_mult);
+	if (elapsed<0) elapsed=0;
+	return (Bit64u)elapsed>>32;
+}
+
 static bool counter_output(Bitu counter) {
 	PIT_Block * p=&pit[counter];
-	double index=PIC_FullIndex()-p->start;
 	switch (p->mode) {
 	case 0:
 		if (p->new_mode) return false;
-		if (index>p->delay) return true;
-		else return false;
-		break;
+		return counter_elapsed(counter,p)>p->cntr;
 	case 2:
 		if (p->new_mode) return true;
-		index=fmod(index,(double)p->delay);
-		return index>0;
+		return (counter_elapsed(counter,p)%p->cntr)>0;
 	case 3:
 		if (p->new_mode) return true;
-		index=fmod(index,(double)p->delay);
-		return index*2<p->delay;
+		return (counter_elapsed(counter,p)%p->cntr)*2<p->cntr;
 	case 4:
 		//Only low on terminal count
 		// if(fmod(index,(double)p->delay) == 0) return false; //Maybe take one rate tick in consideration
@@ -139,48 +166,42 @@ static void counter_latch(Bitu counter) {
 	//If gate2 is disabled don't update the read_latch
 	if (counter == 2 && !gate2 && p->mode !=1) return;
 	if (GCC_UNLIKELY(p->new_mode)) {
-		double passed_time = PIC_FullIndex() - p->start;
-		Bitu ticks_since_then = (Bitu)(passed_time / (1000.0/PIT_TICK_RATE));
 		//if (p->mode==3) ticks_since_then /= 2; // TODO figure this out on real hardware
-		p->read_latch -= ticks_since_then;
+		p->read_latch -= (Bit16u)counter_elapsed(counter,p);
 		return;
 	}
-	double index=PIC_FullIndex()-p->start;
+	Bit64u ticks=counter_elapsed(counter,p);
 	switch (p->mode) {
 	case 4:		/* Software Triggered Strobe */
 	case 0:		/* Interrupt on Terminal Count */
 		/* Counter keeps on counting after passing terminal count */
-		if (index>p->delay) {
-			index-=p->delay;
+		if (ticks>p->cntr) {
+			ticks-=p->cntr;
 			if(p->bcd) {
-				index = fmod(index,(1000.0/PIT_TICK_RATE)*10000.0);
-				p->read_latch = (Bit16u)(9999-index*(PIT_TICK_RATE/1000.0));
+				p->read_latch = (Bit16u)(9999-ticks%10000);
 			} else {
-				index = fmod(index,(1000.0/PIT_TICK_RATE)*(double)0x10000);
-				p->read_latch = (Bit16u)(0xffff-index*(PIT_TICK_RATE/1000.0));
+				p->read_latch = (Bit16u)(0xffff-ticks%0x10000);
 			}
 		} else {
-			p->read_latch=(Bit16u)(p->cntr-index*(PIT_TICK_RATE/1000.0));
+			p->read_latch=(Bit16u)(p->cntr-ticks);
 		}
 		break;
 	case 1: // countdown
 		if(p->counting) {
-			if (index>p->delay) { // has timed out
+			if (ticks>p->cntr) { // has timed out
 				p->read_latch = 0xffff; //unconfirmed
 			} else {
-				p->read_latch=(Bit16u)(p->cntr-index*(PIT_TICK_RATE/1000.0));
+				p->read_latch=(Bit16u)(p->cntr-ticks);
 			}
 		}
 		break;
 	case 2:		/* Rate Generator */
-		index=fmod(index,(double)p->delay);
-		p->read_latch=(Bit16u)(p->cntr - (index/p->delay)*p->cntr);
+		p->read_latch=(Bit16u)(p->cntr - ticks%p->cntr);
 		break;
 	case 3:		/* Square Wave Rate Generator */
-		index=fmod(index,(double)p->delay);
-		index*=2;
-		if (index>p->delay) index-=p->delay;
-		p->read_latch=(Bit16u)(p->cntr - (index/p->delay)*p->cntr);
+		ticks=(ticks%p->cntr)*2;
+		if (ticks>p->cntr) ticks-=p->cntr;
+		p->read_latch=(Bit16u)(p->cntr - ticks);
 		// In mode 3 it never returns odd numbers LSB (if odd number is written 1 will be
 		// subtracted on first clock and then always 2)
 		// fixes "Corncob 3D"
@@ -406,19 +427,19 @@ bool TIMER_GetOutput2(void) {
 	return counter_output(2);
 }
 
+// the PIT always sits on 0x40-0x43; counter 1 (RAM refresh) is
+// read-only for us, the control word port is write-only
+static const IO_PortMapEntry pit_portmap[] = {
+	{ 0x40,1,IO_MB,read_latch,write_latch },
+	{ 0x41,1,IO_MB,read_latch,NULL },
+	{ 0x42,1,IO_MB,read_latch,write_latch },
+	{ 0x43,1,IO_MB,NULL,write_p43 },
+};
+
 class TIMER:public Module_base{
-private:
-	IO_ReadHandleObject ReadHandler[4];
-	IO_WriteHandleObject WriteHandler[4];
 public:
 	TIMER(Section* configuration):Module_base(configuration){
-		WriteHandler[0].Install(0x40,write_latch,IO_MB);
-	//	WriteHandler[1].Install(0x41,write_latch,IO_MB);
-		WriteHandler[2].Install(0x42,write_latch,IO_MB);
-		WriteHandler[3].Install(0x43,write_p43,IO_MB);
-		ReadHandler[0].Install(0x40,read_latch,IO_MB);
-		ReadHandler[1].Install(0x41,read_latch,IO_MB);
-		ReadHandler[2].Install(0x42,read_latch,IO_MB);
+		IO_RegisterPortMap(pit_portmap,sizeof(pit_portmap)/sizeof(pit_portmap[0]));
 		/* Setup Timer 0 */
 		pit[0].cntr=0x10000;
 		pit[0].write_state = 3;
@@ -460,6 +481,7 @@ public:
 	}
 	~TIMER(){
 		PIC_RemoveEvents(PIT0_Event);
+		IO_FreePortMap(pit_portmap,sizeof(pit_portmap)/sizeof(pit_portmap[0]));
 	}
 };
 static TIMER* test;
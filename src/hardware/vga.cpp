@@ -31,6 +31,7 @@ Bit32u CGA_2_Table[16];
 Bit32u CGA_4_Table[256];
 Bit32u CGA_4_HiRes_Table[256];
 Bit32u CGA_16_Table[256];
+Bit32u CGA16_Comp_Table[256];
 Bit32u TXT_Font_Table[16];
 Bit32u TXT_FG_Table[16];
 Bit32u TXT_BG_Table[16];
@@ -195,6 +196,18 @@ void VGA_Init(Section* sec) {
 	for (i=0;i<256;i++) {
 		ExpandTable[i]=i | (i << 8)| (i <<16) | (i << 24);
 	}
+	/* composite output: four hdots per dword, each determined by an
+	   8-bit window (four 2-bit groups) of the video bit stream; the
+	   palette entries behind the 0xc0708030 position codes are set up
+	   by update_cga16_color in vga_other.cpp */
+	for (i=0;i<256;i++) {
+		Bitu g0=(i>>6)&3,g1=(i>>4)&3,g2=(i>>2)&3,g3=i&3;
+		CGA16_Comp_Table[i]=0xc0708030 |
+			((g0<<2)|g1) |
+			(((g0<<4)|(g1<<2)|g2)<<8) |
+			(((g1<<2)|g2)<<16) |
+			(((g1<<4)|(g2<<2)|g3)<<24);
+	}
 	for (i=0;i<16;i++) {
 		TXT_FG_Table[i]=i | (i << 8)| (i <<16) | (i << 24);
 		TXT_BG_Table[i]=i | (i << 8)| (i <<16) | (i << 24);
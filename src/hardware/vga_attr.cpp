@@ -90,6 +90,17 @@ void VGA_ATTR_SetPalette(Bit8u index, Bit8u val) {
 	VGA_DAC_CombineColor(index,val);
 }
 
+// Recombining all 16 entries on every write to the color select/plane
+// enable registers is wasted work when games reprogram them per
+// scanline; the writers just set palette_reload and the recombine runs
+// once per drawn line (or before anything reads the combined state).
+void VGA_ATTR_FlushPalette(void) {
+	if (!vga.attr.palette_reload) return;
+	vga.attr.palette_reload=false;
+	for (Bit8u i=0;i<0x10;i++)
+		VGA_ATTR_SetPalette(i,vga.attr.palette[i]);
+}
+
 Bitu read_p3c0(Bitu /*port*/,Bitu /*iolen*/) {
 	// Wcharts, Win 3.11 & 95 SVGA
 	Bitu retval = attr(index) & 0x1f;
@@ -98,6 +109,7 @@ Bitu read_p3c0(Bitu /*port*/,Bitu /*iolen*/) {
 }
  
 void write_p3c0(Bitu /*port*/,Bitu val,Bitu iolen) {
+	vga.draw.change_count++;
 	if (!vga.internal.attrindex) {
 		attr(index)=val & 0x1F;
 		vga.internal.attrindex=true;
@@ -128,10 +140,7 @@ void write_p3c0(Bitu /*port*/,Bitu val,Bitu iolen) {
 			Bitu difference = attr(mode_control)^val;
 			attr(mode_control)=(Bit8u)val;
 
-			if (difference & 0x80) {
-				for (Bit8u i=0;i<0x10;i++)
-					VGA_ATTR_SetPalette(i,vga.attr.palette[i]);
-			}
+			if (difference & 0x80) vga.attr.palette_reload=true;
 			if (difference & 0x08)
 				VGA_SetBlinking(val & 0x8);
 			
@@ -178,8 +187,7 @@ void write_p3c0(Bitu /*port*/,Bitu val,Bitu iolen) {
 			if ((attr(color_plane_enable)^val) & 0xf) {
 				// in case the plane enable bits change...
 				attr(color_plane_enable)=(Bit8u)val;
-				for (Bit8u i=0;i<0x10;i++)
-					VGA_ATTR_SetPalette(i,vga.attr.palette[i]);
+				vga.attr.palette_reload=true;
 			} else
 				attr(color_plane_enable)=(Bit8u)val;
 			/* 
@@ -235,8 +243,7 @@ void write_p3c0(Bitu /*port*/,Bitu val,Bitu iolen) {
 			}
 			if (attr(color_select) ^ val) {
 				attr(color_select)=(Bit8u)val;
-				for (Bit8u i=0;i<0x10;i++)
-					VGA_ATTR_SetPalette(i,vga.attr.palette[i]);
+				vga.attr.palette_reload=true;
 			}
 			/*
 				0-1	If 3C0h index 10h bit 7 is set these 2 bits are used as bits 4-5 of
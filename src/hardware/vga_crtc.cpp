@@ -45,6 +45,7 @@ Bitu vga_read_p3d4(Bitu port,Bitu iolen) {
 
 void vga_write_p3d5(Bitu port,Bitu val,Bitu iolen) {
 //	if (crtc(index)>0x18) LOG_MSG("VGA CRCT write %X to reg %X",val,crtc(index));
+	vga.draw.change_count++;	// start address, cursor etc. alter the picture
 	switch(crtc(index)) {
 	case 0x00:	/* Horizontal Total Register */
 		if (crtc(read_only)) break;
@@ -52,6 +52,7 @@ Note:  Each read or write of this register will cycle through first the
 enum {DAC_READ,DAC_WRITE};
 
 static void VGA_DAC_SendColor( Bitu index, Bitu src ) {
+	vga.draw.change_count++;
 	const Bit8u red = vga.dac.rgb[src].red;
 	const Bit8u green = vga.dac.rgb[src].green;
 	const Bit8u blue = vga.dac.rgb[src].blue;
@@ -132,6 +133,7 @@ static void write_p3c9(Bitu port,Bitu val,Bitu iolen) {
 			break;
 		default:
 			/* Check for attributes and DAC entry link */
+			VGA_ATTR_FlushPalette();	// combine table must be current
 			for (Bitu i=0;i<16;i++) {
 				if (vga.dac.combine[i]==vga.dac.write_index) {
 					VGA_DAC_SendColor( i, vga.dac.write_index );
@@ -192,7 +194,8 @@ void VGA_DAC_SetEntry(Bitu entry,Bit8u red,Bit8u green,Bit8u blue) {
 	vga.dac.rgb[entry].red=red;
 	vga.dac.rgb[entry].green=green;
 	vga.dac.rgb[entry].blue=blue;
-	for (Bitu i=0;i<16;i++) 
+	VGA_ATTR_FlushPalette();	// combine table must be current
+	for (Bitu i=0;i<16;i++)
 		if (vga.dac.combine[i]==entry)
 			VGA_DAC_SendColor( i, i );
 }
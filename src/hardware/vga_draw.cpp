@@ -31,6 +31,28 @@
 //#define LOG(X,Y) LOG_MSG
 
 #define VGA_PARTS 4
+// upper bound on frames skipped in a row when nothing changed, so the
+// output recovers quickly from window/scaler events we don't track
+#define VGA_CHANGE_MAX_AGE 8
+
+#if defined(__GNUC__)
+// start pulling in the next scanline's vram while the current one is scaled
+#define VGA_PREFETCH(_PTR_) __builtin_prefetch(_PTR_)
+#else
+#define VGA_PREFETCH(_PTR_)
+#endif
+
+/* byte-shuffle kernels for the CGA-style line converters; the scalar
+   table loops remain as tail handling and fallback */
+#if !defined(WORDS_BIGENDIAN)
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#define VGA_DRAW_SIMD 1
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define VGA_DRAW_SIMD 2
+#endif
+#endif
 
 typedef Bit8u * (* VGA_Line_Handler)(Bitu vidstart, Bitu line);
 
@@ -51,7 +73,55 @@ static Bit8u * VGA_Draw_1BPP_Line(Bitu vidstart, Bitu line) {
 static Bit8u * VGA_Draw_2BPP_Line(Bitu vidstart, Bitu line) {
 	const Bit8u *base = vga.tandy.draw_base + ((line & vga.tandy.line_mask) << vga.tandy.line_shift);
 	Bit32u * draw=(Bit32u *)TempLine;
-	for (Bitu x=0;x<vga.draw.blocks;x++) {
+	Bitu x = vga.draw.blocks;
+#ifdef VGA_DRAW_SIMD
+	/* expand 16 source bytes (64 pixels) per step as long as the line
+	   doesn't wrap; the 4-color palette comes out of CGA_4_Table's
+	   identity entry and is applied with a byte shuffle */
+	if (((vidstart & vga.tandy.addr_mask) + x) <= vga.tandy.addr_mask + 1) {
+		const Bit8u *src = base + (vidstart & vga.tandy.addr_mask);
+#if VGA_DRAW_SIMD == 1
+		const __m128i pal = _mm_set1_epi32((int)CGA_4_Table[0x1b]);
+		const __m128i mask3 = _mm_set1_epi8(3);
+		while (x >= 16) {
+			__m128i v = _mm_loadu_si128((const __m128i*)src);
+			__m128i p0 = _mm_and_si128(_mm_srli_epi16(v,6), mask3);
+			__m128i p1 = _mm_and_si128(_mm_srli_epi16(v,4), mask3);
+			__m128i p2 = _mm_and_si128(_mm_srli_epi16(v,2), mask3);
+			__m128i p3 = _mm_and_si128(v, mask3);
+			__m128i t02l = _mm_unpacklo_epi8(p0,p2);
+			__m128i t02h = _mm_unpackhi_epi8(p0,p2);
+			__m128i t13l = _mm_unpacklo_epi8(p1,p3);
+			__m128i t13h = _mm_unpackhi_epi8(p1,p3);
+			_mm_storeu_si128((__m128i*)(draw+ 0), _mm_shuffle_epi8(pal,_mm_unpacklo_epi8(t02l,t13l)));
+			_mm_storeu_si128((__m128i*)(draw+ 4), _mm_shuffle_epi8(pal,_mm_unpackhi_epi8(t02l,t13l)));
+			_mm_storeu_si128((__m128i*)(draw+ 8), _mm_shuffle_epi8(pal,_mm_unpacklo_epi8(t02h,t13h)));
+			_mm_storeu_si128((__m128i*)(draw+12), _mm_shuffle_epi8(pal,_mm_unpackhi_epi8(t02h,t13h)));
+			draw += 16; src += 16; vidstart += 16; x -= 16;
+		}
+#elif VGA_DRAW_SIMD == 2
+		const uint8x16_t pal = vreinterpretq_u8_u32(vdupq_n_u32(CGA_4_Table[0x1b]));
+		const uint8x16_t mask3 = vdupq_n_u8(3);
+		while (x >= 16) {
+			uint8x16_t v = vld1q_u8(src);
+			uint8x16_t p0 = vandq_u8(vshrq_n_u8(v,6), mask3);
+			uint8x16_t p1 = vandq_u8(vshrq_n_u8(v,4), mask3);
+			uint8x16_t p2 = vandq_u8(vshrq_n_u8(v,2), mask3);
+			uint8x16_t p3 = vandq_u8(v, mask3);
+			uint8x16x2_t t02 = vzipq_u8(p0,p2);
+			uint8x16x2_t t13 = vzipq_u8(p1,p3);
+			uint8x16x2_t lo = vzipq_u8(t02.val[0], t13.val[0]);
+			uint8x16x2_t hi = vzipq_u8(t02.val[1], t13.val[1]);
+			vst1q_u8((Bit8u*)draw     , vqtbl1q_u8(pal, lo.val[0]));
+			vst1q_u8((Bit8u*)draw + 16, vqtbl1q_u8(pal, lo.val[1]));
+			vst1q_u8((Bit8u*)draw + 32, vqtbl1q_u8(pal, hi.val[0]));
+			vst1q_u8((Bit8u*)draw + 48, vqtbl1q_u8(pal, hi.val[1]));
+			draw += 16; src += 16; vidstart += 16; x -= 16;
+		}
+#endif
+	}
+#endif
+	for (;x>0;x--) {
 		Bitu val = base[vidstart & vga.tandy.addr_mask];
 		vidstart++;
 		*draw++=CGA_4_Table[val];
@@ -73,8 +143,6 @@ static Bit8u * VGA_Draw_2BPPHiRes_Line(Bitu vidstart, Bitu line) {
 	return TempLine;
 }
 
-static Bitu temp[643]={0};
-
 static Bit8u * VGA_Draw_CGA16_Line(Bitu vidstart, Bitu line) {
 	const Bit8u *base = vga.tandy.draw_base + ((line & vga.tandy.line_mask) << vga.tandy.line_shift);
 #define CGA16_READER(OFF) (base[(vidstart +(OFF))& (8*1024 -1)])
@@ -86,21 +154,19 @@ static Bit8u * VGA_Draw_CGA16_Line(Bitu vidstart, Bitu line) {
 	//modes. We always assume 6 and use duplicate palette entries in
 	//1-hdot-per-pixel modes so that we can use the same routine for all
 	//composite modes.
-  temp[1] = (CGA16_READER(0) >> 6) & 3;
-	for(Bitu x = 2; x < 640; x+=2) {
-		temp[x] = (temp[x-1] & 0xf);
-		temp[x+1] = (temp[x] << 2) | ((( CGA16_READER(x>>3)) >> (6-(x&6)) )&3);
-	}
-	temp[640] = temp[639] & 0xf;
-	temp[641] = temp[640] << 2;
-	temp[642] = temp[641] & 0xf;
-
-	Bitu i = 2;
+	//Four hdots only ever depend on an 8-bit window of the video bit
+	//stream, so CGA16_Comp_Table turns a window into a whole dword of
+	//palette indices; each source byte yields two dwords. The zero
+	//bytes on either end match what the old per-hdot chain produced
+	//when it started empty and ran off the line.
+	Bit8u prev = 0;
+	Bit8u cur = CGA16_READER(0);
 	for (Bitu x=0;x<vga.draw.blocks;x++) {
-		*draw++ = 0xc0708030 | temp[i] | (temp[i+1] << 8) | (temp[i+2] << 16) | (temp[i+3] << 24);
-		i += 4;
-		*draw++ = 0xc0708030 | temp[i] | (temp[i+1] << 8) | (temp[i+2] << 16) | (temp[i+3] << 24);
-		i += 4;
+		const Bit8u next = (x+1<vga.draw.blocks) ? CGA16_READER(x+1) : 0;
+		*draw++ = CGA16_Comp_Table[((prev&0x03)<<6) | (cur>>2)];
+		*draw++ = CGA16_Comp_Table[((cur&0x3f)<<2) | (next>>6)];
+		prev = cur;
+		cur = next;
 	}
 	return TempLine;
 #undef CGA16_READER
@@ -379,6 +445,46 @@ static const Bit8u* VGA_Text_Memwrap(Bitu vidstart) {
 	} else return &vga.tandy.draw_base[vidstart];
 }
 
+/* Pull the visible text screen out of video memory, using the same
+   addressing the text line drawers above use (start, scan length and
+   wrap mask), so panning and page flipping are honoured. */
+Bitu VGA_GetTextScreen(char * buffer,Bitu buflen,Bitu * cols,Bit32u * seq) {
+	if (vga.mode != M_TEXT && vga.mode != M_TANDY_TEXT && vga.mode != M_HERC_TEXT)
+		return 0;
+	const Bitu width = vga.draw.blocks;
+	Bitu rows = vga.draw.address_line_total ?
+		vga.draw.lines_total / vga.draw.address_line_total : 0;
+	if (!width || !rows)
+		return 0;
+	if (rows * width > buflen)
+		rows = buflen / width;
+	Bitu address = vga.config.real_start;
+	if (vga.mode == M_TEXT) address += vga.draw.bytes_skip;
+	address *= 2;
+	char * out = buffer;
+	Bit32u hash = 2166136261u;
+	for (Bitu r = 0; r < rows; r++) {
+		const Bitu row_addr = address + r * vga.draw.address_add;
+		for (Bitu c = 0; c < width; c++) {
+			Bit8u chr = vga.tandy.draw_base[(row_addr + c*2) & vga.draw.linear_mask];
+			if (!chr) chr = ' ';
+			*out++ = (char)chr;
+			hash = (hash ^ chr) * 16777619u;
+		}
+	}
+	*cols = width;
+	if (seq) {
+		static Bit32u last_hash = 0;
+		static Bit32u sequence = 0;
+		if (hash != last_hash) {
+			last_hash = hash;
+			sequence++;
+		}
+		*seq = sequence;
+	}
+	return rows;
+}
+
 static Bit32u FontMask[2]={0xffffffff,0x0};
 static Bit8u * VGA_TEXT_Draw_Line(Bitu vidstart, Bitu line) {
 	Bits font_addr;
@@ -523,20 +629,114 @@ static Bit8u* VGA_TEXT_Draw_Line(Bitu vidstart, Bitu line) {
 	return TempLine+16;
 }
 */
+
+/* Cell-granular cache for the 16bpp VGA text renderer. Each character
+   row's cells are snapshotted when it is rendered; on later frames a
+   row whose cells, cursor overlap, font and colors are unchanged is
+   served from the previously rendered scanlines instead of running
+   the glyph loop again. On a mostly static text screen only the
+   cursor's row re-renders. */
+#define TEXT_CACHE_MAXROWS 64
+#define TEXT_CACHE_MAXCOLS 133	// 132-column SVGA text plus the panning cell
+#define TEXT_CACHE_PITCH (TEXT_CACHE_MAXCOLS * 9 + 32)	// in Bit16u
+
+static struct TextCache {
+	bool active;		// rows may be served/filled this frame
+	bool rowclean;		// the current row comes from the cache
+	Bits row;			// row the current scanline belongs to
+	Bitu lastline;		// previous line value, to spot row starts
+	Bit16u *pixels;		// rendered scanlines, TEXT_CACHE_PITCH apart
+	Bitu alloc_lines;
+	bool rowknown[TEXT_CACHE_MAXROWS];
+	Bit32u rowcursor[TEXT_CACHE_MAXROWS];	// cursor cell rendered into the row
+	Bit8u cells[TEXT_CACHE_MAXROWS][TEXT_CACHE_MAXCOLS * 2];
+	/* frame-global state; a change in any of it invalidates all rows */
+	Bit8u font[2][256 * 32];
+	Bit16u xlat[256];
+	Bitu blocks, panning, line_total, underline;
+	Bitu blink, blinking, char9dot, linegfx, sline, eline;
+} text_cache;
+
+/* Pre-expanded glyph cells for the same renderer: the final 8/9 pixels
+   of (character, attribute, font line), so repeated cells become a
+   small memcpy instead of the bit-by-bit expansion loop. Entries are
+   keyed to the text cache generation, which bumps whenever the font,
+   palette or any glyph-affecting state changes. */
+#define GLYPH_CACHE_SIZE 4096	// direct-mapped, power of two
+#define GLYPH_CACHE_HASH(chr,attr,line) \
+	(((chr) + (attr) * 257 + (line) * 8191) & (GLYPH_CACHE_SIZE - 1))
+
+static struct GlyphCacheEntry {
+	Bit32u key;		// chr | attr<<8 | line<<16
+	Bit32u gen;
+	Bit16u pixels[9];
+} glyph_cache[GLYPH_CACHE_SIZE];
+static Bit32u glyph_generation = 1;	// entries start out invalid
+
+static void TEXT_CacheCheckRow(Bitu vidstart) {
+	text_cache.row++;
+	if (text_cache.row >= TEXT_CACHE_MAXROWS) {
+		text_cache.active = false;
+		return;
+	}
+	Bitu r = (Bitu)text_cache.row;
+	const Bit8u* vidmem = VGA_Text_Memwrap(vidstart);
+	Bitu cellbytes = (vga.draw.blocks + (vga.draw.panning ? 1 : 0)) * 2;
+	Bit32u cursor = 0;
+	if (vga.draw.cursor.enabled && (vga.draw.cursor.count & 0x10)) {
+		Bits attr_addr = ((Bits)vga.draw.cursor.address - (Bits)vidstart) >> 1;
+		if (attr_addr >= 0 && attr_addr < (Bits)vga.draw.blocks)
+			cursor = (Bit32u)(attr_addr + 1);
+	}
+	if (text_cache.rowknown[r] && text_cache.rowcursor[r] == cursor &&
+		!memcmp(text_cache.cells[r], vidmem, cellbytes)) {
+		text_cache.rowclean = true;
+		return;
+	}
+	memcpy(text_cache.cells[r], vidmem, cellbytes);
+	text_cache.rowcursor[r] = cursor;
+	text_cache.rowknown[r] = true;
+	text_cache.rowclean = false;
+}
+
 // combined 8/9-dot wide text mode 16bpp line drawing function
 static Bit8u* VGA_TEXT_Xlat16_Draw_Line(Bitu vidstart, Bitu line) {
+	Bit16u* base = (Bit16u*)TempLine;
+	if (text_cache.active) {
+		// line only ever decreases (or repeats, for one-line rows)
+		// at the start of the next character row
+		if (line <= text_cache.lastline) TEXT_CacheCheckRow(vidstart);
+		text_cache.lastline = line;
+	}
+	if (text_cache.active) {
+		Bitu slot = (Bitu)text_cache.row * vga.draw.address_line_total + line;
+		if (slot < text_cache.alloc_lines) {
+			base = text_cache.pixels + slot * TEXT_CACHE_PITCH;
+			if (text_cache.rowclean) return (Bit8u*)(base + 16);
+		} else text_cache.active = false;
+	}
 	// keep it aligned:
-	Bit16u* draw = ((Bit16u*)TempLine) + 16 - vga.draw.panning;
+	Bit16u* draw = base + 16 - vga.draw.panning;
 	const Bit8u* vidmem = VGA_Text_Memwrap(vidstart); // pointer to chars+attribs
 	Bitu blocks = vga.draw.blocks;
 	if (vga.draw.panning) blocks++; // if the text is panned part of an 
 									// additional character becomes visible
+	const Bitu width = vga.draw.char9dot ? 9 : 8;
 	while (blocks--) { // for each character in the line
 		Bitu chr = *vidmem++;
 		Bitu attr = *vidmem++;
+		GlyphCacheEntry *glyph =
+			&glyph_cache[GLYPH_CACHE_HASH(chr, attr, line)];
+		Bit32u key = (Bit32u)(chr | (attr << 8) | (line << 16));
+		if (glyph->key == key && glyph->gen == glyph_generation) {
+			memcpy(draw, glyph->pixels, width * sizeof(Bit16u));
+			draw += width;
+			continue;
+		}
+		Bit16u *cell = draw;
 		// the font pattern
 		Bitu font = vga.draw.font_tables[(attr >> 3)&1][(chr<<5)+line];
-		
+
 		Bitu background = attr >> 4;
 		// if blinking is enabled bit7 is not mapped to attributes
 		if (vga.draw.blinking) background &= ~0x8;
@@ -562,6 +762,9 @@ static Bit8u* VGA_TEXT_Xlat16_Draw_Line(Bitu vidstart, Bitu line) {
 				font <<= 1;
 			}
 		}
+		memcpy(glyph->pixels, cell, width * sizeof(Bit16u));
+		glyph->key = key;
+		glyph->gen = glyph_generation;
 	}
 	// draw the text mode cursor if needed
 	if ((vga.draw.cursor.count&0x10) && (line >= vga.draw.cursor.sline) &&
@@ -569,16 +772,61 @@ static Bit8u* VGA_TEXT_Xlat16_Draw_Line(Bitu vidstart, Bitu line) {
 		// the adress of the attribute that makes up the cell the cursor is in
 		Bits attr_addr = (vga.draw.cursor.address-vidstart) >> 1;
 		if (attr_addr >= 0 && attr_addr < (Bits)vga.draw.blocks) {
-			Bitu index = attr_addr * (vga.draw.char9dot? 18:16);
-			draw = (Bit16u*)(&TempLine[index]) + 16 - vga.draw.panning;
-			
+			Bitu index = attr_addr * (vga.draw.char9dot? 9:8);
+			draw = base + index + 16 - vga.draw.panning;
+
 			Bitu foreground = vga.tandy.draw_base[vga.draw.cursor.address+1] & 0xf;
 			for (Bitu i = 0; i < 8; i++) {
 				*draw++ = vga.dac.xlat16[foreground];
 			}
 		}
 	}
-	return TempLine+32;
+	return (Bit8u*)(base+16);
+}
+
+static void TEXT_CacheStartFrame(void) {
+	text_cache.active = false;
+	if (VGA_DrawLine != VGA_TEXT_Xlat16_Draw_Line) return;
+	bool flush = false;
+#define TEXT_CACHE_STATE(field,value) \
+	if (text_cache.field != (Bitu)(value)) { text_cache.field = (Bitu)(value); flush = true; }
+	TEXT_CACHE_STATE(blocks, vga.draw.blocks)
+	TEXT_CACHE_STATE(panning, vga.draw.panning)
+	TEXT_CACHE_STATE(line_total, vga.draw.address_line_total)
+	TEXT_CACHE_STATE(underline, vga.crtc.underline_location & 0x1f)
+	TEXT_CACHE_STATE(blink, vga.draw.blink)
+	TEXT_CACHE_STATE(blinking, vga.draw.blinking)
+	TEXT_CACHE_STATE(char9dot, vga.draw.char9dot)
+	TEXT_CACHE_STATE(linegfx, vga.attr.mode_control & 0x04)
+	TEXT_CACHE_STATE(sline, vga.draw.cursor.sline)
+	TEXT_CACHE_STATE(eline, vga.draw.cursor.eline)
+#undef TEXT_CACHE_STATE
+	for (Bitu i = 0; i < 2; i++) {
+		if (memcmp(text_cache.font[i], vga.draw.font_tables[i], sizeof(text_cache.font[i]))) {
+			memcpy(text_cache.font[i], vga.draw.font_tables[i], sizeof(text_cache.font[i]));
+			flush = true;
+		}
+	}
+	if (memcmp(text_cache.xlat, vga.dac.xlat16, sizeof(text_cache.xlat))) {
+		memcpy(text_cache.xlat, vga.dac.xlat16, sizeof(text_cache.xlat));
+		flush = true;
+	}
+	if (flush) {
+		memset(text_cache.rowknown, 0, sizeof(text_cache.rowknown));
+		glyph_generation++;
+	}
+	if (vga.draw.blocks + 1 > TEXT_CACHE_MAXCOLS) return;
+	// split screens reuse row slots; don't bother caching those frames
+	if (vga.draw.split_line < vga.draw.lines_total) return;
+	if (!text_cache.pixels || text_cache.alloc_lines < vga.draw.lines_total) {
+		delete [] text_cache.pixels;
+		text_cache.pixels = new Bit16u[TEXT_CACHE_PITCH * vga.draw.lines_total];
+		text_cache.alloc_lines = vga.draw.lines_total;
+		memset(text_cache.rowknown, 0, sizeof(text_cache.rowknown));
+	}
+	text_cache.row = -1;
+	text_cache.lastline = (Bitu)~0;
+	text_cache.active = true;
 }
 
 #ifdef VGA_KEEP_CHANGES
@@ -617,6 +865,8 @@ static void VGA_ProcessSplit() {
 
 static Bit8u bg_color_index = 0; // screen-off black index
 static void VGA_DrawSingleLine(Bitu /*blah*/) {
+	VGA_FlushChainedWrites();
+	VGA_ATTR_FlushPalette();
 	if (GCC_UNLIKELY(vga.attr.disabled)) {
 		switch(machine) {
 		case MCH_PCJR:
@@ -688,6 +938,7 @@ static void VGA_DrawSingleLine(Bitu /*blah*/) {
 }
 
 static void VGA_DrawEGASingleLine(Bitu /*blah*/) {
+	VGA_ATTR_FlushPalette();
 	if (GCC_UNLIKELY(vga.attr.disabled)) {
 		memset(TempLine, 0, sizeof(TempLine));
 		RENDER_DrawLine(TempLine);
@@ -711,8 +962,18 @@ static void VGA_DrawEGASingleLine(Bitu /*blah*/) {
 }
 
 static void VGA_DrawPart(Bitu lines) {
+	VGA_FlushChainedWrites();
+	VGA_ATTR_FlushPalette();
 	while (lines--) {
 		Bit8u * data=VGA_DrawLine( vga.draw.address, vga.draw.address_line );
+		if (lines && (vga.draw.address_line+1>=vga.draw.address_line_total)) {
+			// the next line reads fresh vram (doubled lines come out of
+			// the cache anyway); overlap the fetch with the scaling below
+			const Bit8u * next = &vga.draw.linear_base[(vga.draw.address+vga.draw.address_add) & vga.draw.linear_mask];
+			VGA_PREFETCH(next);
+			VGA_PREFETCH(next + 64);
+			VGA_PREFETCH(next + 128);
+		}
 		RENDER_DrawLine(data);
 		vga.draw.address_line++;
 		if (vga.draw.address_line>=vga.draw.address_line_total) {
@@ -800,9 +1061,54 @@ static void VGA_PanningLatch(Bitu /*val*/) {
 	vga.draw.panning = vga.config.pel_panning;
 }
 
+/* Modes whose video memory sits in the tlb as plain ram, where the frame
+   content can only be judged by looking at it */
+static bool VGA_FrameHashApplicable(void) {
+	switch (vga.mode) {
+	case M_VGA:
+	case M_LIN8:
+	case M_LIN15:
+	case M_LIN16:
+	case M_LIN32:
+		return vga.draw.linear_base == vga.mem.linear;
+	default:
+		return false;
+	}
+}
+
+/* Hash the span of video memory the coming frame scans out. Eight bytes
+   per multiply keeps this far cheaper than rendering; covering a little
+   too much only costs a false change, never a missed one. */
+static Bit64u VGA_HashScanout(void) {
+	Bitu start = ((vga.config.real_start + vga.draw.bytes_skip) * 4 +
+		vga.draw.panning) & (vga.vmemwrap - 1);
+	Bitu span = vga.draw.address_add * vga.draw.lines_total;
+	if (span > vga.vmemwrap) span = vga.vmemwrap;
+	Bit64u hash = (Bit64u)0xcbf29ce484222325ULL;
+	while (span) {
+		Bitu chunk = vga.vmemwrap - start;
+		if (chunk > span) chunk = span;
+		const Bit8u * p = &vga.mem.linear[start];
+		Bitu n = chunk;
+		while (n >= 8) {
+			Bit64u v;
+			memcpy(&v, p, 8);
+			hash = (hash ^ v) * (Bit64u)0x100000001b3ULL;
+			p += 8;
+			n -= 8;
+		}
+		while (n--) hash = (hash ^ *p++) * (Bit64u)0x100000001b3ULL;
+		span -= chunk;
+		start = 0;
+	}
+	return hash;
+}
+
 static void VGA_VerticalTimer(Bitu /*val*/) {
 	vga.draw.delay.framestart = PIC_FullIndex();
-	PIC_AddEvent( VGA_VerticalTimer, (float)vga.draw.delay.vtotal );
+	// the pacing correction only moves the frame start; vga.draw.delay
+	// itself is untouched so guest-visible retrace timing stays exact
+	PIC_AddEvent( VGA_VerticalTimer, (float)(vga.draw.delay.vtotal + GFX_GetFramePacingAdjust( vga.draw.delay.vtotal )) );
 	
 	switch(machine) {
 	case MCH_PCJR:
@@ -837,8 +1143,33 @@ static void VGA_VerticalTimer(Bitu /*val*/) {
 
 	//Check if we can actually render, else skip the rest (frameskip)
 	vga.draw.cursor.count++; // Do this here, else the cursor speed depends on the frameskip
-	if (vga.draw.vga_override || !RENDER_StartUpdate())
+	if (vga.draw.vga_override)
+		return;
+	// blink state (count&0x10) is part of the picture, a toggle counts as a change
+	if ((vga.draw.cursor.enabled || vga.draw.blinking) && !(vga.draw.cursor.count & 0xf))
+		vga.draw.change_count++;
+	// if nothing that can alter the picture was touched since the last
+	// rendered frame, skip reading, scaling and uploading it entirely
+	if (vga.draw.change_tracked && !RENDER_GetForceUpdate() &&
+		(vga.draw.change_count == vga.draw.change_drawn) &&
+		(++vga.draw.change_age < VGA_CHANGE_MAX_AGE))
+		return;
+	// direct-mapped linear modes have no write tracking (the lfb pages
+	// sit in the tlb as plain ram); a cheap hash over the scanned-out
+	// span catches idle screens there instead
+	if (!vga.draw.change_tracked && VGA_FrameHashApplicable()) {
+		const Bit64u hash = VGA_HashScanout();
+		if (!RENDER_GetForceUpdate() &&
+			(vga.draw.change_count == vga.draw.change_drawn) &&
+			(++vga.draw.change_age < VGA_CHANGE_MAX_AGE) &&
+			(hash == vga.draw.frame_hash))
+			return;
+		vga.draw.frame_hash = hash;
+	}
+	if (!RENDER_StartUpdate())
 		return;
+	vga.draw.change_drawn = vga.draw.change_count;
+	vga.draw.change_age = 0;
 
 	vga.draw.address_line = vga.config.hlines_skip;
 	if (IS_EGAVGA_ARCH) {
@@ -912,6 +1243,7 @@ static void VGA_VerticalTimer(Bitu /*val*/) {
 		 * and false. Otherwise it's true */
 		vga.draw.blink = ((vga.draw.blinking & (vga.draw.cursor.count >> 4))
 			|| !vga.draw.blinking) ? true:false;
+		TEXT_CacheStartFrame();
 		break;
 	case M_HERC_GFX:
 	case M_CGA4:case M_CGA2:
@@ -1579,6 +1911,7 @@ void VGA_SetupDrawing(Bitu /*val*/) {
 		vga.draw.delay.vrstart,vga.draw.delay.vrend);
 #endif
 
+	vga.draw.change_count++;	// timing/mode changes need a fresh frame
 	// need to resize the output window?
 	if ((width != vga.draw.width) ||
 		(height != vga.draw.height) ||
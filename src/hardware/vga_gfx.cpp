@@ -33,6 +33,7 @@ static Bitu read_p3ce(Bitu port,Bitu iolen) {
 }
 
 static void write_p3cf(Bitu port,Bitu val,Bitu iolen) {
+	vga.draw.change_count++;
 	switch (gfx(index)) {
 	case 0:	/* Set/Reset Register */
 		gfx(set_reset)=val & 0x0f;
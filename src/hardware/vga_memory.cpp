@@ -26,6 +26,7 @@
 #include "pic.h"
 #include "inout.h"
 #include "setup.h"
+#include "memarena.h"
 
 
 #ifndef C_VGARAM_CHECKED
@@ -50,7 +51,8 @@
 #define MEM_CHANGED( _MEM ) vga.changes.map[ (_MEM) >> VGA_CHANGE_SHIFT ] |= vga.changes.writeMask;
 //#define MEM_CHANGED( _MEM ) vga.changes.map[ (_MEM) >> VGA_CHANGE_SHIFT ] = 1;
 #else
-#define MEM_CHANGED( _MEM ) 
+// no change map, but still note that the frame needs redrawing
+#define MEM_CHANGED( _MEM ) vga.draw.change_count++;
 #endif
 
 #define TANDY_VIDBASE(_X_)  &MemBase[ 0x80000 + (_X_)]
@@ -322,6 +324,44 @@ public:
 	}
 };
 
+/* Write combining for the chained VGA handler: runs of sequential byte
+ * writes (the rep stosb/movsb blitters of mode 13h titles) are collected
+ * here and applied with wide stores. The run is flushed before anything can
+ * observe video memory: reads and wide writes through the handler, handler
+ * reinstallation, and the renderer (VGA_FlushChainedWrites in vga_draw). */
+#define VGA_WC_SIZE 64
+static struct {
+	PhysPt start;  // translated linear address of the first pending byte
+	Bitu len;      // pending bytes; 0 when the buffer is empty
+	Bit8u data[VGA_WC_SIZE];
+} vga_wc = {0,0,{0}};
+
+static void VGA_WC_Flush(void) {
+	if (!vga_wc.len) return;
+	MEM_CHANGED( vga_wc.start );
+	MEM_CHANGED( vga_wc.start + vga_wc.len - 1 );
+	for (Bitu i=0;i<vga_wc.len;) {
+		const PhysPt addr = vga_wc.start + i;
+		// the bytes of one chain-4 group stay contiguous in planar memory
+		Bitu chunk = 4 - (addr & 3);
+		if (chunk > vga_wc.len - i) chunk = vga_wc.len - i;
+		memcpy( &vga.mem.linear[((addr&~3)<<2)+(addr&3)], &vga_wc.data[i], chunk );
+		i += chunk;
+	}
+	memcpy( &vga.fastmem[vga_wc.start], vga_wc.data, vga_wc.len );
+	if (GCC_UNLIKELY(vga_wc.start < 320)) {
+		// And replicate the first line
+		Bitu repeat = 320 - vga_wc.start;
+		if (repeat > vga_wc.len) repeat = vga_wc.len;
+		memcpy( &vga.fastmem[vga_wc.start+64*1024], vga_wc.data, repeat );
+	}
+	vga_wc.len = 0;
+}
+
+void VGA_FlushChainedWrites(void) {
+	VGA_WC_Flush();
+}
+
 //Slighly unusual version, will directly write 8,16,32 bits values
 class VGA_ChainedVGA_Handler : public PageHandler {
 public:
@@ -346,12 +386,14 @@ public:
 		hostWrite<Size>( &vga.mem.linear[((addr&~3)<<2)+(addr&3)], val );
 	}
 	Bitu readb(PhysPt addr ) {
+		if (GCC_UNLIKELY(vga_wc.len)) VGA_WC_Flush();
 		addr = PAGING_GetPhysicalAddress(addr) & vgapages.mask;
 		addr += vga.svga.bank_read_full;
 		addr = CHECKED(addr);
 		return readHandler<Bit8u>( addr );
 	}
 	Bitu readw(PhysPt addr ) {
+		if (GCC_UNLIKELY(vga_wc.len)) VGA_WC_Flush();
 		addr = PAGING_GetPhysicalAddress(addr) & vgapages.mask;
 		addr += vga.svga.bank_read_full;
 		addr = CHECKED(addr);
@@ -363,6 +405,7 @@ public:
 			return readHandler<Bit16u>( addr );
 	}
 	Bitu readd(PhysPt addr ) {
+		if (GCC_UNLIKELY(vga_wc.len)) VGA_WC_Flush();
 		addr = PAGING_GetPhysicalAddress(addr) & vgapages.mask;
 		addr += vga.svga.bank_read_full;
 		addr = CHECKED(addr);
@@ -379,11 +422,20 @@ public:
 		addr = PAGING_GetPhysicalAddress(addr) & vgapages.mask;
 		addr += vga.svga.bank_write_full;
 		addr = CHECKED(addr);
-		MEM_CHANGED( addr );
-		writeHandler<Bit8u>( addr, val );
-		writeCache<Bit8u>( addr, val );
+		// Combine sequential byte writes into a run, applied on flush
+		if (vga_wc.len) {
+			if (addr == vga_wc.start + vga_wc.len && vga_wc.len < VGA_WC_SIZE) {
+				vga_wc.data[vga_wc.len++] = (Bit8u)val;
+				return;
+			}
+			VGA_WC_Flush();
+		}
+		vga_wc.start = addr;
+		vga_wc.data[0] = (Bit8u)val;
+		vga_wc.len = 1;
 	}
 	void writew(PhysPt addr,Bitu val) {
+		if (GCC_UNLIKELY(vga_wc.len)) VGA_WC_Flush();
 		addr = PAGING_GetPhysicalAddress(addr) & vgapages.mask;
 		addr += vga.svga.bank_write_full;
 		addr = CHECKED(addr);
@@ -398,6 +450,7 @@ public:
 		writeCache<Bit16u>( addr, val );
 	}
 	void writed(PhysPt addr,Bitu val) {
+		if (GCC_UNLIKELY(vga_wc.len)) VGA_WC_Flush();
 		addr = PAGING_GetPhysicalAddress(addr) & vgapages.mask;
 		addr += vga.svga.bank_write_full;
 		addr = CHECKED(addr);
@@ -478,7 +531,7 @@ public:
 	}
 	void writeb(PhysPt addr,Bitu val){
 		addr = PAGING_GetPhysicalAddress(addr) & vgapages.mask;
-		
+		MEM_CHANGED( addr );
 		if (GCC_LIKELY(vga.seq.map_mask == 0x4)) {
 			vga.draw.font[addr]=(Bit8u)val;
 		} else {
@@ -787,9 +840,15 @@ void VGA_ChangedBank(void) {
 }
 
 void VGA_SetupHandlers(void) {
+	VGA_WC_Flush(); // pending writes must land before handlers change
 	vga.svga.bank_read_full = vga.svga.bank_read*vga.svga.bank_size;
 	vga.svga.bank_write_full = vga.svga.bank_write*vga.svga.bank_size;
 
+	// modes where every write that can show up on screen is seen by a
+	// page handler may skip rendering untouched frames, see vga_draw.cpp
+	vga.draw.change_tracked=false;
+	vga.draw.change_count++;
+
 	PageHandler *newHandler;
 	switch (machine) {
 	case MCH_CGA:
@@ -846,7 +905,8 @@ void VGA_SetupHandlers(void) {
 		return;
 	case M_LIN4:
 		newHandler = &vgaph.lin4;
-		break;	
+		vga.draw.change_tracked=true;
+		break;
 	case M_LIN15:
 	case M_LIN16:
 	case M_LIN32:
@@ -859,9 +919,10 @@ void VGA_SetupHandlers(void) {
 	case M_LIN8:
 	case M_VGA:
 		if (vga.config.chained) {
-			if(vga.config.compatible_chain4)
+			if(vga.config.compatible_chain4) {
 				newHandler = &vgaph.cvga;
-			else 
+				vga.draw.change_tracked=true;
+			} else
 #ifdef VGA_LFB_MAPPED
 				newHandler = &vgaph.map;
 #else
@@ -869,18 +930,23 @@ void VGA_SetupHandlers(void) {
 #endif
 		} else {
 			newHandler = &vgaph.uvga;
+			vga.draw.change_tracked=true;
 		}
 		break;
 	case M_EGA:
-		if (vga.config.chained) 
+		if (vga.config.chained)
 			newHandler = &vgaph.cega;
 		else
 			newHandler = &vgaph.uega;
-		break;	
+		vga.draw.change_tracked=true;
+		break;
 	case M_TEXT:
-		/* Check if we're not in odd/even mode */
-		if (vga.gfx.miscellaneous & 0x2) newHandler = &vgaph.map;
+		/* Check if we're not in odd/even mode; use the tracking handler
+		   instead of the direct mapping so frame skipping keeps working,
+		   text mode writes are too rare to need the fast path */
+		if (vga.gfx.miscellaneous & 0x2) newHandler = &vgaph.changes;
 		else newHandler = &vgaph.text;
+		vga.draw.change_tracked=true;
 		break;
 	case M_CGA4:
 	case M_CGA2:
@@ -923,8 +989,10 @@ void VGA_SetupHandlers(void) {
 		MEM_SetPageHandler( VGA_PAGE_B0, 8, &vgaph.empty );
 		break;
 	}
-	if(svgaCard == SVGA_S3Trio && (vga.s3.ext_mem_ctrl & 0x10))
+	if(svgaCard == SVGA_S3Trio && (vga.s3.ext_mem_ctrl & 0x10)) {
 		MEM_SetPageHandler(VGA_PAGE_A0, 16, &vgaph.mmio);
+		vga.draw.change_tracked=false;	// the blitter writes vram directly
+	}
 range_done:
 	PAGING_ClearTLB();
 }
@@ -941,8 +1009,8 @@ void VGA_StartUpdateLFB(void) {
 }
 
 static void VGA_Memory_ShutDown(Section * /*sec*/) {
-	delete[] vga.mem.linear_orgptr;
-	delete[] vga.fastmem_orgptr;
+	ARENA_Free(vga.mem.linear_orgptr);
+	ARENA_Free(vga.fastmem_orgptr);
 #ifdef VGA_KEEP_CHANGES
 	delete[] vga.changes.map;
 #endif
@@ -957,11 +1025,12 @@ void VGA_SetupMemory(Section* sec) {
 	if (vga_allocsize<512*1024) vga_allocsize=512*1024;
 	// We reserve extra 2K for one scan line
 	vga_allocsize+=2048;
-	vga.mem.linear_orgptr = new Bit8u[vga_allocsize+16];
+	/* arena blocks are zeroed and page aligned, and pages a machine never
+	   touches (a full svga framebuffer in text mode) stay unmapped */
+	vga.mem.linear_orgptr = (Bit8u*)ARENA_Alloc("vga",vga_allocsize+16);
 	vga.mem.linear=(Bit8u*)(((Bitu)vga.mem.linear_orgptr + 16-1) & ~(16-1));
-	memset(vga.mem.linear,0,vga_allocsize);
 
-	vga.fastmem_orgptr = new Bit8u[(vga.vmemsize<<1)+4096+16];
+	vga.fastmem_orgptr = (Bit8u*)ARENA_Alloc("vga",(vga.vmemsize<<1)+4096+16);
 	vga.fastmem=(Bit8u*)(((Bitu)vga.fastmem_orgptr + 16-1) & ~(16-1));
 
 	// In most cases these values stay the same. Assumptions: vmemwrap is power of 2,
@@ -33,6 +33,7 @@ void write_p3c4(Bitu /*port*/,Bitu val,Bitu /*iolen*/) {
 
 void write_p3c5(Bitu /*port*/,Bitu val,Bitu iolen) {
 //	LOG_MSG("SEQ WRITE reg %X val %X",seq(index),val);
+	vga.draw.change_count++;
 	switch(seq(index)) {
 	case 0:		/* Reset */
 		seq(reset)=val;
@@ -101,12 +102,17 @@ void write_p3c5(Bitu /*port*/,Bitu val,Bitu iolen) {
 			3  If set address bit 0-1 selects video memory planes (256 color mode),
 				rather than the Map Mask and Read Map Select Registers.
 		*/
-		seq(memory_mode)=val;
-		if (IS_VGA_ARCH) {
-			/* Changing this means changing the VGA Memory Read/Write Handler */
-			if (val&0x08) vga.config.chained=true;
-			else vga.config.chained=false;
-			VGA_SetupHandlers();
+		{
+			Bit8u changed=seq(memory_mode)^val;
+			seq(memory_mode)=val;
+			if (IS_VGA_ARCH) {
+				/* Changing this means changing the VGA Memory Read/Write Handler */
+				if (val&0x08) vga.config.chained=true;
+				else vga.config.chained=false;
+				// re-registering every page handler is expensive; only
+				// the chaining bit matters to them
+				if (changed&0x08) VGA_SetupHandlers();
+			}
 		}
 		break;
 	default:
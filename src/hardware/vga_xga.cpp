@@ -242,6 +242,99 @@ static Bitu GetMixResult(uint32_t mixmode, Bitu srcval, Bitu dstdata)
 	return destval;
 }
 
+/* Row-at-a-time helpers for the rectangle fill and blit commands.
+   XGA_DrawPoint re-resolves the scissor test, color mode and vram
+   bound for every pixel; these resolve them once per span and leave
+   simple inner loops the compiler can vectorize. */
+
+// clip the span of pixels {x + k*dx, k=0..count-1} against the
+// horizontal scissors; on success x is the left edge of what remains
+static bool XGA_ClipSpan(Bits &x, Bits dx, Bitu &count) {
+	Bits x0 = (dx > 0) ? x : x - (Bits)(count - 1);
+	Bits x1 = (dx > 0) ? x + (Bits)(count - 1) : x;
+	if (x0 < (Bits)xga.scissors.x1) x0 = xga.scissors.x1;
+	if (x1 > (Bits)xga.scissors.x2) x1 = xga.scissors.x2;
+	if (x0 > x1) return false;
+	x = x0;
+	count = (Bitu)(x1 - x0 + 1);
+	return true;
+}
+
+template <class T>
+static inline void XGA_MixSpanT(Bitu memaddr, Bitu len, uint32_t mixmode, Bitu srcval, Bitu mask) {
+	if (GCC_UNLIKELY((memaddr + len) * sizeof(T) > vga.vmemsize)) return;
+	T *p = (T*)vga.mem.linear + memaddr;
+	T v = (T)(srcval & mask);
+	switch (mixmode & 0xf) {
+		case 0x03: /* DST */
+			break;
+		case 0x07: /* SRC */
+			for (Bitu i = 0; i < len; i++) p[i] = v;
+			break;
+		case 0x05: /* SRC xor DST */
+			for (Bitu i = 0; i < len; i++) p[i] = (T)((p[i] ^ v) & mask);
+			break;
+		case 0x0b: /* SRC or DST */
+			for (Bitu i = 0; i < len; i++) p[i] = (T)((p[i] | v) & mask);
+			break;
+		case 0x0c: /* SRC and DST */
+			for (Bitu i = 0; i < len; i++) p[i] = (T)((p[i] & v) & mask);
+			break;
+		default:
+			for (Bitu i = 0; i < len; i++)
+				p[i] = (T)(GetMixResult(mixmode, srcval, p[i]) & mask);
+			break;
+	}
+}
+
+// mix a constant source color into a horizontal span
+static void XGA_MixSpan(Bitu x, Bitu y, Bitu len, uint32_t mixmode, Bitu srcval) {
+	Bitu memaddr = (y * XGA_SCREEN_WIDTH) + x;
+	switch (XGA_COLOR_MODE) {
+		case M_LIN8:  XGA_MixSpanT<Bit8u> (memaddr, len, mixmode, srcval, 0xff); break;
+		case M_LIN15: XGA_MixSpanT<Bit16u>(memaddr, len, mixmode, srcval, 0x7fff); break;
+		case M_LIN16: XGA_MixSpanT<Bit16u>(memaddr, len, mixmode, srcval, 0xffff); break;
+		case M_LIN32: XGA_MixSpanT<Bit32u>(memaddr, len, mixmode, srcval, 0xffffffff); break;
+		default: break;
+	}
+}
+
+// straight span copy; false means out of bounds and nothing was done
+static bool XGA_CopySpan(Bitu sx, Bitu sy, Bitu tx, Bitu ty, Bitu len) {
+	Bitu srcaddr = (sy * XGA_SCREEN_WIDTH) + sx;
+	Bitu dstaddr = (ty * XGA_SCREEN_WIDTH) + tx;
+	switch (XGA_COLOR_MODE) {
+	case M_LIN8:
+		if (GCC_UNLIKELY((srcaddr + len) > vga.vmemsize || (dstaddr + len) > vga.vmemsize))
+			return false;
+		memmove(&vga.mem.linear[dstaddr], &vga.mem.linear[srcaddr], len);
+		return true;
+	case M_LIN15: {
+		if (GCC_UNLIKELY((srcaddr + len) * 2 > vga.vmemsize || (dstaddr + len) * 2 > vga.vmemsize))
+			return false;
+		Bit16u *src = (Bit16u*)vga.mem.linear + srcaddr;
+		Bit16u *dst = (Bit16u*)vga.mem.linear + dstaddr;
+		// the store side drops bit 15, so no memmove; keep overlap
+		// safety by picking the copy direction
+		if (dst > src) for (Bitu i = len; i--;) dst[i] = src[i] & 0x7fff;
+		else for (Bitu i = 0; i < len; i++) dst[i] = src[i] & 0x7fff;
+		return true;
+	}
+	case M_LIN16:
+		if (GCC_UNLIKELY((srcaddr + len) * 2 > vga.vmemsize || (dstaddr + len) * 2 > vga.vmemsize))
+			return false;
+		memmove((Bit16u*)vga.mem.linear + dstaddr, (Bit16u*)vga.mem.linear + srcaddr, len * 2);
+		return true;
+	case M_LIN32:
+		if (GCC_UNLIKELY((srcaddr + len) * 4 > vga.vmemsize || (dstaddr + len) * 4 > vga.vmemsize))
+			return false;
+		memmove((Bit32u*)vga.mem.linear + dstaddr, (Bit32u*)vga.mem.linear + srcaddr, len * 4);
+		return true;
+	default:
+		return false;
+	}
+}
+
 void XGA_DrawLineVector(Bitu val) {
 	Bits xat, yat;
 	Bitu srcval = 0;
@@ -463,6 +556,27 @@ void XGA_DrawRectangle(Bitu val) {
 
 	srcy = xga.cury;
 
+	/* constant-color fills: resolve mix, mode and clip per row
+	   instead of per pixel */
+	if ((((xga.pix_cntl >> 6) & 0x3) == 0) && (((xga.foremix >> 5) & 0x03) < 2)) {
+		if ((xga.curcommand & 0x1) && (xga.curcommand & 0x10)) {
+			Bitu srcval2 = ((xga.foremix >> 5) & 0x03) ? xga.forecolor : xga.backcolor;
+			Bits x = xga.curx;
+			Bitu count = (Bitu)xga.MAPcount + 1;
+			if (XGA_ClipSpan(x, dx, count)) {
+				Bits y = srcy;
+				for (yat = 0; yat <= xga.MIPcount; yat++) {
+					if (y >= (Bits)xga.scissors.y1 && y <= (Bits)xga.scissors.y2)
+						XGA_MixSpan((Bitu)x, (Bitu)y, count, xga.foremix, srcval2);
+					y += dy;
+				}
+			}
+		}
+		xga.curx = (Bit16u)(xga.curx + dx * ((Bits)xga.MAPcount + 1));
+		xga.cury = (Bit16u)(xga.cury + dy * ((Bits)xga.MIPcount + 1));
+		return;
+	}
+
 	for(yat=0;yat<=xga.MIPcount;yat++) {
 		srcx = xga.curx;
 		for (xat = 0; xat <= xga.MAPcount; ++xat) {
@@ -747,6 +861,43 @@ void XGA_BlitRect(Bitu val) {
 	}
 
 
+	/* span fast paths: plain screen-to-screen copies and constant
+	   color mixes cover the blits Windows drivers hammer */
+	if (mixselect == 0x00) {
+		Bitu srcclass = (mixmode >> 5) & 0x03;
+		bool plaincopy = (srcclass == 0x03) && ((mixmode & 0xf) == 0x07);
+		if (srcclass < 2 || plaincopy) {
+			if ((xga.curcommand & 0x1) && (xga.curcommand & 0x10)) {
+				Bits x = xga.destx;
+				Bitu count = (Bitu)xga.MAPcount + 1;
+				if (XGA_ClipSpan(x, dx, count)) {
+					// the source walks in lockstep, so it is just
+					// a constant offset from the target
+					Bits sdx = (Bits)xga.curx - (Bits)xga.destx;
+					Bits sdy = (Bits)xga.cury - (Bits)xga.desty;
+					Bits y = xga.desty;
+					for (yat = 0; yat <= xga.MIPcount; yat++) {
+						if (y >= (Bits)xga.scissors.y1 && y <= (Bits)xga.scissors.y2) {
+							if (!plaincopy) {
+								XGA_MixSpan((Bitu)x, (Bitu)y, count, mixmode,
+									srcclass ? xga.forecolor : xga.backcolor);
+							} else if (!XGA_CopySpan((Bitu)(x + sdx), (Bitu)(y + sdy),
+									(Bitu)x, (Bitu)y, count)) {
+								// vram edge: per-pixel keeps the
+								// out-of-bounds-reads-as-zero behavior
+								for (Bitu i = 0; i < count; i++)
+									XGA_DrawPoint((Bitu)x + i, (Bitu)y,
+										XGA_GetPoint((Bitu)(x + sdx) + i, (Bitu)(y + sdy)));
+							}
+						}
+						y += dy;
+					}
+				}
+			}
+			return;
+		}
+	}
+
 	/* Copy source to video ram */
 	for(yat=0;yat<=xga.MIPcount ;yat++) {
 		srcx = xga.curx;
@@ -1008,7 +1159,7 @@ extern Bitu vga_read_p3d5(Bitu port,Bitu iolen);
 
 void XGA_Write(Bitu port, Bitu val, Bitu len) {
 //	LOG_MSG("XGA: Write to port %x, val %8x, len %x", port,val, len);
-
+	vga.draw.change_count++;	// the blitter writes vram behind the handlers
 	switch(port) {
 		case 0x8100:// drawing control: row (low word), column (high word)
 					// "CUR_X" and "CUR_Y" (see PORT 82E8h,PORT 86E8h)
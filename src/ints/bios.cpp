@@ -494,22 +494,28 @@ static Bitu INT11_Handler(void) {
 
 static void BIOS_HostTimeSync() {
 	Bit32u milli = 0;
+	struct tm *loctime;
+	if (DOSBOX_Deterministic) {
+		/* Same virtual clock as the CMOS RTC */
+		time_t virttime = DOSBOX_DETERMINISTIC_TIME_BASE + (time_t)(PIC_Ticks/1000);
+		loctime = gmtime(&virttime);
+		milli = (Bit32u) (PIC_Ticks % 1000);
+	} else {
 #if defined(DB_HAVE_CLOCK_GETTIME) && ! defined(WIN32)
 	struct timespec tp;
 	clock_gettime(CLOCK_REALTIME,&tp);
-	
-	struct tm *loctime;
+
 	loctime = localtime(&tp.tv_sec);
 	milli = (Bit32u) (tp.tv_nsec / 1000000);
 #else
 	/* Setup time and date */
 	struct timeb timebuffer;
 	ftime(&timebuffer);
-	
-	struct tm *loctime;
+
 	loctime = localtime (&timebuffer.time);
 	milli = (Bit32u) timebuffer.millitm;
 #endif
+	}
 	/*
 	loctime->tm_hour = 23;
 	loctime->tm_min = 59;
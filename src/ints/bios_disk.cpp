@@ -22,6 +22,11 @@
 #include <cassert>
 #include <utility>
 
+#ifndef WIN32
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 #include "dosbox.h"
 #include "callback.h"
 #include "regs.h"
@@ -29,6 +34,8 @@
 #include "dos_inc.h" /* for Drives[] */
 #include "drives.h"
 #include "mapper.h"
+#include "control.h"
+#include "memarena.h"
 
 diskGeo DiskGeometryList[] = {
 	{ 160,  8, 1, 40, 0},
@@ -155,6 +162,69 @@ void swapInNextDisk(bool pressed) {
 }
 
 
+#define DISK_CACHE_WAYS 4
+
+/* The cache is sized in kilobytes, so the entry count depends on the
+   sector size; allocation is deferred until the first FILE* access so
+   Set_Geometry has had its say by then. */
+void imageDisk::CacheAlloc(void) {
+	if (cache_tags || !cache_kb || !sector_size) return;
+	Bitu entries = (cache_kb * 1024) / sector_size;
+	cache_sets = entries / DISK_CACHE_WAYS;
+	if (!cache_sets) { cache_kb = 0; return; }
+	cache_tags = new CacheTag[cache_sets * DISK_CACHE_WAYS];
+	memset(cache_tags, 0, sizeof(CacheTag) * cache_sets * DISK_CACHE_WAYS);
+	/* arena block: zeroed, and ways that never fill stay unresident */
+	cache_data = (Bit8u*)ARENA_Alloc("disk cache", cache_sets * DISK_CACHE_WAYS * sector_size);
+	cache_tick = 0;
+}
+
+void imageDisk::CacheFree(void) {
+	delete [] cache_tags;
+	ARENA_Free(cache_data);
+	cache_tags = NULL;
+	cache_data = NULL;
+	cache_sets = 0;
+}
+
+Bit8u *imageDisk::CacheLookup(Bit32u sectnum) {
+	if (!cache_tags) return NULL;
+	CacheTag *set = &cache_tags[(sectnum % cache_sets) * DISK_CACHE_WAYS];
+	for (Bitu way = 0; way < DISK_CACHE_WAYS; way++) {
+		if (set[way].valid && set[way].sect == sectnum) {
+			set[way].lru = ++cache_tick;
+			return cache_data + ((sectnum % cache_sets) * DISK_CACHE_WAYS + way) * sector_size;
+		}
+	}
+	return NULL;
+}
+
+Bit8u *imageDisk::CacheSlot(Bit32u sectnum) {
+	if (!cache_tags) return NULL;
+	const Bitu base = (sectnum % cache_sets) * DISK_CACHE_WAYS;
+	CacheTag *set = &cache_tags[base];
+	Bitu victim = 0;
+	for (Bitu way = 0; way < DISK_CACHE_WAYS; way++) {
+		if (!set[way].valid) { victim = way; break; }
+		if (set[way].lru < set[victim].lru) victim = way;
+	}
+	set[victim].valid = true;
+	set[victim].sect = sectnum;
+	set[victim].lru = ++cache_tick;
+	return cache_data + (base + victim) * sector_size;
+}
+
+void imageDisk::CacheInvalidate(Bit32u sectnum,Bitu count) {
+	if (!cache_tags) return;
+	for (Bitu i = 0; i < count; i++) {
+		CacheTag *set = &cache_tags[((sectnum + i) % cache_sets) * DISK_CACHE_WAYS];
+		for (Bitu way = 0; way < DISK_CACHE_WAYS; way++) {
+			if (set[way].valid && set[way].sect == sectnum + i)
+				set[way].valid = false;
+		}
+	}
+}
+
 Bit8u imageDisk::Read_Sector(Bit32u head,Bit32u cylinder,Bit32u sector,void * data) {
 	Bit32u sectnum;
 
@@ -168,11 +238,45 @@ Bit8u imageDisk::Read_AbsoluteSector(Bit32u sectnum, void * data) {
 
 	bytenum = sectnum * sector_size;
 
+	if (mmap_base && bytenum + sector_size <= mmap_size) {
+		memcpy(data, mmap_base + bytenum, sector_size);
+		return 0x00;
+	}
+
+	CacheAlloc();
+	Bit8u *cached = CacheLookup(sectnum);
+	if (cached) {
+		memcpy(data, cached, sector_size);
+		return 0x00;
+	}
+
 	if (last_action==WRITE || bytenum!=current_fpos) fseek(diskimg,bytenum,SEEK_SET);
 	size_t ret=fread(data, 1, sector_size, diskimg);
 	current_fpos=bytenum+ret;
 	last_action=READ;
 
+	if (ret == sector_size) {
+		Bit8u *slot = CacheSlot(sectnum);
+		if (slot) memcpy(slot, data, sector_size);
+	}
+
+	return 0x00;
+}
+
+Bit8u imageDisk::Read_AbsoluteSectors(Bit32u sectnum, Bitu count, void * data) {
+	Bit32u bytenum = sectnum * sector_size;
+	Bitu bytes = count * sector_size;
+
+	if (mmap_base && bytenum + bytes <= mmap_size) {
+		memcpy(data, mmap_base + bytenum, bytes);
+		return 0x00;
+	}
+
+	if (last_action==WRITE || bytenum!=current_fpos) fseek(diskimg,bytenum,SEEK_SET);
+	size_t ret=fread(data, 1, bytes, diskimg);
+	current_fpos=bytenum+ret;
+	last_action=READ;
+
 	return 0x00;
 }
 
@@ -192,23 +296,99 @@ Bit8u imageDisk::Write_AbsoluteSector(Bit32u sectnum, void *data) {
 
 	//LOG_MSG("Writing sectors to %ld at bytenum %d", sectnum, bytenum);
 
+#ifndef WIN32
+	if (mmap_base && !mmap_readonly && bytenum + sector_size <= mmap_size) {
+		memcpy(mmap_base + bytenum, data, sector_size);
+		/* schedule writeback of the touched pages so the image stays
+		 * durable without blocking on the host disk for every sector */
+		const size_t page = (size_t)sysconf(_SC_PAGESIZE);
+		const size_t start = (bytenum / page) * page;
+		msync(mmap_base + start, bytenum + sector_size - start, MS_ASYNC);
+		return 0x00;
+	}
+#endif
+
 	if (last_action==READ || bytenum!=current_fpos) fseek(diskimg,bytenum,SEEK_SET);
 	size_t ret=fwrite(data, 1, sector_size, diskimg);
 	current_fpos=bytenum+ret;
 	last_action=WRITE;
 
+	// write-through: keep the sector cached, FAT sectors get re-read a lot
+	if (ret == sector_size) {
+		Bit8u *slot = CacheSlot(sectnum);
+		if (slot) memcpy(slot, data, sector_size);
+	} else {
+		CacheInvalidate(sectnum, 1);
+	}
+
 	return ((ret>0)?0x00:0x05);
 
 }
 
+Bit8u imageDisk::Write_AbsoluteSectors(Bit32u sectnum, Bitu count, void *data) {
+	Bit32u bytenum = sectnum * sector_size;
+	Bitu bytes = count * sector_size;
+
+#ifndef WIN32
+	if (mmap_base && !mmap_readonly && bytenum + bytes <= mmap_size) {
+		memcpy(mmap_base + bytenum, data, bytes);
+		const size_t page = (size_t)sysconf(_SC_PAGESIZE);
+		const size_t start = (bytenum / page) * page;
+		msync(mmap_base + start, bytenum + bytes - start, MS_ASYNC);
+		return 0x00;
+	}
+#endif
+
+	if (last_action==READ || bytenum!=current_fpos) fseek(diskimg,bytenum,SEEK_SET);
+	size_t ret=fwrite(data, 1, bytes, diskimg);
+	current_fpos=bytenum+ret;
+	last_action=WRITE;
+
+	/* bulk transfers stay one host call; just drop any cached copies of
+	   the overwritten sectors (reads need no check - write-through keeps
+	   the file authoritative) */
+	CacheInvalidate(sectnum, count);
+
+	return ((ret>0)?0x00:0x05);
+}
+
 imageDisk::imageDisk(FILE *imgFile, const char *imgName, Bit32u imgSizeK, bool isHardDisk) {
 	heads = 0;
 	cylinders = 0;
 	sectors = 0;
 	sector_size = 512;
+	mmap_base = NULL;
+	mmap_size = 0;
+	mmap_readonly = false;
 	current_fpos = 0;
 	last_action = NONE;
 	diskimg = imgFile;
+	cache_data = NULL;
+	cache_tags = NULL;
+	cache_sets = 0;
+	cache_tick = 0;
+	cache_kb = 512;
+	Section_prop *dos_section = static_cast<Section_prop *>(control->GetSection("dos"));
+	if (dos_section) {
+		int kb = dos_section->Get_int("diskcache");
+		cache_kb = (kb > 0) ? (Bitu)kb : 0;
+	}
+#ifndef WIN32
+	long img_size = 0;
+	if (!fseek(diskimg,0,SEEK_END)) img_size = ftell(diskimg);
+	if (img_size > 0) {
+		void *map = mmap(NULL,(size_t)img_size,PROT_READ|PROT_WRITE,MAP_SHARED,fileno(diskimg),0);
+		if (map == MAP_FAILED) {
+			/* image opened read-only; map it for reads at least */
+			map = mmap(NULL,(size_t)img_size,PROT_READ,MAP_SHARED,fileno(diskimg),0);
+			if (map != MAP_FAILED) mmap_readonly = true;
+		}
+		if (map != MAP_FAILED) {
+			mmap_base = (Bit8u *)map;
+			mmap_size = (size_t)img_size;
+		}
+	}
+#endif
 	fseek(diskimg,0,SEEK_SET);
 	memset(diskname,0,512);
 	safe_strncpy(diskname, imgName, sizeof(diskname));
@@ -240,10 +420,24 @@ imageDisk::imageDisk(FILE *imgFile, const char *imgName, Bit32u imgSizeK, bool i
 	}
 }
 
+imageDisk::~imageDisk() {
+#ifndef WIN32
+	if (mmap_base) {
+		if (!mmap_readonly)
+			msync(mmap_base,mmap_size,MS_SYNC);
+		munmap(mmap_base,mmap_size);
+	}
+#endif
+	CacheFree();
+	if (diskimg != NULL) fclose(diskimg);
+}
+
 void imageDisk::Set_Geometry(Bit32u setHeads, Bit32u setCyl, Bit32u setSect, Bit32u setSectSize) {
 	heads = setHeads;
 	cylinders = setCyl;
 	sectors = setSect;
+	// the cache entry size follows the sector size; resize it lazily
+	if (sector_size != setSectSize) CacheFree();
 	sector_size = setSectSize;
 	active = true;
 }
@@ -312,6 +506,10 @@ static bool has_image(const std::array<T, N> &arr) {
 	return std::any_of(std::begin(arr), std::end(arr), to_bool);
 }
 
+/* staging buffer for whole multi-sector transfers; 128 sectors is the
+   most that can fit in a segment without wrapping over itself */
+static Bit8u bulkbuf[128*512];
+
 static Bitu INT13_DiskHandler(void) {
 	Bit16u segat, bufptr;
 	Bit8u sectbuf[512];
@@ -395,7 +593,25 @@ static Bitu INT13_DiskHandler(void) {
 
 		segat = SegValue(es);
 		bufptr = reg_bx;
-		for (Bitu i = 0; i < reg_al; i++) {
+		if (reg_al && (Bitu)reg_al*imageDiskList[drivenum]->getSectSize()<=sizeof(bulkbuf)) {
+			/* one host read for the whole request, then one block write
+			   into guest memory (two when the offset wraps the segment) */
+			imageDisk * disk=imageDiskList[drivenum].get();
+			Bit32u sectnum=(((Bit32u)(reg_ch | ((reg_cl & 0xc0)<<2))*disk->heads+reg_dh)*disk->sectors)+(reg_cl & 63)-1;
+			Bitu bytes=(Bitu)reg_al*disk->getSectSize();
+			last_status = disk->Read_AbsoluteSectors(sectnum,reg_al,bulkbuf);
+			if((last_status != 0x00) || (killRead)) {
+				LOG_MSG("Error in disk read");
+				killRead = false;
+				reg_ah = 0x04;
+				CALLBACK_SCF(true);
+				return CBRET_NONE;
+			}
+			Bitu first=0x10000-bufptr;
+			if (first>bytes) first=bytes;
+			MEM_BlockWrite(PhysMake(segat,bufptr),bulkbuf,first);
+			if (bytes>first) MEM_BlockWrite(PhysMake(segat,0),bulkbuf+first,bytes-first);
+		} else for (Bitu i = 0; i < reg_al; i++) {
 			last_status = imageDiskList[drivenum]->Read_Sector((Bit32u)reg_dh, (Bit32u)(reg_ch | ((reg_cl & 0xc0)<< 2)), (Bit32u)((reg_cl & 63)+i), sectbuf);
 			if((last_status != 0x00) || (killRead)) {
 				LOG_MSG("Error in disk read");
@@ -419,7 +635,22 @@ static Bitu INT13_DiskHandler(void) {
 			return CBRET_NONE;
 		}
 		bufptr = reg_bx;
-		for (Bitu i = 0; i < reg_al; i++) {
+		if (reg_al && (Bitu)reg_al*imageDiskList[drivenum]->getSectSize()<=sizeof(bulkbuf)) {
+			/* mirror of the bulk read: gather the guest buffer in one or
+			   two block reads and issue a single host write */
+			imageDisk * disk=imageDiskList[drivenum].get();
+			Bit32u sectnum=(((Bit32u)(reg_ch | ((reg_cl & 0xc0)<<2))*disk->heads+reg_dh)*disk->sectors)+(reg_cl & 63)-1;
+			Bitu bytes=(Bitu)reg_al*disk->getSectSize();
+			Bitu first=0x10000-bufptr;
+			if (first>bytes) first=bytes;
+			MEM_BlockRead(PhysMake(SegValue(es),bufptr),bulkbuf,first);
+			if (bytes>first) MEM_BlockRead(PhysMake(SegValue(es),0),bulkbuf+first,bytes-first);
+			last_status = disk->Write_AbsoluteSectors(sectnum,reg_al,bulkbuf);
+			if(last_status != 0x00) {
+				CALLBACK_SCF(true);
+				return CBRET_NONE;
+			}
+		} else for (Bitu i = 0; i < reg_al; i++) {
 			for(t=0;t<imageDiskList[drivenum]->getSectSize();t++) {
 				sectbuf[t] = real_readb(SegValue(es),bufptr);
 				bufptr++;
@@ -464,6 +464,21 @@ static bool IsEnhancedKey(Bit16u &key) {
 	return false;
 }
 
+/* number of consecutive empty blocking polls before the host timeslice
+   is given back, see INT16_IdleWait */
+#define INT16_IDLE_THRESHOLD 16
+
+static Bit32u int16_empty_polls=0;
+
+static void INT16_IdleWait(void) {
+	/* The guest sits in the blocking INT16 wait loop with nothing to do
+	   but take interrupts, re-entering this callback over and over.
+	   After a few empty polls stop burning a full host core on it and
+	   yield, the way a hypervisor parks a polling vcpu; pending IRQs
+	   are serviced as soon as the guest loop resumes. */
+	if (++int16_empty_polls>=INT16_IDLE_THRESHOLD) SDL_Delay(1);
+}
+
 static Bitu INT16_Handler(void) {
 	Bit16u temp=0;
 	switch (reg_ah) {
@@ -471,9 +486,11 @@ static Bitu INT16_Handler(void) {
 		if ((get_key(temp)) && (!IsEnhancedKey(temp))) {
 			/* normal key found, return translated key in ax */
 			reg_ax=temp;
+			int16_empty_polls=0;
 		} else {
 			/* enter small idle loop to allow for irqs to happen */
 			reg_ip+=1;
+			INT16_IdleWait();
 		}
 		break;
 	case 0x10: /* GET KEYSTROKE (enhanced keyboards only) */
@@ -483,9 +500,11 @@ static Bitu INT16_Handler(void) {
 				temp&=0xff00;
 			}
 			reg_ax=temp;
+			int16_empty_polls=0;
 		} else {
 			/* enter small idle loop to allow for irqs to happen */
 			reg_ip+=1;
+			INT16_IdleWait();
 		}
 		break;
 	case 0x01: /* CHECK FOR KEYSTROKE */
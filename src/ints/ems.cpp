@@ -302,9 +302,10 @@ static Bit8u EMM_MapPage(Bitu phys_page,Bit16u handle,Bit16u log_page) {
 		/* Unmapping */
 		emm_mappings[phys_page].handle=NULL_HANDLE;
 		emm_mappings[phys_page].page=NULL_PAGE;
+		Bitu mapping[4];
 		for (Bitu i=0;i<4;i++)
-			PAGING_MapPage(EMM_PAGEFRAME4K+phys_page*4+i,EMM_PAGEFRAME4K+phys_page*4+i);
-		PAGING_ClearTLB();
+			mapping[i]=EMM_PAGEFRAME4K+phys_page*4+i;
+		PAGING_MapPages(EMM_PAGEFRAME4K+phys_page*4,mapping,4);
 		return EMM_NO_ERROR;
 	}
 	/* Check for valid handle */
@@ -315,12 +316,15 @@ static Bit8u EMM_MapPage(Bitu phys_page,Bit16u handle,Bit16u log_page) {
 		emm_mappings[phys_page].handle=handle;
 		emm_mappings[phys_page].page=log_page;
 
-		MemHandle memh=MEM_NextHandleAt(emm_handles[handle].mem,log_page*4);;
+		MemHandle memh=MEM_NextHandleAt(emm_handles[handle].mem,log_page*4);
+		Bitu mapping[4];
 		for (Bitu i=0;i<4;i++) {
-			PAGING_MapPage(EMM_PAGEFRAME4K+phys_page*4+i,memh);
+			mapping[i]=(Bitu)memh;
 			memh=MEM_NextHandle(memh);
 		}
-		PAGING_ClearTLB();
+		/* All four 4k slots of the window flip in one go with just their
+		   own tlb entries invalidated */
+		PAGING_MapPages(EMM_PAGEFRAME4K+phys_page*4,mapping,4);
 		return EMM_NO_ERROR;
 	} else  {
 		/* Illegal logical page it is */
@@ -360,9 +364,10 @@ static Bit8u EMM_MapSegment(Bitu segment,Bit16u handle,Bit16u log_page) {
 				emm_segmentmappings[segment>>10].handle=NULL_HANDLE;
 				emm_segmentmappings[segment>>10].page=NULL_PAGE;
 			}
+			Bitu mapping[4];
 			for (Bitu i=0;i<4;i++)
-				PAGING_MapPage(segment*16/4096+i,segment*16/4096+i);
-			PAGING_ClearTLB();
+				mapping[i]=segment*16/4096+i;
+			PAGING_MapPages(segment*16/4096,mapping,4);
 			return EMM_NO_ERROR;
 		}
 		/* Check for valid handle */
@@ -378,12 +383,13 @@ static Bit8u EMM_MapSegment(Bitu segment,Bit16u handle,Bit16u log_page) {
 				emm_segmentmappings[segment>>10].page=log_page;
 			}
 
-			MemHandle memh=MEM_NextHandleAt(emm_handles[handle].mem,log_page*4);;
+			MemHandle memh=MEM_NextHandleAt(emm_handles[handle].mem,log_page*4);
+			Bitu mapping[4];
 			for (Bitu i=0;i<4;i++) {
-				PAGING_MapPage(segment*16/4096+i,memh);
+				mapping[i]=(Bitu)memh;
 				memh=MEM_NextHandle(memh);
 			}
-			PAGING_ClearTLB();
+			PAGING_MapPages(segment*16/4096,mapping,4);
 			return EMM_NO_ERROR;
 		} else  {
 			/* Illegal logical page it is */
@@ -639,55 +645,50 @@ static uint8_t MemoryRegion()
 	while (region.bytes > 0) {
 		const size_t toread = std::min<size_t>(region.bytes, MEM_PAGE_SIZE);
 
-		/* Read from the source */
+		/* Resolve this chunk into physical spans on both sides; a handle
+		   side splits at its page seam into at most two spans */
+		PhysPt src_pt[2];size_t src_len[2];Bitu src_parts;
+		PhysPt dest_pt[2];size_t dest_len[2];Bitu dest_parts;
 		if (!region.src_type) {
-			MEM_BlockRead(src_mem,buf_src,toread);
+			src_pt[0]=src_mem;src_len[0]=toread;src_parts=1;
+		} else if (toread <= src_remain) {
+			src_pt[0]=(src_handle*MEM_PAGE_SIZE)+src_off;src_len[0]=toread;src_parts=1;
 		} else {
-			assert(toread <= MEM_PAGE_SIZE);
-			if (toread <= src_remain) {
-				MEM_BlockRead((src_handle*MEM_PAGE_SIZE)+src_off,buf_src,toread);
-			} else {
-				MEM_BlockRead((src_handle*MEM_PAGE_SIZE)+src_off,buf_src,src_remain);
-				MEM_BlockRead((MEM_NextHandle(src_handle)*MEM_PAGE_SIZE),&buf_src[src_remain],toread-src_remain);
-			}
+			src_pt[0]=(src_handle*MEM_PAGE_SIZE)+src_off;src_len[0]=src_remain;
+			src_pt[1]=MEM_NextHandle(src_handle)*MEM_PAGE_SIZE;src_len[1]=toread-src_remain;
+			src_parts=2;
 		}
-		/* Check for a move */
-		if (reg_al==1) {
-			/* Read from the destination */
-			if (!region.dest_type) {
-				MEM_BlockRead(dest_mem,buf_dest,toread);
-			} else {
-				assert(toread <= MEM_PAGE_SIZE);
-				if (toread <= dest_remain) {
-					MEM_BlockRead((dest_handle*MEM_PAGE_SIZE)+dest_off,buf_dest,toread);
-				} else {
-					MEM_BlockRead((dest_handle*MEM_PAGE_SIZE)+dest_off,buf_dest,dest_remain);
-					MEM_BlockRead((MEM_NextHandle(dest_handle)*MEM_PAGE_SIZE),&buf_dest[dest_remain],toread-dest_remain);
-				}
-			}
-			/* Write to the source */
-			if (!region.src_type) {
-				MEM_BlockWrite(src_mem,buf_dest,toread);
-			} else {
-				assert(toread <= MEM_PAGE_SIZE);
-				if (toread <= src_remain) {
-					MEM_BlockWrite((src_handle*MEM_PAGE_SIZE)+src_off,buf_dest,toread);
-				} else {
-					MEM_BlockWrite((src_handle*MEM_PAGE_SIZE)+src_off,buf_dest,src_remain);
-					MEM_BlockWrite((MEM_NextHandle(src_handle)*MEM_PAGE_SIZE),&buf_dest[src_remain],toread-src_remain);
-				}
-			}
-		}
-		/* Write to the destination */
 		if (!region.dest_type) {
-			MEM_BlockWrite(dest_mem,buf_src,toread);
+			dest_pt[0]=dest_mem;dest_len[0]=toread;dest_parts=1;
+		} else if (toread <= dest_remain) {
+			dest_pt[0]=(dest_handle*MEM_PAGE_SIZE)+dest_off;dest_len[0]=toread;dest_parts=1;
 		} else {
-			assert(toread <= MEM_PAGE_SIZE);
-			if (toread <= dest_remain) {
-				MEM_BlockWrite((dest_handle*MEM_PAGE_SIZE)+dest_off,buf_src,toread);
-			} else {
-				MEM_BlockWrite((dest_handle*MEM_PAGE_SIZE)+dest_off,buf_src,dest_remain);
-				MEM_BlockWrite((MEM_NextHandle(dest_handle)*MEM_PAGE_SIZE),&buf_src[dest_remain],toread-dest_remain);
+			dest_pt[0]=(dest_handle*MEM_PAGE_SIZE)+dest_off;dest_len[0]=dest_remain;
+			dest_pt[1]=MEM_NextHandle(dest_handle)*MEM_PAGE_SIZE;dest_len[1]=toread-dest_remain;
+			dest_parts=2;
+		}
+
+		if (reg_al==1) {
+			/* An exchange needs bounce buffers for both sides */
+			uint8_t *p;
+			p=buf_src;
+			for (Bitu i=0;i<src_parts;i++) { MEM_BlockRead(src_pt[i],p,src_len[i]);p+=src_len[i]; }
+			p=buf_dest;
+			for (Bitu i=0;i<dest_parts;i++) { MEM_BlockRead(dest_pt[i],p,dest_len[i]);p+=dest_len[i]; }
+			p=buf_dest;
+			for (Bitu i=0;i<src_parts;i++) { MEM_BlockWrite(src_pt[i],p,src_len[i]);p+=src_len[i]; }
+			p=buf_src;
+			for (Bitu i=0;i<dest_parts;i++) { MEM_BlockWrite(dest_pt[i],p,dest_len[i]);p+=dest_len[i]; }
+		} else {
+			/* A plain move copies straight between the spans, walking
+			   both splits in step */
+			Bitu si=0,di=0;size_t soff=0,doff=0,left=toread;
+			while (left) {
+				const size_t n=std::min(src_len[si]-soff,dest_len[di]-doff);
+				mem_memcpy(dest_pt[di]+doff,src_pt[si]+soff,n);
+				soff+=n;doff+=n;left-=n;
+				if (soff==src_len[si]) { si++;soff=0; }
+				if (doff==dest_len[di]) { di++;doff=0; }
 			}
 		}
 		/* Advance the pointers */
@@ -761,6 +761,8 @@ void INT10_Init(Section* /*sec*/) {
 	/* Setup the INT 10 vector */
 	call_10=CALLBACK_Allocate();	
 	CALLBACK_Setup(call_10,&INT10_Handler,CB_IRET,"Int 10 video");
+	// the int 10 handler never stops the loop, let the cores run it in place
+	CALLBACK_SetFast(call_10,true);
 	RealSetVec(0x10,CALLBACK_RealPointer(call_10));
 	//Init the 0x40 segment and init the datastructures in the the video rom area
 	INT10_SetupRomMemory();
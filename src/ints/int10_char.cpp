@@ -179,14 +179,16 @@ static void VGA_FillRow(Bit8u cleft,Bit8u cright,Bit8u row,PhysPt base,Bit8u att
 }
 
 static void TEXT_FillRow(Bit8u cleft,Bit8u cright,Bit8u row,PhysPt base,Bit8u attr) {
-	/* Do some filing */
+	/* Build the row on the host and move it with one page-resolved block
+	   write instead of a paging round trip per cell */
 	PhysPt dest;
 	dest=base+(row*CurMode->twidth+cleft)*2;
 	Bit16u fill=(attr<<8)+' ';
-	for (Bit8u x=0;x<(cright-cleft);x++) {
-		mem_writew(dest,fill);
-		dest+=2;
-	}
+	Bit16u line[256];
+	Bitu copy=(Bitu)(cright-cleft);
+	if (copy>256) copy=256;
+	for (Bitu x=0;x<copy;x++) var_write(&line[x],fill);
+	MEM_BlockWrite(dest,line,copy*2);
 }
 
 
@@ -234,6 +236,17 @@ void INT10_ScrollWindow(Bit8u rul,Bit8u cul,Bit8u rlr,Bit8u clr,Bit8s nlines,Bit
 		nlines=rlr-rul+1;
 		goto filling;
 	}
+	/* Full width text scroll up: the rows are contiguous, move the whole
+	   block in one copy instead of row by row. Scrolling down would need
+	   a backward copy, that direction keeps the per-row loop */
+	if (nlines<0 && CurMode->type==M_TEXT && cul==0 && clr==ncols &&
+			ncols==CurMode->twidth && (rlr-rul+1)>-nlines) {
+		Bit8u blines=(Bit8u)(-nlines);
+		MEM_BlockCopy(base+(rul*CurMode->twidth)*2,
+		              base+((rul+blines)*CurMode->twidth)*2,
+		              (Bitu)(rlr-rul+1-blines)*CurMode->twidth*2);
+		goto filling;
+	}
 	while (start!=end) {
 		start+=next;
 		switch (CurMode->type) {
@@ -615,6 +628,37 @@ void INT10_WriteChar(Bit8u chr,Bit8u attr,Bit8u page,Bit16u count,bool showattr)
 	Bit8u cur_row=CURSOR_POS_ROW(pospage);
 	Bit8u cur_col=CURSOR_POS_COL(pospage);
 	BIOS_NCOLS;
+	if (CurMode->type==M_TEXT && count>1) {
+		/* Repeated cell in text mode: fill each row's run on the host
+		   and move it with one page-resolved block write; rows in the
+		   page are contiguous so the address just keeps running */
+		PhysPt where=CurMode->pstart+page*real_readw(BIOSMEM_SEG,BIOSMEM_PAGE_SIZE)+
+			(cur_row*ncols+cur_col)*2;
+		Bit16u buf[256];
+		while (count>0) {
+			Bitu run=(Bitu)(ncols-cur_col);
+			if (run>count) run=count;
+			if (run>256) run=256;
+			if (showattr) {
+				Bit16u cell=(attr<<8)|chr;
+				for (Bitu x=0;x<run;x++) var_write(&buf[x],cell);
+			} else {
+				/* keep the attribute bytes that are already there */
+				MEM_BlockRead(where,buf,run*2);
+				Bit8u * cells=(Bit8u *)buf;
+				for (Bitu x=0;x<run;x++) cells[x*2]=chr;
+			}
+			MEM_BlockWrite(where,buf,run*2);
+			where+=run*2;
+			count-=(Bit16u)run;
+			cur_col+=(Bit8u)run;
+			if (cur_col>=ncols) {
+				cur_col=0;
+				cur_row++;
+			}
+		}
+		return;
+	}
 	while (count>0) {
 		WriteChar(cur_col,cur_row,page,chr,attr,showattr);
 		count--;
@@ -631,10 +675,11 @@ void INT10_WriteChar(Bit8u chr,Bit8u attr,Bit8u page,Bit16u count,bool showattr)
 	}
 }
 
-static void INT10_TeletypeOutputAttr(Bit8u chr,Bit8u attr,bool useattr,Bit8u page) {
-	BIOS_NCOLS;BIOS_NROWS;
-	Bit8u cur_row=CURSOR_POS_ROW(page);
-	Bit8u cur_col=CURSOR_POS_COL(page);
+/* One teletype character against caller-held coordinates; lets a string
+   of output update the bios cursor and the hardware cursor registers
+   once instead of per character */
+static void TeletypeOutputAttr_Step(Bit8u chr,Bit8u attr,bool useattr,Bit8u page,Bit8u &cur_row,Bit8u &cur_col,Bit16u ncols,Bit16u nrows) {
+	const Bit8u orig_row=cur_row,orig_col=cur_col;
 	switch (chr) {
 	case 7: /* Beep */
 		// Prepare PIT counter 2 for ~900 Hz square wave
@@ -676,12 +721,19 @@ static void INT10_TeletypeOutputAttr(Bit8u chr,Bit8u attr,bool useattr,Bit8u pag
 		Bit8u fill=0;
 		if (CurMode->type==M_TEXT) {
 			Bit16u chat;
-			INT10_ReadCharAttr(&chat,page);
+			ReadCharAttr(orig_col,orig_row,page,&chat);
 			fill=(Bit8u)(chat>>8);
 		}
 		INT10_ScrollWindow(0,0,(Bit8u)(nrows-1),(Bit8u)(ncols-1),-1,fill,page);
 		cur_row--;
 	}
+}
+
+static void INT10_TeletypeOutputAttr(Bit8u chr,Bit8u attr,bool useattr,Bit8u page) {
+	BIOS_NCOLS;BIOS_NROWS;
+	Bit8u cur_row=CURSOR_POS_ROW(page);
+	Bit8u cur_col=CURSOR_POS_COL(page);
+	TeletypeOutputAttr_Step(chr,attr,useattr,page,cur_row,cur_col,ncols,nrows);
 	// Set the cursor for the page
 	INT10_SetCursorPos(cur_row,cur_col,page);
 }
@@ -694,16 +746,32 @@ void INT10_TeletypeOutput(Bit8u chr,Bit8u attr) {
 	INT10_TeletypeOutputAttr(chr,attr,CurMode->type!=M_TEXT);
 }
 
+void INT10_TeletypeOutputStringAttr(Bit8u const * str,Bitu count,Bit8u attr,bool useattr) {
+	/* Whole run against local coordinates; the bios cursor variables and
+	   the crtc cursor registers are only written once at the end */
+	Bit8u page=real_readb(BIOSMEM_SEG,BIOSMEM_CURRENT_PAGE);
+	BIOS_NCOLS;BIOS_NROWS;
+	Bit8u cur_row=CURSOR_POS_ROW(page);
+	Bit8u cur_col=CURSOR_POS_COL(page);
+	while (count--) TeletypeOutputAttr_Step(*str++,attr,useattr,page,cur_row,cur_col,ncols,nrows);
+	INT10_SetCursorPos(cur_row,cur_col,page);
+}
+
 void INT10_WriteString(Bit8u row,Bit8u col,Bit8u flag,Bit8u attr,PhysPt string,Bit16u count,Bit8u page) {
+	BIOS_NCOLS;BIOS_NROWS;
 	Bit8u cur_row=CURSOR_POS_ROW(page);
 	Bit8u cur_col=CURSOR_POS_COL(page);
-	
+
 	// if row=0xff special case : use current cursor position
 	if (row==0xff) {
 		row=cur_row;
 		col=cur_col;
 	}
 	INT10_SetCursorPos(row,col,page);
+	/* Track the position locally and touch the cursor once at the end
+	   instead of a bios update and four crtc port writes per character */
+	Bit8u wr_row=row;
+	Bit8u wr_col=col;
 	while (count>0) {
 		Bit8u chr=mem_readb(string);
 		string++;
@@ -711,10 +779,14 @@ void INT10_WriteString(Bit8u row,Bit8u col,Bit8u flag,Bit8u attr,PhysPt string,B
 			attr=mem_readb(string);
 			string++;
 		};
-		INT10_TeletypeOutputAttr(chr,attr,true,page);
+		// the bell idles the machine, keep the visible cursor honest there
+		if (GCC_UNLIKELY(chr==7)) INT10_SetCursorPos(wr_row,wr_col,page);
+		TeletypeOutputAttr_Step(chr,attr,true,page,wr_row,wr_col,ncols,nrows);
 		count--;
 	}
-	if (!(flag&1)) {
+	if (flag&1) {
+		INT10_SetCursorPos(wr_row,wr_col,page);
+	} else {
 		INT10_SetCursorPos(cur_row,cur_col,page);
 	}
 }
@@ -24,6 +24,38 @@
 static Bit8u cga_masks[4]={0x3f,0xcf,0xf3,0xfc};
 static Bit8u cga_masks2[8]={0x7f,0xbf,0xdf,0xef,0xf7,0xfb,0xfd,0xfe};
 
+/* BASIC-era charting software pushes whole images through these services one
+   pixel at a time, so the mode banking and BIOS variable resolution gets
+   redone for every single pixel.  Remember the resolution of the last call
+   and reuse it while the caller stays on the same mode, page and row; only
+   the x-dependent part of the address is computed per pixel then.  The cheap
+   BDA reads stay in the cache key, so a mode set or a PCJr page flip behind
+   our back still invalidates it. */
+static struct {
+	VideoModeBlock * mode;
+	Bit8u biosmode;
+	Bit8u cpupage;
+	Bit8u page;
+	Bit16u y;
+	Bit16u seg;
+	Bit16u row;
+	PhysPt physrow;
+} pixel_row = { NULL,0,0,0,0,0,0,0 };
+
+static bool PixelRowCached(Bit8u page,Bit16u y) {
+	Bit8u biosmode=real_readb(BIOSMEM_SEG,BIOSMEM_CURRENT_MODE);
+	Bit8u cpupage=(machine==MCH_PCJR) ? real_readb(BIOSMEM_SEG,BIOSMEM_CRTCPU_PAGE) : 0;
+	if (pixel_row.mode==CurMode && pixel_row.biosmode==biosmode &&
+		pixel_row.cpupage==cpupage && pixel_row.page==page && pixel_row.y==y)
+		return true;
+	pixel_row.mode=CurMode;
+	pixel_row.biosmode=biosmode;
+	pixel_row.cpupage=cpupage;
+	pixel_row.page=page;
+	pixel_row.y=y;
+	return false;
+}
+
 void INT10_PutPixel(Bit16u x,Bit16u y,Bit8u page,Bit8u color) {
 	static bool putpixelwarned = false;
 
@@ -83,31 +115,31 @@ void INT10_PutPixel(Bit16u x,Bit16u y,Bit8u page,Bit8u color) {
 		break;
 	case M_TANDY16:
 	{
-		// find out if we are in a 32k mode (0x9 or 0xa)
-		// This requires special handling on the PCJR
-		// because only 16k are mapped at 0xB800
-		bool is_32k = (real_readb(BIOSMEM_SEG, BIOSMEM_CURRENT_MODE) >= 9)?
-			true:false;
-
-		Bit16u segment, offset;
-		if (is_32k) {
-			if (machine==MCH_PCJR) {
-				Bitu cpupage =
-					(real_readb(BIOSMEM_SEG, BIOSMEM_CRTCPU_PAGE) >> 3) & 0x7;
-				segment = cpupage << 10; // A14-16 to addr bits 14-16
-			} else
-				segment = 0xb800;
-			// bits 1 and 0 of y select the bank
-			// two pixels per byte (thus x>>1)
-			offset = (y >> 2) * (CurMode->swidth >> 1) + (x>>1);
-			// select the scanline bank
-			offset += (8*1024) * (y & 3);
-		} else {
-			segment = 0xb800;
-			// bit 0 of y selects the bank
-			offset = (y >> 1) * (CurMode->swidth >> 1) + (x>>1);
-			offset += (8*1024) * (y & 1);
+		if (!PixelRowCached(page,y)) {
+			// find out if we are in a 32k mode (0x9 or 0xa)
+			// This requires special handling on the PCJR
+			// because only 16k are mapped at 0xB800
+			bool is_32k = (pixel_row.biosmode >= 9)?true:false;
+			if (is_32k) {
+				if (machine==MCH_PCJR) {
+					Bitu cpupage = (pixel_row.cpupage >> 3) & 0x7;
+					pixel_row.seg = cpupage << 10; // A14-16 to addr bits 14-16
+				} else
+					pixel_row.seg = 0xb800;
+				// bits 1 and 0 of y select the bank
+				pixel_row.row = (y >> 2) * (CurMode->swidth >> 1);
+				// select the scanline bank
+				pixel_row.row += (8*1024) * (y & 3);
+			} else {
+				pixel_row.seg = 0xb800;
+				// bit 0 of y selects the bank
+				pixel_row.row = (y >> 1) * (CurMode->swidth >> 1);
+				pixel_row.row += (8*1024) * (y & 1);
+			}
 		}
+		// two pixels per byte (thus x>>1)
+		Bit16u segment = pixel_row.seg;
+		Bit16u offset = pixel_row.row + (x>>1);
 
 		// update the pixel
 		Bit8u old=real_readb(segment, offset);
@@ -143,14 +175,17 @@ void INT10_PutPixel(Bit16u x,Bit16u y,Bit8u page,Bit8u color) {
 			IO_Write(0x3ce,0x1);IO_Write(0x3cf,0xf);
 			/* test for xorring */
 			if (color & 0x80) { IO_Write(0x3ce,0x3);IO_Write(0x3cf,0x18); }
-			//Perhaps also set mode 1 
-			/* Calculate where the pixel is in video memory */
-			if (CurMode->plength!=(Bitu)real_readw(BIOSMEM_SEG,BIOSMEM_PAGE_SIZE))
-				LOG(LOG_INT10,LOG_ERROR)("PutPixel_EGA_p: %x!=%x",CurMode->plength,real_readw(BIOSMEM_SEG,BIOSMEM_PAGE_SIZE));
-			if (CurMode->swidth!=(Bitu)real_readw(BIOSMEM_SEG,BIOSMEM_NB_COLS)*8)
-				LOG(LOG_INT10,LOG_ERROR)("PutPixel_EGA_w: %x!=%x",CurMode->swidth,real_readw(BIOSMEM_SEG,BIOSMEM_NB_COLS)*8);
-			PhysPt off=0xa0000+real_readw(BIOSMEM_SEG,BIOSMEM_PAGE_SIZE)*page+
-				((y*real_readw(BIOSMEM_SEG,BIOSMEM_NB_COLS)*8+x)>>3);
+			//Perhaps also set mode 1
+			/* Calculate where the pixel row is in video memory */
+			if (!PixelRowCached(page,y)) {
+				if (CurMode->plength!=(Bitu)real_readw(BIOSMEM_SEG,BIOSMEM_PAGE_SIZE))
+					LOG(LOG_INT10,LOG_ERROR)("PutPixel_EGA_p: %x!=%x",CurMode->plength,real_readw(BIOSMEM_SEG,BIOSMEM_PAGE_SIZE));
+				if (CurMode->swidth!=(Bitu)real_readw(BIOSMEM_SEG,BIOSMEM_NB_COLS)*8)
+					LOG(LOG_INT10,LOG_ERROR)("PutPixel_EGA_w: %x!=%x",CurMode->swidth,real_readw(BIOSMEM_SEG,BIOSMEM_NB_COLS)*8);
+				pixel_row.physrow=0xa0000+real_readw(BIOSMEM_SEG,BIOSMEM_PAGE_SIZE)*page+
+					((y*real_readw(BIOSMEM_SEG,BIOSMEM_NB_COLS)*8)>>3);
+			}
+			PhysPt off=pixel_row.physrow+(x>>3);
 			/* Bitmask and set/reset should do the rest */
 			mem_readb(off);
 			mem_writeb(off,0xff);
@@ -166,10 +201,12 @@ void INT10_PutPixel(Bit16u x,Bit16u y,Bit8u page,Bit8u color) {
 		mem_writeb(PhysMake(0xa000,y*320+x),color);
 		break;
 	case M_LIN8: {
-			if (CurMode->swidth!=(Bitu)real_readw(BIOSMEM_SEG,BIOSMEM_NB_COLS)*8)
-				LOG(LOG_INT10,LOG_ERROR)("PutPixel_VGA_w: %x!=%x",CurMode->swidth,real_readw(BIOSMEM_SEG,BIOSMEM_NB_COLS)*8);
-			PhysPt off=S3_LFB_BASE+y*real_readw(BIOSMEM_SEG,BIOSMEM_NB_COLS)*8+x;
-			mem_writeb(off,color);
+			if (!PixelRowCached(page,y)) {
+				if (CurMode->swidth!=(Bitu)real_readw(BIOSMEM_SEG,BIOSMEM_NB_COLS)*8)
+					LOG(LOG_INT10,LOG_ERROR)("PutPixel_VGA_w: %x!=%x",CurMode->swidth,real_readw(BIOSMEM_SEG,BIOSMEM_NB_COLS)*8);
+				pixel_row.physrow=S3_LFB_BASE+y*real_readw(BIOSMEM_SEG,BIOSMEM_NB_COLS)*8;
+			}
+			mem_writeb(pixel_row.physrow+x,color);
 			break;
 		}
 	default:
@@ -201,33 +238,37 @@ void INT10_GetPixel(Bit16u x,Bit16u y,Bit8u page,Bit8u * color) {
 		break;
 	case M_TANDY16:
 		{
-			bool is_32k = (real_readb(BIOSMEM_SEG, BIOSMEM_CURRENT_MODE) >= 9)?true:false;
-			Bit16u segment, offset;
-			if (is_32k) {
-				if (machine==MCH_PCJR) {
-					Bitu cpupage = (real_readb(BIOSMEM_SEG, BIOSMEM_CRTCPU_PAGE) >> 3) & 0x7;
-					segment = cpupage << 10;
-				} else segment = 0xb800;
-				offset = (y >> 2) * (CurMode->swidth >> 1) + (x>>1);
-				offset += (8*1024) * (y & 3);
-			} else {
-				segment = 0xb800;
-				offset = (y >> 1) * (CurMode->swidth >> 1) + (x>>1);
-				offset += (8*1024) * (y & 1);
+			if (!PixelRowCached(page,y)) {
+				bool is_32k = (pixel_row.biosmode >= 9)?true:false;
+				if (is_32k) {
+					if (machine==MCH_PCJR) {
+						Bitu cpupage = (pixel_row.cpupage >> 3) & 0x7;
+						pixel_row.seg = cpupage << 10;
+					} else pixel_row.seg = 0xb800;
+					pixel_row.row = (y >> 2) * (CurMode->swidth >> 1);
+					pixel_row.row += (8*1024) * (y & 3);
+				} else {
+					pixel_row.seg = 0xb800;
+					pixel_row.row = (y >> 1) * (CurMode->swidth >> 1);
+					pixel_row.row += (8*1024) * (y & 1);
+				}
 			}
-			Bit8u val=real_readb(segment,offset);
+			Bit8u val=real_readb(pixel_row.seg,pixel_row.row + (x>>1));
 			*color=(val>>((x&1)?0:4)) & 0xf;
 		}
 		break;
 	case M_EGA:
 		{
-			/* Calculate where the pixel is in video memory */
-			if (CurMode->plength!=(Bitu)real_readw(BIOSMEM_SEG,BIOSMEM_PAGE_SIZE))
-				LOG(LOG_INT10,LOG_ERROR)("GetPixel_EGA_p: %x!=%x",CurMode->plength,real_readw(BIOSMEM_SEG,BIOSMEM_PAGE_SIZE));
-			if (CurMode->swidth!=(Bitu)real_readw(BIOSMEM_SEG,BIOSMEM_NB_COLS)*8)
-				LOG(LOG_INT10,LOG_ERROR)("GetPixel_EGA_w: %x!=%x",CurMode->swidth,real_readw(BIOSMEM_SEG,BIOSMEM_NB_COLS)*8);
-			PhysPt off=0xa0000+real_readw(BIOSMEM_SEG,BIOSMEM_PAGE_SIZE)*page+
-				((y*real_readw(BIOSMEM_SEG,BIOSMEM_NB_COLS)*8+x)>>3);
+			/* Calculate where the pixel row is in video memory */
+			if (!PixelRowCached(page,y)) {
+				if (CurMode->plength!=(Bitu)real_readw(BIOSMEM_SEG,BIOSMEM_PAGE_SIZE))
+					LOG(LOG_INT10,LOG_ERROR)("GetPixel_EGA_p: %x!=%x",CurMode->plength,real_readw(BIOSMEM_SEG,BIOSMEM_PAGE_SIZE));
+				if (CurMode->swidth!=(Bitu)real_readw(BIOSMEM_SEG,BIOSMEM_NB_COLS)*8)
+					LOG(LOG_INT10,LOG_ERROR)("GetPixel_EGA_w: %x!=%x",CurMode->swidth,real_readw(BIOSMEM_SEG,BIOSMEM_NB_COLS)*8);
+				pixel_row.physrow=0xa0000+real_readw(BIOSMEM_SEG,BIOSMEM_PAGE_SIZE)*page+
+					((y*real_readw(BIOSMEM_SEG,BIOSMEM_NB_COLS)*8)>>3);
+			}
+			PhysPt off=pixel_row.physrow+(x>>3);
 			Bitu shift=7-(x & 7);
 			/* Set the read map */
 			*color=0;
@@ -245,10 +286,12 @@ void INT10_GetPixel(Bit16u x,Bit16u y,Bit8u page,Bit8u * color) {
 		*color=mem_readb(PhysMake(0xa000,320*y+x));
 		break;
 	case M_LIN8: {
-			if (CurMode->swidth!=(Bitu)real_readw(BIOSMEM_SEG,BIOSMEM_NB_COLS)*8)
-				LOG(LOG_INT10,LOG_ERROR)("GetPixel_VGA_w: %x!=%x",CurMode->swidth,real_readw(BIOSMEM_SEG,BIOSMEM_NB_COLS)*8);
-			PhysPt off=S3_LFB_BASE+y*real_readw(BIOSMEM_SEG,BIOSMEM_NB_COLS)*8+x;
-			*color = mem_readb(off);
+			if (!PixelRowCached(page,y)) {
+				if (CurMode->swidth!=(Bitu)real_readw(BIOSMEM_SEG,BIOSMEM_NB_COLS)*8)
+					LOG(LOG_INT10,LOG_ERROR)("GetPixel_VGA_w: %x!=%x",CurMode->swidth,real_readw(BIOSMEM_SEG,BIOSMEM_NB_COLS)*8);
+				pixel_row.physrow=S3_LFB_BASE+y*real_readw(BIOSMEM_SEG,BIOSMEM_NB_COLS)*8;
+			}
+			*color = mem_readb(pixel_row.physrow+x);
 			break;
 		}
 	default:
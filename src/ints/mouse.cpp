@@ -123,6 +123,7 @@ static struct {
 	bool enabled;
 	bool inhibit_draw;
 	bool timer_in_progress;
+	float delay;	/* ms between event deliveries, set by int33 1Ch */
 	bool in_UIR;
 	Bit8u mode;
 	Bit16s gran_x,gran_y;
@@ -201,7 +202,7 @@ void MOUSE_Limit_Events(Bitu /*val*/) {
 	mouse.timer_in_progress = false;
 	if (mouse.events) {
 		mouse.timer_in_progress = true;
-		PIC_AddEvent(MOUSE_Limit_Events,MOUSE_DELAY);
+		PIC_AddEvent(MOUSE_Limit_Events,mouse.delay);
 		PIC_ActivateIRQ(MOUSE_IRQ);
 	}
 }
@@ -223,7 +224,7 @@ INLINE void Mouse_AddEvent(Bit8u type) {
 	}
 	if (!mouse.timer_in_progress) {
 		mouse.timer_in_progress = true;
-		PIC_AddEvent(MOUSE_Limit_Events,MOUSE_DELAY);
+		PIC_AddEvent(MOUSE_Limit_Events,mouse.delay);
 		PIC_ActivateIRQ(MOUSE_IRQ);
 	}
 }
@@ -716,6 +717,7 @@ static void Mouse_Reset(void) {
 	mouse.x = static_cast<float>((mouse.max_x + 1)/ 2);
 	mouse.y = static_cast<float>((mouse.max_y + 1)/ 2);
 	mouse.sub_mask = 0;
+	mouse.delay = MOUSE_DELAY;
 	mouse.in_UIR = false;
 }
 
@@ -912,7 +914,15 @@ static Bitu INT33_Handler(void) {
 		LOG(LOG_MOUSE,LOG_WARN)("Get sensitivity %d %d",reg_bx,reg_cx);
 		break;
 	case 0x1c:	/* Set interrupt rate */
-		/* Can't really set a rate this is host determined */
+		/* Only the InPort mouse had a rate register; honour it as the
+		   event delivery rate, so host motion keeps being coalesced
+		   down to the rate the guest asked for */
+		switch (reg_bx) {
+		case 1:	mouse.delay = 1000.0f/30.0f;	break;
+		case 2:	mouse.delay = 1000.0f/50.0f;	break;
+		case 3:	mouse.delay = 1000.0f/100.0f;	break;
+		default:mouse.delay = MOUSE_DELAY;	break;	/* 200 Hz */
+		}
 		break;
 	case 0x1d:      /* Set display page number */
 		mouse.page=reg_bl;
@@ -1080,7 +1090,7 @@ Bitu INT74_Ret_Handler(void) {
 	if (mouse.events) {
 		if (!mouse.timer_in_progress) {
 			mouse.timer_in_progress = true;
-			PIC_AddEvent(MOUSE_Limit_Events,MOUSE_DELAY);
+			PIC_AddEvent(MOUSE_Limit_Events,mouse.delay);
 		}
 	}
 	return CBRET_NONE;
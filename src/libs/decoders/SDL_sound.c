@@ -90,6 +90,14 @@ static SDL_mutex *samplelist_mutex = NULL;
 static const Sound_DecoderInfo **available_decoders = NULL;
 static int initialized = 0;
 
+/* The shared readahead decode thread; started lazily by the first
+ *  Sound_SetReadahead() call. It only inspects samples while holding
+ *  samplelist_mutex, so unlinking a sample from the list is enough to
+ *  take it out of the thread's reach. */
+static SDL_Thread *readahead_thread = NULL;
+static SDL_sem *readahead_work = NULL;
+static volatile int readahead_quit = 0;
+
 
 /* functions ... */
 
@@ -148,6 +156,21 @@ int Sound_Quit(void)
 
     BAIL_IF_MACRO(!initialized, ERR_NOT_INITIALIZED, 0);
 
+    /* wind down the readahead thread before tearing samples down... */
+    if (readahead_thread != NULL)
+    {
+        readahead_quit = 1;
+        SDL_SemPost(readahead_work);
+        SDL_WaitThread(readahead_thread, NULL);
+        readahead_thread = NULL;
+        readahead_quit = 0;
+    } /* if */
+    if (readahead_work != NULL)
+    {
+        SDL_DestroySemaphore(readahead_work);
+        readahead_work = NULL;
+    } /* if */
+
     while (((volatile Sound_Sample *) sample_list) != NULL)
     {
         Sound_Sample *sample = sample_list;
@@ -451,10 +474,16 @@ static int init_sample(const Sound_DecoderFunctions *funcs,
 } /* init_sample */
 
 
-Sound_Sample *Sound_NewSample(SDL_RWops *rw, const char *ext,
-                              Sound_AudioInfo *desired)
+/*
+ * The common backend of Sound_NewSample() and Sound_NewSampleFromFile();
+ *  (filename) is the source path when known, so decoders that keep
+ *  per-file state on disk can name it after their input, or NULL.
+ */
+static Sound_Sample *new_sample(SDL_RWops *rw, const char *filename,
+                                const char *ext, Sound_AudioInfo *desired)
 {
     Sound_Sample *retval;
+    Sound_SampleInternal *internal;
     decoder_element *decoder;
 
     /* sanity checks. */
@@ -465,6 +494,14 @@ Sound_Sample *Sound_NewSample(SDL_RWops *rw, const char *ext,
     if (!retval)
         return(NULL);  /* alloc_sample() sets error message... */
 
+    internal = (Sound_SampleInternal *) retval->opaque;
+    if (filename != NULL)
+    {
+        internal->filename = malloc(strlen(filename) + 1);
+        if (internal->filename != NULL)
+            strcpy(internal->filename, filename);
+    } /* if */
+
     if (ext != NULL)
     {
         for (decoder = &decoders[0]; decoder->funcs != NULL; decoder++)
@@ -514,11 +551,19 @@ Sound_Sample *Sound_NewSample(SDL_RWops *rw, const char *ext,
     } /* for */
 
     /* nothing could handle the sound data... */
+    free(internal->filename);
     free(retval->opaque);
     free(retval);
     SDL_RWclose(rw);
     __Sound_SetError(ERR_UNSUPPORTED_FORMAT);
     return(NULL);
+} /* new_sample */
+
+
+Sound_Sample *Sound_NewSample(SDL_RWops *rw, const char *ext,
+                              Sound_AudioInfo *desired)
+{
+    return(new_sample(rw, NULL, ext, desired));
 } /* Sound_NewSample */
 
 
@@ -543,7 +588,7 @@ Sound_Sample *Sound_NewSampleFromFile(const char *filename,
     if (ext != NULL)
         ext++;
 
-    return(Sound_NewSample(rw, ext, desired));
+    return(new_sample(rw, filename, ext, desired));
 } /* Sound_NewSampleFromFile */
 
 void Sound_FreeSample(Sound_Sample *sample)
@@ -588,16 +633,208 @@ void Sound_FreeSample(Sound_Sample *sample)
 
     SDL_UnlockMutex(samplelist_mutex);
 
+    /* the readahead thread can no longer reach the sample... */
+    if (internal->ra_ring != NULL)
+    {
+        free(internal->ra_ring);
+        SDL_DestroyMutex(internal->ra_mutex);
+    } /* if */
+
     /* nuke it... */
     internal->funcs->close(sample);
 
     if (internal->rw != NULL)  /* this condition is a "just in case" thing. */
         SDL_RWclose(internal->rw);
 
+    free(internal->filename);
     free(internal);
     free(sample);
 } /* Sound_FreeSample */
 
+/*
+ * Top up one sample's ring from the readahead thread. Called with
+ *  samplelist_mutex held; (ra_mutex) serializes the decoder against the
+ *  consumer. EOF/ERROR bits the decoder raises here are parked in
+ *  (ra_flags) so the consumer only sees them once the ring is drained.
+ */
+static int readahead_fill(Sound_Sample *sample)
+{
+    Sound_SampleInternal *internal = (Sound_SampleInternal *) sample->opaque;
+    Uint32 tail, room, before, n;
+    Uint8 *dst;
+
+    SDL_LockMutex(internal->ra_mutex);
+    if ((internal->ra_flags != 0) ||
+        (internal->ra_filled >= internal->ra_capacity))
+    {
+        SDL_UnlockMutex(internal->ra_mutex);
+        return(0);
+    } /* if */
+
+        /* decode into the contiguous stretch behind the filled region. */
+    tail = (internal->ra_head + internal->ra_filled) % internal->ra_capacity;
+    room = internal->ra_capacity - internal->ra_filled;
+    if (room > internal->ra_capacity - tail)
+        room = internal->ra_capacity - tail;
+    dst = ((Uint8 *) internal->ra_ring) + (tail * internal->ra_frame_size);
+
+    before = sample->flags;
+    sample->flags &= ~SOUND_SAMPLEFLAG_EAGAIN;
+    n = internal->funcs->read(sample, dst, room);
+    internal->ra_flags |= sample->flags &
+            (SOUND_SAMPLEFLAG_EOF | SOUND_SAMPLEFLAG_ERROR);
+    sample->flags = before;
+
+    internal->ra_filled += n;
+    SDL_UnlockMutex(internal->ra_mutex);
+    return(n > 0);
+} /* readahead_fill */
+
+
+static int readahead_thread_fn(void *unused)
+{
+    (void) unused;
+    while (!readahead_quit)
+    {
+        Sound_Sample *sample;
+        int progress = 0;
+
+        SDL_LockMutex(samplelist_mutex);
+        for (sample = sample_list; sample != NULL;
+         sample = ((Sound_SampleInternal *) sample->opaque)->next)
+        {
+            if (((Sound_SampleInternal *) sample->opaque)->ra_ring != NULL)
+                progress |= readahead_fill(sample);
+        } /* for */
+        SDL_UnlockMutex(samplelist_mutex);
+
+        if (!progress)
+            SDL_SemWaitTimeout(readahead_work, 100);
+    } /* while */
+    return(0);
+} /* readahead_thread_fn */
+
+
+/*
+ * Serve Sound_Decode_Direct() from the sample's readahead ring, falling
+ *  back to an in-line decode on underrun.
+ */
+static Uint32 readahead_read(Sound_Sample *sample,
+                             Sound_SampleInternal *internal,
+                             void *buffer, Uint32 desired_frames)
+{
+    Uint8 *dst = (Uint8 *) buffer;
+    Uint32 total = 0;
+
+    SDL_LockMutex(internal->ra_mutex);
+    while ((total < desired_frames) && (internal->ra_filled > 0))
+    {
+        Uint32 n = desired_frames - total;
+        if (n > internal->ra_filled)
+            n = internal->ra_filled;
+        if (n > internal->ra_capacity - internal->ra_head)
+            n = internal->ra_capacity - internal->ra_head;
+        memcpy(dst + (total * internal->ra_frame_size),
+               ((Uint8 *) internal->ra_ring) +
+                   (internal->ra_head * internal->ra_frame_size),
+               (size_t) n * internal->ra_frame_size);
+        internal->ra_head = (internal->ra_head + n) % internal->ra_capacity;
+        internal->ra_filled -= n;
+        total += n;
+    } /* while */
+
+    if (total < desired_frames)
+    {
+        if (internal->ra_flags != 0)  /* drained down to the decoder's end. */
+        {
+            sample->flags |= internal->ra_flags;
+        } /* if */
+        else  /* underrun; decode the remainder in the caller's thread. */
+        {
+            total += internal->funcs->read(sample,
+                    dst + (total * internal->ra_frame_size),
+                    desired_frames - total);
+        } /* else */
+    } /* if */
+    SDL_UnlockMutex(internal->ra_mutex);
+
+    SDL_SemPost(readahead_work);  /* top the ring back up. */
+    return(total);
+} /* readahead_read */
+
+
+int Sound_SetReadahead(Sound_Sample *sample, Uint32 frames)
+{
+    Sound_SampleInternal *internal;
+
+    BAIL_IF_MACRO(!initialized, ERR_NOT_INITIALIZED, 0);
+    BAIL_IF_MACRO(sample == NULL, ERR_INVALID_ARGUMENT, 0);
+
+    internal = (Sound_SampleInternal *) sample->opaque;
+
+    if (frames == 0)  /* back to synchronous decoding. */
+    {
+        if (internal->ra_ring != NULL)
+        {
+            SDL_mutex *mutex = internal->ra_mutex;
+
+                /* samplelist_mutex keeps the thread out of the sample. */
+            SDL_LockMutex(samplelist_mutex);
+            free(internal->ra_ring);
+            internal->ra_ring = NULL;
+            internal->ra_capacity = internal->ra_head = 0;
+            internal->ra_filled = internal->ra_flags = 0;
+            internal->ra_mutex = NULL;
+            SDL_UnlockMutex(samplelist_mutex);
+            SDL_DestroyMutex(mutex);
+        } /* if */
+        return(1);
+    } /* if */
+
+    if (internal->ra_ring == NULL)
+    {
+        Uint32 frame_size = ((sample->desired.format & 0xFF) / 8) *
+                            sample->desired.channels;
+        void *ring;
+        SDL_mutex *mutex;
+
+        BAIL_IF_MACRO(frame_size == 0, ERR_INVALID_ARGUMENT, 0);
+
+            /* the shared decode thread starts on first use. */
+        if (readahead_thread == NULL)
+        {
+            if (readahead_work == NULL)
+                readahead_work = SDL_CreateSemaphore(0);
+            BAIL_IF_MACRO(readahead_work == NULL, SDL_GetError(), 0);
+            readahead_thread = SDL_CreateThread(readahead_thread_fn,
+                                                "SoundReadahead", NULL);
+            BAIL_IF_MACRO(readahead_thread == NULL, SDL_GetError(), 0);
+        } /* if */
+
+        ring = malloc((size_t) frames * frame_size);
+        BAIL_IF_MACRO(ring == NULL, ERR_OUT_OF_MEMORY, 0);
+        mutex = SDL_CreateMutex();
+        if (mutex == NULL)
+        {
+            free(ring);
+            BAIL_MACRO(SDL_GetError(), 0);
+        } /* if */
+
+        SDL_LockMutex(samplelist_mutex);
+        internal->ra_ring = ring;
+        internal->ra_capacity = frames;
+        internal->ra_head = internal->ra_filled = 0;
+        internal->ra_flags = 0;
+        internal->ra_frame_size = frame_size;
+        internal->ra_mutex = mutex;
+        SDL_UnlockMutex(samplelist_mutex);
+        SDL_SemPost(readahead_work);
+    } /* if */
+
+    return(1);
+} /* Sound_SetReadahead */
+
+
 Uint32 Sound_Decode_Direct(Sound_Sample *sample, void* buffer, Uint32 desired_frames)
 {
     Sound_SampleInternal *internal = NULL;
@@ -612,6 +849,10 @@ Uint32 Sound_Decode_Direct(Sound_Sample *sample, void* buffer, Uint32 desired_fr
 
         /* reset EAGAIN. Decoder can flip it back on if it needs to. */
     sample->flags &= ~SOUND_SAMPLEFLAG_EAGAIN;
+
+    if (internal->ra_ring != NULL)
+        return(readahead_read(sample, internal, buffer, desired_frames));
+
     return internal->funcs->read(sample, buffer, desired_frames);
 } /* Sound_Decode */
 
@@ -619,10 +860,23 @@ Uint32 Sound_Decode_Direct(Sound_Sample *sample, void* buffer, Uint32 desired_fr
 int Sound_Rewind(Sound_Sample *sample)
 {
     Sound_SampleInternal *internal;
+    int rc;
     BAIL_IF_MACRO(!initialized, ERR_NOT_INITIALIZED, 0);
 
     internal = (Sound_SampleInternal *) sample->opaque;
-    if (!internal->funcs->rewind(sample))
+    if (internal->ra_ring != NULL)
+    {
+            /* toss frames decoded ahead of the old position. */
+        SDL_LockMutex(internal->ra_mutex);
+        internal->ra_head = internal->ra_filled = 0;
+        internal->ra_flags = 0;
+        rc = internal->funcs->rewind(sample);
+        SDL_UnlockMutex(internal->ra_mutex);
+    } /* if */
+    else
+        rc = internal->funcs->rewind(sample);
+
+    if (!rc)
     {
         sample->flags |= SOUND_SAMPLEFLAG_ERROR;
         return(0);
@@ -645,7 +899,20 @@ int Sound_Seek(Sound_Sample *sample, Uint32 ms)
         BAIL_MACRO(ERR_CANNOT_SEEK, 0);
 
     internal = (Sound_SampleInternal *) sample->opaque;
-    BAIL_IF_MACRO(!internal->funcs->seek(sample, ms), NULL, 0);
+    if (internal->ra_ring != NULL)
+    {
+        int rc;
+
+            /* toss frames decoded ahead of the old position. */
+        SDL_LockMutex(internal->ra_mutex);
+        internal->ra_head = internal->ra_filled = 0;
+        internal->ra_flags = 0;
+        rc = internal->funcs->seek(sample, ms);
+        SDL_UnlockMutex(internal->ra_mutex);
+        BAIL_IF_MACRO(!rc, NULL, 0);
+    } /* if */
+    else
+        BAIL_IF_MACRO(!internal->funcs->seek(sample, ms), NULL, 0);
 
     sample->flags &= ~SOUND_SAMPLEFLAG_EAGAIN;
     sample->flags &= ~SOUND_SAMPLEFLAG_ERROR;
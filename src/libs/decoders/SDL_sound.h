@@ -524,6 +524,29 @@ SNDDECLSPEC Sint32 SDLCALL Sound_GetDuration(Sound_Sample *sample);
  */
 SNDDECLSPEC Uint32 SDLCALL Sound_Decode_Direct(Sound_Sample *sample, void* buffer, Uint32 desired_frames);
 
+/**
+ * \fn int Sound_SetReadahead(Sound_Sample *sample, Uint32 frames)
+ * \brief Decode up to (frames) PCM frames of this sample in the background.
+ *
+ * A decode thread shared by all samples keeps a per-sample ring of decoded
+ *  frames topped up, and Sound_Decode_Direct() drains the ring before
+ *  falling back to decoding in the caller's thread. Pass 0 to return the
+ *  sample to purely synchronous decoding. Sound_Seek() and Sound_Rewind()
+ *  discard any frames decoded ahead of the stream position.
+ *
+ * Once readahead is enabled the sample may only be fed to
+ *  Sound_Decode_Direct(), Sound_Seek(), Sound_Rewind() and
+ *  Sound_FreeSample() from one thread at a time.
+ *
+ *    \param sample Sample to decode ahead.
+ *    \param frames Ring capacity in PCM frames, or 0 to disable.
+ *   \return nonzero on success, zero on error.
+ *
+ * \sa Sound_Decode_Direct
+ * \sa Sound_Seek
+ */
+SNDDECLSPEC int SDLCALL Sound_SetReadahead(Sound_Sample *sample, Uint32 frames);
+
 /**
  * \fn int Sound_Rewind(Sound_Sample *sample)
  * \brief Rewind a sample to the start.
@@ -122,6 +122,7 @@ typedef struct __SOUND_DECODERFUNCTIONS__
          *    Sound_Sample *next;  (offlimits)
          *    Sound_Sample *prev;  (offlimits)
          *    SDL_RWops *rw;       (can use, but do NOT close it)
+         *    char *filename;      (read only; NULL if not opened from a file)
          *    const Sound_DecoderFunctions *funcs; (that's this structure)
          *    void *decoder_private; (read and write access)
          *
@@ -219,6 +220,7 @@ typedef struct __SOUND_SAMPLEINTERNAL__
     Sound_Sample *next;
     Sound_Sample *prev;
     SDL_RWops *rw;
+    char *filename;  /* source path when opened from a file, otherwise NULL */
     const Sound_DecoderFunctions *funcs;
     void *buffer;
     Uint32 buffer_size;
@@ -226,6 +228,18 @@ typedef struct __SOUND_SAMPLEINTERNAL__
     Sint32 total_time;
     Uint32 mix_position;
     MixFunc mix;
+
+    /* async readahead state; all zero while readahead is disabled.
+     *  (ra_mutex) serializes the shared decode thread and the consumer,
+     *  (ra_flags) holds EOF/ERROR bits the thread ran into ahead of the
+     *  consumer, which only surface once the ring has been drained. */
+    void *ra_ring;          /* decoded frames, (ra_capacity) of them */
+    Uint32 ra_capacity;     /* ring size in frames */
+    Uint32 ra_head;         /* frame index of the next frame to hand out */
+    Uint32 ra_filled;       /* decoded frames currently in the ring */
+    Uint32 ra_frame_size;   /* bytes per frame of the desired format */
+    Uint32 ra_flags;
+    SDL_mutex *ra_mutex;
 } Sound_SampleInternal;
 
 
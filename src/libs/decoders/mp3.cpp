@@ -27,6 +27,8 @@
  *    - dr_libs: https://github.com/mackron/dr_libs (source)
  *    - dr_mp3:  http://mackron.github.io/dr_mp3.html (website)
  */
+#include <string>
+
 #include <support.h>
 
 #include "mp3_seek_table.h"
@@ -39,6 +41,19 @@
 
 static constexpr char fast_seek_filename[] = "fastseek.lut";
 
+// Persist the fast-seek table beside the audio files instead of in the
+// working directory, which can differ between launches or be read-only.
+// All tracks in a directory still share a single table file.
+static std::string fast_seek_path(const Sound_SampleInternal* const internal)
+{
+    std::string path = internal->filename ? internal->filename : "";
+    const size_t last_slash = path.find_last_of("/\\");
+    if (last_slash == std::string::npos)
+        return fast_seek_filename;
+    path.erase(last_slash + 1);
+    return path + fast_seek_filename;
+}
+
 static size_t mp3_read(void* const pUserData, void* const pBufferOut, const size_t bytesToRead)
 {
     Uint8* ptr = static_cast<Uint8*>(pBufferOut);
@@ -121,7 +136,8 @@ static int32_t MP3_open(Sound_Sample* const sample, const char* const ext)
 
                 // frame count is agnostic of sample size and number of channels
                 const uint64_t num_frames =
-                    populate_seek_points(internal->rw, p_mp3, fast_seek_filename, result);
+                    populate_seek_points(internal->rw, p_mp3,
+                                         fast_seek_path(internal).c_str(), result);
 
                 // total_time needs milliseconds
                 internal->total_time = (num_frames != 0) ? 
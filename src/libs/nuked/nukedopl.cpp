@@ -1131,10 +1131,15 @@ void OPL3_Generate(opl3_chip *chip, Bit16s *buf)
     chip->eg_add = 0;
     if (chip->eg_timer)
     {
+#if defined(__GNUC__)
+        /* count trailing zeros; the timer is nonzero here */
+        shift = (Bit8u)__builtin_ctzll(chip->eg_timer);
+#else
         while (shift < 36 && ((chip->eg_timer >> shift) & 1) == 0)
         {
             shift++;
         }
+#endif
         if (shift > 12)
         {
             chip->eg_add = 0;
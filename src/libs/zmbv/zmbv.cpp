@@ -152,6 +152,8 @@ INLINE int VideoCodec::PossibleBlock(int vx,int vy,FrameBlock * block) {
 			int test=0-((pold[x]-pnew[x])&0x00ffffff);
 			ret-=(test>>31);
 		}
+		/* the caller only wants to know if this stays below 4 */
+		if (ret>=4) return ret;
 		pold+=pitch*4;
 		pnew+=pitch*4;
 	}
@@ -159,14 +161,21 @@ INLINE int VideoCodec::PossibleBlock(int vx,int vy,FrameBlock * block) {
 }
 
 template<class P>
-INLINE int VideoCodec::CompareBlock(int vx,int vy,FrameBlock * block) {
+INLINE int VideoCodec::CompareBlock(int vx,int vy,FrameBlock * block,int best) {
 	int ret=0;
 	P * pold=((P*)oldframe)+block->start+(vy*pitch)+vx;
-	P * pnew=((P*)newframe)+block->start;;	
+	P * pnew=((P*)newframe)+block->start;;
 	for (int y=0;y<block->dy;y++) {
-		for (int x=0;x<block->dx;x++) {
-			int test=0-((pold[x]-pnew[x])&0x00ffffff);
-			ret-=(test>>31);
+		/* identical rows are the common case by far and memcmp beats
+		   the pixel loop on every host; a mismatch might still be
+		   alpha only, so fall through to the masked compare */
+		if (memcmp(pold,pnew,block->dx*sizeof(P))) {
+			for (int x=0;x<block->dx;x++) {
+				int test=0-((pold[x]-pnew[x])&0x00ffffff);
+				ret-=(test>>31);
+			}
+			/* no better than the best vector so far, give up early */
+			if (ret>=best) return ret;
 		}
 		pold+=pitch;
 		pnew+=pitch;
@@ -197,7 +206,7 @@ void VideoCodec::AddXorFrame(void) {
 		FrameBlock * block=&blocks[b];
 		int bestvx = 0;
 		int bestvy = 0;
-		int bestchange=CompareBlock<P>(0,0, block);
+		int bestchange=CompareBlock<P>(0,0, block, 0x7fffffff);
 		int possibles=64;
 		for (int v=0;v<VectorCount && possibles;v++) {
 			if (bestchange<4) break;
@@ -206,7 +215,7 @@ void VideoCodec::AddXorFrame(void) {
 			if (PossibleBlock<P>(vx, vy, block) < 4) {
 				possibles--;
 //				if (!possibles) Msg("Ran out of possibles, at %d of %d best %d\n",v,VectorCount,bestchange);
-				int testchange=CompareBlock<P>(vx,vy, block);
+				int testchange=CompareBlock<P>(vx,vy, block, bestchange);
 				if (testchange<bestchange) {
 					bestchange=testchange;
 					bestvx = vx;
@@ -223,12 +232,12 @@ void VideoCodec::AddXorFrame(void) {
 	}
 }
 
-bool VideoCodec::SetupCompress( int _width, int _height ) {
+bool VideoCodec::SetupCompress( int _width, int _height, int _level ) {
 	width = _width;
 	height = _height;
 	pitch = _width + 2*MAX_VECTOR;
 	format = ZMBV_FORMAT_NONE;
-	if (deflateInit (&zstream, 4) != Z_OK)
+	if (deflateInit (&zstream, _level) != Z_OK)
 		return false;
 	return true;
 }
@@ -318,7 +327,7 @@ void VideoCodec::CompressLines(int lineCount, void *lineData[]) {
 	}
 }
 
-int VideoCodec::FinishCompressFrame( void ) {
+void VideoCodec::CompressFrameData( void ) {
 	unsigned char firstByte = *compress.writeBuf;
 	if (firstByte & Mask_KeyFrame) {
 		int i;
@@ -346,6 +355,9 @@ int VideoCodec::FinishCompressFrame( void ) {
 			break;
 		}
 	}
+}
+
+int VideoCodec::DeflateFrame( void ) {
 	/* Create the actual frame with compression */
 	zstream.next_in = (Bytef *)work;
 	zstream.avail_in = workUsed;
@@ -358,6 +370,11 @@ int VideoCodec::FinishCompressFrame( void ) {
 	return compress.writeDone + zstream.total_out;
 }
 
+int VideoCodec::FinishCompressFrame( void ) {
+	CompressFrameData();
+	return DeflateFrame();
+}
+
 template<class P>
 INLINE void VideoCodec::UnXorBlock(int vx,int vy,FrameBlock * block) {
 	P * pold=((P*)oldframe)+block->start+(vy*pitch)+vx;
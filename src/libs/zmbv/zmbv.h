@@ -96,7 +96,7 @@ private:
 	template<class P>
 		INLINE int PossibleBlock(int vx,int vy,FrameBlock * block);
 	template<class P>
-		INLINE int CompareBlock(int vx,int vy,FrameBlock * block);
+		INLINE int CompareBlock(int vx,int vy,FrameBlock * block,int best);
 	template<class P>
 		INLINE void AddXorBlock(int vx,int vy,FrameBlock * block);
 	template<class P>
@@ -105,13 +105,17 @@ private:
 		INLINE void CopyBlock(int vx, int vy,FrameBlock * block);
 public:
 	VideoCodec();
-	bool SetupCompress( int _width, int _height);
+	bool SetupCompress( int _width, int _height, int _level = 4);
 	bool SetupDecompress( int _width, int _height);
 	zmbv_format_t BPPFormat( int bpp );
 	int NeededSize( int _width, int _height, zmbv_format_t _format);
 
 	void CompressLines(int lineCount, void *lineData[]);
 	bool PrepareCompressFrame(int flags,  zmbv_format_t _format, char * pal, void *writeBuf, int writeSize);
+	/* FinishCompressFrame is CompressFrameData followed by DeflateFrame;
+	   the two stages are exposed so the deflate can run on another thread */
+	void CompressFrameData( void );
+	int DeflateFrame( void );
 	int FinishCompressFrame( void );
 	bool DecompressFrame(void * framedata, int size);
 	void Output_UpsideDown_24(void * output);
@@ -388,3 +388,118 @@ FILE *fopen_wrap(const char *path, const char *mode) {
 
 	return fopen(path,mode);
 }
+
+/* Thread placement ([performance] config section). The emulation thread
+   competes with its own helpers (mixer callback, capture workers) on
+   small machines; these helpers let the config pin the emulation thread
+   to chosen cores, herd the workers onto others, and optionally request
+   SCHED_FIFO for the emulation thread. Keeping all listed cores on one
+   NUMA node also keeps guest memory local through first-touch. */
+
+#include "setup.h"
+#include "logging.h"
+
+#if !defined(WIN32) && defined(_GNU_SOURCE)
+#include <pthread.h>
+#include <sched.h>
+#define PERF_HAVE_AFFINITY 1
+#elif defined(WIN32)
+#define PERF_HAVE_AFFINITY 1
+#else
+#define PERF_HAVE_AFFINITY 0
+#endif
+
+static std::string perf_emu_cores;
+static std::string perf_worker_cores;
+static bool perf_realtime = false;
+
+/* apply a core list like "0-3,6" to the calling thread */
+static bool PERF_ApplyAffinity(const char* spec) {
+	if (!spec || !*spec) return true;
+#if !defined(WIN32) && defined(_GNU_SOURCE)
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	bool any = false;
+	const char* p = spec;
+	while (*p) {
+		char* end;
+		long a = strtol(p,&end,10);
+		if (end == p) break;
+		long b = a;
+		p = end;
+		if (*p == '-') {
+			p++;
+			b = strtol(p,&end,10);
+			if (end == p) break;
+			p = end;
+		}
+		for (long c = a; c <= b; c++) {
+			if (c >= 0 && c < CPU_SETSIZE) { CPU_SET((int)c,&set); any = true; }
+		}
+		if (*p == ',') p++;
+	}
+	if (!any) return false;
+	return pthread_setaffinity_np(pthread_self(),sizeof(set),&set) == 0;
+#elif defined(WIN32)
+	DWORD_PTR mask = 0;
+	const char* p = spec;
+	while (*p) {
+		char* end;
+		long a = strtol(p,&end,10);
+		if (end == p) break;
+		long b = a;
+		p = end;
+		if (*p == '-') {
+			p++;
+			b = strtol(p,&end,10);
+			if (end == p) break;
+			p = end;
+		}
+		for (long c = a; c <= b; c++) {
+			if (c >= 0 && c < (long)(sizeof(mask) * 8)) mask |= ((DWORD_PTR)1 << c);
+		}
+		if (*p == ',') p++;
+	}
+	if (!mask) return false;
+	return SetThreadAffinityMask(GetCurrentThread(),mask) != 0;
+#else
+	return false;
+#endif
+}
+
+void PERF_TuneEmulationThread(void) {
+	if (!perf_emu_cores.empty() && !PERF_ApplyAffinity(perf_emu_cores.c_str()))
+		LOG_MSG("PERF: Could not apply cpuaffinity '%s'",perf_emu_cores.c_str());
+	if (perf_realtime) {
+#if !defined(WIN32) && defined(_GNU_SOURCE)
+		struct sched_param param;
+		param.sched_priority = 10;
+		if (pthread_setschedparam(pthread_self(),SCHED_FIFO,&param) != 0)
+			LOG_MSG("PERF: SCHED_FIFO denied; needs CAP_SYS_NICE or an rtprio limit");
+#elif defined(WIN32)
+		if (!SetThreadPriority(GetCurrentThread(),THREAD_PRIORITY_HIGHEST))
+			LOG_MSG("PERF: Could not raise emulation thread priority");
+#endif
+	}
+}
+
+void PERF_TuneWorkerThread(void) {
+	/* workers stay at normal scheduling; they only get herded off the
+	   emulation cores so they cannot preempt it */
+	if (!perf_worker_cores.empty())
+		PERF_ApplyAffinity(perf_worker_cores.c_str());
+}
+
+void PERF_Init(Section* sec) {
+	Section_prop* section = static_cast<Section_prop*>(sec);
+	perf_emu_cores = section->Get_string("cpuaffinity");
+	perf_worker_cores = section->Get_string("workeraffinity");
+	perf_realtime = section->Get_bool("realtime");
+#if !PERF_HAVE_AFFINITY
+	if (!perf_emu_cores.empty() || !perf_worker_cores.empty())
+		LOG_MSG("PERF: Thread affinity is not supported on this platform");
+#endif
+	/* init runs on the emulation thread; workers pick their settings
+	   up through PERF_TuneWorkerThread when they start */
+	PERF_TuneEmulationThread();
+}
@@ -0,0 +1,125 @@
+/*
+ *  Copyright (C) 2002-2020  The DOSBox Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "memarena.h"
+
+#include <string.h>
+#include <new>
+
+#if defined (WIN32)
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+#define ARENA_MAX_BLOCKS	64
+#define ARENA_MAX_SUBSYSTEMS	16
+
+struct ArenaBlock {
+	void * ptr;
+	Bitu bytes;
+	Bitu subsystem;
+	bool mapped;		// from the VM system, not the heap fallback
+};
+
+/* subsystem names are expected to be string literals, only the pointer is
+   kept */
+static struct {
+	const char * name;
+	Bits bytes;
+} arena_subsystems[ARENA_MAX_SUBSYSTEMS];
+static Bitu arena_subsystem_count=0;
+
+static ArenaBlock arena_blocks[ARENA_MAX_BLOCKS];
+
+static Bitu ARENA_SubsystemIndex(const char * subsystem) {
+	for (Bitu i=0;i<arena_subsystem_count;i++) {
+		if (!strcmp(arena_subsystems[i].name,subsystem)) return i;
+	}
+	if (arena_subsystem_count>=ARENA_MAX_SUBSYSTEMS)
+		E_Exit("ARENA: Too many subsystems");
+	arena_subsystems[arena_subsystem_count].name=subsystem;
+	arena_subsystems[arena_subsystem_count].bytes=0;
+	return arena_subsystem_count++;
+}
+
+void * ARENA_Alloc(const char * subsystem,Bitu bytes) {
+	Bitu slot;
+	for (slot=0;slot<ARENA_MAX_BLOCKS;slot++) {
+		if (!arena_blocks[slot].ptr) break;
+	}
+	if (slot>=ARENA_MAX_BLOCKS) E_Exit("ARENA: Out of block slots");
+
+	void * p=NULL;
+	bool mapped=false;
+#if defined (WIN32)
+	p=VirtualAlloc(NULL,bytes,MEM_RESERVE|MEM_COMMIT,PAGE_READWRITE);
+	if (p) mapped=true;
+#else
+	p=mmap(NULL,bytes,PROT_READ|PROT_WRITE,MAP_PRIVATE|MAP_ANONYMOUS,-1,0);
+	if (p!=MAP_FAILED) mapped=true;
+	else p=NULL;
+#endif
+	if (!p) {
+		/* heap fallback has to zero the block itself */
+		p=new (std::nothrow) Bit8u[bytes];
+		if (!p) E_Exit("ARENA: Can't allocate %d kb for %s",(int)(bytes/1024),subsystem);
+		memset(p,0,bytes);
+	}
+	arena_blocks[slot].ptr=p;
+	arena_blocks[slot].bytes=bytes;
+	arena_blocks[slot].subsystem=ARENA_SubsystemIndex(subsystem);
+	arena_blocks[slot].mapped=mapped;
+	arena_subsystems[arena_blocks[slot].subsystem].bytes+=(Bits)bytes;
+	return p;
+}
+
+void ARENA_Free(void * ptr) {
+	if (!ptr) return;
+	for (Bitu slot=0;slot<ARENA_MAX_BLOCKS;slot++) {
+		if (arena_blocks[slot].ptr!=ptr) continue;
+		arena_subsystems[arena_blocks[slot].subsystem].bytes-=(Bits)arena_blocks[slot].bytes;
+		if (arena_blocks[slot].mapped) {
+#if defined (WIN32)
+			VirtualFree(ptr,0,MEM_RELEASE);
+#else
+			munmap(ptr,arena_blocks[slot].bytes);
+#endif
+		} else {
+			delete [] (Bit8u*)ptr;
+		}
+		arena_blocks[slot].ptr=NULL;
+		return;
+	}
+	E_Exit("ARENA: Freeing a block that was never allocated");
+}
+
+void ARENA_Account(const char * subsystem,Bits bytes) {
+	arena_subsystems[ARENA_SubsystemIndex(subsystem)].bytes+=bytes;
+}
+
+void ARENA_LogUsage(void) {
+	Bits total=0;
+	LOG_MSG("ARENA: Subsystem allocations:");
+	for (Bitu i=0;i<arena_subsystem_count;i++) {
+		LOG_MSG("ARENA:   %-12s %8d kb",arena_subsystems[i].name,
+			(int)(arena_subsystems[i].bytes/1024));
+		total+=arena_subsystems[i].bytes;
+	}
+	LOG_MSG("ARENA:   %-12s %8d kb","total",(int)(total/1024));
+}
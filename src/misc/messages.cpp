@@ -27,6 +27,7 @@
 #include "control.h"
 #include <list>
 #include <string>
+#include <unordered_map>
 using namespace std;
 
 
@@ -43,28 +44,43 @@ struct MessageBlock {
 static list<MessageBlock> Lang;
 typedef list<MessageBlock>::iterator itmb;
 
+/* Hashed index over Lang. Lookups used to walk the whole list with a
+ * string compare per entry, and the shell re-looks messages up on every
+ * WriteOut, so with ~500 registered messages that was noticeable in
+ * scripted workloads. The list itself stays as ordered storage, since
+ * MSG_Write dumps it in registration order for -writelang; list
+ * iterators are stable, so the index can hold them directly.
+ */
+struct MessageHash { // FNV-1a; short ASCII keys, no need for anything fancier
+	size_t operator()(const string &s) const {
+		size_t h = 2166136261u;
+		for (const char c : s)
+			h = (h ^ static_cast<unsigned char>(c)) * 16777619u;
+		return h;
+	}
+};
+
+static unordered_map<string, itmb, MessageHash> LangIndex;
+
 void MSG_Add(const char * _name, const char* _val) {
-	/* Find the message */
-	for(itmb tel=Lang.begin();tel!=Lang.end();tel++) {
-		if((*tel).name==_name) { 
-//			LOG_MSG("double entry for %s",_name); //Message file might be loaded before default text messages
-			return;
-		}
+	/* Only add the message if it doesn't exist yet */
+	if (LangIndex.count(_name)) {
+//		LOG_MSG("double entry for %s",_name); //Message file might be loaded before default text messages
+		return;
 	}
-	/* if the message doesn't exist add it */
 	Lang.push_back(MessageBlock(_name,_val));
+	LangIndex[_name] = --Lang.end();
 }
 
 void MSG_Replace(const char * _name, const char* _val) {
-	/* Find the message */
-	for(itmb tel=Lang.begin();tel!=Lang.end();tel++) {
-		if((*tel).name==_name) { 
-			Lang.erase(tel);
-			break;
-		}
+	/* Replace the message in place, or add it if it doesn't exist */
+	unordered_map<string, itmb, MessageHash>::iterator index = LangIndex.find(_name);
+	if (index != LangIndex.end()) {
+		index->second->val = _val;
+		return;
 	}
-	/* Even if the message doesn't exist add it */
 	Lang.push_back(MessageBlock(_name,_val));
+	LangIndex[_name] = --Lang.end();
 }
 
 static void LoadMessageFile(const char * fname) {
@@ -113,12 +129,9 @@ static void LoadMessageFile(const char * fname) {
 }
 
 const char * MSG_Get(char const * msg) {
-	for(itmb tel=Lang.begin();tel!=Lang.end();tel++){	
-		if((*tel).name==msg)
-		{
-			return  (*tel).val.c_str();
-		}
-	}
+	unordered_map<string, itmb, MessageHash>::iterator index = LangIndex.find(msg);
+	if (index != LangIndex.end())
+		return index->second->val.c_str();
 	return "Message not Found!\n";
 }
 
@@ -0,0 +1,147 @@
+/*
+ *  Copyright (C) 2002-2020  The DOSBox Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "profiler.h"
+
+#include <chrono>
+#include <cstdio>
+
+#include "support.h"
+
+extern void GFX_SetProfilerInfo(const char *info);
+
+bool prof_enabled = false;
+
+static Bit64s prof_totals[PROF_SECTION_COUNT] = {0};
+// worst single probe per section; reset by each stall report so every
+// report attributes its own window
+static Bit64s prof_worst[PROF_SECTION_COUNT] = {0};
+static Bit64s prof_interval_start = 0;
+
+static const char *prof_names[PROF_SECTION_COUNT] = {
+	"pic", "cpu", "render", "mixer", "disk"
+};
+
+// implemented in pic.cpp against its per-handler stats
+extern Bit64s PIC_TakeWorstHandler(const void **handler, const char **kind);
+
+Bit64s PROF_Now(void)
+{
+	using namespace std::chrono;
+	return duration_cast<microseconds>(
+	               steady_clock::now().time_since_epoch())
+	        .count();
+}
+
+void PROF_Account(Bitu section,Bit64s start)
+{
+	const Bit64s spent = PROF_Now() - start;
+	prof_totals[section] += spent;
+	if (spent > prof_worst[section])
+		prof_worst[section] = spent;
+}
+
+static void PROF_ResetInterval(void)
+{
+	for (Bitu i = 0; i < PROF_SECTION_COUNT; i++)
+		prof_totals[i] = 0;
+	prof_interval_start = PROF_Now();
+}
+
+void PROF_Update(void)
+{
+	const Bit64s now = PROF_Now();
+	const Bit64s interval = now - prof_interval_start;
+	if (interval < 1000000)
+		return;
+
+	// one parseable line per interval for triage scripts
+	char line[256];
+	int pos = snprintf(line, sizeof(line), "PROFILER: interval_us=%lld",
+	                   static_cast<long long>(interval));
+	Bit64s accounted = 0;
+	for (Bitu i = 0; i < PROF_SECTION_COUNT; i++) {
+		accounted += prof_totals[i];
+		pos += snprintf(line + pos, sizeof(line) - pos, " %s_us=%lld",
+		                prof_names[i],
+		                static_cast<long long>(prof_totals[i]));
+	}
+	snprintf(line + pos, sizeof(line) - pos, " other_us=%lld",
+	         static_cast<long long>(interval - accounted));
+	LOG_MSG("%s", line);
+
+	// short percentage summary for the title bar
+	char info[96];
+	snprintf(info, sizeof(info), "pic %d%% cpu %d%% rend %d%% mix %d%% disk %d%%",
+	         static_cast<int>(prof_totals[PROF_PIC] * 100 / interval),
+	         static_cast<int>(prof_totals[PROF_CPU] * 100 / interval),
+	         static_cast<int>(prof_totals[PROF_RENDER] * 100 / interval),
+	         static_cast<int>(prof_totals[PROF_MIXER] * 100 / interval),
+	         static_cast<int>(prof_totals[PROF_DISK] * 100 / interval));
+	GFX_SetProfilerInfo(info);
+
+	PROF_ResetInterval();
+}
+
+void PROF_Stall(Bitu behind_ms)
+{
+	if (!prof_enabled)
+		return;
+	// a big overrun arrives as a burst of behind ticks; one line per
+	// half second is enough to catch each stutter without flooding
+	static Bit64s last_report = 0;
+	const Bit64s now = PROF_Now();
+	if (now - last_report < 500000)
+		return;
+	last_report = now;
+
+	const void *handler = NULL;
+	const char *kind = NULL;
+	const Bit64s handler_us = PIC_TakeWorstHandler(&handler, &kind);
+
+	char line[256];
+	int pos = snprintf(line, sizeof(line), "PROFILER: stall behind_ms=%u",
+	                   static_cast<unsigned>(behind_ms));
+	for (Bitu i = 0; i < PROF_SECTION_COUNT; i++) {
+		pos += snprintf(line + pos, sizeof(line) - pos,
+		                " %s_worst_us=%lld", prof_names[i],
+		                static_cast<long long>(prof_worst[i]));
+		prof_worst[i] = 0;
+	}
+	if (handler_us)
+		snprintf(line + pos, sizeof(line) - pos,
+		         " worst_%s=%p handler_us=%lld", kind, handler,
+		         static_cast<long long>(handler_us));
+	LOG_MSG("%s", line);
+}
+
+void PROF_Toggle(bool pressed)
+{
+	if (!pressed)
+		return;
+	prof_enabled = !prof_enabled;
+	if (prof_enabled) {
+		for (Bitu i = 0; i < PROF_SECTION_COUNT; i++)
+			prof_worst[i] = 0;
+		PROF_ResetInterval();
+		LOG_MSG("PROFILER: enabled");
+	} else {
+		GFX_SetProfilerInfo("");
+		LOG_MSG("PROFILER: disabled");
+	}
+}
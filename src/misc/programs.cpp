@@ -134,44 +134,42 @@ void Program::ChangeToLongCmd() {
 }
 
 static char last_written_character = 0;//For 0xA to OxD 0xA expansion
+//Expand 0xA to 0xD 0xA into a local chunk and hand it to DOS_WriteFile in
+//as few calls as possible, instead of one int21 write per character
+static void WriteOut_Chunked(const char * buf, Bitu size) {
+	Bit8u chunk[2048];
+	Bitu used = 0;
+	dos.internal_output=true;
+	for (Bitu i = 0; i < size; i++) {
+		if (used + 2 > sizeof(chunk)) {
+			Bit16u s = (Bit16u)used;
+			DOS_WriteFile(STDOUT,chunk,&s);
+			used = 0;
+		}
+		if (buf[i] == 0xA && last_written_character != 0xD)
+			chunk[used++] = 0xD;
+		last_written_character = (char)(chunk[used++] = (Bit8u)buf[i]);
+	}
+	if (used) {
+		Bit16u s = (Bit16u)used;
+		DOS_WriteFile(STDOUT,chunk,&s);
+	}
+	dos.internal_output=false;
+}
+
 void Program::WriteOut(const char * format,...) {
 	char buf[2048];
 	va_list msg;
-	
+
 	va_start(msg,format);
 	vsnprintf(buf,2047,format,msg);
 	va_end(msg);
 
-	Bit16u size = (Bit16u)strlen(buf);
-	dos.internal_output=true;
-	for (Bit16u i = 0; i < size; i++) {
-		Bit8u out;Bit16u s=1;
-		if (buf[i] == 0xA && last_written_character != 0xD) {
-			out = 0xD;DOS_WriteFile(STDOUT,&out,&s);
-		}
-		last_written_character = out = buf[i];
-		DOS_WriteFile(STDOUT,&out,&s);
-	}
-	dos.internal_output=false;
-	
-//	DOS_WriteFile(STDOUT,(Bit8u *)buf,&size);
+	WriteOut_Chunked(buf,strlen(buf));
 }
 
 void Program::WriteOut_NoParsing(const char * format) {
-	Bit16u size = (Bit16u)strlen(format);
-	char const* buf = format;
-	dos.internal_output=true;
-	for (Bit16u i = 0; i < size; i++) {
-		Bit8u out;Bit16u s=1;
-		if (buf[i] == 0xA && last_written_character != 0xD) {
-			out = 0xD;DOS_WriteFile(STDOUT,&out,&s);
-		}
-		last_written_character = out = buf[i];
-		DOS_WriteFile(STDOUT,&out,&s);
-	}
-	dos.internal_output=false;
-
-//	DOS_WriteFile(STDOUT,(Bit8u *)format,&size);
+	WriteOut_Chunked(format,strlen(format));
 }
 
 void Program::ResetLastWrittenChar(char c)
@@ -192,91 +190,106 @@ void Program::InjectMissingNewline()
 	last_written_character = '\n';
 }
 
+#define ENV_BLOCK_MAX 4096
+
+/* Snapshot the environment block into a host buffer with one bulk read,
+   so the per-variable scans below run on host memory instead of walking
+   the block byte-by-byte through the paging layer per access. A
+   persistent host mirror is deliberately not kept: programs may patch
+   their own (or the master) environment segment directly, so the block
+   has to be re-read, but one block copy is cheap enough. Returns the
+   snapshot size, clamped to the buffer. */
+static Bitu SnapshotEnvBlock(Bit16u env_seg,char * buf,Bitu bufsize) {
+	DOS_MCB mcb(env_seg-1);
+	Bitu envsize=mcb.GetSize()*16;
+	if (envsize>bufsize) envsize=bufsize;
+	if (envsize) MEM_BlockRead(PhysMake(env_seg,0),buf,envsize);
+	buf[envsize?envsize-1:0]=0;	/* keep the scan loops bounded */
+	return envsize;
+}
+
 bool Program::GetEnvStr(const char * entry,std::string & result) {
 	/* Walk through the internal environment and see for a match */
-	PhysPt env_read=PhysMake(psp->GetEnvironment(),0);
-
-	char env_string[1024+1];
+	char env_block[ENV_BLOCK_MAX];
+	Bitu blocksize=SnapshotEnvBlock(psp->GetEnvironment(),env_block,ENV_BLOCK_MAX);
 	result.erase();
 	if (!entry[0]) return false;
-	do 	{
-		MEM_StrCopy(env_read,env_string,1024);
-		if (!env_string[0]) return false;
-		env_read += (PhysPt)(strlen(env_string)+1);
-		char* equal = strchr(env_string,'=');
-		if (!equal) continue;
-		/* replace the = with \0 to get the length */
-		*equal = 0;
-		if (strlen(env_string) != strlen(entry)) continue;
-		if (strcasecmp(entry,env_string)!=0) continue;
-		/* restore the = to get the original result */
-		*equal = '=';
-		result = env_string;
-		return true;
-	} while (1);
+	size_t entry_length=strlen(entry);
+	char * env_string=env_block;
+	while (env_string<env_block+blocksize && *env_string) {
+		char * equal=strchr(env_string,'=');
+		if (equal && (size_t)(equal-env_string)==entry_length &&
+		    strncasecmp(entry,env_string,entry_length)==0) {
+			result=env_string;
+			return true;
+		}
+		env_string+=strlen(env_string)+1;
+	}
 	return false;
 }
 
 bool Program::GetEnvNum(Bitu num,std::string & result) {
-	char env_string[1024+1];
-	PhysPt env_read=PhysMake(psp->GetEnvironment(),0);
-	do 	{
-		MEM_StrCopy(env_read,env_string,1024);
-		if (!env_string[0]) break;
+	char env_block[ENV_BLOCK_MAX];
+	Bitu blocksize=SnapshotEnvBlock(psp->GetEnvironment(),env_block,ENV_BLOCK_MAX);
+	char * env_string=env_block;
+	while (env_string<env_block+blocksize && *env_string) {
 		if (!num) { result=env_string;return true;}
-		env_read += (PhysPt)(strlen(env_string)+1);
+		env_string+=strlen(env_string)+1;
 		num--;
-	} while (1);
+	}
 	return false;
 }
 
 Bitu Program::GetEnvCount(void) {
-	PhysPt env_read=PhysMake(psp->GetEnvironment(),0);
+	char env_block[ENV_BLOCK_MAX];
+	Bitu blocksize=SnapshotEnvBlock(psp->GetEnvironment(),env_block,ENV_BLOCK_MAX);
+	char * env_string=env_block;
 	Bitu num=0;
-	while (mem_readb(env_read)!=0) {
-		for (;mem_readb(env_read);env_read++) {};
-		env_read++;
+	while (env_string<env_block+blocksize && *env_string) {
+		env_string+=strlen(env_string)+1;
 		num++;
 	}
 	return num;
 }
 
 bool Program::SetEnv(const char * entry,const char * new_string) {
-	PhysPt env_read = PhysMake(psp->GetEnvironment(),0);
-	
 	//Get size of environment.
 	DOS_MCB mcb(psp->GetEnvironment() - 1);
 	Bit16u envsize = mcb.GetSize()*16;
-
-
-	PhysPt env_write = env_read;
-	PhysPt env_write_start = env_read;
-	char env_string[1024+1] = { 0 };
-	do 	{
-		MEM_StrCopy(env_read,env_string,1024);
-		if (!env_string[0]) break;
-		env_read += (PhysPt)(strlen(env_string)+1);
-		if (!strchr(env_string,'=')) continue;		/* Remove corrupt entry? */
-		if ((strncasecmp(entry,env_string,strlen(entry))==0) && 
-			env_string[strlen(entry)]=='=') continue;
-		MEM_BlockWrite(env_write,env_string,(Bitu)(strlen(env_string)+1));
-		env_write += (PhysPt)(strlen(env_string)+1);
-	} while (1);
+	if (envsize > ENV_BLOCK_MAX) envsize = ENV_BLOCK_MAX;
+
+	/* Compact the surviving entries into a host buffer and write the
+	   whole block back in one go afterwards */
+	char env_block[ENV_BLOCK_MAX];
+	char new_block[ENV_BLOCK_MAX];
+	Bitu blocksize=SnapshotEnvBlock(psp->GetEnvironment(),env_block,ENV_BLOCK_MAX);
+	size_t entry_length=strlen(entry);
+	char * env_string=env_block;
+	Bitu written=0;
+	while (env_string<env_block+blocksize && *env_string) {
+		size_t len=strlen(env_string);
+		if (strchr(env_string,'=') &&		/* Remove corrupt entry? */
+		    !(strncasecmp(entry,env_string,entry_length)==0 &&
+		      env_string[entry_length]=='=')) {
+			memcpy(new_block+written,env_string,len+1);
+			written+=len+1;
+		}
+		env_string+=len+1;
+	}
 /* TODO Maybe save the program name sometime. not really needed though */
 	/* Save the new entry */
 
 	//ensure room
-	if (envsize <= (env_write-env_write_start) + strlen(entry) + 1 + strlen(new_string) + 2) return false;
+	if (envsize <= written + entry_length + 1 + strlen(new_string) + 2) return false;
 
 	if (new_string[0]) {
 		std::string bigentry(entry);
 		for (std::string::iterator it = bigentry.begin(); it != bigentry.end(); ++it) *it = toupper(*it);
-		snprintf(env_string,1024+1,"%s=%s",bigentry.c_str(),new_string);
-		MEM_BlockWrite(env_write,env_string,(Bitu)(strlen(env_string)+1));
-		env_write += (PhysPt)(strlen(env_string)+1);
+		written+=(Bitu)snprintf(new_block+written,ENV_BLOCK_MAX-written,"%s=%s",bigentry.c_str(),new_string)+1;
 	}
 	/* Clear out the final piece of the environment */
-	mem_writeb(env_write,0);
+	new_block[written++]=0;
+	MEM_BlockWrite(PhysMake(psp->GetEnvironment(),0),new_block,written);
 	return true;
 }
 
@@ -766,7 +779,16 @@ void CONFIG::Run(void) {
 				return;
 			}
 			std::string inputline = pvars[1] + "=" + value;
-			
+
+			if (tsec->HasUpdateFunction(pvars[1])) {
+				// hot-reloadable property: the section applies the new
+				// value to the running device, no destroy/init cycle
+				if (tsec->HandleInputline(inputline.c_str()))
+					tsec->ExecuteUpdate(pvars[1]);
+				else WriteOut(MSG_Get("PROGRAM_CONFIG_VALUE_ERROR"),
+					value.c_str(),pvars[1].c_str());
+				return;
+			}
 			tsec->ExecuteDestroy(false);
 			bool change_success = tsec->HandleInputline(inputline.c_str());
 			if (!change_success) WriteOut(MSG_Get("PROGRAM_CONFIG_VALUE_ERROR"),
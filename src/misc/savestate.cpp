@@ -0,0 +1,319 @@
+/*
+ *  Copyright (C) 2002-2020  The DOSBox Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "savestate.h"
+
+#include <string.h>
+
+#include "dosbox.h"
+#include "mem.h"
+#include "regs.h"
+#include "cpu.h"
+#include "fpu.h"
+#include "paging.h"
+#include "pic.h"
+#include "timer.h"
+#include "profiler.h"
+
+/* Everything outside guest RAM that a snapshot carries */
+struct MachineState {
+	CPU_Regs regs;
+	Segments segs;
+	CPUBlock cpu;
+	FPU_rec fpu;
+	Bit32s cycles,cycleleft;
+	Bitu cr3,cr2;
+	bool paged;
+	Bitu ticks,irqcheck;
+	PICEventState events[PIC_QUEUESIZE];
+	Bitu event_count;
+	Bit8u pics[256];
+};
+
+static void CaptureMachine(MachineState * state) {
+	state->regs = cpu_regs;
+	state->segs = Segs;
+	state->cpu = cpu;
+	state->fpu = fpu;
+	state->cycles = CPU_Cycles;
+	state->cycleleft = CPU_CycleLeft;
+	state->cr3 = paging.cr3;
+	state->cr2 = paging.cr2;
+	state->paged = PAGING_Enabled();
+	state->ticks = PIC_Ticks;
+	state->irqcheck = PIC_IRQCheck;
+	state->event_count = PIC_SaveEvents(state->events,PIC_QUEUESIZE);
+	PIC_SaveControllers(state->pics);
+}
+
+static void RestoreMachine(const MachineState * state) {
+	cpu_regs = state->regs;
+	Segs = state->segs;
+	cpu = state->cpu;
+	fpu = state->fpu;
+	CPU_Cycles = state->cycles;
+	CPU_CycleLeft = state->cycleleft;
+	paging.cr2 = state->cr2;
+	PAGING_SetDirBase(state->cr3);
+	PAGING_Enable(state->paged);
+	PAGING_ClearTLB();
+	PIC_Ticks = state->ticks;
+	PIC_IRQCheck = state->irqcheck;
+	PIC_LoadEvents(state->events,state->event_count);
+	PIC_LoadControllers(state->pics);
+}
+
+static Bit8u * snap_ram = NULL;
+static Bitu snap_pages = 0;
+static bool snap_valid = false;
+static MachineState snap_machine;
+
+void SAVESTATE_Save(bool pressed) {
+	if (!pressed) return;
+	const Bit64s start = PROF_Now();
+	const Bitu pages = MEM_TotalPages();
+	if (PIC_ControllerStateSize() > sizeof(snap_machine.pics)) {
+		LOG_MSG("SAVESTATE: Controller state too large, not saving");
+		return;
+	}
+	if (!snap_ram || snap_pages != pages) {
+		delete [] snap_ram;
+		snap_ram = new Bit8u[pages*4096];
+		snap_pages = pages;
+		snap_valid = false;
+	}
+
+	Bitu copied;
+	if (snap_valid) {
+		/* Incremental: only pages that changed since the previous
+		   snapshot get copied, which keeps repeat saves fast on a
+		   mostly idle guest */
+		Bit8u page[4096];
+		copied = 0;
+		for (Bitu p = 0; p < pages; p++) {
+			MEM_BlockRead((PhysPt)(p*4096),page,4096);
+			if (memcmp(snap_ram + p*4096,page,4096)) {
+				memcpy(snap_ram + p*4096,page,4096);
+				copied++;
+			}
+		}
+	} else {
+		MEM_BlockRead(0,snap_ram,pages*4096);
+		copied = pages;
+	}
+	CaptureMachine(&snap_machine);
+
+	snap_valid = true;
+	LOG_MSG("SAVESTATE: Saved snapshot, %u of %u pages copied, %d us",
+	        (unsigned)copied,(unsigned)pages,(int)(PROF_Now()-start));
+}
+
+void SAVESTATE_Load(bool pressed) {
+	if (!pressed) return;
+	if (!snap_valid || snap_pages != MEM_TotalPages()) {
+		LOG_MSG("SAVESTATE: No snapshot to restore");
+		return;
+	}
+	const Bit64s start = PROF_Now();
+
+	/* Write RAM back through the paging handlers so the dynamic cores
+	   see their code pages change and mapped regions stay consistent */
+	MEM_BlockWrite(0,snap_ram,snap_pages*4096);
+	RestoreMachine(&snap_machine);
+
+	LOG_MSG("SAVESTATE: Restored snapshot in %d us (device state is not "
+	        "covered, expect glitches after mode changes)",
+	        (int)(PROF_Now()-start));
+}
+
+
+/* Rewind: while enabled, a snapshot is taken once per emulated second and
+   kept as an XOR delta against the previous one, run-length compressed
+   (after the XOR the buffer is almost entirely zero, the same property the
+   ZMBV codec exploits). The deltas chain backwards from a full image of
+   the newest snapshot, so stepping back just XORs the newest delta into
+   that image; memory use is bounded by dropping the oldest slots. */
+
+#define REWIND_SLOTS 64
+#define REWIND_MAXBYTES (64*1024*1024)
+#define REWIND_INTERVAL 1000	// emulated ms between snapshots
+
+struct RewindSlot {
+	Bit8u * delta;	// compressed XOR against the previous slot's image
+	Bitu size;
+	MachineState machine;
+};
+
+static RewindSlot rewind_slots[REWIND_SLOTS];
+static Bitu rewind_head = 0;	// next slot to write
+static Bitu rewind_count = 0;
+static Bitu rewind_bytes = 0;
+static Bit8u * rewind_base = NULL;	// full image of the newest slot
+static Bitu rewind_pages = 0;
+static bool rewind_enabled = false;
+static Bitu rewind_last_ticks = 0;
+
+/* Zero-run RLE: records of {Bit32u zero_run, Bit32u literals, data}.
+   Literal runs only break for eight or more consecutive zeros, which
+   bounds the overhead on noisy input */
+static Bitu RewindCompress(const Bit8u * src,Bitu len,Bit8u * out) {
+	Bitu in = 0;
+	Bitu used = 0;
+	while (in < len) {
+		Bitu zeros = 0;
+		while (in + zeros < len && !src[in + zeros]) zeros++;
+		if (in + zeros >= len) break;	// trailing zeros are implicit
+		Bitu lit_start = in + zeros;
+		Bitu lit = 0;
+		while (lit_start + lit < len && src[lit_start + lit]) {
+			lit++;
+			/* absorb short zero gaps into the literal run */
+			Bitu gap = 0;
+			while (lit_start + lit + gap < len && gap < 8 &&
+			       !src[lit_start + lit + gap]) gap++;
+			if (gap < 8 && lit_start + lit + gap < len) lit += gap;
+			else break;
+		}
+		host_writed(out + used,(Bit32u)zeros); used += 4;
+		host_writed(out + used,(Bit32u)lit); used += 4;
+		memcpy(out + used,src + lit_start,lit); used += lit;
+		in = lit_start + lit;
+	}
+	return used;
+}
+
+static void RewindApply(Bit8u * image,const Bit8u * delta,Bitu size) {
+	Bitu pos = 0;
+	Bitu used = 0;
+	while (used < size) {
+		pos += host_readd(delta + used); used += 4;
+		Bitu lit = host_readd(delta + used); used += 4;
+		for (Bitu i = 0; i < lit; i++) image[pos + i] ^= delta[used + i];
+		pos += lit; used += lit;
+	}
+}
+
+static void RewindDropOldest(void) {
+	if (!rewind_count) return;
+	Bitu oldest = (rewind_head + REWIND_SLOTS - rewind_count) % REWIND_SLOTS;
+	delete [] rewind_slots[oldest].delta;
+	rewind_slots[oldest].delta = NULL;
+	rewind_bytes -= rewind_slots[oldest].size;
+	rewind_slots[oldest].size = 0;
+	rewind_count--;
+}
+
+static void RewindSnapshot(void) {
+	const Bitu pages = MEM_TotalPages();
+	const Bitu bytes = pages*4096;
+	if (!rewind_base || rewind_pages != pages) {
+		delete [] rewind_base;
+		rewind_base = new Bit8u[bytes];
+		rewind_pages = pages;
+		while (rewind_count) RewindDropOldest();
+	}
+	if (rewind_count == REWIND_SLOTS) RewindDropOldest();
+
+	RewindSlot * slot = &rewind_slots[rewind_head];
+	if (rewind_count) {
+		/* XOR the new image against the old one in place, compress
+		   the result, then flip the base forward again */
+		Bit8u page[4096];
+		for (Bitu p = 0; p < pages; p++) {
+			MEM_BlockRead((PhysPt)(p*4096),page,4096);
+			for (Bitu i = 0; i < 4096; i++)
+				rewind_base[p*4096 + i] ^= page[i];
+		}
+		Bit8u * packed = new Bit8u[2*bytes + 16];
+		const Bitu size = RewindCompress(rewind_base,bytes,packed);
+		slot->delta = new Bit8u[size];
+		memcpy(slot->delta,packed,size);
+		delete [] packed;
+		slot->size = size;
+		MEM_BlockRead(0,rewind_base,bytes);
+	} else {
+		MEM_BlockRead(0,rewind_base,bytes);
+		slot->delta = NULL;
+		slot->size = 0;
+	}
+	CaptureMachine(&slot->machine);
+	rewind_bytes += slot->size;
+	rewind_head = (rewind_head + 1) % REWIND_SLOTS;
+	rewind_count++;
+	while (rewind_bytes > REWIND_MAXBYTES && rewind_count > 1)
+		RewindDropOldest();
+}
+
+static void REWIND_Tick(void) {
+	if (!rewind_enabled) return;
+	if (PIC_Ticks - rewind_last_ticks < REWIND_INTERVAL) return;
+	rewind_last_ticks = PIC_Ticks;
+	RewindSnapshot();
+}
+
+void REWIND_Toggle(bool pressed) {
+	if (!pressed) return;
+	rewind_enabled = !rewind_enabled;
+	if (rewind_enabled) {
+		if (PIC_ControllerStateSize() > sizeof(snap_machine.pics)) {
+			LOG_MSG("REWIND: Controller state too large, not enabling");
+			rewind_enabled = false;
+			return;
+		}
+		rewind_last_ticks = PIC_Ticks;
+		LOG_MSG("REWIND: Recording a snapshot every %d ms of emulated time",
+		        REWIND_INTERVAL);
+	} else {
+		while (rewind_count) RewindDropOldest();
+		delete [] rewind_base;
+		rewind_base = NULL;
+		LOG_MSG("REWIND: Stopped, buffer discarded");
+	}
+}
+
+void REWIND_Step(bool pressed) {
+	if (!pressed) return;
+	if (!rewind_enabled || !rewind_count) {
+		LOG_MSG("REWIND: Nothing recorded");
+		return;
+	}
+	const Bit64s start = PROF_Now();
+	Bitu newest = (rewind_head + REWIND_SLOTS - 1) % REWIND_SLOTS;
+	RewindSlot * slot = &rewind_slots[newest];
+	if (rewind_count > 1 && slot->delta) {
+		/* step the base image back, then retire the newest slot */
+		RewindApply(rewind_base,slot->delta,slot->size);
+		delete [] slot->delta;
+		slot->delta = NULL;
+		rewind_bytes -= slot->size;
+		slot->size = 0;
+		rewind_head = newest;
+		rewind_count--;
+		newest = (rewind_head + REWIND_SLOTS - 1) % REWIND_SLOTS;
+		slot = &rewind_slots[newest];
+	}
+	MEM_BlockWrite(0,rewind_base,rewind_pages*4096);
+	RestoreMachine(&slot->machine);
+	rewind_last_ticks = PIC_Ticks;
+	LOG_MSG("REWIND: Stepped back to %u ms of emulated time in %d us",
+	        (unsigned)PIC_Ticks,(int)(PROF_Now()-start));
+}
+
+void REWIND_Init(void) {
+	TIMER_AddTickHandlerRate(REWIND_Tick, 10); // snapshots are seconds apart
+}
@@ -841,6 +841,34 @@ void Section::AddDestroyFunction(SectionFunction func,bool canchange) {
 	destroyfunctions.push_front(Function_wrapper(func,canchange));
 }
 
+void Section::AddUpdateFunction(std::string const& propname,SectionFunction func) {
+	/* init functions run again on a config change, don't let them
+	   register the same update twice */
+	typedef std::list<Update_wrapper>::const_iterator func_it;
+	for (func_it tel = updatefunctions.begin(); tel != updatefunctions.end(); ++tel)
+		if ((*tel).propname == propname && (*tel).function == func) return;
+	updatefunctions.push_back(Update_wrapper(propname,func));
+}
+
+bool Section::HasUpdateFunction(std::string const& propname) const {
+	typedef std::list<Update_wrapper>::const_iterator func_it;
+	for (func_it tel = updatefunctions.begin(); tel != updatefunctions.end(); ++tel)
+		if ((*tel).propname == propname) return true;
+	return false;
+}
+
+bool Section::ExecuteUpdate(std::string const& propname) {
+	bool ran = false;
+	typedef std::list<Update_wrapper>::iterator func_it;
+	for (func_it tel = updatefunctions.begin(); tel != updatefunctions.end(); ++tel) {
+		if ((*tel).propname == propname) {
+			(*tel).function(this);
+			ran = true;
+		}
+	}
+	return ran;
+}
+
 
 void Section::ExecuteInit(bool initall) {
 	typedef std::list<Function_wrapper>::iterator func_it;
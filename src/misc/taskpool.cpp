@@ -0,0 +1,200 @@
+/*
+ *  Copyright (C) 2002-2020  The DOSBox Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "taskpool.h"
+
+#include "SDL.h"
+#include "SDL_thread.h"
+
+#define TASKPOOL_MAX_WORKERS	8
+#define TASKPOOL_ASYNC_SLOTS	16
+
+struct AsyncTask {
+	void (*func)(void *);
+	void * data;
+};
+
+static struct {
+	SDL_Thread * threads[TASKPOOL_MAX_WORKERS];
+	SDL_mutex * lock;
+	SDL_sem * work;		// one post per part or async task made available
+	SDL_sem * done;		// posted by whoever finishes the last part of a job
+
+	// current tiled job; next_part hands out parts to whoever asks first,
+	// which is all the stealing this job granularity needs
+	TASK_Handler handler;
+	void * data;
+	Bitu next_part;
+	Bitu parts;
+	Bitu done_parts;
+	bool job_active;
+
+	// detached one-shot tasks
+	AsyncTask async_q[TASKPOOL_ASYNC_SLOTS];
+	Bitu async_in,async_out;
+
+	// occupancy counters, logged on shutdown
+	Bitu stat_jobs;
+	Bitu stat_parts;
+	Bitu stat_stolen;	// parts that actually ran on a worker
+	Bitu stat_async;
+
+	Bitu workers;
+	bool quit;
+} pool = {};
+
+static int TASKPOOL_Worker(void *) {
+	while (true) {
+		SDL_SemWait(pool.work);
+		if (pool.quit) return 0;
+		while (true) {
+			SDL_LockMutex(pool.lock);
+			if (pool.next_part < pool.parts) {
+				const Bitu part = pool.next_part++;
+				const Bitu parts = pool.parts;
+				TASK_Handler handler = pool.handler;
+				void * data = pool.data;
+				pool.stat_stolen++;
+				SDL_UnlockMutex(pool.lock);
+				handler(part,parts,data);
+				SDL_LockMutex(pool.lock);
+				const bool last = (++pool.done_parts == pool.parts);
+				SDL_UnlockMutex(pool.lock);
+				if (last) SDL_SemPost(pool.done);
+				continue;
+			}
+			if (pool.async_out != pool.async_in) {
+				const AsyncTask task =
+					pool.async_q[pool.async_out % TASKPOOL_ASYNC_SLOTS];
+				pool.async_out++;
+				SDL_UnlockMutex(pool.lock);
+				task.func(task.data);
+				continue;
+			}
+			SDL_UnlockMutex(pool.lock);
+			break;
+		}
+	}
+}
+
+void TASKPOOL_Init(void) {
+	if (pool.lock) return;
+	pool.lock = SDL_CreateMutex();
+	pool.work = SDL_CreateSemaphore(0);
+	pool.done = SDL_CreateSemaphore(0);
+	if (!pool.lock || !pool.work || !pool.done) return;
+
+	// leave a core free for the emulation thread and the blocking-I/O
+	// threads; a single-core host gets no workers and runs jobs inline
+	int cores = SDL_GetCPUCount();
+	Bitu wanted = (cores > 1) ? (Bitu)(cores - 1) : 0;
+	if (wanted > TASKPOOL_MAX_WORKERS) wanted = TASKPOOL_MAX_WORKERS;
+
+	for (Bitu i = 0; i < wanted; i++) {
+		pool.threads[pool.workers] = SDL_CreateThread(TASKPOOL_Worker,"TaskPool",NULL);
+		if (!pool.threads[pool.workers]) break;
+		pool.workers++;
+	}
+	if (pool.workers)
+		LOG_MSG("TASKPOOL: %u worker(s) for %d host core(s)",
+			(unsigned)pool.workers,cores);
+}
+
+void TASKPOOL_Shutdown(void) {
+	if (!pool.workers) return;
+	pool.quit = true;
+	for (Bitu i = 0; i < pool.workers; i++) SDL_SemPost(pool.work);
+	for (Bitu i = 0; i < pool.workers; i++) {
+		int status;
+		SDL_WaitThread(pool.threads[i],&status);
+		pool.threads[i] = NULL;
+	}
+	LOG_MSG("TASKPOOL: ran %u tiled job(s), %u part(s) of which the workers "
+		"took %u, plus %u async task(s)",
+		(unsigned)pool.stat_jobs,(unsigned)pool.stat_parts,
+		(unsigned)pool.stat_stolen,(unsigned)pool.stat_async);
+	pool.workers = 0;
+	pool.quit = false;
+}
+
+Bitu TASKPOOL_Workers(void) {
+	return pool.workers;
+}
+
+void TASKPOOL_RunTiled(TASK_Handler handler,void * data,Bitu parts) {
+	if (!parts) return;
+	// without workers, with a trivial job, or when called from inside a
+	// running job there is nothing to distribute
+	if (!pool.workers || parts == 1 || pool.job_active) {
+		for (Bitu part = 0; part < parts; part++) handler(part,parts,data);
+		return;
+	}
+
+	SDL_LockMutex(pool.lock);
+	pool.handler = handler;
+	pool.data = data;
+	pool.parts = parts;
+	pool.next_part = 0;
+	pool.done_parts = 0;
+	pool.job_active = true;
+	pool.stat_jobs++;
+	pool.stat_parts += parts;
+	SDL_UnlockMutex(pool.lock);
+
+	Bitu wake = (parts - 1 < pool.workers) ? parts - 1 : pool.workers;
+	for (Bitu i = 0; i < wake; i++) SDL_SemPost(pool.work);
+
+	// work on the job ourselves instead of blocking right away
+	while (true) {
+		SDL_LockMutex(pool.lock);
+		if (pool.next_part >= pool.parts) {
+			SDL_UnlockMutex(pool.lock);
+			break;
+		}
+		const Bitu part = pool.next_part++;
+		SDL_UnlockMutex(pool.lock);
+		handler(part,parts,data);
+		SDL_LockMutex(pool.lock);
+		const bool last = (++pool.done_parts == pool.parts);
+		SDL_UnlockMutex(pool.lock);
+		if (last) SDL_SemPost(pool.done);
+	}
+
+	// the finisher of the last part posted done exactly once, possibly us
+	SDL_SemWait(pool.done);
+	SDL_LockMutex(pool.lock);
+	pool.job_active = false;
+	SDL_UnlockMutex(pool.lock);
+}
+
+bool TASKPOOL_RunAsync(void (*func)(void *),void * data) {
+	if (!pool.workers) return false;
+	SDL_LockMutex(pool.lock);
+	if (pool.async_in - pool.async_out >= TASKPOOL_ASYNC_SLOTS) {
+		SDL_UnlockMutex(pool.lock);
+		return false;
+	}
+	AsyncTask &task = pool.async_q[pool.async_in % TASKPOOL_ASYNC_SLOTS];
+	task.func = func;
+	task.data = data;
+	pool.async_in++;
+	pool.stat_async++;
+	SDL_UnlockMutex(pool.lock);
+	SDL_SemPost(pool.work);
+	return true;
+}
@@ -0,0 +1,116 @@
+/*
+ *  Copyright (C) 2002-2020  The DOSBox Team
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "tracer.h"
+
+#include <atomic>
+#include <cstdio>
+
+bool trace_enabled = false;
+
+struct TraceEvent {
+	const char *cat;
+	const char *name;
+	const void *id;
+	Bit64s ts;		// microseconds, PROF_Now() clock
+	Bit64s dur;		// <0 for instant events
+};
+
+// ~6 MB; enough for a couple of minutes of normal scheduling activity
+#define TRACE_MAXEVENTS 131072
+
+static TraceEvent *trace_events = NULL;
+static std::atomic<Bitu> trace_used(0);
+
+/* The mixer callback records from the audio thread, so claim slots with an
+   atomic increment; everything else about an event is slot-local. */
+static void TRACE_Record(const char *cat,const char *name,const void *id,
+                         Bit64s ts,Bit64s dur)
+{
+	const Bitu slot = trace_used.fetch_add(1, std::memory_order_relaxed);
+	if (slot >= TRACE_MAXEVENTS)
+		return;
+	TraceEvent &ev = trace_events[slot];
+	ev.cat = cat;
+	ev.name = name;
+	ev.id = id;
+	ev.ts = ts;
+	ev.dur = dur;
+}
+
+void TRACE_Complete(const char *cat,const char *name,const void *id,Bit64s start)
+{
+	TRACE_Record(cat, name, id, start, PROF_Now() - start);
+}
+
+void TRACE_Instant(const char *cat,const char *name,const void *id)
+{
+	TRACE_Record(cat, name, id, PROF_Now(), -1);
+}
+
+static void TRACE_WriteFile(void)
+{
+	FILE *f = fopen("dosbox_trace.json", "wb");
+	if (!f) {
+		LOG_MSG("TRACER: Can't create dosbox_trace.json");
+		return;
+	}
+	const Bitu used = trace_used.load();
+	const Bitu kept = (used > TRACE_MAXEVENTS) ? TRACE_MAXEVENTS : used;
+	fprintf(f, "{\"traceEvents\":[\n");
+	for (Bitu i = 0; i < kept; i++) {
+		const TraceEvent &ev = trace_events[i];
+		char name[64];
+		if (ev.id)
+			snprintf(name, sizeof(name), "%s@%p", ev.name, ev.id);
+		else
+			snprintf(name, sizeof(name), "%s", ev.name);
+		if (ev.dur >= 0)
+			fprintf(f, "{\"ph\":\"X\",\"pid\":1,\"tid\":1,"
+			        "\"cat\":\"%s\",\"name\":\"%s\","
+			        "\"ts\":%lld,\"dur\":%lld}%s\n",
+			        ev.cat, name, static_cast<long long>(ev.ts),
+			        static_cast<long long>(ev.dur),
+			        (i + 1 < kept) ? "," : "");
+		else
+			fprintf(f, "{\"ph\":\"i\",\"pid\":1,\"tid\":1,\"s\":\"g\","
+			        "\"cat\":\"%s\",\"name\":\"%s\",\"ts\":%lld}%s\n",
+			        ev.cat, name, static_cast<long long>(ev.ts),
+			        (i + 1 < kept) ? "," : "");
+	}
+	fprintf(f, "]}\n");
+	fclose(f);
+	LOG_MSG("TRACER: Wrote %d event(s) to dosbox_trace.json, %d dropped",
+	        static_cast<int>(kept), static_cast<int>(used - kept));
+}
+
+void TRACE_Toggle(bool pressed)
+{
+	if (!pressed)
+		return;
+	if (!trace_enabled) {
+		if (!trace_events)
+			trace_events = new TraceEvent[TRACE_MAXEVENTS];
+		trace_used = 0;
+		trace_enabled = true;
+		LOG_MSG("TRACER: Recording scheduling trace");
+	} else {
+		trace_enabled = false;
+		TRACE_WriteFile();
+	}
+}
@@ -147,6 +147,8 @@ AutoexecObject::~AutoexecObject(){
 			if (stringset && first_shell && first_shell->bf && first_shell->bf->filename.find("AUTOEXEC.BAT") != std::string::npos) {
 				//Replace entry with spaces if it is a set and from autoexec.bat, as else the location counter will be off.
 				*it = buf.assign(buf.size(),' ');
+				//Running batch files keep an in-memory copy; make them re-read the blanked line
+				for (BatchFile* bf=first_shell->bf; bf; bf=bf->prev) bf->InvalidateCache();
 				it++;
 			} else {
 				it = autoexec_strings.erase(it);
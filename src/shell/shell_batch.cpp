@@ -33,7 +33,8 @@ BatchFile::BatchFile(DOS_Shell *host,
 	  shell(host),
 	  prev(host->bf),
 	  cmd(new CommandLine(entered_name, cmd_line)),
-	  filename("")
+	  filename(""),
+	  cached(false)
 {
 	char totalname[DOS_PATHLENGTH+4];
 	DOS_Canonicalize(resolved_name,totalname); // Get fullname including drive specificiation
@@ -52,25 +53,35 @@ BatchFile::~BatchFile() {
 	shell->echo=echo;
 }
 
-bool BatchFile::ReadLine(char * line) {
-	//Open the batchfile and seek to stored postion
-	if (!DOS_OpenFile(filename.c_str(),(DOS_NOT_INHERIT|OPEN_READ),&file_handle)) {
-		LOG(LOG_MISC,LOG_ERROR)("ReadLine Can't open BatchFile %s",filename.c_str());
-		delete this;
-		return false;
-	}
-	DOS_SeekFile(file_handle,&(this->location),DOS_SEEK_SET);
+/* Read the whole file once through the DOS file API, split it into lines and
+ * index the labels, so ReadLine and Goto become array lookups instead of
+ * re-opening and scanning the file byte by byte. Done lazily on first use:
+ * subclasses (VirtualBatch) pass device names to the constructor and never
+ * call into the base reader. */
+bool BatchFile::CacheFile(void) {
+	if (cached) return true;
+	if (!DOS_OpenFile(filename.c_str(),(DOS_NOT_INHERIT|OPEN_READ),&file_handle)) return false;
+
+	cached_lines.clear();
+	labels.clear();
 
-	Bit8u c=0;Bit16u n=1;
+	Bit8u buffer[1024];
 	char temp[CMD_MAXLINE];
-emptyline:
 	char * cmd_write=temp;
-	do {
-		n=1;
-		DOS_ReadFile(file_handle,&c,&n);
-		if (n>0) {
+	Bit16u n=sizeof(buffer);
+	while (n==sizeof(buffer)) {
+		n=sizeof(buffer);
+		DOS_ReadFile(file_handle,buffer,&n);
+		for (Bit16u i=0;i<n;i++) {
+			Bit8u c=buffer[i];
+			if (c=='\n') {
+				*cmd_write=0;
+				cached_lines.push_back(temp);
+				cmd_write=temp;
+				continue;
+			}
 			/* Why are we filtering this ?
-			 * Exclusion list: tab for batch files 
+			 * Exclusion list: tab for batch files
 			 * escape for ansi
 			 * backspace for alien odyssey */
 			if (c>31 || c==0x1b || c=='\t' || c==8) {
@@ -80,16 +91,57 @@ emptyline:
 					*cmd_write++ = c;
 			}
 		}
-	} while (c!='\n' && n);
-	*cmd_write=0;
-	if (!n && cmd_write==temp) {
-		//Close file and delete bat file
-		DOS_CloseFile(file_handle);
+	}
+	if (cmd_write!=temp) {
+		//Last line without a newline still counts
+		*cmd_write=0;
+		cached_lines.push_back(temp);
+	}
+	DOS_CloseFile(file_handle);
+
+	//Index the labels, first occurrence wins like the old top-down scan
+	for (Bitu i=0;i<cached_lines.size();i++) {
+		safe_strcpy(temp,cached_lines[i].c_str());
+		char *nospace = trim(temp);
+		if (nospace[0] != ':') continue;
+		nospace++; //Skip :
+		//Strip spaces and = from it.
+		while(*nospace && (isspace(*reinterpret_cast<unsigned char*>(nospace)) || (*nospace == '=')))
+			nospace++;
+
+		//label is until space/=/eol
+		char* const beginlabel = nospace;
+		while(*nospace && !isspace(*reinterpret_cast<unsigned char*>(nospace)) && (*nospace != '='))
+			nospace++;
+
+		*nospace = 0;
+		if (*beginlabel) labels.insert(std::make_pair(std::string(upcase(beginlabel)),i));
+	}
+	cached=true;
+	return true;
+}
+
+bool BatchFile::ReadLine(char * line) {
+	if (!CacheFile()) {
+		LOG(LOG_MISC,LOG_ERROR)("ReadLine Can't open BatchFile %s",filename.c_str());
 		delete this;
-		return false;	
+		return false;
 	}
-	if (!strlen(temp)) goto emptyline;
-	if (temp[0]==':') goto emptyline;
+
+	char temp[CMD_MAXLINE];
+	for (;;) {
+		if (location>=cached_lines.size()) {
+			//Batch file exhausted, delete bat file
+			delete this;
+			return false;
+		}
+		safe_strcpy(temp,cached_lines[location].c_str());
+		location++;
+		if (!strlen(temp)) continue;
+		if (temp[0]==':') continue;
+		break;
+	}
+	char * cmd_write;
 
 	/* Now parse the line read from the bat file for % stuff */
 	cmd_write=line;
@@ -152,68 +204,28 @@ emptyline:
 		}
 	}
 	*cmd_write = 0;
-	//Store current location and close bat file
-	this->location = 0;
-	DOS_SeekFile(file_handle,&(this->location),DOS_SEEK_CUR);
-	DOS_CloseFile(file_handle);
-	return true;	
+	return true;
 }
 
 bool BatchFile::Goto(char * where) {
-	//Open bat file and search for the where string
-	if (!DOS_OpenFile(filename.c_str(),(DOS_NOT_INHERIT|OPEN_READ),&file_handle)) {
+	if (!CacheFile()) {
 		LOG(LOG_MISC,LOG_ERROR)("SHELL:Goto Can't open BatchFile %s",filename.c_str());
 		delete this;
 		return false;
 	}
 
-	char cmd_buffer[CMD_MAXLINE];
-	char * cmd_write;
-
-	/* Scan till we have a match or return false */
-	Bit8u c;Bit16u n;
-again:
-	cmd_write=cmd_buffer;
-	do {
-		n=1;
-		DOS_ReadFile(file_handle,&c,&n);
-		if (n>0) {
-			if (c>31) {
-				if (((cmd_write - cmd_buffer) + 1) < (CMD_MAXLINE - 1))
-					*cmd_write++ = c;
-			}
-		}
-	} while (c!='\n' && n);
-	*cmd_write++ = 0;
-	char *nospace = trim(cmd_buffer);
-	if (nospace[0] == ':') {
-		nospace++; //Skip :
-		//Strip spaces and = from it.
-		while(*nospace && (isspace(*reinterpret_cast<unsigned char*>(nospace)) || (*nospace == '=')))
-			nospace++;
-
-		//label is until space/=/eol
-		char* const beginlabel = nospace;
-		while(*nospace && !isspace(*reinterpret_cast<unsigned char*>(nospace)) && (*nospace != '=')) 
-			nospace++;
-
-		*nospace = 0;
-		if (strcasecmp(beginlabel,where)==0) {
-		//Found it! Store location and continue
-			this->location = 0;
-			DOS_SeekFile(file_handle,&(this->location),DOS_SEEK_CUR);
-			DOS_CloseFile(file_handle);
-			return true;
-		}
-	   
-	}
-	if (!n) {
-		DOS_CloseFile(file_handle);
+	char label[CMD_MAXLINE];
+	safe_strcpy(label,where);
+	upcase(label);
+	std::map<std::string,Bitu>::iterator it=labels.find(label);
+	if (it==labels.end()) {
+		//No such label, delete bat file
 		delete this;
-		return false;	
+		return false;
 	}
-	goto again;
-	return false;
+	//Found it! Continue with the line after the label
+	location=(Bit32u)it->second+1;
+	return true;
 }
 
 void BatchFile::Shift(void) {
@@ -73,6 +73,39 @@ static SHELL_Cmd cmd_list[]={
 {0,0,0,0}
 };
 
+/* Index over cmd_list keyed on the first letter, built on first use.
+   Scripted shells dispatch thousands of commands and DoCommand walked the
+   whole table with strcasecmp for every one of them (twice for things
+   like cd..); the buckets cut that to the one or two entries sharing the
+   initial. HELP still iterates cmd_list itself for the listing. */
+static Bits cmd_bucket['Z' - 'A' + 1];
+static Bits cmd_chain[sizeof(cmd_list) / sizeof(cmd_list[0])];
+static bool cmd_index_built = false;
+
+static void BuildCommandIndex(void) {
+	for (Bitu b = 0; b < sizeof(cmd_bucket) / sizeof(cmd_bucket[0]); b++)
+		cmd_bucket[b] = -1;
+	for (Bitu i = 0; cmd_list[i].name; i++) {
+		const Bitu b = static_cast<Bitu>(cmd_list[i].name[0] - 'A');
+		cmd_chain[i] = cmd_bucket[b];
+		cmd_bucket[b] = static_cast<Bits>(i);
+	}
+	cmd_index_built = true;
+}
+
+static const SHELL_Cmd *LookupCommand(const char *name) {
+	if (!cmd_index_built)
+		BuildCommandIndex();
+	const char c = static_cast<char>(toupper(static_cast<unsigned char>(name[0])));
+	if (c < 'A' || c > 'Z')
+		return nullptr;
+	for (Bits i = cmd_bucket[c - 'A']; i >= 0; i = cmd_chain[i]) {
+		if (strcasecmp(cmd_list[i].name, name) == 0)
+			return &cmd_list[i];
+	}
+	return nullptr;
+}
+
 /* support functions */
 static char empty_char = 0;
 static char* empty_string = &empty_char;
@@ -139,13 +172,10 @@ void DOS_Shell::DoCommand(char * line) {
 //		if (*line == ':') break; //This breaks drive switching as that is handled at a later stage.
 		if ((*line == '.') ||(*line == '\\')) {  //allow stuff like cd.. and dir.exe cd\kees
 			*cmd_write=0;
-			Bit32u cmd_index=0;
-			while (cmd_list[cmd_index].name) {
-				if (strcasecmp(cmd_list[cmd_index].name,cmd_buffer) == 0) {
-					(this->*(cmd_list[cmd_index].handler))(line);
-			 		return;
-				}
-				cmd_index++;
+			const SHELL_Cmd *cmd=LookupCommand(cmd_buffer);
+			if (cmd) {
+				(this->*(cmd->handler))(line);
+				return;
 			}
 		}
 		*cmd_write++=*line++;
@@ -153,13 +183,10 @@ void DOS_Shell::DoCommand(char * line) {
 	*cmd_write=0;
 	if (strlen(cmd_buffer) == 0) return;
 /* Check the internal list */
-	Bit32u cmd_index=0;
-	while (cmd_list[cmd_index].name) {
-		if (strcasecmp(cmd_list[cmd_index].name,cmd_buffer) == 0) {
-			(this->*(cmd_list[cmd_index].handler))(line);
-			return;
-		}
-		cmd_index++;
+	const SHELL_Cmd *cmd=LookupCommand(cmd_buffer);
+	if (cmd) {
+		(this->*(cmd->handler))(line);
+		return;
 	}
 /* This isn't an internal command execute it */
 	if (Execute(cmd_buffer,line)) return;
@@ -553,6 +580,29 @@ void DOS_Shell::CMD_DIR(char * args) {
 		p_count += 2;
 	}
 
+	// Entry lines are collected here and flushed in large chunks, so a big
+	// listing does not pay one DOS_WriteFile round trip per line.
+	char out_buf[4096];
+	size_t out_used = 0;
+	auto flush_output = [&]() {
+		if (!out_used)
+			return;
+		out_buf[out_used] = '\0';
+		WriteOut_NoParsing(out_buf);
+		out_used = 0;
+	};
+	auto append_output = [&](const char *text) {
+		const size_t len = strlen(text);
+		if (out_used + len >= sizeof(out_buf) - 1)
+			flush_output();
+		if (len >= sizeof(out_buf) - 1) {
+			WriteOut_NoParsing(text);
+			return;
+		}
+		memcpy(out_buf + out_used, text, len);
+		out_used += len;
+	};
+
 	// Helper function to handle 'Press any key to continue' message
 	// regardless of specific formatting below.
 	// Call it whenever a newline gets printed.
@@ -560,8 +610,10 @@ void DOS_Shell::CMD_DIR(char * args) {
 	// TODO: DIR code assumes, that terminal size is 80x25
 	auto show_press_any_key = [&]() {
 		p_count += 1;
-		if (optP && (p_count % 24) == 0)
+		if (optP && (p_count % 24) == 0) {
+			flush_output();
 			CMD_PAUSE(empty_string);
+		}
 	};
 
 	const bool is_root = strnlen(path, sizeof(path)) == 3;
@@ -638,10 +690,13 @@ void DOS_Shell::CMD_DIR(char * args) {
 			byte_count += size;
 		}
 
+		char line_buf[CROSS_LEN];
+
 		// 'Bare' format: just the name, one per line, nothing else
 		//
 		if (optB) {
-			WriteOut("%s\n", name);
+			snprintf(line_buf, sizeof(line_buf), "%s\n", name);
+			append_output(line_buf);
 			show_press_any_key();
 			continue;
 		}
@@ -651,10 +706,12 @@ void DOS_Shell::CMD_DIR(char * args) {
 		if (optW) {
 			if (is_dir) {
 				const int length = static_cast<int>(strlen(name));
-				WriteOut("[%s]%*s", name, (14 - length), "");
+				snprintf(line_buf, sizeof(line_buf),
+				         "[%s]%*s", name, (14 - length), "");
 			} else {
-				WriteOut("%-16s", name);
+				snprintf(line_buf, sizeof(line_buf), "%-16s", name);
 			}
+			append_output(line_buf);
 			w_count += 1;
 			if ((w_count % 5) == 0)
 				show_press_any_key();
@@ -682,22 +739,26 @@ void DOS_Shell::CMD_DIR(char * args) {
 		}
 
 		if (is_dir) {
-			WriteOut("%-8s %-3s   %-16s %02d-%02d-%04d %2d:%02d\n",
+			snprintf(line_buf, sizeof(line_buf),
+			         "%-8s %-3s   %-16s %02d-%02d-%04d %2d:%02d\n",
 			         name, ext, "<DIR>", day, month, year, hour, minute);
 		} else {
 			FormatNumber(size, numformat);
-			WriteOut("%-8s %-3s   %16s %02d-%02d-%04d %2d:%02d\n",
+			snprintf(line_buf, sizeof(line_buf),
+			         "%-8s %-3s   %16s %02d-%02d-%04d %2d:%02d\n",
 			         name, ext, numformat, day, month, year, hour, minute);
 		}
+		append_output(line_buf);
 		show_press_any_key();
 	}
 
 	// Additional newline in case last line in 'Wide list` format was
 	// not wrapped automatically.
 	if (optW && (w_count % 5)) {
-		WriteOut("\n");
+		append_output("\n");
 		show_press_any_key();
 	}
+	flush_output();
 
 	// Show the summary of results
 	if (!optB) {